@@ -0,0 +1,99 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+void Arena_Init(Arena *arena, size_t block_size, MemTag tag)
+{
+    memset(arena, 0, sizeof(Arena));
+    arena->block_size = block_size;
+    arena->tag = tag;
+}
+
+static ArenaBlock *Arena_NewBlock(Arena *arena, size_t min_size)
+{
+    size_t size = arena->block_size > min_size ? arena->block_size : min_size;
+    ArenaBlock *block = Mem_Alloc(arena->tag, ARENA_HEADER_SIZE + size);
+    if (!block)
+        return NULL;
+
+    block->size = size;
+    block->used = 0;
+    if (min_size > arena->block_size && arena->head)
+    {
+        // Grosse allocation : bloc dédié rangé derrière le bloc courant, qui
+        // reste disponible pour les petites allocations suivantes
+        block->next = arena->head->next;
+        arena->head->next = block;
+    }
+    else
+    {
+        block->next = arena->head;
+        arena->head = block;
+    }
+    arena->capacity += size;
+    arena->block_count++;
+    return block;
+}
+
+void *Arena_Alloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (size == 0)
+        size = ARENA_ALIGNMENT;
+
+    ArenaBlock *block = arena->head;
+    if (!block || block->size - block->used < size)
+    {
+        // Les blocs précédents ne sont pas parcourus : leur reste est perdu
+        block = Arena_NewBlock(arena, size);
+        if (!block)
+            return NULL;
+    }
+
+    void *ptr = (char *)block + ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+    arena->used += size;
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void *Arena_Calloc(Arena *arena, size_t count, size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+    return Arena_Alloc(arena, count * size);
+}
+
+char *Arena_Strdup(Arena *arena, const char *str)
+{
+    if (!str)
+        return NULL;
+
+    size_t length = strlen(str) + 1;
+    char *copy = Arena_Alloc(arena, length);
+    if (copy)
+        memcpy(copy, str, length);
+    return copy;
+}
+
+void Arena_Release(Arena *arena)
+{
+    ArenaBlock *block = arena->head;
+    while (block)
+    {
+        ArenaBlock *next = block->next;
+        Mem_Free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+    arena->used = 0;
+    arena->capacity = 0;
+    arena->block_count = 0;
+}
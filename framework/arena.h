@@ -0,0 +1,41 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include "memtrack.h"
+
+// Allocateur par incrément (« arène ») : les allocations ne sont jamais
+// libérées une à une, tout est rendu d'un coup par Arena_Release. Les blocs
+// sont chaînés, les pointeurs déjà donnés restent donc valides.
+
+#define ARENA_ALIGNMENT 16
+
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t size; // Octets utilisables après l'en-tête
+    size_t used;
+} ArenaBlock;
+
+typedef struct
+{
+    ArenaBlock *head;  // Bloc courant (les précédents sont pleins)
+    size_t block_size; // Taille des nouveaux blocs
+    size_t used;       // Octets alloués (alignement compris)
+    size_t capacity;   // Octets réservés dans tous les blocs
+    size_t peak;       // Plus haut `used` atteint depuis Arena_Init
+    int block_count;
+    MemTag tag; // Sous-système auquel les blocs sont comptés
+} Arena;
+
+void Arena_Init(Arena *arena, size_t block_size, MemTag tag);
+
+// Mémoire mise à zéro ; NULL si l'allocation d'un bloc échoue
+void *Arena_Alloc(Arena *arena, size_t size);
+void *Arena_Calloc(Arena *arena, size_t count, size_t size);
+char *Arena_Strdup(Arena *arena, const char *str);
+
+// Rend tous les blocs ; l'arène peut être réutilisée (le pic est conservé)
+void Arena_Release(Arena *arena);
+
+#endif // ARENA_H
@@ -0,0 +1,402 @@
+#include "font.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_ATLAS_ROWS ((FONT_CHAR_COUNT + FONT_ATLAS_COLUMNS - 1) / FONT_ATLAS_COLUMNS)
+
+// Glyphes 8x8 du domaine public (font8x8_basic), de l'espace au tilde : une
+// ligne par octet, de haut en bas, bit 0 à gauche
+static const Uint8 font_glyphs[FONT_CHAR_COUNT][FONT_GLYPH_SIZE] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // '!'
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // '#'
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // '$'
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // '%'
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // '&'
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '''
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // '('
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // ')'
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // '*'
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ','
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // '.'
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // '/'
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // '0'
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // '1'
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // '2'
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // '3'
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // '4'
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // '5'
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // '6'
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // '7'
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // '8'
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // '9'
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ';'
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // '<'
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // '='
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // '>'
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // '?'
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // '@'
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // 'A'
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // 'B'
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // 'C'
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // 'D'
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // 'E'
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // 'F'
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // 'G'
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // 'H'
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'I'
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // 'J'
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // 'K'
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // 'L'
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // 'M'
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // 'N'
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // 'O'
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // 'P'
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // 'Q'
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // 'R'
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // 'S'
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'T'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // 'U'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // 'V'
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // 'W'
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // 'X'
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // 'Y'
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // 'Z'
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // '['
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // '\'
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ']'
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // '_'
+    {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // '`'
+    {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // 'a'
+    {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // 'b'
+    {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // 'c'
+    {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // 'd'
+    {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // 'e'
+    {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // 'f'
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // 'g'
+    {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // 'h'
+    {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'i'
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // 'j'
+    {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // 'k'
+    {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'l'
+    {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // 'm'
+    {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // 'n'
+    {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // 'o'
+    {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // 'p'
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // 'q'
+    {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // 'r'
+    {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // 's'
+    {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // 't'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // 'u'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // 'v'
+    {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // 'w'
+    {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // 'x'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // 'y'
+    {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // 'z'
+    {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // '{'
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // '|'
+    {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // '}'
+    {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '~'
+};
+
+// U+00C0 à U+00FF ramenés à une lettre de l'atlas (accents retirés)
+static const char latin1_fold[] = "AAAAAAACEEEEIIIIDNOOOOOxOUUUUYTsaaaaaaaceeeeiiiidnooooo/ouuuuyty";
+
+// Rend les glyphes blancs sur fond transparent : la couleur vient des sommets
+static SDL_Texture *Font_CreateAtlas(SDL_Renderer *renderer)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, FONT_ATLAS_COLUMNS * FONT_GLYPH_SIZE,
+                                                          FONT_ATLAS_ROWS * FONT_GLYPH_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface)
+    {
+        fprintf(stderr, "Impossible de créer l'atlas de la police: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    Uint32 on = SDL_MapRGBA(surface->format, 255, 255, 255, 255);
+    Uint32 off = SDL_MapRGBA(surface->format, 255, 255, 255, 0);
+    SDL_LockSurface(surface);
+    for (int g = 0; g < FONT_CHAR_COUNT; g++)
+    {
+        int ox = (g % FONT_ATLAS_COLUMNS) * FONT_GLYPH_SIZE;
+        int oy = (g / FONT_ATLAS_COLUMNS) * FONT_GLYPH_SIZE;
+        for (int y = 0; y < FONT_GLYPH_SIZE; y++)
+        {
+            Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + (oy + y) * surface->pitch) + ox;
+            for (int x = 0; x < FONT_GLYPH_SIZE; x++)
+                row[x] = (font_glyphs[g][y] >> x) & 1 ? on : off;
+        }
+    }
+    SDL_UnlockSurface(surface);
+
+    SDL_Texture *atlas = Mem_CreateTextureFromSurface(MEM_TAG_RENDER, renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!atlas)
+    {
+        fprintf(stderr, "Impossible de créer la texture de la police: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    return atlas;
+}
+
+Font *Font_Create(SDL_Renderer *renderer)
+{
+    Font *font = Mem_Calloc(MEM_TAG_RENDER, 1, sizeof(Font));
+    if (!font)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la police.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (renderer)
+        font->atlas = Font_CreateAtlas(renderer);
+    return font;
+}
+
+void Font_Free(Font *font)
+{
+    if (!font)
+        return;
+    Mem_DestroyTexture(MEM_TAG_RENDER, font->atlas);
+    for (int i = 0; i < FONT_LAYOUT_CACHE_SIZE; i++)
+    {
+        Mem_Free(font->layouts[i].text);
+        Mem_Free(font->layouts[i].glyphs);
+    }
+    Mem_Free(font);
+}
+
+// Caractère suivant de la chaîne UTF-8 : indice dans l'atlas, -1 s'il n'est
+// pas affichable (contrôle). Hors Latin-1, '?'.
+static int Font_NextGlyph(const char **cursor)
+{
+    const unsigned char *c = (const unsigned char *)*cursor;
+    if (c[0] < 0x80)
+    {
+        (*cursor)++;
+        return c[0] >= FONT_FIRST_CHAR && c[0] < FONT_FIRST_CHAR + FONT_CHAR_COUNT ? c[0] - FONT_FIRST_CHAR : -1;
+    }
+
+    // Séquence tronquée : on s'arrête au premier octet qui n'en fait pas partie
+    int length = c[0] >= 0xF0 ? 4 : c[0] >= 0xE0 ? 3 : c[0] >= 0xC0 ? 2 : 1;
+    for (int i = 1; i < length; i++)
+    {
+        if ((c[i] & 0xC0) != 0x80)
+        {
+            length = i;
+            break;
+        }
+    }
+    *cursor += length;
+
+    if (length == 2)
+    {
+        unsigned int codepoint = ((c[0] & 0x1Fu) << 6) | (c[1] & 0x3Fu);
+        if (codepoint >= 0xC0 && codepoint <= 0xFF)
+            return latin1_fold[codepoint - 0xC0] - FONT_FIRST_CHAR;
+    }
+    return '?' - FONT_FIRST_CHAR;
+}
+
+int Font_CountGlyphs(const char *text)
+{
+    int count = 0;
+    const char *c = text;
+    while (*c)
+    {
+        if (*c == ' ' || *c == '\n')
+            c++;
+        else if (Font_NextGlyph(&c) >= 0)
+            count++;
+    }
+    return count;
+}
+
+static void Font_PushGlyph(FontLayout *layout, int column, int line, int glyph)
+{
+    if (layout->glyph_count == layout->glyph_capacity)
+    {
+        int capacity = layout->glyph_capacity ? layout->glyph_capacity * 2 : 64;
+        FontGlyph *glyphs = Mem_Realloc(MEM_TAG_RENDER, layout->glyphs, capacity * sizeof(FontGlyph));
+        if (!glyphs)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la mise en page du texte.\n");
+            exit(EXIT_FAILURE);
+        }
+        layout->glyphs = glyphs;
+        layout->glyph_capacity = capacity;
+    }
+    layout->glyphs[layout->glyph_count++] = (FontGlyph){(Uint16)column, (Uint16)line, (Uint8)glyph};
+}
+
+// Coupure par mots : un mot qui ne tient pas dans la fin de la ligne passe à
+// la suivante, un mot plus long qu'une ligne est coupé. Les espaces en début
+// de ligne coupée sont absorbés.
+static void Font_BuildLayout(FontLayout *layout, const char *text, int wrap_width, int scale)
+{
+    int max_columns = wrap_width > 0 ? wrap_width / (FONT_GLYPH_SIZE * scale) : 0;
+    if (wrap_width > 0 && max_columns < 1)
+        max_columns = 1;
+
+    int column = 0, line = 0, widest = 0;
+    bool wrapped = false;
+    layout->glyph_count = 0;
+
+    const char *c = text;
+    while (*c)
+    {
+        if (*c == '\n')
+        {
+            line++;
+            column = 0;
+            wrapped = false;
+            c++;
+            continue;
+        }
+        if (*c == ' ')
+        {
+            if (column > 0 || !wrapped)
+                column++;
+            c++;
+            continue;
+        }
+
+        int length = 0;
+        for (const char *w = c; *w && *w != ' ' && *w != '\n'; length++)
+            Font_NextGlyph(&w);
+        if (max_columns > 0 && column > 0 && column + length > max_columns)
+        {
+            line++;
+            column = 0;
+        }
+
+        while (*c && *c != ' ' && *c != '\n')
+        {
+            int glyph = Font_NextGlyph(&c);
+            if (glyph < 0)
+                continue;
+            if (max_columns > 0 && column >= max_columns)
+            {
+                line++;
+                column = 0;
+            }
+            Font_PushGlyph(layout, column, line, glyph);
+            column++;
+            if (column > widest)
+                widest = column;
+        }
+        wrapped = true; // Les espaces suivants peuvent finir sur une ligne coupée
+    }
+
+    layout->line_count = text[0] ? line + 1 : 0;
+    layout->width = widest * FONT_GLYPH_SIZE * scale;
+    layout->height = layout->line_count > 0
+                         ? (layout->line_count * (FONT_GLYPH_SIZE + FONT_LINE_SPACING) - FONT_LINE_SPACING) * scale
+                         : 0;
+}
+
+static Uint32 Font_Hash(const char *text, int wrap_width, int scale)
+{
+    Uint32 hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    hash ^= (Uint32)wrap_width * 2654435761u ^ (Uint32)scale;
+    return hash ? hash : 1;
+}
+
+const FontLayout *Font_Layout(Font *font, const char *text, int wrap_width, int scale)
+{
+    if (!font || !text)
+        return NULL;
+    if (scale < 1)
+        scale = 1;
+
+    Uint32 hash = Font_Hash(text, wrap_width, scale);
+    FontLayout *victim = &font->layouts[0];
+    font->clock++;
+    for (int i = 0; i < FONT_LAYOUT_CACHE_SIZE; i++)
+    {
+        FontLayout *layout = &font->layouts[i];
+        if (layout->hash == hash && layout->wrap_width == wrap_width && layout->scale == scale &&
+            strcmp(layout->text, text) == 0)
+        {
+            layout->last_used = font->clock;
+            return layout;
+        }
+        if (layout->last_used < victim->last_used)
+            victim = layout;
+    }
+
+    // Absent : l'emplacement le moins récemment utilisé est réemployé avec ses tampons
+    size_t size = strlen(text) + 1;
+    if (size > victim->text_capacity)
+    {
+        char *copy = Mem_Realloc(MEM_TAG_RENDER, victim->text, size);
+        if (!copy)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la mise en page du texte.\n");
+            exit(EXIT_FAILURE);
+        }
+        victim->text = copy;
+        victim->text_capacity = size;
+    }
+    memcpy(victim->text, text, size);
+    victim->hash = hash;
+    victim->wrap_width = wrap_width;
+    victim->scale = scale;
+    victim->last_used = font->clock;
+    Font_BuildLayout(victim, text, wrap_width, scale);
+    return victim;
+}
+
+// Deux triangles par glyphe ; une commande par ligne
+const FontLayout *Font_Draw(Font *font, RenderList *list, const char *text, int x, int y, int wrap_width,
+                            int scale, SDL_Color color, int visible)
+{
+    const FontLayout *layout = Font_Layout(font, text, wrap_width, scale);
+    if (!layout || !font->atlas || !list)
+        return layout;
+
+    int count = visible < 0 || visible > layout->glyph_count ? layout->glyph_count : visible;
+    float cell = (float)(FONT_GLYPH_SIZE * layout->scale);
+    float line_height = (float)((FONT_GLYPH_SIZE + FONT_LINE_SPACING) * layout->scale);
+    const float du = 1.0f / FONT_ATLAS_COLUMNS, dv = 1.0f / FONT_ATLAS_ROWS;
+
+    for (int first = 0; first < count;)
+    {
+        int last = first;
+        while (last < count && layout->glyphs[last].line == layout->glyphs[first].line)
+            last++;
+
+        SDL_Vertex *vertex = RenderList_Geometry(list, font->atlas, (last - first) * 6);
+        for (int i = first; i < last; i++, vertex += 6)
+        {
+            const FontGlyph *glyph = &layout->glyphs[i];
+            float x0 = x + glyph->column * cell, y0 = y + glyph->line * line_height;
+            float u0 = (glyph->glyph % FONT_ATLAS_COLUMNS) * du, v0 = (glyph->glyph / FONT_ATLAS_COLUMNS) * dv;
+
+            SDL_Vertex tl = {{x0, y0}, color, {u0, v0}};
+            SDL_Vertex tr = {{x0 + cell, y0}, color, {u0 + du, v0}};
+            SDL_Vertex bl = {{x0, y0 + cell}, color, {u0, v0 + dv}};
+            SDL_Vertex br = {{x0 + cell, y0 + cell}, color, {u0 + du, v0 + dv}};
+            vertex[0] = tl;
+            vertex[1] = tr;
+            vertex[2] = br;
+            vertex[3] = tl;
+            vertex[4] = br;
+            vertex[5] = bl;
+        }
+        first = last;
+    }
+    return layout;
+}
@@ -0,0 +1,66 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "renderlist.h"
+
+// Police bitmap 8x8 intégrée (ASCII 32 à 126, lettres accentuées ramenées à
+// leur base). Tous les glyphes sont dans une seule texture et chaque ligne de
+// texte est une seule commande de géométrie. Les mises en page (coupure par
+// mots) sont gardées en cache par chaîne, largeur et échelle : un écran de
+// texte ne recalcule ni n'alloue rien d'une frame à l'autre.
+//
+// Le cache n'est pas protégé : à utiliser pendant l'enregistrement des frames
+// (thread de simulation sous world_lock, ou thread principal sans lui).
+
+#define FONT_GLYPH_SIZE 8
+#define FONT_FIRST_CHAR 32
+#define FONT_CHAR_COUNT 95
+#define FONT_ATLAS_COLUMNS 16
+#define FONT_LINE_SPACING 2     // Pixels entre deux lignes, avant mise à l'échelle
+#define FONT_LAYOUT_CACHE_SIZE 64
+
+typedef struct
+{
+    Uint16 column, line; // En cellules de glyphe
+    Uint8 glyph;         // Indice dans l'atlas
+} FontGlyph;
+
+typedef struct
+{
+    Uint32 hash; // 0 : emplacement libre
+    int wrap_width, scale;
+    char *text;  // Copie, pour départager les collisions
+    size_t text_capacity;
+    FontGlyph *glyphs; // Par ligne puis par colonne : une ligne est contiguë
+    int glyph_count, glyph_capacity;
+    int line_count;
+    int width, height; // En pixels, mise à l'échelle comprise
+    Uint32 last_used;
+} FontLayout;
+
+typedef struct
+{
+    SDL_Texture *atlas; // NULL sans renderer : mise en page seule
+    FontLayout layouts[FONT_LAYOUT_CACHE_SIZE];
+    Uint32 clock;
+} Font;
+
+Font *Font_Create(SDL_Renderer *renderer);
+void Font_Free(Font *font);
+
+// Mise en page de `text`, coupée par mots à `wrap_width` pixels (0 : aux
+// seuls '\n'). Valide jusqu'à ce qu'un autre texte prenne sa place au cache.
+const FontLayout *Font_Layout(Font *font, const char *text, int wrap_width, int scale);
+
+// Nombre de glyphes de `text`, sans mise en page ni police : sert au
+// défilement dans la simulation, y compris en headless
+int Font_CountGlyphs(const char *text);
+
+// Dessine `text` en (x, y). `visible` limite le nombre de caractères
+// affichés (défilement façon machine à écrire), -1 pour tout afficher.
+const FontLayout *Font_Draw(Font *font, RenderList *list, const char *text, int x, int y, int wrap_width,
+                            int scale, SDL_Color color, int visible);
+
+#endif // FONT_H
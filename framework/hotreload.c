@@ -0,0 +1,177 @@
+#include "hotreload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#define HOTRELOAD_MAX_BATCH 32
+
+bool HotReload_SamePath(const char *a, const char *b)
+{
+    if (!a || !b)
+        return false;
+    if (strcmp(a, b) == 0)
+        return true;
+
+    // Les chemins des maps sont relatifs à des dossiers différents : on compare les inodes
+    struct stat sa, sb;
+    return stat(a, &sa) == 0 && stat(b, &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+#ifdef __linux__
+
+HotReload *HotReload_Create(void)
+{
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Rechargement à chaud indisponible (inotify)\n");
+        return NULL;
+    }
+
+    HotReload *hotReload = calloc(1, sizeof(HotReload));
+    if (!hotReload)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    hotReload->fd = fd;
+    return hotReload;
+}
+
+void HotReload_Free(HotReload *hotReload)
+{
+    if (!hotReload)
+        return;
+
+    close(hotReload->fd);
+    free(hotReload->watches);
+    free(hotReload);
+}
+
+bool HotReload_WatchFile(HotReload *hotReload, const char *path)
+{
+    if (!hotReload || !path)
+        return false;
+
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *last_slash = strrchr(dir, '/');
+    if (last_slash)
+        *last_slash = '\0';
+    else
+        strcpy(dir, ".");
+
+    for (int i = 0; i < hotReload->watch_count; i++)
+    {
+        if (HotReload_SamePath(hotReload->watches[i].dir, dir))
+            return true;
+    }
+
+    // Écriture terminée, ou fichier remplacé par renommage
+    int wd = inotify_add_watch(hotReload->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+        return false;
+
+    // inotify renvoie le même descripteur pour un dossier déjà surveillé sous un autre nom
+    for (int i = 0; i < hotReload->watch_count; i++)
+    {
+        if (hotReload->watches[i].wd == wd)
+            return true;
+    }
+
+    HotReloadWatch *watches = realloc(hotReload->watches, (hotReload->watch_count + 1) * sizeof(HotReloadWatch));
+    if (!watches)
+        return false;
+
+    hotReload->watches = watches;
+    hotReload->watches[hotReload->watch_count].wd = wd;
+    snprintf(hotReload->watches[hotReload->watch_count].dir, sizeof(hotReload->watches[0].dir), "%s", dir);
+    hotReload->watch_count++;
+    return true;
+}
+
+static const char *HotReload_FindDir(HotReload *hotReload, int wd)
+{
+    for (int i = 0; i < hotReload->watch_count; i++)
+    {
+        if (hotReload->watches[i].wd == wd)
+            return hotReload->watches[i].dir;
+    }
+    return NULL;
+}
+
+int HotReload_Poll(HotReload *hotReload, HotReloadCallback callback, void *userdata)
+{
+    if (!hotReload)
+        return 0;
+
+    // Une sauvegarde produit plusieurs événements : on regroupe par fichier
+    char changed[HOTRELOAD_MAX_BATCH][1024];
+    int changed_count = 0;
+
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(hotReload->fd, buffer, sizeof(buffer))) > 0)
+    {
+        for (char *ptr = buffer; ptr < buffer + length;)
+        {
+            struct inotify_event *event = (struct inotify_event *)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            const char *dir = HotReload_FindDir(hotReload, event->wd);
+            if (!dir || event->len == 0 || event->name[0] == '.')
+                continue;
+
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", dir, event->name);
+
+            bool duplicate = false;
+            for (int i = 0; i < changed_count && !duplicate; i++)
+                duplicate = strcmp(changed[i], path) == 0;
+            if (!duplicate && changed_count < HOTRELOAD_MAX_BATCH)
+                snprintf(changed[changed_count++], sizeof(changed[0]), "%s", path);
+        }
+    }
+
+    for (int i = 0; i < changed_count; i++)
+    {
+        callback(changed[i], userdata);
+    }
+    return changed_count;
+}
+
+#else
+
+HotReload *HotReload_Create(void)
+{
+    return NULL;
+}
+
+void HotReload_Free(HotReload *hotReload)
+{
+    (void)hotReload;
+}
+
+bool HotReload_WatchFile(HotReload *hotReload, const char *path)
+{
+    (void)hotReload;
+    (void)path;
+    return false;
+}
+
+int HotReload_Poll(HotReload *hotReload, HotReloadCallback callback, void *userdata)
+{
+    (void)hotReload;
+    (void)callback;
+    (void)userdata;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef HOTRELOAD_H
+#define HOTRELOAD_H
+
+#include <stdbool.h>
+
+// Surveillance des fichiers de ressources (inotify) pour le rechargement à
+// chaud. On surveille les dossiers plutôt que les fichiers : les éditeurs
+// (Tiled, GIMP...) remplacent souvent le fichier par un renommage.
+
+typedef void (*HotReloadCallback)(const char *path, void *userdata);
+
+typedef struct
+{
+    int wd;
+    char dir[512];
+} HotReloadWatch;
+
+typedef struct HotReload
+{
+    int fd;
+    HotReloadWatch *watches;
+    int watch_count;
+} HotReload;
+
+// NULL si la plateforme ne le permet pas (le jeu fonctionne alors sans)
+HotReload *HotReload_Create(void);
+void HotReload_Free(HotReload *hotReload);
+
+// Surveille le dossier contenant `path` (sans effet s'il l'est déjà)
+bool HotReload_WatchFile(HotReload *hotReload, const char *path);
+
+// Appelle `callback` une fois par fichier modifié depuis le dernier appel.
+// Non bloquant ; retourne le nombre de fichiers signalés.
+int HotReload_Poll(HotReload *hotReload, HotReloadCallback callback, void *userdata);
+
+// Vrai si les deux chemins désignent le même fichier existant
+bool HotReload_SamePath(const char *a, const char *b);
+
+#endif // HOTRELOAD_H
@@ -0,0 +1,274 @@
+#include "loader.h"
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tmx.h"
+#include "pack.h"
+
+// Exécute le décodage d'une tâche (thread de travail, ou thread principal si threadCount == 0)
+static void Loader_RunJob(LoadJob *job)
+{
+    switch (job->type)
+    {
+    case LOAD_JOB_IMAGE:
+        job->result = Asset_LoadImage(job->path);
+        if (!job->result && job->fallbackPath[0] != '\0')
+            job->result = Asset_LoadImage(job->fallbackPath);
+        if (!job->result)
+            fprintf(stderr, "Erreur de chargement de l'image %s: %s\n", job->path, IMG_GetError());
+        break;
+
+    case LOAD_JOB_TMX:
+        job->result = Asset_LoadTMX(job->path, &job->resources);
+        if (!job->result)
+            fprintf(stderr, "Erreur lors du chargement de la map: %s (libtmx error: %s)\n", job->path, tmx_strerr());
+        break;
+    }
+
+    if (job->result && job->onDecoded)
+        job->onDecoded(job, job->userdata);
+}
+
+// Libère un résultat qui n'a jamais été remis à un callback
+static void Loader_DiscardResult(LoadJob *job)
+{
+    if (!job->result)
+        return;
+
+    if (job->type == LOAD_JOB_IMAGE)
+        SDL_FreeSurface((SDL_Surface *)job->result);
+    else
+        tmx_map_free((tmx_map *)job->result);
+    job->result = NULL;
+
+    if (job->resources)
+        tmx_free_resource_manager((tmx_resource_manager *)job->resources);
+    job->resources = NULL;
+}
+
+static void Loader_PushDone(Loader *loader, LoadJob *job)
+{
+    job->next = NULL;
+    if (loader->doneTail)
+        loader->doneTail->next = job;
+    else
+        loader->doneHead = job;
+    loader->doneTail = job;
+}
+
+static LoadJob *Loader_PopPending(Loader *loader)
+{
+    LoadJob *job = loader->pendingHead;
+    if (job)
+    {
+        loader->pendingHead = job->next;
+        if (!loader->pendingHead)
+            loader->pendingTail = NULL;
+        job->next = NULL;
+    }
+    return job;
+}
+
+static int Loader_WorkerThread(void *data)
+{
+    Loader *loader = (Loader *)data;
+
+    SDL_LockMutex(loader->mutex);
+    while (!loader->quit)
+    {
+        LoadJob *job = Loader_PopPending(loader);
+        if (!job)
+        {
+            SDL_CondWait(loader->cond, loader->mutex);
+            continue;
+        }
+
+        // Décodage hors verrou
+        SDL_UnlockMutex(loader->mutex);
+        Loader_RunJob(job);
+        SDL_LockMutex(loader->mutex);
+
+        Loader_PushDone(loader, job);
+    }
+    SDL_UnlockMutex(loader->mutex);
+
+    return 0;
+}
+
+Loader *Loader_Create(SDL_Renderer *renderer, int threadCount)
+{
+    Loader *loader = calloc(1, sizeof(Loader));
+    if (!loader)
+        return NULL;
+
+    loader->renderer = renderer;
+    loader->mutex = SDL_CreateMutex();
+    loader->cond = SDL_CreateCond();
+    if (!loader->mutex || !loader->cond)
+    {
+        fprintf(stderr, "Erreur de création des primitives du loader: %s\n", SDL_GetError());
+        Loader_Free(loader);
+        return NULL;
+    }
+
+    if (threadCount > 0)
+    {
+        loader->threads = calloc(threadCount, sizeof(SDL_Thread *));
+        if (!loader->threads)
+        {
+            Loader_Free(loader);
+            return NULL;
+        }
+
+        for (int i = 0; i < threadCount; i++)
+        {
+            loader->threads[i] = SDL_CreateThread(Loader_WorkerThread, "AssetLoader", loader);
+            if (!loader->threads[i])
+            {
+                fprintf(stderr, "Impossible de créer le thread de chargement: %s\n", SDL_GetError());
+                break;
+            }
+            loader->threadCount++;
+        }
+    }
+
+    return loader;
+}
+
+void Loader_Free(Loader *loader)
+{
+    if (!loader)
+        return;
+
+    if (loader->mutex)
+    {
+        SDL_LockMutex(loader->mutex);
+        loader->quit = true;
+        SDL_CondBroadcast(loader->cond);
+        SDL_UnlockMutex(loader->mutex);
+    }
+
+    for (int i = 0; i < loader->threadCount; i++)
+    {
+        SDL_WaitThread(loader->threads[i], NULL);
+    }
+    free(loader->threads);
+
+    // Les tâches restantes ne seront jamais livrées
+    LoadJob *job;
+    while ((job = Loader_PopPending(loader)))
+    {
+        free(job);
+    }
+    job = loader->doneHead;
+    while (job)
+    {
+        LoadJob *next = job->next;
+        Loader_DiscardResult(job);
+        free(job);
+        job = next;
+    }
+
+    if (loader->cond)
+        SDL_DestroyCond(loader->cond);
+    if (loader->mutex)
+        SDL_DestroyMutex(loader->mutex);
+    free(loader);
+}
+
+void Loader_Submit(Loader *loader, LoadJobType type, const char *path, const char *fallbackPath,
+                   LoadJobCallback onComplete, void *userdata)
+{
+    Loader_SubmitPrepared(loader, type, path, fallbackPath, NULL, onComplete, userdata);
+}
+
+void Loader_SubmitPrepared(Loader *loader, LoadJobType type, const char *path, const char *fallbackPath,
+                           LoadJobPrepare onDecoded, LoadJobCallback onComplete, void *userdata)
+{
+    LoadJob *job = calloc(1, sizeof(LoadJob));
+    if (!job)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour une tâche de chargement.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    job->type = type;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+    if (fallbackPath)
+        snprintf(job->fallbackPath, sizeof(job->fallbackPath), "%s", fallbackPath);
+    job->onDecoded = onDecoded;
+    job->onComplete = onComplete;
+    job->userdata = userdata;
+
+    SDL_LockMutex(loader->mutex);
+    if (loader->pendingTail)
+        loader->pendingTail->next = job;
+    else
+        loader->pendingHead = job;
+    loader->pendingTail = job;
+    loader->inFlight++;
+    SDL_CondSignal(loader->cond);
+    SDL_UnlockMutex(loader->mutex);
+}
+
+int Loader_Pump(Loader *loader, Uint32 budgetMs)
+{
+    if (!loader)
+        return 0;
+
+    Uint32 start = SDL_GetTicks();
+    int processed = 0;
+
+    while (budgetMs == 0 || SDL_GetTicks() - start < budgetMs)
+    {
+        SDL_LockMutex(loader->mutex);
+        LoadJob *job = loader->doneHead;
+        if (job)
+        {
+            loader->doneHead = job->next;
+            if (!loader->doneHead)
+                loader->doneTail = NULL;
+        }
+        else if (loader->threadCount == 0)
+        {
+            // Mode synchrone : on décode nous-mêmes
+            job = Loader_PopPending(loader);
+            if (job)
+            {
+                SDL_UnlockMutex(loader->mutex);
+                Loader_RunJob(job);
+                SDL_LockMutex(loader->mutex);
+            }
+        }
+        SDL_UnlockMutex(loader->mutex);
+
+        if (!job)
+            break;
+
+        // Le callback peut soumettre de nouvelles tâches (ex : tilesets après le TMX)
+        if (job->onComplete)
+            job->onComplete(job, loader->renderer, job->userdata);
+        else
+            Loader_DiscardResult(job);
+        free(job);
+        processed++;
+
+        SDL_LockMutex(loader->mutex);
+        loader->inFlight--;
+        SDL_UnlockMutex(loader->mutex);
+    }
+
+    return processed;
+}
+
+bool Loader_IsIdle(Loader *loader)
+{
+    if (!loader)
+        return true;
+
+    SDL_LockMutex(loader->mutex);
+    bool idle = loader->inFlight == 0;
+    SDL_UnlockMutex(loader->mutex);
+    return idle;
+}
@@ -0,0 +1,63 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+// Chargement d'assets en arrière-plan : les threads de travail décodent
+// (PNG -> SDL_Surface, TMX -> tmx_map) et le thread principal vide la file
+// des résultats sous un budget de temps par frame pour créer les textures.
+
+typedef enum
+{
+    LOAD_JOB_IMAGE, // result : SDL_Surface *
+    LOAD_JOB_TMX    // result : tmx_map *
+} LoadJobType;
+
+struct LoadJob;
+typedef void (*LoadJobCallback)(struct LoadJob *job, SDL_Renderer *renderer, void *userdata);
+typedef void (*LoadJobPrepare)(struct LoadJob *job, void *userdata);
+
+typedef struct LoadJob
+{
+    LoadJobType type;
+    char path[512];
+    char fallbackPath[512];     // Essayé si path échoue (peut être vide)
+    void *result;               // Propriété transférée au callback (NULL en cas d'échec)
+    void *resources;            // TMX lu depuis l'archive : tmx_resource_manager à garder avec la map
+    LoadJobPrepare onDecoded;   // Optionnel : appelé sur le thread de travail si le décodage a réussi
+    LoadJobCallback onComplete; // Appelé sur le thread principal
+    void *userdata;
+    struct LoadJob *next;
+} LoadJob;
+
+typedef struct Loader
+{
+    SDL_Renderer *renderer;
+    bool headless; // Sans renderer mais avec PNJ : simulation seule (les textures restent NULL)
+    SDL_Thread **threads;
+    int threadCount; // 0 : les tâches sont exécutées par Loader_Pump
+
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    LoadJob *pendingHead, *pendingTail;
+    LoadJob *doneHead, *doneTail;
+    int inFlight; // Tâches soumises dont le callback n'a pas encore été appelé
+    bool quit;
+} Loader;
+
+Loader *Loader_Create(SDL_Renderer *renderer, int threadCount);
+void Loader_Free(Loader *loader);
+
+void Loader_Submit(Loader *loader, LoadJobType type, const char *path, const char *fallbackPath,
+                   LoadJobCallback onComplete, void *userdata);
+// Comme Loader_Submit, avec un traitement du résultat fait hors du thread principal
+void Loader_SubmitPrepared(Loader *loader, LoadJobType type, const char *path, const char *fallbackPath,
+                           LoadJobPrepare onDecoded, LoadJobCallback onComplete, void *userdata);
+
+// Appelle les callbacks des tâches terminées jusqu'à épuisement du budget
+// (0 = pas de limite). Retourne le nombre de tâches traitées.
+int Loader_Pump(Loader *loader, Uint32 budgetMs);
+bool Loader_IsIdle(Loader *loader);
+
+#endif // LOADER_H
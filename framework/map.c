@@ -1,12 +1,20 @@
 #include "map.h"
+#include "pack.h"
+#include "hotreload.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h> // Ajout explicite ici aussi, bien que map.h l'inclue
+#include <zlib.h>
 
-static int Map_LoadTilesets(Map *map, SDL_Renderer *renderer);
+static bool Map_LoadTMXData(Map *map, MapChunksBuilder *layer_chunks, int layer_chunk_count);
+static void Map_PrepareTMXLayers(LoadJob *job, void *userdata);
+static void Map_SubmitTilesets(MapLoadTask *task);
 static void Map_LoadCollisions(Map *map);
-static void Map_RenderTileLayer(Map *map, SDL_Renderer *renderer, tmx_layer *layer);
+static void Map_LoadTriggers(Map *map);
+static void Map_LoadEncounterZones(Map *map);
+static void Map_RenderTileLayer(Map *map, RenderList *list, MapLayer *layer);
 static tmx_object *tmx_find_object_by_name(tmx_object_group *objgr, const char *name);
 static void Map_DefaultSpawn(Map *map);
 
@@ -97,266 +105,1390 @@ static void Map_SetDefaultSpawn(Map *map)
     // printf("Spawn position: (%.2f, %.2f)\n", map->spawn_x, map->spawn_y);
 }
 
+// --- Chargement asynchrone ---
+
+typedef enum
+{
+    MAP_LOAD_PARSING,   // Le TMX est en cours d'analyse sur un thread de travail
+    MAP_LOAD_RESOURCES, // Les images (tilesets, feuilles des PNJ) sont en cours de décodage
+    MAP_LOAD_DONE,
+    MAP_LOAD_FAILED
+} MapLoadStage;
+
+// Contexte d'une tâche d'image : index de tileset, ou index de PNJ au-delà de tileset_count
+typedef struct
+{
+    struct MapLoadTask *task;
+    int index;
+} MapLoadJobContext;
+
+struct MapLoadTask
+{
+    Map *map;
+    Loader *loader;
+    MapLoadStage stage;
+    MapLoadJobContext *contexts;
+    int jobsSubmitted;
+    int jobsDone;
+    MapChunksBuilder *layer_chunks; // Un par calque de tuiles, remplis par le thread de travail
+    int layer_chunk_count;
+};
+
+static void Map_OnTilesetDecoded(LoadJob *job, SDL_Renderer *renderer, void *userdata)
+{
+    MapLoadJobContext *ctx = (MapLoadJobContext *)userdata;
+    SDL_Surface *surface = (SDL_Surface *)job->result;
+
+    if (surface)
+    {
+        ctx->task->map->tileset_textures[ctx->index] = Mem_CreateTextureFromSurface(MEM_TAG_MAP, renderer, surface);
+        SDL_FreeSurface(surface);
+    }
+    ctx->task->jobsDone++;
+}
+
+static void Map_OnNPCSpriteDecoded(LoadJob *job, SDL_Renderer *renderer, void *userdata)
+{
+    MapLoadJobContext *ctx = (MapLoadJobContext *)userdata;
+    SDL_Surface *surface = (SDL_Surface *)job->result;
+    PNJ_init *pnj = ctx->task->map->pnj_list[ctx->index - ctx->task->map->tileset_count];
+
+    if (surface)
+    {
+        Map *map = ctx->task->map;
+        AnimationSet *set = NPC_PreloadAnimationSet(renderer, pnj->sprite_path, surface, pnj->width, pnj->height);
+        if (set)
+            map->npc_sets[map->npc_set_count++] = set;
+        SDL_FreeSurface(surface);
+    }
+    ctx->task->jobsDone++;
+}
+
+// Soumet le décodage des feuilles de PNJ qui ne sont pas encore dans le registre
+static void Map_SubmitNPCSprites(MapLoadTask *task)
+{
+    Map *map = task->map;
+    if (!task->loader->renderer && !task->loader->headless)
+        return;
+
+    // Au plus une référence par PNJ
+    map->npc_sets = Arena_Calloc(&map->arena, map->pnj_count + 1, sizeof(AnimationSet *));
+    if (!map->npc_sets)
+        return;
+
+    for (int i = 0; i < map->pnj_count; i++)
+    {
+        PNJ_init *pnj = map->pnj_list[i];
+        if (!pnj || !pnj->sprite_path)
+            continue;
+
+        char key[256];
+        AnimSet_MakeKey(key, sizeof(key), pnj->sprite_path, pnj->width, pnj->height);
+        AnimationSet *set = AnimSet_Get(key);
+        if (set && set->animationCount > 0)
+        {
+            // Déjà construit : la map le garde aussi jusqu'à la création de ses PNJ
+            AnimSet_Retain(set);
+            map->npc_sets[map->npc_set_count++] = set;
+            continue;
+        }
+
+        // Une seule tâche par feuille, même si plusieurs PNJ l'utilisent
+        bool alreadySubmitted = false;
+        for (int j = 0; j < i && !alreadySubmitted; j++)
+        {
+            PNJ_init *other = map->pnj_list[j];
+            alreadySubmitted = other && other->sprite_path && strcmp(other->sprite_path, pnj->sprite_path) == 0 &&
+                               other->width == pnj->width && other->height == pnj->height;
+        }
+        if (alreadySubmitted)
+            continue;
+
+        MapLoadJobContext *ctx = &task->contexts[map->tileset_count + i];
+        ctx->task = task;
+        ctx->index = map->tileset_count + i;
+        task->jobsSubmitted++;
+        Loader_Submit(task->loader, LOAD_JOB_IMAGE, pnj->sprite_path, NULL, Map_OnNPCSpriteDecoded, ctx);
+    }
+}
+
+// Soumet le décodage de toutes les images nécessaires à la map (tilesets puis PNJ)
+static bool Map_SubmitResources(MapLoadTask *task)
+{
+    Map *map = task->map;
+
+    task->contexts = Mem_Calloc(MEM_TAG_MAP, map->tileset_count + map->pnj_count + 1, sizeof(MapLoadJobContext));
+    if (!task->contexts)
+        return false;
+
+    Map_SubmitTilesets(task);
+    Map_SubmitNPCSprites(task);
+    task->stage = MAP_LOAD_RESOURCES;
+    return true;
+}
+
+static void Map_OnTMXParsed(LoadJob *job, SDL_Renderer *renderer, void *userdata)
+{
+    MapLoadTask *task = (MapLoadTask *)userdata;
+    Map *map = task->map;
+    (void)renderer;
+
+    map->tmx_map = (tmx_map *)job->result;
+    map->tmx_resources = job->resources;
+    job->resources = NULL;
+    if (!map->tmx_map || !Map_LoadTMXData(map, task->layer_chunks, task->layer_chunk_count) || !Map_SubmitResources(task))
+    {
+        task->stage = MAP_LOAD_FAILED;
+    }
+}
+
+MapLoadTask *Map_LoadAsync(const char *filename, Loader *loader)
+{
+    MapLoadTask *task = Mem_Calloc(MEM_TAG_MAP, 1, sizeof(MapLoadTask));
+    if (!task)
+        return NULL;
+
+    Map *map = Mem_Alloc(MEM_TAG_MAP, sizeof(Map));
+    if (!map)
+    {
+        Mem_Free(task);
+        return NULL;
+    }
+
+    // Initialisation
+    memset(map, 0, sizeof(Map));
+    Arena_Init(&map->arena, MAP_ARENA_BLOCK_SIZE, MEM_TAG_MAP);
+    map->filename = Arena_Strdup(&map->arena, filename);
+
+    task->map = map;
+    task->loader = loader;
+    task->stage = MAP_LOAD_PARSING;
+
+    if (Map_IsCookedPath(filename))
+    {
+        // Map cuite : projetée en mémoire et utilisée en place, aucune analyse
+        if (!Map_LoadCooked(map, filename) || !Map_SubmitResources(task))
+            task->stage = MAP_LOAD_FAILED;
+    }
+    else
+    {
+        // Analyse du TMX et construction des blocs de tuiles sur un thread de travail
+        Loader_SubmitPrepared(loader, LOAD_JOB_TMX, filename, NULL, Map_PrepareTMXLayers, Map_OnTMXParsed, task);
+    }
+
+    return task;
+}
+
+bool Map_LoadTask_Update(MapLoadTask *task)
+{
+    if (task->stage == MAP_LOAD_RESOURCES && task->jobsDone == task->jobsSubmitted)
+    {
+        Map *map = task->map;
+
+        if (!Map_BuildDerivedData(map))
+        {
+            task->stage = MAP_LOAD_FAILED;
+            return true;
+        }
+
+        // Création des PNJ (leurs ensembles d'animations sont déjà construits)
+        if (task->loader->renderer || task->loader->headless)
+            Map_CreateNPC(map, task->loader->renderer);
+
+        task->stage = MAP_LOAD_DONE;
+    }
+
+    return task->stage == MAP_LOAD_DONE || task->stage == MAP_LOAD_FAILED;
+}
+
+float Map_LoadTask_Progress(const MapLoadTask *task)
+{
+    switch (task->stage)
+    {
+    case MAP_LOAD_PARSING:
+        return 0.0f;
+    case MAP_LOAD_RESOURCES:
+        // Le TMX compte pour 10%, les images pour le reste
+        return task->jobsSubmitted == 0 ? 0.9f : 0.1f + 0.8f * (float)task->jobsDone / (float)task->jobsSubmitted;
+    default:
+        return 1.0f;
+    }
+}
+
+// Libère la tâche et retourne la map chargée (NULL en cas d'échec).
+// Ne doit être appelée qu'une fois Map_LoadTask_Update terminé, ou après Loader_Free.
+Map *Map_LoadTask_Finish(MapLoadTask *task)
+{
+    if (!task)
+        return NULL;
+
+    Map *map = task->map;
+    if (task->stage != MAP_LOAD_DONE)
+    {
+        printf("Erreur lors du chargement de la map: %s\n", map->filename);
+        Map_Free(map);
+        map = NULL;
+    }
+    else if (map->arena.block_count > 1)
+    {
+        printf("Arène de %s : %zu octets en %d blocs (blocs de %zu)\n", map->filename,
+               map->arena.peak, map->arena.block_count, map->arena.block_size);
+    }
+
+    // Blocs non remis à la map (échec ou tâche abandonnée)
+    for (int i = 0; i < task->layer_chunk_count; i++)
+        MapChunks_Discard(&task->layer_chunks[i]);
+    Mem_Free(task->layer_chunks);
+    Mem_Free(task->contexts);
+    Mem_Free(task);
+    return map;
+}
+
 Map *Map_Load(const char *filename, SDL_Renderer *renderer)
 {
-    Map *map = malloc(sizeof(Map));
+    // Chargement bloquant : loader sans thread, vidé sans budget
+    Loader *loader = Loader_Create(renderer, 0);
+    if (!loader)
+        return NULL;
+
+    MapLoadTask *task = Map_LoadAsync(filename, loader);
+    while (task && !Map_LoadTask_Update(task))
+    {
+        if (Loader_Pump(loader, 0) == 0 && task->jobsDone != task->jobsSubmitted)
+            break;
+    }
+
+    Map *map = Map_LoadTask_Finish(task);
+    Loader_Free(loader);
+
+    // printf("Map chargée avec succès: %s\n", filename);
+    // Map_DEBUG(map);
+
+    return map;
+}
+
+// Plus gros pic d'arène observé, pour ajuster MAP_ARENA_BLOCK_SIZE
+static size_t map_arena_peak = 0;
+
+size_t Map_GetArenaPeak(void)
+{
+    return map_arena_peak;
+}
+
+void Map_Free(Map *map)
+{
     if (!map)
+        return;
+
+    // Libération des textures de tilesets
+    for (int i = 0; map->tileset_textures && i < map->tileset_count; i++)
+    {
+        if (map->tileset_textures[i])
+        {
+            Mem_DestroyTexture(MEM_TAG_MAP, map->tileset_textures[i]);
+        }
+    }
+
+    for (int i = 0; i < map->npc_count; i++)
+    {
+        NPC_Free(map->npc[i]);
+    }
+    Mem_Free(map->npc);
+    Mem_Free(map->npc_source);
+
+    // Après les PNJ : un ensemble qui n'est plus utilisé est alors détruit
+    for (int i = 0; i < map->npc_set_count; i++)
+    {
+        AnimSet_Release(map->npc_sets[i]);
+    }
+
+    // Libération de la map TMX ou de la projection de la map cuite
+    if (map->tmx_map)
+    {
+        tmx_map_free(map->tmx_map);
+    }
+    if (map->tmx_resources)
+    {
+        tmx_free_resource_manager((tmx_resource_manager *)map->tmx_resources);
+    }
+    Map_FreeCooked(map);
+
+    // Tout le reste (tables, chaînes, PNJ_init) vient de l'arène
+    if (map->arena.peak > map_arena_peak)
+        map_arena_peak = map->arena.peak;
+    Arena_Release(&map->arena);
+    Mem_Free(map);
+}
+
+// --- Rechargement à chaud ---
+
+static SDL_Texture *Map_LoadTilesetTexture(SDL_Renderer *renderer, const MapTileset *tileset)
+{
+    SDL_Surface *surface = Asset_LoadImage(tileset->image);
+    if (!surface && tileset->image_fallback)
+        surface = Asset_LoadImage(tileset->image_fallback);
+    if (!surface)
+    {
+        printf("Erreur de rechargement du tileset %s: %s\n", tileset->image, IMG_GetError());
         return NULL;
+    }
+
+    SDL_Texture *texture = Mem_CreateTextureFromSurface(MEM_TAG_MAP, renderer, surface);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+static bool Map_SameString(const char *a, const char *b)
+{
+    return (!a && !b) || (a && b && strcmp(a, b) == 0);
+}
+
+// Même liste de PNJ (noms et feuilles) : les PNJ vivants peuvent être conservés
+static bool Map_SamePNJ(const Map *a, const Map *b)
+{
+    if (a->pnj_count != b->pnj_count)
+        return false;
+
+    for (int i = 0; i < a->pnj_count; i++)
+    {
+        const PNJ_init *pa = a->pnj_list[i], *pb = b->pnj_list[i];
+        if (!pa || !pb)
+        {
+            if (pa != pb)
+                return false;
+            continue;
+        }
+        if (!Map_SameString(pa->Name, pb->Name) || !Map_SameString(pa->sprite_path, pb->sprite_path))
+            return false;
+    }
+    return true;
+}
+
+// Recharge les données de la map (calques, collisions, tiles animées, passages)
+// depuis `filename`. Seules les images de tilesets nouvelles sont décodées, et les
+// PNJ gardent leur état si la liste des PNJ n'a pas changé. En cas d'erreur,
+// la map reste dans son état précédent.
+bool Map_Reload(Map *map, const char *filename, SDL_Renderer *renderer)
+{
+    // Données seules : sans renderer, ni textures ni PNJ
+    Map *fresh = Map_Load(filename, NULL);
+    if (!fresh)
+    {
+        printf("Rechargement de %s impossible, la map actuelle est conservée\n", filename);
+        return false;
+    }
+
+    for (int i = 0; i < fresh->tileset_count; i++)
+    {
+        const MapTileset *tileset = &fresh->tilesets[i];
+        if (!tileset->image)
+            continue;
+
+        // Texture reprise de l'ancienne map si l'image est la même
+        for (int j = 0; j < map->tileset_count && !fresh->tileset_textures[i]; j++)
+        {
+            if (map->tileset_textures[j] && Map_SameString(map->tilesets[j].image, tileset->image))
+            {
+                fresh->tileset_textures[i] = map->tileset_textures[j];
+                map->tileset_textures[j] = NULL;
+            }
+        }
+
+        if (!fresh->tileset_textures[i] && renderer)
+            fresh->tileset_textures[i] = Map_LoadTilesetTexture(renderer, tileset);
+    }
+
+    if (Map_SamePNJ(map, fresh))
+    {
+        fresh->npc = map->npc;
+        fresh->npc_source = map->npc_source;
+        fresh->npc_count = map->npc_count;
+        map->npc = NULL;
+        map->npc_source = NULL;
+        map->npc_count = 0;
+    }
+    else if (renderer)
+    {
+        printf("La liste des PNJ de %s a changé, ils sont recréés\n", filename);
+        Map_CreateNPC(fresh, renderer);
+    }
+
+    fresh->map_visited = map->map_visited;
+    fresh->in_world = map->in_world;
+    fresh->neighbour_count = map->neighbour_count;
+    memcpy(fresh->neighbours, map->neighbours, sizeof(fresh->neighbours));
+
+    // Échange des contenus : les pointeurs vers la map restent valides
+    Map old = *map;
+    *map = *fresh;
+    *fresh = old;
+    Map_Free(fresh);
+
+    return true;
+}
+
+// Recrée la texture des tilesets qui utilisent cette image
+int Map_ReloadTilesetImage(Map *map, SDL_Renderer *renderer, const char *imagePath)
+{
+    int reloaded = 0;
+    if (!map || !renderer)
+        return 0;
+
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        const MapTileset *tileset = &map->tilesets[i];
+        if (!tileset->image ||
+            (!HotReload_SamePath(tileset->image, imagePath) && !HotReload_SamePath(tileset->image_fallback, imagePath)))
+            continue;
+
+        SDL_Texture *texture = Map_LoadTilesetTexture(renderer, tileset);
+        if (texture)
+        {
+            Mem_DestroyTexture(MEM_TAG_MAP, map->tileset_textures[i]);
+            map->tileset_textures[i] = texture;
+            reloaded++;
+        }
+    }
+    return reloaded;
+}
+
+// Vrai si la map a été chargée depuis ce fichier ou utilise ce TSX externe
+bool Map_UsesFile(Map *map, const char *path)
+{
+    if (!map || !path)
+        return false;
+    if (HotReload_SamePath(map->filename, path))
+        return true;
+    if (!map->tmx_map)
+        return false;
+
+    char tsx_path[1024];
+    const char *last_slash = strrchr(map->filename, '/');
+    int dir_len = last_slash ? (int)(last_slash - map->filename) + 1 : 0;
+
+    for (tmx_tileset_list *ts = map->tmx_map->ts_head; ts; ts = ts->next)
+    {
+        if (!ts->source)
+            continue;
+
+        snprintf(tsx_path, sizeof(tsx_path), "%.*s%s", dir_len, map->filename, ts->source);
+        if (HotReload_SamePath(tsx_path, path))
+            return true;
+    }
+    return false;
+}
+
+void Map_Update(Map *map, float deltaTime)
+{
+    if (!map)
+        return;
+
+    // Mise à jour des tiles animées avec deltaTime
+    for (int i = 0; i < map->animated_tile_count; i++)
+    {
+        AnimatedTile *tile = &map->animated_tiles[i];
+
+        tile->last_update += deltaTime * 1000.0f;
+
+        if (tile->last_update >= tile->frame_duration)
+        {
+            tile->current_frame = (tile->current_frame + 1) % tile->frame_count;
+            tile->last_update = 0;
+        }
+    }
+}
+
+MapLayer *Map_FindLayer(Map *map, const char *layer_name)
+{
+    for (int i = 0; i < map->layer_count; i++)
+    {
+        if (strcmp(map->layers[i].name, layer_name) == 0)
+        {
+            return &map->layers[i];
+        }
+    }
+    return NULL;
+}
+
+void Map_RenderLayer(Map *map, RenderList *list, const char *layer_name)
+{
+    if (!map || !layer_name)
+        return;
+
+    MapLayer *layer = Map_FindLayer(map, layer_name);
+    if (!layer)
+    {
+        printf("Layer '%s' introuvable\n", layer_name);
+        return;
+    }
+
+    Map_RenderTileLayer(map, list, layer);
+}
+
+void Map_RenderAllLayers(Map *map, RenderList *list)
+{
+    if (!map)
+        return;
+
+    for (int i = 0; i < map->layer_count; i++)
+    {
+        if (map->layers[i].visible)
+        {
+            Map_RenderTileLayer(map, list, &map->layers[i]);
+        }
+    }
+}
+
+static int Map_CheckLocalCollision(const Map *map, const SDL_Rect *rect)
+{
+    for (int i = 0; i < map->collision_count; i++)
+    {
+        if (SDL_HasIntersection(rect, &map->collisions[i].rect))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Voisine qui contient le point (coordonnées de `map`), NULL sinon
+static const MapNeighbour *Map_NeighbourAt(const Map *map, int x, int y)
+{
+    for (int i = 0; i < map->neighbour_count; i++)
+    {
+        const MapNeighbour *neighbour = &map->neighbours[i];
+        int local_x = x - neighbour->dx, local_y = y - neighbour->dy;
+        if (local_x >= 0 && local_y >= 0 && local_x < neighbour->map->width * neighbour->map->tile_width &&
+            local_y < neighbour->map->height * neighbour->map->tile_height)
+            return neighbour;
+    }
+    return NULL;
+}
+
+// Partie du rectangle hors de la map : les coins doivent être sur des
+// voisines chargées (sinon bord du monde, ou voisine pas encore prête), dont
+// les collisions comptent aussi
+static int Map_CheckBorders(const Map *map, const SDL_Rect *rect)
+{
+    int width = map->width * map->tile_width, height = map->height * map->tile_height;
+    if (rect->x >= 0 && rect->y >= 0 && rect->x + rect->w <= width && rect->y + rect->h <= height)
+        return 0;
+
+    const int corners[4][2] = {{rect->x, rect->y},
+                               {rect->x + rect->w - 1, rect->y},
+                               {rect->x, rect->y + rect->h - 1},
+                               {rect->x + rect->w - 1, rect->y + rect->h - 1}};
+    for (int c = 0; c < 4; c++)
+    {
+        int x = corners[c][0], y = corners[c][1];
+        if ((x < 0 || y < 0 || x >= width || y >= height) && !Map_NeighbourAt(map, x, y))
+            return 1;
+    }
+
+    for (int i = 0; i < map->neighbour_count; i++)
+    {
+        SDL_Rect local = {rect->x - map->neighbours[i].dx, rect->y - map->neighbours[i].dy, rect->w, rect->h};
+        if (Map_CheckLocalCollision(map->neighbours[i].map, &local))
+            return 1;
+    }
+    return 0;
+}
+
+int Map_CheckCollision(Map *map, SDL_Rect *rect)
+{
+    if (!map || !rect)
+        return 0;
+
+    if (Map_CheckLocalCollision(map, rect))
+        return 1;
+    return map->in_world ? Map_CheckBorders(map, rect) : 0;
+}
+
+// Case de l'index contenant la coordonnée, ramenée dans la grille
+static int Map_TriggerCell(int coord, int cells)
+{
+    int cell = coord < 0 ? 0 : coord / MAP_TRIGGER_CELL_SIZE;
+    return cell < cells ? cell : cells - 1;
+}
+
+// Seules les zones des cases couvertes par le rectangle sont testées
+int Map_QueryTriggers(const Map *map, const SDL_Rect *rect, Uint16 *out, int max, bool *truncated)
+{
+    if (truncated)
+        *truncated = false;
+    if (!map || !rect || !map->trigger_cell_start || rect->w <= 0 || rect->h <= 0 || max <= 0)
+        return 0;
+
+    int x0 = Map_TriggerCell(rect->x, map->trigger_cols);
+    int y0 = Map_TriggerCell(rect->y, map->trigger_rows);
+    int x1 = Map_TriggerCell(rect->x + rect->w - 1, map->trigger_cols);
+    int y1 = Map_TriggerCell(rect->y + rect->h - 1, map->trigger_rows);
+
+    int count = 0;
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            int cell = y * map->trigger_cols + x;
+            for (Uint32 i = map->trigger_cell_start[cell]; i < map->trigger_cell_start[cell + 1]; i++)
+            {
+                Uint16 id = map->trigger_cell_items[i];
+                if (!SDL_HasIntersection(rect, &map->triggers[id].rect))
+                    continue;
+
+                // Insertion triée ; une zone sur plusieurs cases n'est gardée qu'une fois
+                int pos = count;
+                while (pos > 0 && out[pos - 1] > id)
+                    pos--;
+                if (pos > 0 && out[pos - 1] == id)
+                    continue;
+                if (count == max)
+                {
+                    if (truncated)
+                        *truncated = true;
+                    if (pos == count)
+                        continue;
+                    count--; // Plein : l'indice le plus grand cède sa place
+                }
+                memmove(&out[pos + 1], &out[pos], (count - pos) * sizeof(Uint16));
+                out[pos] = id;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static const char *const trigger_type_names[MAP_TRIGGER_TYPE_COUNT] = {"warp", "sign", "cutscene", "encounter"};
+
+const char *Map_TriggerTypeName(MapTriggerType type)
+{
+    return type >= 0 && type < MAP_TRIGGER_TYPE_COUNT ? trigger_type_names[type] : "?";
+}
+
+// Une lecture dans la grille : appelée à chaque pas du joueur
+int Map_GetEncounterZone(const Map *map, int tile_x, int tile_y)
+{
+    if (!map || !map->encounter_grid || tile_x < 0 || tile_y < 0 || tile_x >= map->width || tile_y >= map->height)
+        return -1;
+    int zone = (int)map->encounter_grid[tile_y * map->width + tile_x] - 1;
+    return zone < map->encounter_zone_count ? zone : -1;
+}
+
+void Map_GetSpawnPosition(Map *map, float *x, float *y)
+{
+    if (!map || !x || !y)
+        return;
+    *x = map->spawn_x;
+    *y = map->spawn_y;
+}
+
+// Fonctions internes
+
+// --- Calques en blocs (maps infinies) ---
+// libtmx ne remplit que les grilles denses : les balises <chunk> sont lues
+// directement dans le XML, comme les tilesets de l'archive (pack.c).
+// Encodages csv et base64, brut ou compressé zlib/gzip.
+
+// Valeur d'un attribut dans la balise [tag, tag_end) ; faux si absent
+static bool Map_XmlAttribute(const char *tag, const char *tag_end, const char *name, char *out, size_t size)
+{
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), " %s=\"", name);
+    const char *value = strstr(tag, pattern);
+    if (!value || value > tag_end)
+        return false;
+
+    value += strlen(pattern);
+    const char *quote = strchr(value, '"');
+    if (!quote || quote > tag_end)
+        return false;
+
+    snprintf(out, size, "%.*s", (int)(quote - value), value);
+    return true;
+}
+
+static int Map_XmlIntAttribute(const char *tag, const char *tag_end, const char *name, int fallback)
+{
+    char value[32];
+    return Map_XmlAttribute(tag, tag_end, name, value, sizeof(value)) ? atoi(value) : fallback;
+}
+
+static int Map_Base64Value(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 26;
+    if (c >= '0' && c <= '9')
+        return c - '0' + 52;
+    if (c == '+')
+        return 62;
+    if (c == '/')
+        return 63;
+    return -1;
+}
+
+// Décode [text, end) dans `out` (blancs ignorés) ; renvoie le nombre d'octets
+static size_t Map_Base64Decode(const char *text, const char *end, Uint8 *out)
+{
+    size_t size = 0;
+    Uint32 bits = 0;
+    int bit_count = 0;
+    for (; text < end && *text != '='; text++)
+    {
+        int value = Map_Base64Value(*text);
+        if (value < 0)
+            continue;
+        bits = (bits << 6) | (Uint32)value;
+        bit_count += 6;
+        if (bit_count >= 8)
+        {
+            bit_count -= 8;
+            out[size++] = (Uint8)(bits >> bit_count);
+        }
+    }
+    return size;
+}
+
+// GID d'un bloc de `count` tuiles, contenu texte [text, end) de la balise
+static bool Map_DecodeChunk(const char *text, const char *end, const char *encoding, const char *compression,
+                            Uint32 *gids, int count)
+{
+    if (strcmp(encoding, "csv") == 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            while (text < end && (*text == ',' || isspace((unsigned char)*text)))
+                text++;
+            char *next;
+            gids[i] = (Uint32)strtoul(text, &next, 10);
+            if (next == text || next > end)
+                return false;
+            text = next;
+        }
+        return true;
+    }
+
+    if (strcmp(encoding, "base64") != 0)
+        return false;
+
+    size_t expected = (size_t)count * sizeof(Uint32);
+    Uint8 *raw = Mem_Alloc(MEM_TAG_MAP, (size_t)(end - text) * 3 / 4 + 4);
+    if (!raw)
+        return false;
+    size_t raw_size = Map_Base64Decode(text, end, raw);
+
+    bool ok;
+    if (compression[0] == '\0')
+    {
+        ok = raw_size == expected;
+        if (ok)
+            memcpy(gids, raw, expected);
+    }
+    else if (strcmp(compression, "zlib") == 0 || strcmp(compression, "gzip") == 0)
+    {
+        // 15 + 32 : en-tête zlib ou gzip détecté par zlib
+        z_stream stream = {0};
+        stream.next_in = raw;
+        stream.avail_in = (uInt)raw_size;
+        stream.next_out = (Bytef *)gids;
+        stream.avail_out = (uInt)expected;
+        ok = inflateInit2(&stream, 15 + 32) == Z_OK;
+        ok = ok && inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == expected;
+        inflateEnd(&stream);
+    }
+    else
+    {
+        ok = false; // zstd : non pris en charge
+    }
+    Mem_Free(raw);
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    for (int i = 0; ok && i < count; i++)
+        gids[i] = SDL_SwapLE32(gids[i]);
+#endif
+    return ok;
+}
+
+// Côté maximal d'un bloc de TMX infini (Tiled écrit des blocs de 16 par défaut)
+#define MAP_TMX_MAX_CHUNK_SIDE 256
+
+// Blocs du calque d'identifiant `layer_id` du TMX `xml` (l'identifiant est
+// unique, le nom ne l'est pas) ; faux si le calque ou ses données sont illisibles
+static bool Map_ReadLayerChunks(const char *xml, int layer_id, MapChunksBuilder *builder)
+{
+    const char *tag = xml;
+    const char *tag_end = NULL;
+    while ((tag = strstr(tag, "<layer ")))
+    {
+        tag_end = strchr(tag, '>');
+        if (!tag_end)
+            return false;
+        if (Map_XmlIntAttribute(tag, tag_end, "id", -1) == layer_id)
+            break;
+        tag = tag_end;
+    }
+    if (!tag)
+        return false;
+
+    const char *data = strstr(tag_end, "<data");
+    const char *data_end = data ? strstr(data, "</data>") : NULL;
+    const char *data_tag_end = data ? strchr(data, '>') : NULL;
+    if (!data_end || !data_tag_end)
+        return false;
+
+    char encoding[16] = "", compression[16] = "";
+    Map_XmlAttribute(data, data_tag_end, "encoding", encoding, sizeof(encoding));
+    Map_XmlAttribute(data, data_tag_end, "compression", compression, sizeof(compression));
+
+    Uint32 *gids = NULL;
+    int gids_capacity = 0;
+    bool ok = true;
+    for (const char *chunk = strstr(data_tag_end, "<chunk"); ok && chunk && chunk < data_end;
+         chunk = strstr(chunk + 1, "<chunk"))
+    {
+        const char *chunk_tag_end = strchr(chunk, '>');
+        const char *chunk_end = chunk_tag_end ? strstr(chunk_tag_end, "</chunk>") : NULL;
+        int x = Map_XmlIntAttribute(chunk, chunk_tag_end, "x", 0);
+        int y = Map_XmlIntAttribute(chunk, chunk_tag_end, "y", 0);
+        int width = Map_XmlIntAttribute(chunk, chunk_tag_end, "width", 0);
+        int height = Map_XmlIntAttribute(chunk, chunk_tag_end, "height", 0);
+        // Valeurs du fichier : bornées avant tout produit ou indice
+        if (!chunk_end || width <= 0 || height <= 0 || width > MAP_TMX_MAX_CHUNK_SIDE ||
+            height > MAP_TMX_MAX_CHUNK_SIDE || x < -MAP_MAX_SIDE || x > MAP_MAX_SIDE - width ||
+            y < -MAP_MAX_SIDE || y > MAP_MAX_SIDE - height)
+        {
+            ok = false;
+            break;
+        }
+
+        if (width * height > gids_capacity)
+        {
+            gids_capacity = width * height;
+            Uint32 *grown = Mem_Realloc(MEM_TAG_MAP, gids, (size_t)gids_capacity * sizeof(Uint32));
+            if (!grown)
+            {
+                fprintf(stderr, "Erreur d'allocation mémoire pour les blocs de tuiles.\n");
+                exit(EXIT_FAILURE);
+            }
+            gids = grown;
+        }
+
+        ok = Map_DecodeChunk(chunk_tag_end + 1, chunk_end, encoding, compression, gids, width * height);
+        if (ok)
+            MapChunks_PutGrid(builder, x, y, width, height, gids);
+    }
+    Mem_Free(gids);
+    return ok;
+}
+
+// Thread de travail : construit les blocs de chaque calque de tuiles pendant que
+// le thread principal continue, le callback n'a plus qu'à les copier dans l'arène
+static void Map_PrepareTMXLayers(LoadJob *job, void *userdata)
+{
+    MapLoadTask *task = (MapLoadTask *)userdata;
+    tmx_map *tmx = (tmx_map *)job->result;
+    if (tmx->width > MAP_MAX_SIDE || tmx->height > MAP_MAX_SIDE)
+        return; // Refusée par Map_LoadTMXTilesetsAndLayers
+
+    int count = 0;
+    for (tmx_layer *layer = tmx->ly_head; layer; layer = layer->next)
+    {
+        if (layer->type == L_LAYER)
+            count++;
+    }
+
+    task->layer_chunks = Mem_Calloc(MEM_TAG_MAP, count + 1, sizeof(MapChunksBuilder));
+    if (!task->layer_chunks)
+        return; // Nombre de calques incohérent : Map_LoadTMXTilesetsAndLayers échouera
+    task->layer_chunk_count = count;
+
+    // Les calques d'une map infinie n'ont pas de grille dense : leurs blocs sont relus
+    // dans le XML, libtmx ne gardant ni le texte ni les blocs
+    char *xml = NULL;
+    int i = 0;
+    for (tmx_layer *layer = tmx->ly_head; layer; layer = layer->next)
+    {
+        if (layer->type != L_LAYER)
+            continue;
+
+        MapChunksBuilder *builder = &task->layer_chunks[i++];
+        if (layer->content.gids)
+        {
+            MapChunks_PutGrid(builder, 0, 0, tmx->width, tmx->height, layer->content.gids);
+        }
+        else
+        {
+            if (!xml)
+                xml = Asset_LoadFile(job->path, NULL);
+            if (xml && !Map_ReadLayerChunks(xml, layer->id, builder))
+                fprintf(stderr, "Calque '%s' : blocs illisibles dans %s\n", layer->name, job->path);
+        }
+    }
+    Mem_Free(xml);
+}
+
+// Remplit les tilesets et calques résolus à partir du tmx_map et des blocs
+// construits par Map_PrepareTMXLayers (vidés au passage)
+static bool Map_LoadTMXTilesetsAndLayers(Map *map, MapChunksBuilder *layer_chunks, int layer_chunk_count)
+{
+    tmx_map *tmx = map->tmx_map;
+    if (tmx->width > MAP_MAX_SIDE || tmx->height > MAP_MAX_SIDE)
+    {
+        printf("Map %s trop grande (%ux%u tuiles)\n", map->filename, tmx->width, tmx->height);
+        return false;
+    }
+
+    map->width = tmx->width;
+    map->height = tmx->height;
+    map->tile_width = tmx->tile_width;
+    map->tile_height = tmx->tile_height;
+
+    // Compter et allouer en une passe
+    map->tileset_count = 0;
+    for (tmx_tileset_list *ts = tmx->ts_head; ts; ts = ts->next)
+        map->tileset_count++;
+
+    map->layer_count = 0;
+    for (tmx_layer *layer = tmx->ly_head; layer; layer = layer->next)
+    {
+        if (layer->type == L_LAYER)
+            map->layer_count++;
+    }
+
+    if (layer_chunk_count != map->layer_count)
+        return false;
+
+    map->tilesets = Arena_Calloc(&map->arena, map->tileset_count + 1, sizeof(MapTileset));
+    map->tileset_textures = Arena_Calloc(&map->arena, map->tileset_count + 1, sizeof(SDL_Texture *));
+    map->layers = Arena_Calloc(&map->arena, map->layer_count + 1, sizeof(MapLayer));
+    if (!map->tilesets || !map->tileset_textures || !map->layers)
+        return false;
 
-    // Initialisation
-    memset(map, 0, sizeof(Map));
-    map->filename = strdup(filename);
+    // Les images sont relatives au dossier de la map
+    char full_path[1024], map_dir[1024];
+    snprintf(map_dir, sizeof(map_dir), "%s", map->filename);
+    char *last_slash = strrchr(map_dir, '/');
+    if (last_slash)
+        *last_slash = '\0';
+    else
+        strcpy(map_dir, ".");
 
-    // Chargement de la map TMX
-    map->tmx_map = tmx_load(filename);
-    if (!map->tmx_map)
+    int i = 0;
+    for (tmx_tileset_list *ts = tmx->ts_head; ts; ts = ts->next, i++)
     {
-        printf("Erreur lors du chargement de la map: %s (libtmx error: %s)\n", filename, tmx_strerr());
-        Map_Free(map);
-        return NULL;
+        MapTileset *tileset = &map->tilesets[i];
+        tileset->firstgid = ts->firstgid;
+        tileset->tilecount = ts->tileset->tilecount;
+        tileset->tile_width = ts->tileset->tile_width;
+        tileset->tile_height = ts->tileset->tile_height;
+
+        if (ts->tileset->image)
+        {
+            tileset->columns = ts->tileset->image->width / ts->tileset->tile_width;
+            snprintf(full_path, sizeof(full_path), "%s/%s", map_dir, ts->tileset->image->source);
+            tileset->image = Arena_Strdup(&map->arena, full_path);
+            tileset->image_fallback = Arena_Strdup(&map->arena, ts->tileset->image->source);
+        }
+    }
+
+    i = 0;
+    for (tmx_layer *layer = tmx->ly_head; layer; layer = layer->next)
+    {
+        if (layer->type != L_LAYER)
+            continue;
+
+        map->layers[i].name = layer->name;
+        map->layers[i].visible = layer->visible;
+        if (!MapChunks_Finish(&layer_chunks[i], &map->arena, &map->layers[i].chunks))
+            return false;
+        i++;
     }
 
-    // Chargement des tilesets
-    if (!Map_LoadTilesets(map, renderer))
+    return true;
+}
+
+static bool Map_LoadTMXData(Map *map, MapChunksBuilder *layer_chunks, int layer_chunk_count)
+{
+    if (!Map_LoadTMXTilesetsAndLayers(map, layer_chunks, layer_chunk_count))
     {
         printf("Erreur lors du chargement des tilesets\n");
-        Map_Free(map);
-        return NULL;
+        return false;
     }
 
     // Chargement des collisions
     Map_LoadCollisions(map);
 
+    // Zones de déclenchement (passages vers les autres maps, panneaux...)
+    Map_LoadTriggers(map);
+
+    // Zones de rencontres, cuites en grille
+    Map_LoadEncounterZones(map);
+
     // Chargement des tiles animées
     Map_LoadAnimatedTiles(map);
 
     // Chargement des PNJ
     Map_LoadPNJ(map);
-    Map_CreateNPC(map, renderer);
 
     // Charger la position du spawn par défaut
     Map_SetDefaultSpawn(map);
 
-    // printf("Map chargée avec succès: %s\n", filename);
-    // Map_DEBUG(map);
-
-    return map;
+    return true;
 }
 
-void Map_Free(Map *map)
+// Décodage des textures en arrière-plan (rien à faire sans renderer)
+static void Map_SubmitTilesets(MapLoadTask *task)
 {
-    if (!map)
+    Map *map = task->map;
+    if (!task->loader->renderer)
         return;
 
-    // Libération des textures de tilesets
     for (int i = 0; i < map->tileset_count; i++)
     {
-        if (map->tileset_textures[i])
-        {
-            SDL_DestroyTexture(map->tileset_textures[i]);
-        }
-    }
-    free(map->tileset_textures);
+        if (!map->tilesets[i].image)
+            continue;
 
-    // Libération des collisions
-    for (int i = 0; i < map->collision_count; i++)
-    {
-        free(map->collisions[i].name);
+        task->contexts[i].task = task;
+        task->contexts[i].index = i;
+        task->jobsSubmitted++;
+        Loader_Submit(task->loader, LOAD_JOB_IMAGE, map->tilesets[i].image, map->tilesets[i].image_fallback,
+                      Map_OnTilesetDecoded, &task->contexts[i]);
     }
-    free(map->collisions);
+}
 
-    // Libération des tiles animées
-    for (int i = 0; i < map->animated_tile_count; i++)
-    {
-        free(map->animated_tiles[i].frame_ids);
-    }
-    free(map->animated_tiles);
+// Vrai si le fichier est une map cuite (.cmap) plutôt qu'un TMX
+bool Map_IsCookedPath(const char *filename)
+{
+    const char *ext = strrchr(filename, '.');
+    return ext && strcmp(ext, ".cmap") == 0;
+}
 
-    // Libération des PNJ
-    for (int i = 0; i < map->pnj_count; i++)
+// Index des zones de déclenchement : chaque zone est rangée dans toutes les
+// cases qu'elle touche. Comptage par case, sommes cumulées, puis remplissage.
+static bool Map_BuildTriggerIndex(Map *map)
+{
+    map->trigger_cols = 0;
+    map->trigger_rows = 0;
+    map->trigger_cell_start = NULL;
+    map->trigger_cell_items = NULL;
+    if (map->trigger_count == 0)
+        return true;
+
+    int cols = (map->width * map->tile_width + MAP_TRIGGER_CELL_SIZE - 1) / MAP_TRIGGER_CELL_SIZE;
+    int rows = (map->height * map->tile_height + MAP_TRIGGER_CELL_SIZE - 1) / MAP_TRIGGER_CELL_SIZE;
+    map->trigger_cols = cols > 0 ? cols : 1;
+    map->trigger_rows = rows > 0 ? rows : 1;
+    int cells = map->trigger_cols * map->trigger_rows;
+
+    Uint32 *start = Arena_Calloc(&map->arena, cells + 1, sizeof(Uint32));
+    if (!start)
+        return false;
+
+    for (int pass = 0; pass < 2; pass++)
     {
-        if (map->pnj_list[i])
+        for (int t = 0; t < map->trigger_count; t++)
         {
-            free(map->pnj_list[i]->Name);
-            free(map->pnj_list[i]->sprite_path);
-            free(map->pnj_list[i]);
+            const SDL_Rect *rect = &map->triggers[t].rect;
+            if (rect->w <= 0 || rect->h <= 0)
+                continue;
+
+            int x0 = Map_TriggerCell(rect->x, map->trigger_cols);
+            int y0 = Map_TriggerCell(rect->y, map->trigger_rows);
+            int x1 = Map_TriggerCell(rect->x + rect->w - 1, map->trigger_cols);
+            int y1 = Map_TriggerCell(rect->y + rect->h - 1, map->trigger_rows);
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    int cell = y * map->trigger_cols + x;
+                    if (pass == 0)
+                        start[cell + 1]++;
+                    else
+                        map->trigger_cell_items[start[cell]++] = (Uint16)t;
+                }
+            }
         }
-    }
-    free(map->pnj_list);
 
-    for (int i = 0; i < map->npc_count; i++)
-    {
-        if (map->npc[i])
+        if (pass == 0)
         {
-            NPC_Free(map->npc[i]);
-            free(map->npc[i]);
+            for (int c = 0; c < cells; c++)
+                start[c + 1] += start[c];
+            if (start[cells] == 0)
+                break;
+            map->trigger_cell_items = Arena_Calloc(&map->arena, start[cells], sizeof(Uint16));
+            if (!map->trigger_cell_items)
+                return false;
         }
     }
-    free(map->npc);
 
-    // Libération de la map TMX
-    if (map->tmx_map)
-    {
-        tmx_map_free(map->tmx_map);
-    }
-
-    free(map->filename);
-    free(map);
+    // Le remplissage a avancé chaque début d'une case : on les décale
+    for (int c = cells; c > 0; c--)
+        start[c] = start[c - 1];
+    start[0] = 0;
+    map->trigger_cell_start = start;
+    return true;
 }
 
-void Map_Update(Map *map, float deltaTime)
+// Données dérivées communes aux deux formats, calculées une fois au chargement
+bool Map_BuildDerivedData(Map *map)
 {
-    if (!map)
-        return;
+    if (!Map_BuildTriggerIndex(map))
+        return false;
 
-    // Mise à jour des tiles animées avec deltaTime
-    for (int i = 0; i < map->animated_tile_count; i++)
-    {
-        AnimatedTile *tile = &map->animated_tiles[i];
+    map->anim_lookup = NULL;
+    map->anim_lookup_size = 0;
 
-        tile->last_update += deltaTime * 1000.0f;
-
-        if (tile->last_update >= tile->frame_duration)
-        {
-            tile->current_frame = (tile->current_frame + 1) % tile->frame_count;
-            tile->last_update = 0;
-        }
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        Uint32 end = map->tilesets[i].firstgid + map->tilesets[i].tilecount;
+        if (end > map->anim_lookup_size)
+            map->anim_lookup_size = end;
     }
 
-    Map_UpdateNPC(map, deltaTime);
-}
+    if (map->animated_tile_count == 0 || map->anim_lookup_size == 0)
+        return true;
 
-void Map_RenderLayer(Map *map, SDL_Renderer *renderer, const char *layer_name)
-{
-    if (!map || !layer_name)
-        return;
+    // GID -> tile animée, pour éviter une recherche linéaire par tuile au rendu
+    map->anim_lookup = Arena_Calloc(&map->arena, map->anim_lookup_size, sizeof(Sint16));
+    if (!map->anim_lookup)
+        return false;
 
-    tmx_layer *layer = tmx_find_layer_by_name(map->tmx_map, layer_name);
-    if (!layer)
+    memset(map->anim_lookup, 0xFF, map->anim_lookup_size * sizeof(Sint16));
+    for (int i = 0; i < map->animated_tile_count; i++)
     {
-        printf("Layer '%s' introuvable\n", layer_name);
-        return;
+        Uint32 tile_id = (Uint32)map->animated_tiles[i].tile_id;
+        if (tile_id < map->anim_lookup_size && map->animated_tiles[i].frame_ids)
+            map->anim_lookup[tile_id] = (Sint16)i;
     }
 
-    if (layer->type == L_LAYER)
-    {
-        Map_RenderTileLayer(map, renderer, layer);
-    }
+    return true;
 }
 
-void Map_RenderAllLayers(Map *map, SDL_Renderer *renderer)
+static void Map_LoadCollisions(Map *map)
 {
-    if (!map)
+    map->collision_count = count_objects_in_layer(map->tmx_map->ly_head, "CollisionObject", false);
+    if (map->collision_count == 0)
+        return;
+
+    map->collisions = Arena_Calloc(&map->arena, map->collision_count, sizeof(Collision));
+    if (!map->collisions)
         return;
 
     tmx_layer *layer = map->tmx_map->ly_head;
-    while (layer)
+    while (layer && (layer->type != L_OBJGR || strcmp(layer->name, "CollisionObject") != 0))
     {
-        if (layer->type == L_LAYER && layer->visible)
-        {
-            Map_RenderTileLayer(map, renderer, layer);
-        }
         layer = layer->next;
     }
-}
-
-int Map_CheckCollision(Map *map, SDL_Rect *rect)
-{
-    if (!map || !rect)
-        return 0;
 
-    for (int i = 0; i < map->collision_count; i++)
+    if (layer)
     {
-        if (SDL_HasIntersection(rect, &map->collisions[i].rect))
+        tmx_object *obj = layer->content.objgr->head;
+        for (int i = 0; obj && i < map->collision_count; obj = obj->next, i++)
         {
-            return 1;
+            map->collisions[i] = (Collision){
+                .rect = {obj->x, obj->y, obj->width, obj->height},
+                .name = Arena_Strdup(&map->arena, obj->name ? obj->name : "")};
         }
     }
-    return 0;
 }
 
-void Map_GetSpawnPosition(Map *map, float *x, float *y)
+static float Map_GetNumberProperty(tmx_property *props, const char *name, float fallback)
 {
-    if (!map || !x || !y)
-        return;
-    *x = map->spawn_x;
-    *y = map->spawn_y;
+    tmx_property *prop = tmx_get_property(props, name);
+    if (prop && prop->type == PT_FLOAT)
+        return prop->value.decimal;
+    if (prop && prop->type == PT_INT)
+        return (float)prop->value.integer;
+    return fallback;
 }
 
-// Fonctions internes
-
-static int Map_LoadTilesets(Map *map, SDL_Renderer *renderer)
+// Genre d'un objet selon son calque, -1 s'il ne déclenche rien
+static int Map_GetTriggerType(const tmx_layer *layer, const tmx_object *obj, bool report)
 {
-    tmx_tileset_list *ts_list = map->tmx_map->ts_head;
-
-    // Compter et allouer en une passe
-    map->tileset_count = 0;
-    tmx_tileset_list *temp = ts_list;
-    while (temp)
+    if (strcmp(layer->name, "WarpObject") == 0)
+        return MAP_TRIGGER_WARP;
+    if (strcmp(layer->name, "EncounterObject") == 0)
+        return MAP_TRIGGER_ENCOUNTER;
+    if (strcmp(layer->name, "TriggerObject") != 0 || !obj->type)
+        return -1;
+
+    for (int type = 0; type < MAP_TRIGGER_TYPE_COUNT; type++)
     {
-        map->tileset_count++;
-        temp = temp->next;
+        if (strcmp(obj->type, trigger_type_names[type]) == 0)
+            return type;
     }
+    if (report)
+        printf("Zone de déclenchement de type inconnu: %s (%s)\n", obj->type, obj->name ? obj->name : "sans nom");
+    return -1;
+}
 
-    map->tileset_textures = calloc(map->tileset_count, sizeof(SDL_Texture *));
-    if (!map->tileset_textures)
-        return 0;
+// Valeur de la zone : propriété "map" (passage), "text" (panneau), "cutscene"
+// ou "zone" (rencontres), à défaut le nom de l'objet. NULL : zone ignorée.
+static const char *Map_GetTriggerValue(const tmx_object *obj, MapTriggerType type)
+{
+    static const char *const properties[MAP_TRIGGER_TYPE_COUNT] = {"map", "text", "cutscene", "zone"};
 
-    // Charger les textures
-    char full_path[1024], *map_dir = strdup(map->filename);
-    char *last_slash = strrchr(map_dir, '/');
-    if (last_slash)
-        *last_slash = '\0';
-    else
-        strcpy(map_dir, ".");
+    tmx_property *prop = tmx_get_property(obj->properties, properties[type]);
+    if (prop && prop->type == PT_STRING && prop->value.string[0] != '\0')
+        return prop->value.string;
 
-    for (int i = 0; ts_list; ts_list = ts_list->next, i++)
+    // Un passage sans destination ne mène nulle part
+    if (type == MAP_TRIGGER_WARP || !obj->name || obj->name[0] == '\0')
+        return NULL;
+    return obj->name;
+}
+
+// Zones de déclenchement de tous les calques d'objets. Passages :
+// "target_x"/"target_y" optionnels (sinon spawn de la destination).
+static void Map_LoadTriggers(Map *map)
+{
+    int count = 0;
+    for (tmx_layer *layer = map->tmx_map->ly_head; layer; layer = layer->next)
     {
-        if (!ts_list->tileset->image)
+        if (layer->type != L_OBJGR)
             continue;
+        for (tmx_object *obj = layer->content.objgr->head; obj; obj = obj->next)
+        {
+            int type = Map_GetTriggerType(layer, obj, true);
+            if (type >= 0 && Map_GetTriggerValue(obj, type))
+                count++;
+        }
+    }
+    if (count == 0)
+        return;
+    if (count > MAP_MAX_TRIGGERS)
+    {
+        printf("Trop de zones de déclenchement dans %s, %d ignorées\n", map->filename, count - MAP_MAX_TRIGGERS);
+        count = MAP_MAX_TRIGGERS;
+    }
 
-        snprintf(full_path, sizeof(full_path), "%s/%s", map_dir, ts_list->tileset->image->source);
-        SDL_Surface *surface = IMG_Load(full_path);
-        if (!surface)
-            surface = IMG_Load(ts_list->tileset->image->source);
+    map->triggers = Arena_Calloc(&map->arena, count, sizeof(MapTrigger));
+    if (!map->triggers)
+        return;
 
-        if (surface)
+    for (tmx_layer *layer = map->tmx_map->ly_head; layer && map->trigger_count < count; layer = layer->next)
+    {
+        if (layer->type != L_OBJGR)
+            continue;
+        for (tmx_object *obj = layer->content.objgr->head; obj && map->trigger_count < count; obj = obj->next)
         {
-            map->tileset_textures[i] = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_FreeSurface(surface);
+            int type = Map_GetTriggerType(layer, obj, false);
+            const char *value = type >= 0 ? Map_GetTriggerValue(obj, type) : NULL;
+            if (!value)
+                continue;
+
+            MapTrigger *trigger = &map->triggers[map->trigger_count++];
+            trigger->rect = (SDL_Rect){obj->x, obj->y, obj->width, obj->height};
+            trigger->type = (MapTriggerType)type;
+            trigger->name = Arena_Strdup(&map->arena, obj->name ? obj->name : "");
+            trigger->value = Arena_Strdup(&map->arena, value);
+            trigger->target_x = Map_GetNumberProperty(obj->properties, "target_x", -1.0f);
+            trigger->target_y = Map_GetNumberProperty(obj->properties, "target_y", -1.0f);
         }
     }
+}
 
-    free(map_dir);
-    return 1;
+// Indice de la zone `name` (ajoutée si nouvelle), -1 si la table est pleine
+static int Map_AddEncounterZone(Map *map, const char **zones, const char *name)
+{
+    for (int i = 0; i < map->encounter_zone_count; i++)
+    {
+        if (strcmp(zones[i], name) == 0)
+            return i;
+    }
+    if (map->encounter_zone_count == MAP_MAX_ENCOUNTER_ZONES)
+    {
+        printf("Trop de zones de rencontres dans %s, %s ignorée\n", map->filename, name);
+        return -1;
+    }
+    zones[map->encounter_zone_count] = Arena_Strdup(&map->arena, name);
+    return map->encounter_zone_count++;
 }
 
-static void Map_LoadCollisions(Map *map)
+// Zones de rencontres, de deux sources : les tuiles des tilesets qui ont une
+// propriété "encounter" (la tuile la plus haute l'emporte), puis les zones de
+// déclenchement de rencontres, qui recouvrent les tuiles dont le centre est
+// dans leur rectangle. Le résultat est cuit en grille.
+static void Map_LoadEncounterZones(Map *map)
 {
-    map->collision_count = count_objects_in_layer(map->tmx_map->ly_head, "CollisionObject", false);
-    if (map->collision_count == 0)
+    tmx_map *tmx = map->tmx_map;
+    bool objects = false;
+    for (int t = 0; t < map->trigger_count && !objects; t++)
+        objects = map->triggers[t].type == MAP_TRIGGER_ENCOUNTER;
+
+    bool tagged_tiles = false;
+    for (unsigned int gid = 0; gid < tmx->tilecount && !tagged_tiles; gid++)
+    {
+        tmx_property *prop = tmx->tiles[gid] ? tmx_get_property(tmx->tiles[gid]->properties, "encounter") : NULL;
+        tagged_tiles = prop && prop->type == PT_STRING;
+    }
+    if (!tagged_tiles && !objects)
         return;
 
-    map->collisions = malloc(map->collision_count * sizeof(Collision));
-    if (!map->collisions)
+    const char **zones = Arena_Calloc(&map->arena, MAP_MAX_ENCOUNTER_ZONES, sizeof(char *));
+    Uint8 *grid = Arena_Calloc(&map->arena, (size_t)map->width * map->height, 1);
+    if (!zones || !grid)
         return;
 
-    tmx_layer *layer = map->tmx_map->ly_head;
-    while (layer && (layer->type != L_OBJGR || strcmp(layer->name, "CollisionObject") != 0))
+    // Grille limitée aux dimensions de la map : les blocs au-delà sont ignorés
+    for (int l = 0; tagged_tiles && l < map->layer_count; l++)
     {
-        layer = layer->next;
+        const MapChunks *chunks = &map->layers[l].chunks;
+        for (Uint32 c = 0; c < chunks->capacity; c++)
+        {
+            const MapChunk *chunk = &chunks->slots[c];
+            if (chunk->index == MAP_CHUNK_NONE)
+                continue;
+
+            const Uint32 *tiles = chunks->tiles + (size_t)chunk->index * MAP_CHUNK_AREA;
+            for (int i = 0; i < MAP_CHUNK_AREA; i++)
+            {
+                int x = chunk->x * MAP_CHUNK_SIZE + i % MAP_CHUNK_SIZE;
+                int y = chunk->y * MAP_CHUNK_SIZE + i / MAP_CHUNK_SIZE;
+                Uint32 gid = tiles[i] & TMX_FLIP_BITS_REMOVAL;
+                if (gid == 0 || x < 0 || y < 0 || x >= map->width || y >= map->height || gid >= tmx->tilecount ||
+                    !tmx->tiles[gid])
+                    continue;
+
+                tmx_property *prop = tmx_get_property(tmx->tiles[gid]->properties, "encounter");
+                if (!prop || prop->type != PT_STRING)
+                    continue;
+
+                int zone = Map_AddEncounterZone(map, zones, prop->value.string);
+                if (zone >= 0)
+                    grid[y * map->width + x] = (Uint8)(zone + 1);
+            }
+        }
     }
 
-    if (layer)
+    for (int t = 0; objects && t < map->trigger_count; t++)
     {
-        tmx_object *obj = layer->content.objgr->head;
-        for (int i = 0; obj && i < map->collision_count; obj = obj->next, i++)
+        const MapTrigger *trigger = &map->triggers[t];
+        if (trigger->type != MAP_TRIGGER_ENCOUNTER)
+            continue;
+
+        int zone = Map_AddEncounterZone(map, zones, trigger->value);
+        if (zone < 0)
+            continue;
+
+        const SDL_Rect *rect = &trigger->rect;
+        int x0 = (int)((rect->x + map->tile_width / 2.0) / map->tile_width);
+        int y0 = (int)((rect->y + map->tile_height / 2.0) / map->tile_height);
+        int x1 = (int)((rect->x + rect->w - map->tile_width / 2.0) / map->tile_width);
+        int y1 = (int)((rect->y + rect->h - map->tile_height / 2.0) / map->tile_height);
+        for (int y = y0 < 0 ? 0 : y0; y <= y1 && y < map->height; y++)
         {
-            map->collisions[i] = (Collision){
-                .rect = {obj->x, obj->y, obj->width, obj->height},
-                .name = strdup(obj->name ? obj->name : "")};
+            for (int x = x0 < 0 ? 0 : x0; x <= x1 && x < map->width; x++)
+                grid[y * map->width + x] = (Uint8)(zone + 1);
         }
     }
+
+    if (map->encounter_zone_count == 0)
+        return;
+    map->encounter_zones = zones;
+    map->encounter_grid = grid;
 }
 
 void Map_LoadAnimatedTiles(Map *map)
@@ -382,7 +1514,7 @@ void Map_LoadAnimatedTiles(Map *map)
     if (map->animated_tile_count == 0)
         return;
 
-    map->animated_tiles = calloc(map->animated_tile_count, sizeof(AnimatedTile));
+    map->animated_tiles = Arena_Calloc(&map->arena, map->animated_tile_count, sizeof(AnimatedTile));
     if (!map->animated_tiles)
         return;
 
@@ -402,7 +1534,7 @@ void Map_LoadAnimatedTiles(Map *map)
                 anim->frame_duration = tile->animation ? tile->animation[0].duration : 0;
                 anim->last_update = SDL_GetTicks();
 
-                anim->frame_ids = malloc(anim->frame_count * sizeof(int));
+                anim->frame_ids = Arena_Calloc(&map->arena, anim->frame_count, sizeof(int));
                 if (anim->frame_ids)
                 {
                     for (int j = 0; j < anim->frame_count; j++)
@@ -426,7 +1558,7 @@ void Map_LoadPNJ(Map *map)
     if (map->pnj_count == 0)
         return;
 
-    map->pnj_list = calloc(map->pnj_count, sizeof(PNJ_init *));
+    map->pnj_list = Arena_Calloc(&map->arena, map->pnj_count, sizeof(PNJ_init *));
     if (!map->pnj_list)
         return;
 
@@ -445,14 +1577,14 @@ void Map_LoadPNJ(Map *map)
             tmx_property *prop_name = tmx_get_property(obj->properties, "Name");
             if (prop_name && prop_name->type == PT_STRING)
             {
-                PNJ_init *pnj = calloc(1, sizeof(PNJ_init));
+                PNJ_init *pnj = Arena_Alloc(&map->arena, sizeof(PNJ_init));
                 if (pnj)
                 {
-                    pnj->Name = strdup(prop_name->value.string);
+                    pnj->Name = Arena_Strdup(&map->arena, prop_name->value.string);
 
                     tmx_property *prop;
                     if ((prop = tmx_get_property(obj->properties, "sprite")) && prop->type == PT_STRING)
-                        pnj->sprite_path = strdup(prop->value.string);
+                        pnj->sprite_path = Arena_Strdup(&map->arena, prop->value.string);
                     if ((prop = tmx_get_property(obj->properties, "speed")) && prop->type == PT_FLOAT)
                         pnj->speed = prop->value.decimal;
                     if ((prop = tmx_get_property(obj->properties, "dir")) && prop->type == PT_INT)
@@ -480,91 +1612,79 @@ void Map_CreateNPC(Map *map, SDL_Renderer *renderer)
     if (!map || map->pnj_count == 0)
         return;
 
-    // Allouer le tableau de NPC
-    map->npc = calloc(map->pnj_count, sizeof(NPC *));
-    if (!map->npc)
+    // Allouer le tableau des entités PNJ
+    map->npc = Mem_Calloc(MEM_TAG_NPC, map->pnj_count, sizeof(EntityId));
+    map->npc_source = Mem_Calloc(MEM_TAG_NPC, map->pnj_count, sizeof(int));
+    if (!map->npc || !map->npc_source)
+    {
+        Mem_Free(map->npc);
+        Mem_Free(map->npc_source);
+        map->npc = NULL;
+        map->npc_source = NULL;
         return;
+    }
 
     map->npc_count = 0;
 
     for (int i = 0; i < map->pnj_count; i++)
     {
-        if (map->pnj_list[i])
-        {
-            NPC *npc = malloc(sizeof(NPC));
-            if (npc)
-            {
-
-                char sprite_path[512];
-                snprintf(sprite_path, sizeof(sprite_path), "resources/sprites/%s", map->pnj_list[i]->sprite_path);
-
-                // Utiliser les informations de PNJ_init pour créer le NPC
-                if (NPC_Init(npc, renderer, map->pnj_list[i]->sprite_path, map->pnj_list[i]->width, map->pnj_list[i]->height, map->pnj_list[i]->x, map->pnj_list[i]->y, NPC_HITBOX_WIDTH, NPC_HITBOX_HEIGHT, map->pnj_list[i]->speed))
-                {
-                    npc->baseEntity.traversable = map->pnj_list[i]->is_throughable;
-                    // printf("NPC hitbox traversable : %s\n", npc->baseEntity.traversable ? "oui" : "non");
-                    npc->direction = map->pnj_list[i]->direction;
-
-                    Entity_AddAnimation(&npc->baseEntity, "walk_down", "DEFAULT", 0, 0, 4, 200, true);
-                    Entity_AddAnimation(&npc->baseEntity, "walk_left", "DEFAULT", 1, 0, 4, 200, true);
-                    Entity_AddAnimation(&npc->baseEntity, "walk_right", "DEFAULT", 2, 0, 4, 200, true);
-                    Entity_AddAnimation(&npc->baseEntity, "walk_top", "DEFAULT", 3, 0, 4, 150, true);
-
-                    switch (npc->direction)
-                    {
-                    case 0:
-                        Entity_SetAnimation(&npc->baseEntity, "idle_down");
-                        break;
-                    case 1:
-                        Entity_SetAnimation(&npc->baseEntity, "idle_left");
-                        break;
-                    case 2:
-                        Entity_SetAnimation(&npc->baseEntity, "idle_right");
-                        break;
-                    case 3:
-                        Entity_SetAnimation(&npc->baseEntity, "idle_top");
-                        break;
-                    default:
-                        Entity_SetAnimation(&npc->baseEntity, "idle_down");
-                        break;
-                    }
+        PNJ_init *pnj = map->pnj_list[i];
+        if (!pnj)
+            continue;
 
-                    map->npc[map->npc_count] = npc;
-                    map->npc_count++;
-                }
-                else
-                {
-                    printf("Erreur lors de l'initialisation du NPC avec le sprite: %s\n", sprite_path);
-                    free(npc);
-                }
-            }
+        // Utiliser les informations de PNJ_init pour créer le PNJ
+        EntityId npc = NPC_Create(renderer, pnj->sprite_path, pnj->width, pnj->height, pnj->x, pnj->y,
+                                  NPC_HITBOX_WIDTH, NPC_HITBOX_HEIGHT, pnj->speed);
+        if (npc == ENTITY_NONE)
+        {
+            printf("Erreur lors de l'initialisation du NPC avec le sprite: %s\n", pnj->sprite_path);
+            continue;
         }
+
+        ECS_GetCollider(npc)->solid = !pnj->is_throughable;
+        NPC_SetFacing(npc, pnj->direction);
+        map->npc_source[map->npc_count] = i;
+        map->npc[map->npc_count++] = npc;
     }
 }
 
-void Map_RenderNPC(Map *map, SDL_Renderer *renderer)
+// Les PNJ d'une map hors écran (cache, préchargement) sont désactivés : ni
+// animés, ni affichés, ni pris en compte dans les collisions
+void Map_SetNPCPaused(Map *map, bool paused)
 {
+    if (!map || !map->npc)
+        return;
+
     for (int i = 0; i < map->npc_count; i++)
     {
-        if (map->npc[i])
-        {
-            NPC_Draw(map->npc[i], renderer);
-        }
+        NPC_SetPaused(map->npc[i], paused);
     }
 }
 
-void Map_UpdateNPC(Map *map, float deltaTime)
+void Map_Unlink(Map *map, const Map *neighbour)
 {
-    if (!map || !map->npc)
+    if (!map)
         return;
 
+    for (int i = 0; i < map->neighbour_count; i++)
+    {
+        if (map->neighbours[i].map == neighbour)
+            map->neighbours[i--] = map->neighbours[--map->neighbour_count];
+    }
+}
+
+EntityId Map_FindNPC(const Map *map, const char *name)
+{
+    if (!map || !name)
+        return ENTITY_NONE;
+
     for (int i = 0; i < map->npc_count; i++)
     {
-        if (map->npc[i])
-        {
-            NPC_Update(map->npc[i], deltaTime);
-        }
+        const PNJ_init *pnj = map->pnj_list[map->npc_source[i]];
+        if (pnj->Name && strcmp(pnj->Name, name) == 0)
+            return map->npc[i];
     }
+    return ENTITY_NONE;
 }
 
 // Fonction utilitaire pour trouver un objet par son nom dans un groupe d'objets
@@ -585,88 +1705,128 @@ static tmx_object *tmx_find_object_by_name(tmx_object_group *objgr, const char *
     return NULL;
 }
 
-static void Map_RenderTileLayer(Map *map, SDL_Renderer *renderer, tmx_layer *layer)
+// Une tuile du calque, à sa place dans le monde
+static void Map_RenderTile(Map *map, RenderList *list, Uint32 gid, int tile_x, int tile_y)
 {
-    unsigned int gid;
-    tmx_tileset_list *ts_list_iter; // Utiliser tmx_tileset_list pour itérer et accéder firstgid
-    tmx_tileset *current_tileset = NULL;
+    MapTileset *current_tileset = NULL;
     SDL_Texture *texture_to_render = NULL;
     SDL_Rect src_rect;
     SDL_Rect dst_rect;
 
-    long tile_x, tile_y; // Itérateurs de boucle pour les tuiles
+    // Supprimer les drapeaux de retournement pour obtenir l'ID de tuile original
+    unsigned int original_gid = gid & TMX_FLIP_BITS_REMOVAL;
 
-    for (tile_y = 0; tile_y < map->tmx_map->height; tile_y++)
+    // Vérifier si cette tuile est animée
+    unsigned int current_frame_gid = original_gid; // Par défaut, utiliser l'ID original
+    if (map->anim_lookup && original_gid < map->anim_lookup_size && map->anim_lookup[original_gid] >= 0)
     {
-        for (tile_x = 0; tile_x < map->tmx_map->width; tile_x++)
-        {
-            gid = layer->content.gids[(tile_y * map->tmx_map->width) + tile_x];
+        AnimatedTile *anim = &map->animated_tiles[map->anim_lookup[original_gid]];
+        current_frame_gid = anim->frame_ids[anim->current_frame];
+    }
 
-            // Si gid est 0, cela signifie pas de tuile (vide)
-            if (gid == 0)
-                continue;
+    // Trouver le tileset et la texture pour le GID de l'image actuelle
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        if (current_frame_gid >= map->tilesets[i].firstgid &&
+            current_frame_gid < map->tilesets[i].firstgid + map->tilesets[i].tilecount)
+        {
+            current_tileset = &map->tilesets[i];
+            texture_to_render = map->tileset_textures[i];
+            break;
+        }
+    }
 
-            // Supprimer les drapeaux de retournement pour obtenir l'ID de tuile original
-            unsigned int original_gid = gid & TMX_FLIP_BITS_REMOVAL;
+    if (!current_tileset || !texture_to_render || current_tileset->columns <= 0)
+    {
+        // Si le tileset ou la texture n'est pas trouvée pour ce GID, ignorer le rendu.
+        return;
+    }
 
-            // Vérifier si cette tuile est animée
-            int current_frame_gid = original_gid; // Par défaut, utiliser l'ID original
-            for (int i = 0; i < map->animated_tile_count; i++)
-            {
-                if (map->animated_tiles[i].tile_id == original_gid)
-                {
-                    current_frame_gid = map->animated_tiles[i].frame_ids[map->animated_tiles[i].current_frame];
-                    break;
-                }
-            }
+    // Calculer la position dans le tileset (rectangle source)
+    int local_id = current_frame_gid - current_tileset->firstgid;
+    src_rect.x = (local_id % current_tileset->columns) * current_tileset->tile_width;
+    src_rect.y = (local_id / current_tileset->columns) * current_tileset->tile_height;
+    src_rect.w = current_tileset->tile_width;
+    src_rect.h = current_tileset->tile_height;
+
+    // Calculer la position sur l'écran (rectangle de destination)
+    dst_rect.x = tile_x * map->tile_width;
+    dst_rect.y = tile_y * map->tile_height;
+    dst_rect.w = map->tile_width;
+    dst_rect.h = map->tile_height;
+
+    // Gérer le retournement des tuiles (drapeaux conservés dans le gid)
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    if (gid & TMX_FLIPPED_HORIZONTALLY)
+        flip |= SDL_FLIP_HORIZONTAL;
+    if (gid & TMX_FLIPPED_VERTICALLY)
+        flip |= SDL_FLIP_VERTICAL;
+
+    // Enregistrer la tuile
+    RenderList_Quad(list, texture_to_render, &src_rect, &dst_rect, flip);
+}
 
-            // Trouver le tileset et la texture pour le GID de l'image actuelle
-            current_tileset = NULL;
-            texture_to_render = NULL;
-            ts_list_iter = map->tmx_map->ts_head;
-            int tileset_idx = 0;
-            while (ts_list_iter)
-            {
-                if (current_frame_gid >= ts_list_iter->firstgid &&
-                    current_frame_gid < (ts_list_iter->firstgid + ts_list_iter->tileset->tilecount))
-                {
-                    current_tileset = ts_list_iter->tileset;
-                    texture_to_render = map->tileset_textures[tileset_idx];
-                    break;
-                }
-                ts_list_iter = ts_list_iter->next;
-                tileset_idx++;
-            }
+// Division par défaut (vers -infini), comme MapChunks pour les coordonnées négatives
+static int Map_FloorDiv(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
 
-            if (!current_tileset || !texture_to_render)
-            {
-                // Si le tileset ou la texture n'est pas trouvée pour ce GID, ignorer le rendu.
-                continue;
-            }
+static void Map_RenderChunk(Map *map, RenderList *list, const Uint32 *tiles, int chunk_x, int chunk_y)
+{
+    for (int i = 0; i < MAP_CHUNK_AREA; i++)
+    {
+        // Si gid est 0, cela signifie pas de tuile (vide)
+        if (tiles[i] != 0)
+            Map_RenderTile(map, list, tiles[i], chunk_x * MAP_CHUNK_SIZE + i % MAP_CHUNK_SIZE,
+                           chunk_y * MAP_CHUNK_SIZE + i / MAP_CHUNK_SIZE);
+    }
+}
 
-            // Calculer la position dans le tileset (rectangle source)
-            int local_id = current_frame_gid - ts_list_iter->firstgid; // Utiliser firstgid du tmx_tileset_list
-            int tiles_per_row = current_tileset->image->width / current_tileset->tile_width;
-            src_rect.x = (local_id % tiles_per_row) * current_tileset->tile_width;
-            src_rect.y = (local_id / tiles_per_row) * current_tileset->tile_height;
-            src_rect.w = current_tileset->tile_width;
-            src_rect.h = current_tileset->tile_height;
+// Seuls les blocs sous l'écran sont cherchés : le coût suit la zone visible,
+// pas l'étendue du calque. Sans taille d'écran, tous les blocs présents.
+static void Map_RenderTileLayer(Map *map, RenderList *list, MapLayer *layer)
+{
+    const MapChunks *chunks = &layer->chunks;
+    if (chunks->count == 0)
+        return;
 
-            // Calculer la position sur l'écran (rectangle de destination)
-            dst_rect.x = tile_x * map->tmx_map->tile_width;
-            dst_rect.y = tile_y * map->tmx_map->tile_height;
-            dst_rect.w = map->tmx_map->tile_width;
-            dst_rect.h = map->tmx_map->tile_height;
+    if (list->view_w <= 0 || list->view_h <= 0 || map->tile_width <= 0 || map->tile_height <= 0)
+    {
+        for (Uint32 c = 0; c < chunks->capacity; c++)
+        {
+            const MapChunk *chunk = &chunks->slots[c];
+            if (chunk->index != MAP_CHUNK_NONE)
+                Map_RenderChunk(map, list, chunks->tiles + (size_t)chunk->index * MAP_CHUNK_AREA, chunk->x, chunk->y);
+        }
+        return;
+    }
 
-            // Gérer le retournement des tuiles (libtmx fournit des drapeaux dans gid)
-            SDL_RendererFlip flip = SDL_FLIP_NONE;
-            if (gid & TMX_FLIPPED_HORIZONTALLY)
-                flip |= SDL_FLIP_HORIZONTAL;
-            if (gid & TMX_FLIPPED_VERTICALLY)
-                flip |= SDL_FLIP_VERTICAL;
+    // Écran dans les coordonnées de la map (le décalage inclut la caméra), en
+    // tuiles, borné aux tuiles posées du calque
+    int first_x = Map_FloorDiv(-list->offset_x, map->tile_width);
+    int first_y = Map_FloorDiv(-list->offset_y, map->tile_height);
+    int last_x = Map_FloorDiv(list->view_w - 1 - list->offset_x, map->tile_width);
+    int last_y = Map_FloorDiv(list->view_h - 1 - list->offset_y, map->tile_height);
+    if (first_x < chunks->min_x)
+        first_x = chunks->min_x;
+    if (first_y < chunks->min_y)
+        first_y = chunks->min_y;
+    if (last_x >= chunks->max_x)
+        last_x = chunks->max_x - 1;
+    if (last_y >= chunks->max_y)
+        last_y = chunks->max_y - 1;
+    if (first_x > last_x || first_y > last_y)
+        return;
 
-            // Rendre la tuile
-            SDL_RenderCopyEx(renderer, texture_to_render, &src_rect, &dst_rect, 0, NULL, flip);
+    int chunk_last_x = Map_FloorDiv(last_x, MAP_CHUNK_SIZE), chunk_last_y = Map_FloorDiv(last_y, MAP_CHUNK_SIZE);
+    for (int chunk_y = Map_FloorDiv(first_y, MAP_CHUNK_SIZE); chunk_y <= chunk_last_y; chunk_y++)
+    {
+        for (int chunk_x = Map_FloorDiv(first_x, MAP_CHUNK_SIZE); chunk_x <= chunk_last_x; chunk_x++)
+        {
+            const Uint32 *tiles = MapChunks_Find(chunks, chunk_x, chunk_y);
+            if (tiles)
+                Map_RenderChunk(map, list, tiles, chunk_x, chunk_y);
         }
     }
-}
\ No newline at end of file
+}
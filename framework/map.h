@@ -6,6 +6,46 @@
 #include <stdbool.h>
 #include "tmx.h"
 #include "../game/npc.h"
+#include "loader.h"
+#include "arena.h"
+#include "renderlist.h"
+#include "mapchunks.h"
+
+// Zones de rencontres sauvages d'une map (au plus 255, 0 réservé à « aucune »)
+#define MAP_MAX_ENCOUNTER_ZONES 255
+
+// Zones de déclenchement : indices sur 16 bits, index spatial en cases de
+// MAP_TRIGGER_CELL_SIZE pixels
+#define MAP_MAX_TRIGGERS 65535
+#define MAP_TRIGGER_CELL_SIZE 128
+
+// Côté maximal d'une map, en tuiles : width * height tient dans un int. Les
+// blocs d'une map infinie restent dans [-MAP_MAX_SIDE, MAP_MAX_SIDE].
+#define MAP_MAX_SIDE 32768
+
+// Taille des blocs de l'arène d'une map : couvre la plupart des maps en un
+// seul bloc (voir le pic affiché au chargement et Map_GetArenaPeak)
+#define MAP_ARENA_BLOCK_SIZE (16 * 1024)
+
+// Tileset résolu (indépendant de libtmx, rempli depuis le TMX ou une map cuite)
+typedef struct
+{
+    Uint32 firstgid;
+    Uint32 tilecount;
+    int tile_width, tile_height;
+    int columns;
+    const char *image;          // Chemin de l'image (NULL si aucune)
+    const char *image_fallback; // Chemin alternatif essayé si le premier échoue
+} MapTileset;
+
+// Calque de tuiles : GID (drapeaux de retournement inclus) rangés par blocs,
+// seuls les blocs non vides existent (maps finies comme infinies)
+typedef struct
+{
+    const char *name;
+    MapChunks chunks;
+    bool visible;
+} MapLayer;
 
 typedef struct
 {
@@ -34,12 +74,64 @@ typedef struct
     int width, height;
 } PNJ_init;
 
+// Zone de déclenchement : objet du calque "TriggerObject", dont la classe
+// (type) donne le genre. Les calques "WarpObject" et "EncounterObject" en
+// donnent aussi, de genre imposé.
+typedef enum
+{
+    MAP_TRIGGER_WARP,      // Passage vers une autre map : arête du graphe de connexions
+    MAP_TRIGGER_SIGN,      // Panneau
+    MAP_TRIGGER_CUTSCENE,  // Début de cinématique
+    MAP_TRIGGER_ENCOUNTER, // Zone de rencontres (cuite aussi dans la grille)
+    MAP_TRIGGER_TYPE_COUNT
+} MapTriggerType;
+
+typedef struct
+{
+    SDL_Rect rect;
+    MapTriggerType type;
+    char *name;
+    // Passage : map de destination (sans extension) ; panneau : texte ;
+    // cinématique : son nom ; rencontres : zone de la base de données
+    char *value;
+    float target_x, target_y; // Passage : arrivée (négative : spawn de la destination)
+} MapTrigger;
+
+#define MAP_MAX_NEIGHBOURS 8
+
+// Map voisine dans un monde (world.h), à son décalage en pixels dans les
+// coordonnées de la map qui la référence
 typedef struct
 {
-    tmx_map *tmx_map;
+    struct Map *map;
+    int dx, dy;
+} MapNeighbour;
+
+typedef struct Map
+{
+    tmx_map *tmx_map;   // NULL pour une map cuite
+    void *tmx_resources; // Gestionnaire libtmx des tilesets lus dans l'archive (NULL sinon)
+    void *cooked_data;  // Map cuite projetée en mémoire (mmap), NULL sinon
+    size_t cooked_size;
+    bool cooked_borrowed; // cooked_data pointe dans l'archive montée
+
+    // Données de chargement (tables, chaînes, PNJ_init...) : rendues d'un coup
+    // par Map_Free. Les PNJ vivants et les textures restent hors arène.
+    Arena arena;
+
+    int width, height;  // En tuiles
+    int tile_width, tile_height;
+
+    MapTileset *tilesets;
     SDL_Texture **tileset_textures;
     int tileset_count;
 
+    MapLayer *layers;
+    int layer_count;
+
+    Sint16 *anim_lookup; // GID -> index dans animated_tiles (-1 si non animée)
+    Uint32 anim_lookup_size;
+
     Collision *collisions;
     int collision_count;
 
@@ -49,35 +141,91 @@ typedef struct
     PNJ_init **pnj_list;
     int pnj_count;
 
-    NPC **npc;
+    // Ensembles d'animations des feuilles de PNJ, référencés par la map de
+    // leur préchargement jusqu'à Map_Free (voir NPC_PreloadAnimationSet)
+    AnimationSet **npc_sets;
+    int npc_set_count;
+
+    EntityId *npc; // Entités des PNJ créés (voir Map_CreateNPC)
+    int *npc_source; // Indice dans pnj_list de chaque entité de npc
     int npc_count;
 
+    // Zones de déclenchement et leur index : grille de cases de
+    // MAP_TRIGGER_CELL_SIZE pixels, chacune avec la liste des zones qui la
+    // touchent (plage [cell_start[c], cell_start[c + 1]) de cell_items)
+    MapTrigger *triggers;
+    int trigger_count;
+    int trigger_cols, trigger_rows;
+    Uint32 *trigger_cell_start;
+    Uint16 *trigger_cell_items;
+
+    // Rencontres sauvages : grille cuite au chargement, une case par tuile
+    // (0 : aucune, sinon indice de zone + 1). Les zones portent le nom d'une
+    // zone de la base de données (herbes, eau, grotte...).
+    const char **encounter_zones;
+    int encounter_zone_count;
+    const Uint8 *encounter_grid; // [height * width], NULL sans zone
+
     float spawn_x, spawn_y;
     char *filename;
 
+    // Monde : voisines résidentes de la map courante (World_Link). Dans un
+    // monde, sortir de la map n'est possible que sur une voisine chargée.
+    bool in_world;
+    MapNeighbour neighbours[MAP_MAX_NEIGHBOURS];
+    int neighbour_count;
+
     bool map_visited;
 } Map;
 
+// Chargement en arrière-plan d'une map (voir Loader_Pump)
+typedef struct MapLoadTask MapLoadTask;
+
 // Fonctions principales
 Map *Map_Load(const char *filename, SDL_Renderer *renderer);
+MapLoadTask *Map_LoadAsync(const char *filename, Loader *loader);
+bool Map_LoadTask_Update(MapLoadTask *task);
+float Map_LoadTask_Progress(const MapLoadTask *task);
+Map *Map_LoadTask_Finish(MapLoadTask *task);
 void Map_Free(Map *map);
 void Map_Update(Map *map, float deltaTime);
-void Map_RenderLayer(Map *map, SDL_Renderer *renderer, const char *layer_name);
-void Map_RenderAllLayers(Map *map, SDL_Renderer *renderer);
-void Map_RenderNPC(Map *map, SDL_Renderer *renderer);
+// Enregistrent les tuiles visibles dans la liste de rendu
+void Map_RenderLayer(Map *map, RenderList *list, const char *layer_name);
+void Map_RenderAllLayers(Map *map, RenderList *list);
 static void Map_LoadPNJ(Map *map);
 void Map_CreateNPC(Map *map, SDL_Renderer *renderer);
-void Map_UpdateNPC(Map *map, float deltaTime);
+void Map_SetNPCPaused(Map *map, bool paused);
+void Map_Unlink(Map *map, const Map *neighbour); // Retire une voisine (évincée du cache)
+EntityId Map_FindNPC(const Map *map, const char *name); // Par le nom du PNJ dans Tiled, ENTITY_NONE sinon
+size_t Map_GetArenaPeak(void); // Plus gros pic d'arène parmi les maps libérées
+
+// Rechargement à chaud (voir hotreload.h) : l'adresse de la map, ses PNJ et
+// les textures inchangées sont conservés
+bool Map_Reload(Map *map, const char *filename, SDL_Renderer *renderer);
+int Map_ReloadTilesetImage(Map *map, SDL_Renderer *renderer, const char *imagePath);
+bool Map_UsesFile(Map *map, const char *path);
 
 // Fonctions utilitaires
 int Map_CheckCollision(Map *map, SDL_Rect *rect);
 void Map_GetSpawnPosition(Map *map, float *x, float *y);
+MapLayer *Map_FindLayer(Map *map, const char *layer_name);
+// Zones touchées par le rectangle, par indice croissant (au plus `max`, les
+// plus grands indices en trop sont écartés et `truncated` passe à vrai)
+int Map_QueryTriggers(const Map *map, const SDL_Rect *rect, Uint16 *out, int max, bool *truncated);
+const char *Map_TriggerTypeName(MapTriggerType type);
+int Map_GetEncounterZone(const Map *map, int tile_x, int tile_y); // -1 si aucune
+bool Map_IsCookedPath(const char *filename);
+bool Map_BuildDerivedData(Map *map);
+
+// Format binaire cuit (voir mapcooked.c)
+bool Map_LoadCooked(Map *map, const char *filename);
+void Map_FreeCooked(Map *map);
+bool Map_WriteCooked(const Map *map, const char *filename);
 
 // Fonctions internes
-static int Map_LoadTilesets(Map *map, SDL_Renderer *renderer);
 static void Map_LoadCollisions(Map *map);
 static void Map_LoadAnimatedTiles(Map *map);
-static void Map_RenderTileLayer(Map *map, SDL_Renderer *renderer, tmx_layer *layer);
+static void Map_RenderTileLayer(Map *map, RenderList *list, MapLayer *layer);
 static void Map_DEBUG(Map *map);
 static void Map_SetDefaultSpawn(Map *map);
 
@@ -0,0 +1,181 @@
+#include "mapchunks.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Division par défaut (vers -infini) : la tuile -1 est dans le bloc -1
+static int MapChunks_ChunkOf(int tile)
+{
+    return tile >= 0 ? tile / MAP_CHUNK_SIZE : (tile - MAP_CHUNK_SIZE + 1) / MAP_CHUNK_SIZE;
+}
+
+static Uint32 MapChunks_Hash(int chunk_x, int chunk_y)
+{
+    Uint32 h = (Uint32)chunk_x * 0x9E3779B1u ^ (Uint32)chunk_y * 0x85EBCA77u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+// Case du bloc, ou la case libre où il serait rangé
+static Uint32 MapChunks_Slot(const MapChunk *slots, Uint32 capacity, int chunk_x, int chunk_y)
+{
+    Uint32 mask = capacity - 1;
+    Uint32 slot = MapChunks_Hash(chunk_x, chunk_y) & mask;
+    while (slots[slot].index != MAP_CHUNK_NONE && (slots[slot].x != chunk_x || slots[slot].y != chunk_y))
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+const Uint32 *MapChunks_Find(const MapChunks *chunks, int chunk_x, int chunk_y)
+{
+    if (!chunks || chunks->capacity == 0)
+        return NULL;
+
+    const MapChunk *chunk = &chunks->slots[MapChunks_Slot(chunks->slots, chunks->capacity, chunk_x, chunk_y)];
+    return chunk->index == MAP_CHUNK_NONE ? NULL : chunks->tiles + (size_t)chunk->index * MAP_CHUNK_AREA;
+}
+
+Uint32 MapChunks_Get(const MapChunks *chunks, int tile_x, int tile_y)
+{
+    int chunk_x = MapChunks_ChunkOf(tile_x), chunk_y = MapChunks_ChunkOf(tile_y);
+    const Uint32 *tiles = MapChunks_Find(chunks, chunk_x, chunk_y);
+    if (!tiles)
+        return 0;
+    return tiles[(tile_y - chunk_y * MAP_CHUNK_SIZE) * MAP_CHUNK_SIZE + (tile_x - chunk_x * MAP_CHUNK_SIZE)];
+}
+
+bool MapChunks_Validate(const MapChunks *chunks)
+{
+    if (chunks->capacity == 0)
+        return chunks->count == 0;
+
+    // Une case libre au moins, sinon une recherche ratée ne s'arrêterait pas
+    if ((chunks->capacity & (chunks->capacity - 1)) != 0 || chunks->count >= chunks->capacity)
+        return false;
+
+    Uint32 used = 0;
+    for (Uint32 i = 0; i < chunks->capacity; i++)
+    {
+        if (chunks->slots[i].index == MAP_CHUNK_NONE)
+            continue;
+        if (chunks->slots[i].index >= chunks->count)
+            return false;
+        used++;
+    }
+    return used == chunks->count;
+}
+
+// --- Construction ---
+
+static void MapChunks_Grow(MapChunksBuilder *builder)
+{
+    Uint32 capacity = builder->capacity ? builder->capacity * 2 : 16;
+    MapChunk *slots = Mem_Alloc(MEM_TAG_MAP, capacity * sizeof(MapChunk));
+    Uint32 *tiles = Mem_Realloc(MEM_TAG_MAP, builder->tiles, (size_t)(capacity / 2) * MAP_CHUNK_AREA * sizeof(Uint32));
+    if (!slots || !tiles)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les blocs de tuiles.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (Uint32 i = 0; i < capacity; i++)
+        slots[i].index = MAP_CHUNK_NONE;
+    for (Uint32 i = 0; i < builder->capacity; i++)
+    {
+        const MapChunk *chunk = &builder->slots[i];
+        if (chunk->index != MAP_CHUNK_NONE)
+            slots[MapChunks_Slot(slots, capacity, chunk->x, chunk->y)] = *chunk;
+    }
+
+    Mem_Free(builder->slots);
+    builder->slots = slots;
+    builder->tiles = tiles;
+    builder->capacity = capacity;
+}
+
+void MapChunks_Put(MapChunksBuilder *builder, int tile_x, int tile_y, Uint32 gid)
+{
+    if (gid == 0)
+        return;
+
+    if ((builder->count + 1) * 2 > builder->capacity)
+        MapChunks_Grow(builder);
+
+    int chunk_x = MapChunks_ChunkOf(tile_x), chunk_y = MapChunks_ChunkOf(tile_y);
+    MapChunk *chunk = &builder->slots[MapChunks_Slot(builder->slots, builder->capacity, chunk_x, chunk_y)];
+    if (chunk->index == MAP_CHUNK_NONE)
+    {
+        *chunk = (MapChunk){chunk_x, chunk_y, builder->count++};
+        memset(builder->tiles + (size_t)chunk->index * MAP_CHUNK_AREA, 0, MAP_CHUNK_AREA * sizeof(Uint32));
+    }
+
+    Uint32 *tiles = builder->tiles + (size_t)chunk->index * MAP_CHUNK_AREA;
+    tiles[(tile_y - chunk_y * MAP_CHUNK_SIZE) * MAP_CHUNK_SIZE + (tile_x - chunk_x * MAP_CHUNK_SIZE)] = gid;
+
+    if (builder->min_x == builder->max_x) // Premier GID : bornes vides jusqu'ici
+    {
+        builder->min_x = tile_x;
+        builder->min_y = tile_y;
+        builder->max_x = tile_x + 1;
+        builder->max_y = tile_y + 1;
+        return;
+    }
+    if (tile_x < builder->min_x)
+        builder->min_x = tile_x;
+    if (tile_y < builder->min_y)
+        builder->min_y = tile_y;
+    if (tile_x >= builder->max_x)
+        builder->max_x = tile_x + 1;
+    if (tile_y >= builder->max_y)
+        builder->max_y = tile_y + 1;
+}
+
+void MapChunks_PutGrid(MapChunksBuilder *builder, int x, int y, int width, int height, const Uint32 *gids)
+{
+    for (int row = 0; row < height; row++)
+    {
+        for (int column = 0; column < width; column++)
+            MapChunks_Put(builder, x + column, y + row, gids[row * width + column]);
+    }
+}
+
+bool MapChunks_Finish(MapChunksBuilder *builder, Arena *arena, MapChunks *out)
+{
+    memset(out, 0, sizeof(MapChunks));
+    if (builder->count == 0)
+    {
+        MapChunks_Discard(builder);
+        return true;
+    }
+
+    MapChunk *slots = Arena_Alloc(arena, builder->capacity * sizeof(MapChunk));
+    Uint32 *tiles = Arena_Alloc(arena, (size_t)builder->count * MAP_CHUNK_AREA * sizeof(Uint32));
+    if (!slots || !tiles)
+    {
+        MapChunks_Discard(builder);
+        return false;
+    }
+
+    memcpy(slots, builder->slots, builder->capacity * sizeof(MapChunk));
+    memcpy(tiles, builder->tiles, (size_t)builder->count * MAP_CHUNK_AREA * sizeof(Uint32));
+    out->slots = slots;
+    out->tiles = tiles;
+    out->capacity = builder->capacity;
+    out->count = builder->count;
+    out->min_x = builder->min_x;
+    out->min_y = builder->min_y;
+    out->max_x = builder->max_x;
+    out->max_y = builder->max_y;
+    MapChunks_Discard(builder);
+    return true;
+}
+
+void MapChunks_Discard(MapChunksBuilder *builder)
+{
+    Mem_Free(builder->slots);
+    Mem_Free(builder->tiles);
+    memset(builder, 0, sizeof(MapChunksBuilder));
+}
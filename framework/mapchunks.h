@@ -0,0 +1,58 @@
+#ifndef MAPCHUNKS_H
+#define MAPCHUNKS_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "arena.h"
+
+// Calque de tuiles creux : les tuiles sont rangées par blocs carrés (chunks)
+// retrouvés par une table de hachage sur leurs coordonnées. Un bloc sans
+// tuile n'existe pas et ne coûte rien : une map « infinie » de Tiled ou une
+// grande zone clairsemée ne paie que ce qui est dessiné. Les coordonnées
+// peuvent être négatives.
+//
+// La table et les tuiles sont deux tableaux sans pointeur : une map cuite
+// les utilise en place depuis sa projection mmap.
+
+#define MAP_CHUNK_SHIFT 4
+#define MAP_CHUNK_SIZE (1 << MAP_CHUNK_SHIFT) // Tuiles par côté
+#define MAP_CHUNK_AREA (MAP_CHUNK_SIZE * MAP_CHUNK_SIZE)
+#define MAP_CHUNK_NONE 0xFFFFFFFFu
+
+typedef struct
+{
+    Sint32 x, y;  // Coordonnées du bloc (en blocs)
+    Uint32 index; // Tuiles [index * MAP_CHUNK_AREA, +MAP_CHUNK_AREA), MAP_CHUNK_NONE : case libre
+} MapChunk;
+
+typedef struct
+{
+    const MapChunk *slots; // Adressage ouvert, sondage linéaire
+    const Uint32 *tiles;   // GID (drapeaux de retournement inclus), ligne par ligne dans chaque bloc
+    Uint32 capacity;       // Puissance de deux, remplie au plus à moitié ; 0 : calque vide
+    Uint32 count;          // Blocs présents
+    int min_x, min_y, max_x, max_y; // Tuiles non vides : [min, max) en tuiles
+} MapChunks;
+
+// Construction sur le tas, puis copie compacte dans l'arène de la map
+typedef struct
+{
+    MapChunk *slots;
+    Uint32 *tiles;
+    Uint32 capacity, count;
+    int min_x, min_y, max_x, max_y;
+} MapChunksBuilder;
+
+Uint32 MapChunks_Get(const MapChunks *chunks, int tile_x, int tile_y); // 0 si vide
+const Uint32 *MapChunks_Find(const MapChunks *chunks, int chunk_x, int chunk_y); // NULL si absent
+
+// Faux si la table lue (map cuite) est incohérente
+bool MapChunks_Validate(const MapChunks *chunks);
+
+void MapChunks_Put(MapChunksBuilder *builder, int tile_x, int tile_y, Uint32 gid); // GID 0 ignoré
+void MapChunks_PutGrid(MapChunksBuilder *builder, int x, int y, int width, int height, const Uint32 *gids);
+// Copie dans l'arène et vide le constructeur ; faux si l'arène est pleine
+bool MapChunks_Finish(MapChunksBuilder *builder, Arena *arena, MapChunks *out);
+void MapChunks_Discard(MapChunksBuilder *builder);
+
+#endif // MAPCHUNKS_H
@@ -0,0 +1,653 @@
+#include "map.h"
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Format binaire cuit (.cmap), petit-boutiste, tous les champs sur 32 bits :
+//
+//   CookedHeader
+//   CookedTileset[tileset_count]
+//   CookedLayer[layer_count]      + MapChunk slots[chunk_capacity]
+//                                   + Uint32 tiles[chunk_count * MAP_CHUNK_AREA] par calque
+//   CookedCollision[collision_count]
+//   CookedAnimTile[anim_count]    + Uint32 frame_ids[frame_count] par tile
+//   CookedNPC[npc_count]
+//   CookedTrigger[trigger_count]  (l'index spatial est reconstruit au chargement)
+//   Uint32 encounter_zones[encounter_zone_count] (noms des zones)
+//   Uint8 encounter_grid[width * height] (si au moins une zone)
+//   table de chaînes (terminées par '\0')
+//
+// Les offsets sont relatifs au début du fichier, les chaînes relatives à la
+// table de chaînes (COOKED_NO_STRING si absente). Les gros tableaux (blocs
+// de tuiles, frames) sont utilisés en place depuis la projection mmap.
+
+#define MAP_COOKED_MAGIC "PKMC"
+#define MAP_COOKED_VERSION 5
+#define COOKED_NO_STRING 0xFFFFFFFFu
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 file_size;
+    Uint32 width, height;
+    Uint32 tile_width, tile_height;
+    float spawn_x, spawn_y;
+    Uint32 strings_offset, strings_size;
+    Uint32 tileset_count, tilesets_offset;
+    Uint32 layer_count, layers_offset;
+    Uint32 collision_count, collisions_offset;
+    Uint32 anim_count, anims_offset;
+    Uint32 npc_count, npcs_offset;
+    Uint32 trigger_count, triggers_offset;
+    Uint32 encounter_zone_count, encounter_zones_offset;
+    Uint32 encounter_grid_offset;
+} CookedHeader;
+
+typedef struct
+{
+    Uint32 firstgid, tilecount;
+    Uint32 tile_width, tile_height;
+    Uint32 columns;
+    Uint32 image, image_fallback;
+} CookedTileset;
+
+typedef struct
+{
+    Uint32 name;
+    Uint32 visible;
+    Uint32 chunk_capacity, chunk_count;
+    Uint32 slots_offset, tiles_offset;
+    Sint32 min_x, min_y, max_x, max_y;
+} CookedLayer;
+
+typedef struct
+{
+    Sint32 x, y, w, h;
+    Uint32 name;
+} CookedCollision;
+
+typedef struct
+{
+    Uint32 tile_id;
+    Uint32 frame_count;
+    Uint32 frame_duration;
+    Uint32 frames_offset;
+} CookedAnimTile;
+
+typedef struct
+{
+    Uint32 name, sprite_path;
+    float speed;
+    Sint32 direction;
+    Uint32 is_throughable;
+    float x, y;
+    Sint32 width, height;
+} CookedNPC;
+
+typedef struct
+{
+    Sint32 x, y, w, h;
+    Uint32 type;
+    Uint32 name, value;
+    float target_x, target_y;
+} CookedTrigger;
+
+// --- Lecture ---
+
+static bool Cooked_RangeValid(const CookedHeader *header, Uint32 offset, Uint64 count, size_t elem_size)
+{
+    Uint64 end = (Uint64)offset + count * elem_size;
+    return (offset % 4) == 0 && end <= header->file_size;
+}
+
+static const char *Cooked_String(const CookedHeader *header, const char *strings, Uint32 offset)
+{
+    if (offset == COOKED_NO_STRING || offset >= header->strings_size)
+        return NULL;
+    return strings + offset;
+}
+
+static bool Cooked_Validate(const CookedHeader *header, size_t size)
+{
+    if (size < sizeof(CookedHeader) || memcmp(header->magic, MAP_COOKED_MAGIC, 4) != 0)
+    {
+        printf("Map cuite invalide (signature)\n");
+        return false;
+    }
+    if (header->version != MAP_COOKED_VERSION)
+    {
+        printf("Map cuite de version %u non supportée (attendue %d), la recuire\n", header->version, MAP_COOKED_VERSION);
+        return false;
+    }
+    if (header->file_size != size)
+    {
+        printf("Map cuite tronquée\n");
+        return false;
+    }
+    if (header->width > MAP_MAX_SIDE || header->height > MAP_MAX_SIDE)
+    {
+        printf("Map cuite invalide (taille %ux%u)\n", header->width, header->height);
+        return false;
+    }
+
+    const char *base = (const char *)header;
+    return Cooked_RangeValid(header, header->tilesets_offset, header->tileset_count, sizeof(CookedTileset)) &&
+           Cooked_RangeValid(header, header->layers_offset, header->layer_count, sizeof(CookedLayer)) &&
+           Cooked_RangeValid(header, header->collisions_offset, header->collision_count, sizeof(CookedCollision)) &&
+           Cooked_RangeValid(header, header->anims_offset, header->anim_count, sizeof(CookedAnimTile)) &&
+           Cooked_RangeValid(header, header->npcs_offset, header->npc_count, sizeof(CookedNPC)) &&
+           header->trigger_count <= MAP_MAX_TRIGGERS &&
+           Cooked_RangeValid(header, header->triggers_offset, header->trigger_count, sizeof(CookedTrigger)) &&
+           header->encounter_zone_count <= MAP_MAX_ENCOUNTER_ZONES &&
+           Cooked_RangeValid(header, header->encounter_zones_offset, header->encounter_zone_count, sizeof(Uint32)) &&
+           (header->encounter_zone_count == 0 ||
+            Cooked_RangeValid(header, header->encounter_grid_offset, (Uint64)header->width * header->height, 1)) &&
+           (Uint64)header->strings_offset + header->strings_size <= header->file_size &&
+           (header->strings_size == 0 || base[header->strings_offset + header->strings_size - 1] == '\0');
+}
+
+static bool Map_LoadCookedData(Map *map);
+
+bool Map_LoadCooked(Map *map, const char *filename)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    printf("Les maps cuites sont petit-boutistes, non supportées sur cette plateforme: %s\n", filename);
+    return false;
+#endif
+
+    // Entrée non compressée de l'archive : utilisée en place, sans copie
+    size_t packed_size = 0;
+    const void *packed = Pack_GetMapped(filename, &packed_size);
+    if (packed)
+    {
+        if (packed_size < sizeof(CookedHeader))
+        {
+            printf("Map cuite invalide: %s\n", filename);
+            return false;
+        }
+        map->cooked_data = (void *)packed;
+        map->cooked_size = packed_size;
+        map->cooked_borrowed = true;
+        return Map_LoadCookedData(map);
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Impossible d'ouvrir la map cuite: %s\n", filename);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CookedHeader))
+    {
+        close(fd);
+        printf("Map cuite invalide: %s\n", filename);
+        return false;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        printf("mmap impossible pour la map cuite: %s\n", filename);
+        return false;
+    }
+
+    map->cooked_data = data;
+    map->cooked_size = st.st_size;
+    return Map_LoadCookedData(map);
+}
+
+// Résout les tables de la map à partir de map->cooked_data
+static bool Map_LoadCookedData(Map *map)
+{
+    const CookedHeader *header = (const CookedHeader *)map->cooked_data;
+    if (!Cooked_Validate(header, map->cooked_size))
+        return false;
+
+    const char *base = (const char *)map->cooked_data;
+    const char *strings = base + header->strings_offset;
+
+    map->width = header->width;
+    map->height = header->height;
+    map->tile_width = header->tile_width;
+    map->tile_height = header->tile_height;
+    map->spawn_x = header->spawn_x;
+    map->spawn_y = header->spawn_y;
+
+    // Petites tables d'en-têtes : pointeurs résolus vers les données projetées
+    map->tileset_count = header->tileset_count;
+    map->tilesets = Arena_Calloc(&map->arena, map->tileset_count + 1, sizeof(MapTileset));
+    map->tileset_textures = Arena_Calloc(&map->arena, map->tileset_count + 1, sizeof(SDL_Texture *));
+    if (!map->tilesets || !map->tileset_textures)
+        return false;
+
+    const CookedTileset *cooked_tilesets = (const CookedTileset *)(base + header->tilesets_offset);
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        map->tilesets[i].firstgid = cooked_tilesets[i].firstgid;
+        map->tilesets[i].tilecount = cooked_tilesets[i].tilecount;
+        map->tilesets[i].tile_width = cooked_tilesets[i].tile_width;
+        map->tilesets[i].tile_height = cooked_tilesets[i].tile_height;
+        map->tilesets[i].columns = cooked_tilesets[i].columns;
+        map->tilesets[i].image = Cooked_String(header, strings, cooked_tilesets[i].image);
+        map->tilesets[i].image_fallback = Cooked_String(header, strings, cooked_tilesets[i].image_fallback);
+    }
+
+    map->layer_count = header->layer_count;
+    map->layers = Arena_Calloc(&map->arena, map->layer_count + 1, sizeof(MapLayer));
+    if (!map->layers)
+        return false;
+
+    const CookedLayer *cooked_layers = (const CookedLayer *)(base + header->layers_offset);
+    for (int i = 0; i < map->layer_count; i++)
+    {
+        const CookedLayer *cl = &cooked_layers[i];
+        if (!Cooked_RangeValid(header, cl->slots_offset, cl->chunk_capacity, sizeof(MapChunk)) ||
+            !Cooked_RangeValid(header, cl->tiles_offset, cl->chunk_count, MAP_CHUNK_AREA * sizeof(Uint32)))
+            return false;
+
+        const char *name = Cooked_String(header, strings, cl->name);
+        MapChunks *chunks = &map->layers[i].chunks;
+        map->layers[i].name = name ? name : "";
+        map->layers[i].visible = cl->visible != 0;
+        chunks->slots = (const MapChunk *)(base + cl->slots_offset);
+        chunks->tiles = (const Uint32 *)(base + cl->tiles_offset);
+        chunks->capacity = cl->chunk_capacity;
+        chunks->count = cl->chunk_count;
+        chunks->min_x = cl->min_x;
+        chunks->min_y = cl->min_y;
+        chunks->max_x = cl->max_x;
+        chunks->max_y = cl->max_y;
+        if (!MapChunks_Validate(chunks))
+            return false;
+    }
+
+    map->collision_count = header->collision_count;
+    if (map->collision_count > 0)
+    {
+        map->collisions = Arena_Calloc(&map->arena, map->collision_count, sizeof(Collision));
+        if (!map->collisions)
+            return false;
+
+        const CookedCollision *cooked_collisions = (const CookedCollision *)(base + header->collisions_offset);
+        for (int i = 0; i < map->collision_count; i++)
+        {
+            const CookedCollision *cc = &cooked_collisions[i];
+            map->collisions[i].rect = (SDL_Rect){cc->x, cc->y, cc->w, cc->h};
+            map->collisions[i].name = (char *)Cooked_String(header, strings, cc->name);
+        }
+    }
+
+    map->animated_tile_count = header->anim_count;
+    if (map->animated_tile_count > 0)
+    {
+        map->animated_tiles = Arena_Calloc(&map->arena, map->animated_tile_count, sizeof(AnimatedTile));
+        if (!map->animated_tiles)
+            return false;
+
+        const CookedAnimTile *cooked_anims = (const CookedAnimTile *)(base + header->anims_offset);
+        for (int i = 0; i < map->animated_tile_count; i++)
+        {
+            const CookedAnimTile *ca = &cooked_anims[i];
+            if (ca->frame_count == 0 || !Cooked_RangeValid(header, ca->frames_offset, ca->frame_count, sizeof(Uint32)))
+                return false;
+
+            AnimatedTile *anim = &map->animated_tiles[i];
+            anim->tile_id = ca->tile_id;
+            anim->frame_count = ca->frame_count;
+            anim->frame_duration = ca->frame_duration;
+            anim->frame_ids = (int *)(base + ca->frames_offset); // Lecture seule
+        }
+    }
+
+    int npc_count = header->npc_count;
+    if (npc_count > 0)
+    {
+        map->pnj_list = Arena_Calloc(&map->arena, npc_count, sizeof(PNJ_init *));
+        if (!map->pnj_list)
+            return false;
+
+        const CookedNPC *cooked_npcs = (const CookedNPC *)(base + header->npcs_offset);
+        for (int i = 0; i < npc_count; i++)
+        {
+            PNJ_init *pnj = Arena_Alloc(&map->arena, sizeof(PNJ_init));
+            if (!pnj)
+                return false;
+
+            const CookedNPC *cn = &cooked_npcs[i];
+            pnj->Name = (char *)Cooked_String(header, strings, cn->name);
+            pnj->sprite_path = (char *)Cooked_String(header, strings, cn->sprite_path);
+            pnj->speed = cn->speed;
+            pnj->direction = cn->direction;
+            pnj->is_throughable = cn->is_throughable != 0;
+            pnj->x = cn->x;
+            pnj->y = cn->y;
+            pnj->width = cn->width;
+            pnj->height = cn->height;
+            map->pnj_list[map->pnj_count++] = pnj;
+        }
+    }
+
+    if (header->trigger_count > 0)
+    {
+        map->triggers = Arena_Calloc(&map->arena, header->trigger_count, sizeof(MapTrigger));
+        if (!map->triggers)
+            return false;
+
+        const CookedTrigger *cooked_triggers = (const CookedTrigger *)(base + header->triggers_offset);
+        for (Uint32 i = 0; i < header->trigger_count; i++)
+        {
+            const CookedTrigger *ct = &cooked_triggers[i];
+            const char *value = Cooked_String(header, strings, ct->value);
+            if (!value || ct->type >= MAP_TRIGGER_TYPE_COUNT)
+                continue;
+
+            const char *name = Cooked_String(header, strings, ct->name);
+            MapTrigger *trigger = &map->triggers[map->trigger_count++];
+            trigger->rect = (SDL_Rect){ct->x, ct->y, ct->w, ct->h};
+            trigger->type = (MapTriggerType)ct->type;
+            trigger->name = (char *)(name ? name : "");
+            trigger->value = (char *)value;
+            trigger->target_x = ct->target_x;
+            trigger->target_y = ct->target_y;
+        }
+    }
+
+    // La grille est lue en place ; une zone sans nom la rend inutilisable
+    if (header->encounter_zone_count > 0)
+    {
+        map->encounter_zones = Arena_Calloc(&map->arena, header->encounter_zone_count, sizeof(char *));
+        if (!map->encounter_zones)
+            return false;
+
+        const Uint32 *cooked_zones = (const Uint32 *)(base + header->encounter_zones_offset);
+        for (Uint32 i = 0; i < header->encounter_zone_count; i++)
+        {
+            map->encounter_zones[i] = Cooked_String(header, strings, cooked_zones[i]);
+            if (!map->encounter_zones[i])
+                return false;
+        }
+        map->encounter_zone_count = header->encounter_zone_count;
+        map->encounter_grid = (const Uint8 *)(base + header->encounter_grid_offset);
+    }
+
+    return true;
+}
+
+void Map_FreeCooked(Map *map)
+{
+    if (map->cooked_data)
+    {
+        // Les données lues dans l'archive appartiennent à la projection du pack
+        if (!map->cooked_borrowed)
+            munmap(map->cooked_data, map->cooked_size);
+        map->cooked_borrowed = false;
+        map->cooked_data = NULL;
+        map->cooked_size = 0;
+    }
+}
+
+// --- Écriture (outil mapcook) ---
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+} CookedBuffer;
+
+typedef struct
+{
+    char *data;
+    Uint32 size;
+    Uint32 capacity;
+} CookedStrings;
+
+static size_t Cooked_Reserve(CookedBuffer *buf, size_t bytes)
+{
+    // Toutes les sections sont alignées sur 4 octets
+    size_t offset = (buf->size + 3) & ~(size_t)3;
+    size_t needed = offset + bytes;
+    if (needed > buf->capacity)
+    {
+        size_t capacity = buf->capacity ? buf->capacity : 4096;
+        while (capacity < needed)
+            capacity *= 2;
+        char *data = realloc(buf->data, capacity);
+        if (!data)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la map cuite.\n");
+            exit(EXIT_FAILURE);
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+    memset(buf->data + buf->size, 0, needed - buf->size);
+    buf->size = needed;
+    return offset;
+}
+
+static Uint32 Cooked_AddString(CookedStrings *strings, const char *str)
+{
+    if (!str)
+        return COOKED_NO_STRING;
+
+    Uint32 len = (Uint32)strlen(str) + 1;
+    if (strings->size + len > strings->capacity)
+    {
+        Uint32 capacity = strings->capacity ? strings->capacity : 1024;
+        while (capacity < strings->size + len)
+            capacity *= 2;
+        char *data = realloc(strings->data, capacity);
+        if (!data)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la table de chaînes.\n");
+            exit(EXIT_FAILURE);
+        }
+        strings->data = data;
+        strings->capacity = capacity;
+    }
+
+    Uint32 offset = strings->size;
+    memcpy(strings->data + offset, str, len);
+    strings->size += len;
+    return offset;
+}
+
+bool Map_WriteCooked(const Map *map, const char *filename)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    fprintf(stderr, "La cuisson des maps n'est supportée que sur une plateforme petit-boutiste.\n");
+    return false;
+#endif
+
+    CookedBuffer buf = {0};
+    CookedStrings strings = {0};
+
+    size_t header_offset = Cooked_Reserve(&buf, sizeof(CookedHeader));
+
+    int npc_count = 0;
+    for (int i = 0; i < map->pnj_count; i++)
+    {
+        if (map->pnj_list[i])
+            npc_count++;
+    }
+
+    // Les tables sont réservées d'abord ; buf.data peut être réalloué, donc on
+    // repasse toujours par les offsets.
+    size_t tilesets_offset = Cooked_Reserve(&buf, map->tileset_count * sizeof(CookedTileset));
+    size_t layers_offset = Cooked_Reserve(&buf, map->layer_count * sizeof(CookedLayer));
+    size_t collisions_offset = Cooked_Reserve(&buf, map->collision_count * sizeof(CookedCollision));
+    size_t anims_offset = Cooked_Reserve(&buf, map->animated_tile_count * sizeof(CookedAnimTile));
+    size_t npcs_offset = Cooked_Reserve(&buf, npc_count * sizeof(CookedNPC));
+    size_t triggers_offset = Cooked_Reserve(&buf, map->trigger_count * sizeof(CookedTrigger));
+    size_t zones_offset = Cooked_Reserve(&buf, map->encounter_zone_count * sizeof(Uint32));
+    size_t grid_offset = 0;
+    if (map->encounter_zone_count > 0)
+    {
+        grid_offset = Cooked_Reserve(&buf, (size_t)map->width * map->height);
+        memcpy(buf.data + grid_offset, map->encounter_grid, (size_t)map->width * map->height);
+    }
+
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        CookedTileset *ct = (CookedTileset *)(buf.data + tilesets_offset) + i;
+        ct->firstgid = map->tilesets[i].firstgid;
+        ct->tilecount = map->tilesets[i].tilecount;
+        ct->tile_width = map->tilesets[i].tile_width;
+        ct->tile_height = map->tilesets[i].tile_height;
+        ct->columns = map->tilesets[i].columns;
+        ct->image = Cooked_AddString(&strings, map->tilesets[i].image);
+        ct->image_fallback = Cooked_AddString(&strings, map->tilesets[i].image_fallback);
+    }
+
+    for (int i = 0; i < map->layer_count; i++)
+    {
+        const MapChunks *chunks = &map->layers[i].chunks;
+        size_t slots_size = chunks->capacity * sizeof(MapChunk);
+        size_t tiles_size = (size_t)chunks->count * MAP_CHUNK_AREA * sizeof(Uint32);
+        size_t slots_offset = Cooked_Reserve(&buf, slots_size);
+        size_t tiles_offset = Cooked_Reserve(&buf, tiles_size);
+        if (slots_size > 0)
+            memcpy(buf.data + slots_offset, chunks->slots, slots_size);
+        if (tiles_size > 0)
+            memcpy(buf.data + tiles_offset, chunks->tiles, tiles_size);
+
+        CookedLayer *cl = (CookedLayer *)(buf.data + layers_offset) + i;
+        cl->name = Cooked_AddString(&strings, map->layers[i].name);
+        cl->visible = map->layers[i].visible;
+        cl->chunk_capacity = chunks->capacity;
+        cl->chunk_count = chunks->count;
+        cl->slots_offset = (Uint32)slots_offset;
+        cl->tiles_offset = (Uint32)tiles_offset;
+        cl->min_x = chunks->min_x;
+        cl->min_y = chunks->min_y;
+        cl->max_x = chunks->max_x;
+        cl->max_y = chunks->max_y;
+    }
+
+    for (int i = 0; i < map->collision_count; i++)
+    {
+        CookedCollision *cc = (CookedCollision *)(buf.data + collisions_offset) + i;
+        cc->x = map->collisions[i].rect.x;
+        cc->y = map->collisions[i].rect.y;
+        cc->w = map->collisions[i].rect.w;
+        cc->h = map->collisions[i].rect.h;
+        cc->name = Cooked_AddString(&strings, map->collisions[i].name);
+    }
+
+    for (int i = 0; i < map->animated_tile_count; i++)
+    {
+        const AnimatedTile *anim = &map->animated_tiles[i];
+        int frame_count = anim->frame_ids ? anim->frame_count : 0;
+        size_t frames_offset = Cooked_Reserve(&buf, frame_count * sizeof(Uint32));
+        if (frame_count > 0)
+            memcpy(buf.data + frames_offset, anim->frame_ids, frame_count * sizeof(Uint32));
+
+        CookedAnimTile *ca = (CookedAnimTile *)(buf.data + anims_offset) + i;
+        ca->tile_id = anim->tile_id;
+        ca->frame_count = frame_count;
+        ca->frame_duration = anim->frame_duration;
+        ca->frames_offset = (Uint32)frames_offset;
+    }
+
+    for (int i = 0, n = 0; i < map->pnj_count; i++)
+    {
+        const PNJ_init *pnj = map->pnj_list[i];
+        if (!pnj)
+            continue;
+
+        CookedNPC *cn = (CookedNPC *)(buf.data + npcs_offset) + n++;
+        cn->name = Cooked_AddString(&strings, pnj->Name);
+        cn->sprite_path = Cooked_AddString(&strings, pnj->sprite_path);
+        cn->speed = pnj->speed;
+        cn->direction = pnj->direction;
+        cn->is_throughable = pnj->is_throughable;
+        cn->x = pnj->x;
+        cn->y = pnj->y;
+        cn->width = pnj->width;
+        cn->height = pnj->height;
+    }
+
+    for (int i = 0; i < map->trigger_count; i++)
+    {
+        const MapTrigger *trigger = &map->triggers[i];
+        CookedTrigger *ct = (CookedTrigger *)(buf.data + triggers_offset) + i;
+        ct->x = trigger->rect.x;
+        ct->y = trigger->rect.y;
+        ct->w = trigger->rect.w;
+        ct->h = trigger->rect.h;
+        ct->type = (Uint32)trigger->type;
+        ct->name = Cooked_AddString(&strings, trigger->name);
+        ct->value = Cooked_AddString(&strings, trigger->value);
+        ct->target_x = trigger->target_x;
+        ct->target_y = trigger->target_y;
+    }
+
+    for (int i = 0; i < map->encounter_zone_count; i++)
+    {
+        Uint32 *cz = (Uint32 *)(buf.data + zones_offset) + i;
+        *cz = Cooked_AddString(&strings, map->encounter_zones[i]);
+    }
+
+    size_t strings_offset = Cooked_Reserve(&buf, strings.size);
+    if (strings.size > 0)
+        memcpy(buf.data + strings_offset, strings.data, strings.size);
+
+    CookedHeader *header = (CookedHeader *)(buf.data + header_offset);
+    memcpy(header->magic, MAP_COOKED_MAGIC, 4);
+    header->version = MAP_COOKED_VERSION;
+    header->file_size = (Uint32)buf.size;
+    header->width = map->width;
+    header->height = map->height;
+    header->tile_width = map->tile_width;
+    header->tile_height = map->tile_height;
+    header->spawn_x = map->spawn_x;
+    header->spawn_y = map->spawn_y;
+    header->strings_offset = (Uint32)strings_offset;
+    header->strings_size = strings.size;
+    header->tileset_count = map->tileset_count;
+    header->tilesets_offset = (Uint32)tilesets_offset;
+    header->layer_count = map->layer_count;
+    header->layers_offset = (Uint32)layers_offset;
+    header->collision_count = map->collision_count;
+    header->collisions_offset = (Uint32)collisions_offset;
+    header->anim_count = map->animated_tile_count;
+    header->anims_offset = (Uint32)anims_offset;
+    header->npc_count = npc_count;
+    header->npcs_offset = (Uint32)npcs_offset;
+    header->trigger_count = map->trigger_count;
+    header->triggers_offset = (Uint32)triggers_offset;
+    header->encounter_zone_count = map->encounter_zone_count;
+    header->encounter_zones_offset = (Uint32)zones_offset;
+    header->encounter_grid_offset = (Uint32)grid_offset;
+
+    // Écriture dans un fichier temporaire puis renommage, pour ne jamais laisser de map à moitié écrite
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+
+    bool ok = false;
+    FILE *file = fopen(tmp_path, "wb");
+    if (file)
+    {
+        ok = fwrite(buf.data, 1, buf.size, file) == buf.size;
+        ok = (fclose(file) == 0) && ok;
+        ok = ok && rename(tmp_path, filename) == 0;
+        if (!ok)
+            remove(tmp_path);
+    }
+    if (!ok)
+        fprintf(stderr, "Impossible d'écrire la map cuite: %s\n", filename);
+
+    free(strings.data);
+    free(buf.data);
+    return ok;
+}
@@ -0,0 +1,220 @@
+#include "mapmanager.h"
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+MapManager *MapManager_Create(Loader *loader, int capacity)
+{
+    MapManager *manager = Mem_Calloc(MEM_TAG_MAP, 1, sizeof(MapManager));
+    if (!manager)
+        return NULL;
+
+    manager->entries = Mem_Calloc(MEM_TAG_MAP, capacity, sizeof(MapCacheEntry));
+    if (!manager->entries)
+    {
+        Mem_Free(manager);
+        return NULL;
+    }
+
+    manager->loader = loader;
+    manager->capacity = capacity;
+    return manager;
+}
+
+void MapManager_Free(MapManager *manager)
+{
+    if (!manager)
+        return;
+
+    for (int i = 0; i < manager->capacity; i++)
+    {
+        Map_Free(Map_LoadTask_Finish(manager->entries[i].task));
+        Map_Free(manager->entries[i].map);
+    }
+    Mem_Free(manager->entries);
+    Mem_Free(manager);
+}
+
+// Choisit la version cuite (.cmap) d'une map si elle est au moins aussi récente
+// que le TMX ; sinon on retombe sur le TMX, qui reste le format d'édition.
+void MapManager_ResolvePath(const char *map_name, char *out, size_t size)
+{
+    char tmx_path[256];
+    struct stat tmx_stat, cooked_stat;
+
+    snprintf(tmx_path, sizeof(tmx_path), "resources/maps/%s.tmx", map_name);
+    snprintf(out, size, "resources/maps/%s.cmap", map_name);
+
+    // L'archive est construite à partir des maps cuites : elle fait foi
+    if (Pack_Contains(out))
+        return;
+    if (Pack_Contains(tmx_path))
+    {
+        snprintf(out, size, "%s", tmx_path);
+        return;
+    }
+
+    if (stat(out, &cooked_stat) == 0 &&
+        (stat(tmx_path, &tmx_stat) != 0 || cooked_stat.st_mtime >= tmx_stat.st_mtime))
+    {
+        return;
+    }
+
+    snprintf(out, size, "%s", tmx_path);
+}
+
+static MapCacheEntry *MapManager_Find(MapManager *manager, const char *map_name)
+{
+    for (int i = 0; i < manager->capacity; i++)
+    {
+        if (manager->entries[i].name[0] != '\0' && strcmp(manager->entries[i].name, map_name) == 0)
+        {
+            return &manager->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Emplacement libre, sinon la map la moins récemment utilisée (hors map courante
+// et chargements en cours, qui sont référencés par le loader)
+static MapCacheEntry *MapManager_Evict(MapManager *manager)
+{
+    MapCacheEntry *victim = NULL;
+    for (int i = 0; i < manager->capacity; i++)
+    {
+        MapCacheEntry *entry = &manager->entries[i];
+        if (entry->name[0] == '\0')
+            return entry;
+        if (entry->task || (entry->map && entry->map == manager->current))
+            continue;
+        if (!victim || entry->lastUsed < victim->lastUsed)
+            victim = entry;
+    }
+
+    if (victim)
+    {
+        printf("Map retirée du cache: %s\n", victim->name);
+        Map_Unlink(manager->current, victim->map);
+        Map_Free(victim->map);
+        memset(victim, 0, sizeof(MapCacheEntry));
+    }
+    return victim;
+}
+
+bool MapManager_Preload(MapManager *manager, const char *map_name)
+{
+    MapCacheEntry *entry = MapManager_Find(manager, map_name);
+    if (entry)
+    {
+        entry->lastUsed = ++manager->clock;
+        return !entry->failed;
+    }
+
+    entry = MapManager_Evict(manager);
+    if (!entry)
+        return false; // Cache plein de maps épinglées
+
+    char map_path[256];
+    MapManager_ResolvePath(map_name, map_path, sizeof(map_path));
+
+    snprintf(entry->name, sizeof(entry->name), "%s", map_name);
+    entry->lastUsed = ++manager->clock;
+    entry->task = Map_LoadAsync(map_path, manager->loader);
+    entry->failed = entry->task == NULL;
+    return !entry->failed;
+}
+
+void MapManager_PreloadNeighbours(MapManager *manager, Map *map, const SDL_Rect *area, int distance)
+{
+    if (!map || !area)
+        return;
+
+    SDL_Rect zone = {area->x - distance, area->y - distance, area->w + 2 * distance, area->h + 2 * distance};
+    Uint16 near[MAP_PRELOAD_MAX_TRIGGERS];
+    int count = Map_QueryTriggers(map, &zone, near, MAP_PRELOAD_MAX_TRIGGERS, NULL);
+    for (int i = 0; i < count; i++)
+    {
+        const MapTrigger *trigger = &map->triggers[near[i]];
+        if (trigger->type == MAP_TRIGGER_WARP)
+            MapManager_Preload(manager, trigger->value);
+    }
+}
+
+void MapManager_Update(MapManager *manager)
+{
+    for (int i = 0; i < manager->capacity; i++)
+    {
+        MapCacheEntry *entry = &manager->entries[i];
+        if (!entry->task || !Map_LoadTask_Update(entry->task))
+            continue;
+
+        entry->map = Map_LoadTask_Finish(entry->task);
+        entry->task = NULL;
+        entry->failed = entry->map == NULL;
+        if (entry->map != manager->current)
+            Map_SetNPCPaused(entry->map, true); // Réveillés par MapManager_SetCurrent
+    }
+}
+
+Map *MapManager_Get(MapManager *manager, const char *map_name)
+{
+    MapCacheEntry *entry = MapManager_Find(manager, map_name);
+    if (!entry || !entry->map)
+        return NULL;
+
+    entry->lastUsed = ++manager->clock;
+    return entry->map;
+}
+
+Map *MapManager_LoadNow(MapManager *manager, const char *map_name)
+{
+    MapCacheEntry *entry = MapManager_Find(manager, map_name);
+    if (entry && entry->failed)
+    {
+        // Nouvelle tentative explicite
+        memset(entry, 0, sizeof(MapCacheEntry));
+    }
+
+    if (!MapManager_Preload(manager, map_name))
+        return NULL;
+
+    entry = MapManager_Find(manager, map_name);
+    while (entry->task)
+    {
+        if (Loader_Pump(manager->loader, 0) == 0)
+            SDL_Delay(1); // Les threads de travail décodent encore
+        MapManager_Update(manager);
+    }
+
+    return MapManager_Get(manager, map_name);
+}
+
+bool MapManager_HasFailed(MapManager *manager, const char *map_name)
+{
+    MapCacheEntry *entry = MapManager_Find(manager, map_name);
+    return !entry || entry->failed;
+}
+
+float MapManager_Progress(MapManager *manager, const char *map_name)
+{
+    MapCacheEntry *entry = MapManager_Find(manager, map_name);
+    if (!entry)
+        return 0.0f;
+    return entry->task ? Map_LoadTask_Progress(entry->task) : 1.0f;
+}
+
+void MapManager_SetCurrent(MapManager *manager, Map *map)
+{
+    if (manager->current != map && manager->current)
+    {
+        Map_SetNPCPaused(manager->current, true);
+        manager->current->neighbour_count = 0; // Seules celles de la map courante sont tenues à jour
+    }
+
+    manager->current = map;
+    Map_SetNPCPaused(map, false);
+    if (map)
+        map->map_visited = true;
+}
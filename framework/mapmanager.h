@@ -0,0 +1,55 @@
+#ifndef MAPMANAGER_H
+#define MAPMANAGER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "map.h"
+#include "loader.h"
+
+// Cache LRU des maps chargées. Une map reste en mémoire avec ses PNJ tant
+// qu'elle n'est pas évincée : y revenir est instantané et les PNJ retrouvent
+// leur position. Les maps voisines (zones de passage) sont préchargées en
+// arrière-plan quand le joueur approche d'une sortie.
+
+#define MAP_PRELOAD_MAX_TRIGGERS 32 // Zones examinées autour du joueur
+
+typedef struct
+{
+    char name[64];     // Nom de la map (sans extension), vide si emplacement libre
+    Map *map;          // NULL tant que le chargement n'est pas terminé
+    MapLoadTask *task; // Chargement en cours (NULL sinon)
+    Uint32 lastUsed;   // Horloge LRU
+    bool failed;       // Chargement échoué : pas de nouvelle tentative automatique
+} MapCacheEntry;
+
+typedef struct MapManager
+{
+    Loader *loader;
+    MapCacheEntry *entries;
+    int capacity;
+    Uint32 clock;
+    Map *current; // Map affichée, jamais évincée
+} MapManager;
+
+MapManager *MapManager_Create(Loader *loader, int capacity);
+// À appeler après Loader_Free (les tâches en cours référencent le loader)
+void MapManager_Free(MapManager *manager);
+
+// Choisit la version cuite (.cmap) ou le TMX d'une map
+void MapManager_ResolvePath(const char *map_name, char *out, size_t size);
+
+// Démarre le chargement en arrière-plan si la map n'est pas en cache
+bool MapManager_Preload(MapManager *manager, const char *map_name);
+// Précharge les destinations des passages à moins de `distance` pixels de la zone
+void MapManager_PreloadNeighbours(MapManager *manager, Map *map, const SDL_Rect *area, int distance);
+
+// Termine les chargements dont les ressources sont prêtes (après Loader_Pump)
+void MapManager_Update(MapManager *manager);
+
+Map *MapManager_Get(MapManager *manager, const char *map_name); // NULL si pas encore prête
+Map *MapManager_LoadNow(MapManager *manager, const char *map_name); // Bloquant
+bool MapManager_HasFailed(MapManager *manager, const char *map_name);
+float MapManager_Progress(MapManager *manager, const char *map_name);
+void MapManager_SetCurrent(MapManager *manager, Map *map);
+
+#endif // MAPMANAGER_H
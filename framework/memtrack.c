@@ -0,0 +1,308 @@
+#include "memtrack.h"
+#include "tmx.h"
+#include <libxml/xmlmemory.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEM_MAGIC 0x4D454D54u // "MEMT"
+
+// En-tête placé devant chaque bloc (16 octets : l'alignement de malloc est conservé)
+typedef struct
+{
+    _Alignas(16) size_t size;
+    Uint32 magic;
+    Uint32 tag;
+} MemHeader;
+
+typedef struct
+{
+    atomic_size_t heap;
+    atomic_size_t heapPeak;
+    atomic_size_t textures;
+    atomic_size_t texturesPeak;
+    atomic_size_t peak; // Tas + textures
+    atomic_size_t budget;
+    atomic_bool overBudget; // Avertissement déjà affiché
+} MemCounters;
+
+// Un compteur par étiquette, le dernier pour le total
+static MemCounters counters[MEM_TAG_COUNT + 1];
+
+static atomic_uint textureGeneration;
+
+static const char *tagNames[MEM_TAG_COUNT] = {"map", "tmx", "entity", "npc", "render", "save", "battle", "asset"};
+
+static const char *Mem_TagName(int tag)
+{
+    return tag < MEM_TAG_COUNT ? tagNames[tag] : "total";
+}
+
+static void Mem_RaisePeak(atomic_size_t *peak, size_t value)
+{
+    size_t current = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(peak, &current, value, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+static void Mem_CheckBudget(int tag)
+{
+    MemCounters *c = &counters[tag];
+    size_t budget = atomic_load_explicit(&c->budget, memory_order_relaxed);
+    if (budget == 0)
+        return;
+
+    size_t live = atomic_load_explicit(&c->heap, memory_order_relaxed) +
+                  atomic_load_explicit(&c->textures, memory_order_relaxed);
+    if (live > budget)
+    {
+        if (!atomic_exchange(&c->overBudget, true))
+            fprintf(stderr, "Avertissement mémoire: %s utilise %zu Ko (budget %zu Ko)\n",
+                    Mem_TagName(tag), live / 1024, budget / 1024);
+    }
+    else
+    {
+        atomic_store(&c->overBudget, false);
+    }
+}
+
+// Ajoute ou retire `size` octets, pour l'étiquette et pour le total
+static void Mem_Count(int tag, bool texture, size_t size, bool add)
+{
+    int targets[2] = {tag, MEM_TAG_COUNT};
+    for (int i = 0; i < 2; i++)
+    {
+        MemCounters *c = &counters[targets[i]];
+        atomic_size_t *value = texture ? &c->textures : &c->heap;
+        if (!add)
+        {
+            atomic_fetch_sub_explicit(value, size, memory_order_relaxed);
+            Mem_CheckBudget(targets[i]);
+            continue;
+        }
+
+        size_t now = atomic_fetch_add_explicit(value, size, memory_order_relaxed) + size;
+        Mem_RaisePeak(texture ? &c->texturesPeak : &c->heapPeak, now);
+        Mem_RaisePeak(&c->peak, atomic_load_explicit(&c->heap, memory_order_relaxed) +
+                                    atomic_load_explicit(&c->textures, memory_order_relaxed));
+        Mem_CheckBudget(targets[i]);
+    }
+}
+
+void *Mem_Alloc(MemTag tag, size_t size)
+{
+    if (size > SIZE_MAX - sizeof(MemHeader))
+        return NULL;
+
+    MemHeader *header = malloc(sizeof(MemHeader) + size);
+    if (!header)
+        return NULL;
+
+    header->size = size;
+    header->magic = MEM_MAGIC;
+    header->tag = tag;
+    Mem_Count(tag, false, size, true);
+    return header + 1;
+}
+
+void *Mem_Calloc(MemTag tag, size_t count, size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+
+    void *ptr = Mem_Alloc(tag, count * size);
+    if (ptr)
+        memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Un bloc étranger ou déjà libéré corromprait le tas en silence : on s'arrête,
+// y compris en version optimisée
+static MemHeader *Mem_Header(void *ptr, const char *caller)
+{
+    MemHeader *header = (MemHeader *)ptr - 1;
+    if (header->magic != MEM_MAGIC)
+    {
+        fprintf(stderr, "%s : bloc %p non suivi ou déjà libéré\n", caller, ptr);
+        abort();
+    }
+    return header;
+}
+
+void *Mem_Realloc(MemTag tag, void *ptr, size_t size)
+{
+    if (!ptr)
+        return Mem_Alloc(tag, size);
+    if (size > SIZE_MAX - sizeof(MemHeader))
+        return NULL;
+
+    MemHeader *header = Mem_Header(ptr, "Mem_Realloc");
+    size_t oldSize = header->size;
+    int oldTag = header->tag;
+
+    MemHeader *grown = realloc(header, sizeof(MemHeader) + size);
+    if (!grown)
+        return NULL;
+
+    grown->size = size;
+    grown->tag = tag;
+    Mem_Count(oldTag, false, oldSize, false);
+    Mem_Count(tag, false, size, true);
+    return grown + 1;
+}
+
+char *Mem_Strdup(MemTag tag, const char *str)
+{
+    if (!str)
+        return NULL;
+
+    size_t length = strlen(str) + 1;
+    char *copy = Mem_Alloc(tag, length);
+    if (copy)
+        memcpy(copy, str, length);
+    return copy;
+}
+
+void Mem_Free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    // Seuls des blocs de Mem_Alloc arrivent ici : libtmx et libxml2 sont
+    // branchés par Mem_Init avant leur première allocation
+    MemHeader *header = Mem_Header(ptr, "Mem_Free");
+    header->magic = 0;
+    Mem_Count(header->tag, false, header->size, false);
+    free(header);
+}
+
+// --- libtmx et libxml2 ---
+// libtmx libère avec tmx_free_func des chaînes allouées par libxml2 : les
+// deux bibliothèques passent donc par le suivi, dès leur première allocation.
+
+static void *Mem_TMXAlloc(void *ptr, size_t size)
+{
+    return Mem_Realloc(MEM_TAG_TMX, ptr, size);
+}
+
+static void *Mem_XMLMalloc(size_t size)
+{
+    return Mem_Alloc(MEM_TAG_TMX, size);
+}
+
+static void *Mem_XMLRealloc(void *ptr, size_t size)
+{
+    return Mem_Realloc(MEM_TAG_TMX, ptr, size);
+}
+
+static char *Mem_XMLStrdup(const char *str)
+{
+    return Mem_Strdup(MEM_TAG_TMX, str);
+}
+
+void Mem_Init(void)
+{
+    static bool installed = false;
+    if (installed)
+        return;
+    installed = true;
+
+    xmlMemSetup(Mem_Free, Mem_XMLMalloc, Mem_XMLRealloc, Mem_XMLStrdup);
+    tmx_alloc_func = Mem_TMXAlloc;
+    tmx_free_func = Mem_Free;
+}
+
+// --- Textures ---
+
+static size_t Mem_TextureSize(SDL_Texture *texture)
+{
+    Uint32 format;
+    int w, h;
+    if (SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0)
+        return 0;
+
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+    if (bytesPerPixel == 0)
+        bytesPerPixel = 4; // Formats compressés ou YUV : estimation haute
+    return (size_t)w * (size_t)h * (size_t)bytesPerPixel;
+}
+
+SDL_Texture *Mem_CreateTextureFromSurface(MemTag tag, SDL_Renderer *renderer, SDL_Surface *surface)
+{
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture)
+        Mem_Count(tag, true, Mem_TextureSize(texture), true);
+    return texture;
+}
+
+SDL_Texture *Mem_CreateTexture(MemTag tag, SDL_Renderer *renderer, Uint32 format, int access, int w, int h)
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, format, access, w, h);
+    if (texture)
+        Mem_Count(tag, true, Mem_TextureSize(texture), true);
+    return texture;
+}
+
+void Mem_DestroyTexture(MemTag tag, SDL_Texture *texture)
+{
+    if (!texture)
+        return;
+
+    Mem_Count(tag, true, Mem_TextureSize(texture), false);
+    SDL_DestroyTexture(texture);
+    atomic_fetch_add(&textureGeneration, 1);
+}
+
+Uint32 Mem_GetTextureGeneration(void)
+{
+    return atomic_load(&textureGeneration);
+}
+
+// --- Rapports ---
+
+void Mem_SetBudget(MemTag tag, size_t bytes)
+{
+    if (tag < 0 || tag > MEM_TAG_COUNT)
+        return;
+
+    atomic_store(&counters[tag].budget, bytes);
+    atomic_store(&counters[tag].overBudget, false);
+    Mem_CheckBudget(tag);
+}
+
+size_t Mem_GetLive(MemTag tag)
+{
+    if (tag < 0 || tag > MEM_TAG_COUNT)
+        return 0;
+    return atomic_load(&counters[tag].heap) + atomic_load(&counters[tag].textures);
+}
+
+size_t Mem_GetPeak(MemTag tag)
+{
+    if (tag < 0 || tag > MEM_TAG_COUNT)
+        return 0;
+    return atomic_load(&counters[tag].peak);
+}
+
+void Mem_Report(void)
+{
+    printf("\n--- Mémoire par sous-système (Ko) ---\n");
+    printf("%-8s %10s %10s %10s %10s %10s %10s\n", "", "tas", "pic tas", "textures", "pic tex", "pic total", "budget");
+    for (int tag = 0; tag <= MEM_TAG_COUNT; tag++)
+    {
+        MemCounters *c = &counters[tag];
+        size_t budget = atomic_load(&c->budget);
+        char budgetText[24] = "-";
+        if (budget > 0)
+            snprintf(budgetText, sizeof(budgetText), "%zu", budget / 1024);
+
+        printf("%-8s %10zu %10zu %10zu %10zu %10zu %10s%s\n", Mem_TagName(tag),
+               atomic_load(&c->heap) / 1024, atomic_load(&c->heapPeak) / 1024,
+               atomic_load(&c->textures) / 1024, atomic_load(&c->texturesPeak) / 1024,
+               atomic_load(&c->peak) / 1024, budgetText, atomic_load(&c->overBudget) ? " DÉPASSÉ" : "");
+    }
+}
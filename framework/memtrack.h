@@ -0,0 +1,52 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <SDL2/SDL.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Suivi de la mémoire par sous-système : allocations étiquetées (tas) et
+// estimation de la mémoire des textures (largeur x hauteur x octets/pixel).
+// Les compteurs sont atomiques, les threads du loader allouent aussi.
+
+typedef enum
+{
+    MEM_TAG_MAP,    // Maps : arènes, tâches de chargement, cache, tilesets
+    MEM_TAG_TMX,    // Allocations internes de libtmx (et libxml2)
+    MEM_TAG_ENTITY, // Ensembles d'animations, lectures, joueur
+    MEM_TAG_NPC,    // Tables des PNJ des maps
+    MEM_TAG_RENDER, // Listes de commandes de rendu
+    MEM_TAG_SAVE,   // Instantanés de sauvegarde et tampons d'écriture
+    MEM_TAG_BATTLE, // Combats : base de données, arbres de recherche de l'IA
+    MEM_TAG_ASSET,  // Fichiers lus en entier (Asset_LoadFile), entrées extraites de l'archive
+    MEM_TAG_COUNT
+} MemTag;
+
+// Branche libtmx et libxml2 sur le suivi ; à appeler avant toute utilisation
+// de l'une ou l'autre (Mem_Free n'accepte que des blocs suivis)
+void Mem_Init(void);
+
+void *Mem_Alloc(MemTag tag, size_t size);
+void *Mem_Calloc(MemTag tag, size_t count, size_t size);
+void *Mem_Realloc(MemTag tag, void *ptr, size_t size);
+char *Mem_Strdup(MemTag tag, const char *str);
+void Mem_Free(void *ptr); // L'étiquette est retrouvée dans l'en-tête
+
+// Textures : la taille estimée est comptée à la création et retirée à la destruction
+SDL_Texture *Mem_CreateTextureFromSurface(MemTag tag, SDL_Renderer *renderer, SDL_Surface *surface);
+SDL_Texture *Mem_CreateTexture(MemTag tag, SDL_Renderer *renderer, Uint32 format, int access, int w, int h);
+void Mem_DestroyTexture(MemTag tag, SDL_Texture *texture);
+
+// Incrémentée à chaque destruction de texture : une liste de rendu enregistrée
+// sous une génération plus ancienne peut référencer une texture libérée
+Uint32 Mem_GetTextureGeneration(void);
+
+// Budget (tas + textures) au-delà duquel un avertissement est affiché ;
+// 0 désactive. MEM_TAG_COUNT désigne le total de tous les sous-systèmes.
+void Mem_SetBudget(MemTag tag, size_t bytes);
+
+size_t Mem_GetLive(MemTag tag); // Tas + textures, MEM_TAG_COUNT pour le total
+size_t Mem_GetPeak(MemTag tag);
+void Mem_Report(void);
+
+#endif // MEMTRACK_H
@@ -0,0 +1,467 @@
+#include "pack.h"
+#include "memtrack.h"
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// Archive montée (lecture seule après Pack_Mount : accessible depuis tous les threads)
+static struct
+{
+    const Uint8 *data;
+    size_t size;
+    const PackHeader *header;
+    const PackEntry *entries;
+    const char *paths;
+} mounted = {0};
+
+// --- Chemins ---
+
+// Chemin relatif canonique : séparateurs '/', sans "./" ni "dir/.."
+void Pack_NormalizePath(const char *path, char *out, size_t size)
+{
+    size_t len = 0;
+    const char *p = path;
+
+    if (size == 0)
+        return;
+
+    while (*p)
+    {
+        // Extraire le segment courant
+        const char *start = p;
+        while (*p && *p != '/' && *p != '\\')
+            p++;
+        size_t seg_len = p - start;
+        while (*p == '/' || *p == '\\')
+            p++;
+
+        if (seg_len == 0 || (seg_len == 1 && start[0] == '.'))
+            continue;
+
+        if (seg_len == 2 && start[0] == '.' && start[1] == '.')
+        {
+            // Remonter d'un segment s'il y en a un (sinon on garde le "..")
+            size_t last = len;
+            while (last > 0 && out[last - 1] != '/')
+                last--;
+            bool parent_is_dotdot = (len - last == 2 && out[last] == '.' && out[last + 1] == '.');
+            if (len > 0 && !parent_is_dotdot)
+            {
+                len = last > 0 ? last - 1 : 0;
+                continue;
+            }
+        }
+
+        if (len > 0 && len + 1 < size)
+            out[len++] = '/';
+        for (size_t i = 0; i < seg_len && len + 1 < size; i++)
+            out[len++] = start[i];
+    }
+
+    out[len] = '\0';
+}
+
+Uint64 Pack_HashPath(const char *normalizedPath)
+{
+    Uint64 hash = 0xcbf29ce484222325ull;
+    for (const unsigned char *c = (const unsigned char *)normalizedPath; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// --- Montage ---
+
+bool Pack_Mount(const char *path)
+{
+    Pack_Unmount();
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PackHeader))
+    {
+        close(fd);
+        fprintf(stderr, "Archive d'assets invalide: %s\n", path);
+        return false;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        fprintf(stderr, "mmap impossible pour l'archive: %s\n", path);
+        return false;
+    }
+
+    const PackHeader *header = (const PackHeader *)data;
+    bool valid = memcmp(header->magic, PACK_MAGIC, 4) == 0 &&
+                 header->version == PACK_VERSION &&
+                 header->file_size == (Uint64)st.st_size &&
+                 (Uint64)header->index_offset + (Uint64)header->entry_count * sizeof(PackEntry) <= header->file_size &&
+                 (Uint64)header->paths_offset + header->paths_size <= header->file_size &&
+                 header->index_offset % 8 == 0;
+    if (!valid)
+    {
+        fprintf(stderr, "Archive d'assets invalide ou de version inconnue: %s\n", path);
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    // Lecture séquentielle de l'index, lecture paresseuse du reste
+    madvise(data, st.st_size, MADV_RANDOM);
+
+    mounted.data = (const Uint8 *)data;
+    mounted.size = st.st_size;
+    mounted.header = header;
+    mounted.entries = (const PackEntry *)(mounted.data + header->index_offset);
+    mounted.paths = (const char *)(mounted.data + header->paths_offset);
+
+    printf("Archive d'assets montée: %s (%u entrées)\n", path, header->entry_count);
+    return true;
+}
+
+void Pack_Unmount(void)
+{
+    if (mounted.data)
+    {
+        munmap((void *)mounted.data, mounted.size);
+    }
+    memset(&mounted, 0, sizeof(mounted));
+}
+
+bool Pack_IsMounted(void)
+{
+    return mounted.data != NULL;
+}
+
+// Recherche dichotomique dans l'index trié par hash
+static const PackEntry *Pack_FindEntry(const char *path)
+{
+    if (!mounted.data)
+        return NULL;
+
+    char normalized[1024];
+    Pack_NormalizePath(path, normalized, sizeof(normalized));
+    Uint64 hash = Pack_HashPath(normalized);
+
+    Uint32 lo = 0, hi = mounted.header->entry_count;
+    while (lo < hi)
+    {
+        Uint32 mid = lo + (hi - lo) / 2;
+        if (mounted.entries[mid].hash < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (; lo < mounted.header->entry_count && mounted.entries[lo].hash == hash; lo++)
+    {
+        const PackEntry *entry = &mounted.entries[lo];
+        if (entry->path_offset < mounted.header->paths_size &&
+            strcmp(mounted.paths + entry->path_offset, normalized) == 0 &&
+            entry->offset <= mounted.size && entry->stored_size <= mounted.size - entry->offset &&
+            // Une entrée stockée telle quelle est lue sur raw_size octets
+            ((entry->flags & PACK_ENTRY_DEFLATE) || entry->raw_size == entry->stored_size))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool Pack_Contains(const char *path)
+{
+    return Pack_FindEntry(path) != NULL;
+}
+
+const void *Pack_GetMapped(const char *path, size_t *size)
+{
+    const PackEntry *entry = Pack_FindEntry(path);
+    if (!entry || (entry->flags & PACK_ENTRY_DEFLATE))
+        return NULL;
+
+    if (size)
+        *size = entry->raw_size;
+    return mounted.data + entry->offset;
+}
+
+// Copie décompressée d'une entrée (Mem_Free)
+static void *Pack_ExtractEntry(const PackEntry *entry)
+{
+    Uint8 *buffer = Mem_Alloc(MEM_TAG_ASSET, (size_t)entry->raw_size + 1);
+    if (!buffer)
+        return NULL;
+
+    if (entry->flags & PACK_ENTRY_DEFLATE)
+    {
+        uLongf raw_size = entry->raw_size;
+        if (uncompress(buffer, &raw_size, mounted.data + entry->offset, entry->stored_size) != Z_OK ||
+            raw_size != entry->raw_size)
+        {
+            fprintf(stderr, "Entrée compressée corrompue dans l'archive (offset %llu)\n", (unsigned long long)entry->offset);
+            Mem_Free(buffer);
+            return NULL;
+        }
+    }
+    else
+    {
+        memcpy(buffer, mounted.data + entry->offset, entry->raw_size);
+    }
+
+    buffer[entry->raw_size] = '\0'; // Pratique pour les fichiers texte
+    return buffer;
+}
+
+// --- Flux SDL_RWops en lecture seule sur un bloc mémoire ---
+
+typedef struct
+{
+    const Uint8 *base;
+    size_t size;
+    size_t pos;
+    void *owned; // Tampon décompressé à libérer à la fermeture (NULL si lu en place)
+} PackStream;
+
+static Sint64 PackRW_Size(SDL_RWops *context)
+{
+    return (Sint64)((PackStream *)context->hidden.unknown.data1)->size;
+}
+
+static Sint64 PackRW_Seek(SDL_RWops *context, Sint64 offset, int whence)
+{
+    PackStream *stream = (PackStream *)context->hidden.unknown.data1;
+    Sint64 pos;
+
+    switch (whence)
+    {
+    case RW_SEEK_SET:
+        pos = offset;
+        break;
+    case RW_SEEK_CUR:
+        pos = (Sint64)stream->pos + offset;
+        break;
+    case RW_SEEK_END:
+        pos = (Sint64)stream->size + offset;
+        break;
+    default:
+        return SDL_SetError("Pack: whence invalide");
+    }
+
+    if (pos < 0)
+        pos = 0;
+    if ((size_t)pos > stream->size)
+        pos = stream->size;
+    stream->pos = (size_t)pos;
+    return pos;
+}
+
+static size_t PackRW_Read(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+    PackStream *stream = (PackStream *)context->hidden.unknown.data1;
+    if (size == 0)
+        return 0;
+
+    size_t available = (stream->size - stream->pos) / size;
+    size_t count = maxnum < available ? maxnum : available;
+    memcpy(ptr, stream->base + stream->pos, count * size);
+    stream->pos += count * size;
+    return count;
+}
+
+static size_t PackRW_Write(SDL_RWops *context, const void *ptr, size_t size, size_t num)
+{
+    (void)context;
+    (void)ptr;
+    (void)size;
+    (void)num;
+    SDL_SetError("Pack: flux en lecture seule");
+    return 0;
+}
+
+static int PackRW_Close(SDL_RWops *context)
+{
+    if (context)
+    {
+        PackStream *stream = (PackStream *)context->hidden.unknown.data1;
+        Mem_Free(stream->owned);
+        free(stream);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+static SDL_RWops *Pack_OpenEntry(const PackEntry *entry)
+{
+    PackStream *stream = calloc(1, sizeof(PackStream));
+    SDL_RWops *rw = SDL_AllocRW();
+    if (!stream || !rw)
+    {
+        free(stream);
+        if (rw)
+            SDL_FreeRW(rw);
+        return NULL;
+    }
+
+    if (entry->flags & PACK_ENTRY_DEFLATE)
+    {
+        stream->owned = Pack_ExtractEntry(entry);
+        if (!stream->owned)
+        {
+            free(stream);
+            SDL_FreeRW(rw);
+            return NULL;
+        }
+        stream->base = (const Uint8 *)stream->owned;
+    }
+    else
+    {
+        // Lu directement depuis la projection mmap
+        stream->base = mounted.data + entry->offset;
+    }
+    stream->size = entry->raw_size;
+
+    rw->size = PackRW_Size;
+    rw->seek = PackRW_Seek;
+    rw->read = PackRW_Read;
+    rw->write = PackRW_Write;
+    rw->close = PackRW_Close;
+    rw->type = SDL_RWOPS_UNKNOWN;
+    rw->hidden.unknown.data1 = stream;
+    return rw;
+}
+
+// --- Ouverture des assets ---
+
+SDL_RWops *Asset_OpenRW(const char *path)
+{
+    const PackEntry *entry = Pack_FindEntry(path);
+    if (entry)
+        return Pack_OpenEntry(entry);
+
+    return SDL_RWFromFile(path, "rb");
+}
+
+SDL_Surface *Asset_LoadImage(const char *path)
+{
+    SDL_RWops *rw = Asset_OpenRW(path);
+    if (!rw)
+        return NULL;
+
+    return IMG_Load_RW(rw, 1);
+}
+
+void *Asset_LoadFile(const char *path, size_t *size)
+{
+    const PackEntry *entry = Pack_FindEntry(path);
+    if (entry)
+    {
+        if (size)
+            *size = entry->raw_size;
+        return Pack_ExtractEntry(entry);
+    }
+
+    // Copié dans un bloc suivi : un seul allocateur, quelle que soit la source
+    size_t length;
+    void *loaded = SDL_LoadFile(path, &length);
+    if (!loaded)
+        return NULL;
+
+    char *data = Mem_Alloc(MEM_TAG_ASSET, length + 1);
+    if (data)
+    {
+        memcpy(data, loaded, length);
+        data[length] = '\0';
+        if (size)
+            *size = length;
+    }
+    SDL_free(loaded);
+    return data;
+}
+
+// Enregistre dans le gestionnaire libtmx les TSX externes référencés par la map,
+// sous la clé que libtmx calculera (dossier de la map + attribut source).
+static void Pack_PreloadTilesets(tmx_resource_manager *rc_mgr, const char *map_path, const char *xml)
+{
+    // Même règle que libtmx : préfixe du chemin de la map jusqu'au dernier '/' inclus
+    char map_dir[512];
+    snprintf(map_dir, sizeof(map_dir), "%s", map_path);
+    char *last_slash = strrchr(map_dir, '/');
+    if (last_slash)
+        last_slash[1] = '\0';
+    else
+        map_dir[0] = '\0';
+
+    const char *cursor = xml;
+    while ((cursor = strstr(cursor, "<tileset")))
+    {
+        const char *tag_end = strchr(cursor, '>');
+        const char *source = strstr(cursor, "source=\"");
+        cursor += 8;
+        if (!tag_end || !source || source > tag_end)
+            continue;
+
+        source += 8;
+        const char *quote = strchr(source, '"');
+        if (!quote || quote > tag_end)
+            continue;
+
+        char key[1024];
+        snprintf(key, sizeof(key), "%s%.*s", map_dir, (int)(quote - source), source);
+
+        const PackEntry *entry = Pack_FindEntry(key);
+        if (!entry)
+            continue; // libtmx le lira depuis le disque
+
+        char *tsx = Pack_ExtractEntry(entry);
+        if (tsx)
+        {
+            tmx_load_tileset_buffer(rc_mgr, tsx, (int)entry->raw_size, key);
+            Mem_Free(tsx);
+        }
+    }
+}
+
+tmx_map *Asset_LoadTMX(const char *path, void **resources)
+{
+    *resources = NULL;
+
+    const PackEntry *entry = Pack_FindEntry(path);
+    if (!entry)
+        return tmx_load(path);
+
+    char *xml = Pack_ExtractEntry(entry);
+    if (!xml)
+        return NULL;
+
+    // Les tilesets chargés via le gestionnaire lui appartiennent : il doit vivre aussi longtemps que la map
+    tmx_resource_manager *rc_mgr = tmx_make_resource_manager();
+    if (!rc_mgr)
+    {
+        Mem_Free(xml);
+        return NULL;
+    }
+
+    Pack_PreloadTilesets(rc_mgr, path, xml);
+    tmx_map *map = tmx_rcmgr_load_buffer_vpath(rc_mgr, xml, (int)entry->raw_size, path);
+    Mem_Free(xml);
+
+    if (!map)
+    {
+        tmx_free_resource_manager(rc_mgr);
+        return NULL;
+    }
+
+    *resources = rc_mgr;
+    return map;
+}
@@ -0,0 +1,59 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "tmx.h"
+
+// Archive d'assets unique (.pak), projetée en mémoire avec mmap.
+// Index trié par hash du chemin normalisé ; les entrées non compressées sont
+// alignées et lues en place, les autres sont compressées avec zlib.
+
+#define PACK_MAGIC "PKPK"
+#define PACK_VERSION 1
+#define PACK_ALIGNMENT 16
+#define PACK_ENTRY_DEFLATE 0x1
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 entry_count;
+    Uint32 index_offset; // PackEntry[entry_count], trié par hash croissant
+    Uint32 paths_offset; // Chemins normalisés (terminés par '\0')
+    Uint32 paths_size;
+    Uint64 file_size;
+} PackHeader;
+
+typedef struct
+{
+    Uint64 hash; // FNV-1a 64 bits du chemin normalisé
+    Uint64 offset;
+    Uint32 stored_size; // Taille dans l'archive
+    Uint32 raw_size;    // Taille une fois décompressée
+    Uint32 flags;
+    Uint32 path_offset; // Dans la table des chemins, pour lever les collisions
+} PackEntry;
+
+// Archive montée (une seule à la fois)
+bool Pack_Mount(const char *path);
+void Pack_Unmount(void);
+bool Pack_IsMounted(void);
+
+// Utilitaires partagés avec l'outil packer
+void Pack_NormalizePath(const char *path, char *out, size_t size);
+Uint64 Pack_HashPath(const char *normalizedPath);
+
+// Accès aux entrées
+bool Pack_Contains(const char *path);
+const void *Pack_GetMapped(const char *path, size_t *size); // NULL si absente ou compressée
+
+// Ouverture d'un asset : archive montée d'abord, puis système de fichiers
+SDL_RWops *Asset_OpenRW(const char *path);
+SDL_Surface *Asset_LoadImage(const char *path);
+// Contenu entier, suivi d'un '\0' (non compté dans `size`) : à libérer avec
+// Mem_Free, que le fichier vienne de l'archive ou du disque
+void *Asset_LoadFile(const char *path, size_t *size);
+tmx_map *Asset_LoadTMX(const char *path, void **resources);
+
+#endif // PACK_H
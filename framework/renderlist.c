@@ -0,0 +1,189 @@
+#include "renderlist.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_LIST_MIN_CAPACITY 1024
+#define RENDER_LIST_MIN_VERTICES 1536
+
+void RenderList_Reset(RenderList *list, Uint32 generation)
+{
+    list->count = 0;
+    list->vertex_count = 0;
+    list->offset_x = 0;
+    list->offset_y = 0;
+    list->view_w = 0;
+    list->view_h = 0;
+    list->generation = generation;
+}
+
+void RenderList_SetOffset(RenderList *list, int x, int y)
+{
+    list->offset_x = x;
+    list->offset_y = y;
+}
+
+void RenderList_SetView(RenderList *list, int width, int height)
+{
+    list->view_w = width;
+    list->view_h = height;
+}
+
+static RenderCommand *RenderList_Push(RenderList *list, RenderCommandType type)
+{
+    if (list->count >= list->capacity)
+    {
+        // La capacité atteinte est conservée : plus d'allocation en régime établi
+        int capacity = list->capacity ? list->capacity * 2 : RENDER_LIST_MIN_CAPACITY;
+        RenderCommand *commands = Mem_Realloc(MEM_TAG_RENDER, list->commands, capacity * sizeof(RenderCommand));
+        if (!commands)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la liste de rendu.\n");
+            exit(EXIT_FAILURE);
+        }
+        list->commands = commands;
+        list->capacity = capacity;
+    }
+
+    RenderCommand *command = &list->commands[list->count++];
+    memset(command, 0, sizeof(RenderCommand));
+    command->type = type;
+    return command;
+}
+
+void RenderList_Clear(RenderList *list, SDL_Color color)
+{
+    RenderList_Push(list, RENDER_CMD_CLEAR)->color = color;
+}
+
+void RenderList_Quad(RenderList *list, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                     SDL_RendererFlip flip)
+{
+    RenderCommand *command = RenderList_Push(list, RENDER_CMD_QUAD);
+    command->texture = texture;
+    command->src = *src;
+    command->dst = *dst;
+    command->dst.x += list->offset_x;
+    command->dst.y += list->offset_y;
+    command->flip = (Uint8)flip;
+}
+
+void RenderList_Rect(RenderList *list, const SDL_Rect *rect, SDL_Color color, bool filled)
+{
+    RenderCommand *command = RenderList_Push(list, filled ? RENDER_CMD_FILL_RECT : RENDER_CMD_RECT);
+    command->dst = *rect;
+    command->dst.x += list->offset_x;
+    command->dst.y += list->offset_y;
+    command->color = color;
+}
+
+SDL_Vertex *RenderList_Geometry(RenderList *list, SDL_Texture *texture, int count)
+{
+    if (list->vertex_count + count > list->vertex_capacity)
+    {
+        int capacity = list->vertex_capacity ? list->vertex_capacity : RENDER_LIST_MIN_VERTICES;
+        while (capacity < list->vertex_count + count)
+            capacity *= 2;
+        SDL_Vertex *vertices = Mem_Realloc(MEM_TAG_RENDER, list->vertices, capacity * sizeof(SDL_Vertex));
+        if (!vertices)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la liste de rendu.\n");
+            exit(EXIT_FAILURE);
+        }
+        list->vertices = vertices;
+        list->vertex_capacity = capacity;
+    }
+
+    RenderCommand *command = RenderList_Push(list, RENDER_CMD_GEOMETRY);
+    command->texture = texture;
+    command->first = list->vertex_count;
+    command->count = count;
+    list->vertex_count += count;
+    return &list->vertices[command->first];
+}
+
+void RenderList_Submit(const RenderList *list, SDL_Renderer *renderer)
+{
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    for (int i = 0; i < list->count; i++)
+    {
+        const RenderCommand *command = &list->commands[i];
+        switch (command->type)
+        {
+        case RENDER_CMD_CLEAR:
+            SDL_SetRenderDrawColor(renderer, command->color.r, command->color.g, command->color.b, command->color.a);
+            SDL_RenderClear(renderer);
+            break;
+        case RENDER_CMD_QUAD:
+            if (command->flip == SDL_FLIP_NONE)
+                SDL_RenderCopy(renderer, command->texture, &command->src, &command->dst);
+            else
+                SDL_RenderCopyEx(renderer, command->texture, &command->src, &command->dst, 0, NULL,
+                                 (SDL_RendererFlip)command->flip);
+            break;
+        case RENDER_CMD_RECT:
+            SDL_SetRenderDrawColor(renderer, command->color.r, command->color.g, command->color.b, command->color.a);
+            SDL_RenderDrawRect(renderer, &command->dst);
+            break;
+        case RENDER_CMD_FILL_RECT:
+            SDL_SetRenderDrawColor(renderer, command->color.r, command->color.g, command->color.b, command->color.a);
+            SDL_RenderFillRect(renderer, &command->dst);
+            break;
+        case RENDER_CMD_GEOMETRY:
+            SDL_RenderGeometry(renderer, command->texture, &list->vertices[command->first], command->count, NULL, 0);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void RenderList_Free(RenderList *list)
+{
+    Mem_Free(list->commands);
+    Mem_Free(list->vertices);
+    memset(list, 0, sizeof(RenderList));
+}
+
+// --- Triple tampon ---
+
+void RenderBuffer_Init(RenderBuffer *buffer)
+{
+    memset(buffer->lists, 0, sizeof(buffer->lists));
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1);
+    buffer->front = 2;
+}
+
+void RenderBuffer_Free(RenderBuffer *buffer)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        RenderList_Free(&buffer->lists[i]);
+    }
+}
+
+RenderList *RenderBuffer_Back(RenderBuffer *buffer)
+{
+    return &buffer->lists[buffer->back];
+}
+
+void RenderBuffer_Publish(RenderBuffer *buffer)
+{
+    // On récupère l'ancienne liste du milieu (prise ou non) pour la frame suivante
+    int previous = atomic_exchange(&buffer->middle, buffer->back | RENDER_BUFFER_FRESH);
+    buffer->back = previous & ~RENDER_BUFFER_FRESH;
+}
+
+const RenderList *RenderBuffer_Acquire(RenderBuffer *buffer, bool *fresh)
+{
+    *fresh = (atomic_load(&buffer->middle) & RENDER_BUFFER_FRESH) != 0;
+    if (*fresh)
+    {
+        int latest = atomic_exchange(&buffer->middle, buffer->front);
+        buffer->front = latest & ~RENDER_BUFFER_FRESH;
+    }
+    return &buffer->lists[buffer->front];
+}
@@ -0,0 +1,87 @@
+#ifndef RENDERLIST_H
+#define RENDERLIST_H
+
+#include <SDL2/SDL.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Liste de commandes de rendu : la simulation enregistre la frame (tuiles,
+// sprites, primitives de debug) sans appeler SDL, le thread principal la
+// soumet ensuite au renderer. Une liste publiée n'est plus modifiée.
+
+typedef enum
+{
+    RENDER_CMD_CLEAR,     // color
+    RENDER_CMD_QUAD,      // texture, src -> dst, flip
+    RENDER_CMD_RECT,      // dst, color
+    RENDER_CMD_FILL_RECT, // dst, color (mélange alpha)
+    RENDER_CMD_GEOMETRY   // texture, sommets [first, first + count) : triangles en un appel
+} RenderCommandType;
+
+typedef struct
+{
+    Uint8 type;
+    Uint8 flip; // SDL_RendererFlip
+    SDL_Color color;
+    SDL_Texture *texture;
+    SDL_Rect src;
+    SDL_Rect dst;
+    int first, count; // RENDER_CMD_GEOMETRY
+} RenderCommand;
+
+typedef struct
+{
+    RenderCommand *commands;
+    int count;
+    int capacity;
+    SDL_Vertex *vertices; // Sommets des commandes de géométrie
+    int vertex_count;
+    int vertex_capacity;
+    int offset_x, offset_y; // Ajouté aux destinations des quads et rectangles (caméra)
+    int view_w, view_h;     // Zone visible à partir de (0, 0) ; 0 : tout est enregistré
+    // Génération des textures (Mem_GetTextureGeneration) à l'enregistrement :
+    // si une texture a été détruite depuis, la liste n'est pas soumise
+    Uint32 generation;
+} RenderList;
+
+void RenderList_Reset(RenderList *list, Uint32 generation);
+void RenderList_Clear(RenderList *list, SDL_Color color);
+void RenderList_Quad(RenderList *list, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                     SDL_RendererFlip flip);
+void RenderList_Rect(RenderList *list, const SDL_Rect *rect, SDL_Color color, bool filled);
+// Décalage des quads et rectangles suivants, remis à zéro par RenderList_Reset
+void RenderList_SetOffset(RenderList *list, int x, int y);
+// Taille de l'écran : les calques de tuiles n'enregistrent que ce qui y tombe
+// (remise à zéro par RenderList_Reset)
+void RenderList_SetView(RenderList *list, int width, int height);
+// Réserve `count` sommets (triangles, 3 par 3) à remplir par l'appelant ;
+// valides jusqu'au prochain ajout à la liste
+SDL_Vertex *RenderList_Geometry(RenderList *list, SDL_Texture *texture, int count);
+void RenderList_Submit(const RenderList *list, SDL_Renderer *renderer);
+void RenderList_Free(RenderList *list);
+
+// --- Échange entre threads ---
+// Triple tampon sans verrou : la simulation remplit `back` pendant que le
+// rendu soumet `front` ; la dernière liste publiée attend dans `middle`.
+// Chaque côté ne touche que sa liste, seul l'index du milieu est partagé.
+
+#define RENDER_BUFFER_FRESH 4 // Bit de `middle` : liste publiée pas encore prise
+
+typedef struct
+{
+    RenderList lists[3];
+    atomic_int middle; // Index | RENDER_BUFFER_FRESH
+    int back;          // Côté simulation
+    int front;         // Côté rendu
+} RenderBuffer;
+
+void RenderBuffer_Init(RenderBuffer *buffer);
+void RenderBuffer_Free(RenderBuffer *buffer);
+
+RenderList *RenderBuffer_Back(RenderBuffer *buffer);
+void RenderBuffer_Publish(RenderBuffer *buffer); // La liste `back` devient la plus récente
+
+// Dernière liste publiée ; `fresh` est faux si c'est la même qu'au dernier appel
+const RenderList *RenderBuffer_Acquire(RenderBuffer *buffer, bool *fresh);
+
+#endif // RENDERLIST_H
@@ -0,0 +1,274 @@
+#include "savewriter.h"
+#include "memtrack.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+// Écrit `data` dans `path` sans jamais laisser de fichier à moitié écrit :
+// fichier temporaire, fsync, renommage, puis fsync du dossier pour que le
+// renommage lui-même survive à une coupure
+static bool SaveWriter_WriteAtomic(const char *path, const SaveFileHeader *header, const Uint8 *data)
+{
+    char tmpPath[520];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *file = fopen(tmpPath, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible de créer la sauvegarde %s\n", tmpPath);
+        return false;
+    }
+
+    bool ok = fwrite(header, sizeof(SaveFileHeader), 1, file) == 1 &&
+              fwrite(data, 1, header->stored_size, file) == header->stored_size &&
+              fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        fprintf(stderr, "Erreur d'écriture de la sauvegarde %s\n", path);
+        remove(tmpPath);
+        return false;
+    }
+
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash)
+        *slash = '\0';
+    else
+        snprintf(dir, sizeof(dir), ".");
+
+    int fd = open(dir, O_RDONLY);
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+}
+
+// Compression et écriture d'une demande (thread d'écriture, hors verrou)
+static void SaveWriter_Write(const char *path, const Uint8 *data, size_t size)
+{
+    uLongf storedSize = compressBound((uLong)size);
+    Uint8 *stored = Mem_Alloc(MEM_TAG_SAVE, storedSize);
+    if (!stored)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la sauvegarde.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Z_BEST_SPEED : les instantanés sont petits et répétitifs, le gain d'un
+    // niveau plus élevé ne vaut pas le temps passé
+    if (compress2(stored, &storedSize, data, (uLong)size, Z_BEST_SPEED) != Z_OK)
+    {
+        fprintf(stderr, "Erreur de compression de la sauvegarde %s\n", path);
+        Mem_Free(stored);
+        return;
+    }
+
+    SaveFileHeader header;
+    memcpy(header.magic, SAVE_FILE_MAGIC, 4);
+    header.raw_size = (Uint32)size;
+    header.stored_size = (Uint32)storedSize;
+    header.checksum = (Uint32)adler32(adler32(0L, Z_NULL, 0), data, (uInt)size);
+
+    SaveWriter_WriteAtomic(path, &header, stored);
+    Mem_Free(stored);
+}
+
+static int SaveWriter_Thread(void *data)
+{
+    SaveWriter *writer = (SaveWriter *)data;
+    Uint8 *buffer = NULL;
+    size_t capacity = 0;
+    char path[512];
+
+    SDL_LockMutex(writer->mutex);
+    while (true)
+    {
+        if (!writer->hasPending)
+        {
+            if (writer->quit)
+                break;
+            SDL_CondWait(writer->cond, writer->mutex);
+            continue;
+        }
+
+        // Copie locale : le thread principal peut déjà soumettre la suivante
+        if (capacity < writer->pendingSize)
+        {
+            buffer = Mem_Realloc(MEM_TAG_SAVE, buffer, writer->pendingSize);
+            if (!buffer)
+            {
+                fprintf(stderr, "Erreur d'allocation mémoire pour la sauvegarde.\n");
+                exit(EXIT_FAILURE);
+            }
+            capacity = writer->pendingSize;
+        }
+        size_t size = writer->pendingSize;
+        memcpy(buffer, writer->pending, size);
+        memcpy(path, writer->pendingPath, sizeof(path));
+        writer->hasPending = false;
+        writer->busy = true;
+
+        SDL_UnlockMutex(writer->mutex);
+        SaveWriter_Write(path, buffer, size);
+        SDL_LockMutex(writer->mutex);
+
+        writer->busy = false;
+    }
+    SDL_UnlockMutex(writer->mutex);
+
+    Mem_Free(buffer);
+    return 0;
+}
+
+SaveWriter *SaveWriter_Create(void)
+{
+    SaveWriter *writer = calloc(1, sizeof(SaveWriter));
+    if (!writer)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour l'écriture des sauvegardes.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    writer->mutex = SDL_CreateMutex();
+    writer->cond = SDL_CreateCond();
+    if (!writer->mutex || !writer->cond)
+    {
+        fprintf(stderr, "Erreur de création des primitives de synchronisation: %s\n", SDL_GetError());
+        SaveWriter_Free(writer);
+        return NULL;
+    }
+
+    writer->thread = SDL_CreateThread(SaveWriter_Thread, "save", writer);
+    if (!writer->thread)
+    {
+        fprintf(stderr, "Erreur de création du thread de sauvegarde: %s\n", SDL_GetError());
+        SaveWriter_Free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void SaveWriter_Free(SaveWriter *writer)
+{
+    if (!writer)
+        return;
+
+    if (writer->thread)
+    {
+        // Le thread termine la demande en attente avant de sortir
+        SDL_LockMutex(writer->mutex);
+        writer->quit = true;
+        SDL_CondSignal(writer->cond);
+        SDL_UnlockMutex(writer->mutex);
+        SDL_WaitThread(writer->thread, NULL);
+    }
+
+    Mem_Free(writer->pending);
+    if (writer->cond)
+        SDL_DestroyCond(writer->cond);
+    if (writer->mutex)
+        SDL_DestroyMutex(writer->mutex);
+    free(writer);
+}
+
+bool SaveWriter_Submit(SaveWriter *writer, const char *path, const void *data, size_t size)
+{
+    if (!writer || size == 0)
+        return false;
+
+    SDL_LockMutex(writer->mutex);
+    if (writer->pendingCapacity < size)
+    {
+        Uint8 *pending = Mem_Realloc(MEM_TAG_SAVE, writer->pending, size);
+        if (!pending)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour la sauvegarde.\n");
+            exit(EXIT_FAILURE);
+        }
+        writer->pending = pending;
+        writer->pendingCapacity = size;
+    }
+
+    // Remplace une demande pas encore prise : seule la plus récente compte
+    memcpy(writer->pending, data, size);
+    writer->pendingSize = size;
+    snprintf(writer->pendingPath, sizeof(writer->pendingPath), "%s", path);
+    writer->hasPending = true;
+    SDL_CondSignal(writer->cond);
+    SDL_UnlockMutex(writer->mutex);
+    return true;
+}
+
+bool SaveWriter_IsIdle(SaveWriter *writer)
+{
+    SDL_LockMutex(writer->mutex);
+    bool idle = !writer->hasPending && !writer->busy;
+    SDL_UnlockMutex(writer->mutex);
+    return idle;
+}
+
+Uint8 *SaveWriter_ReadFile(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Sauvegarde introuvable: %s\n", path);
+        return NULL;
+    }
+
+    SaveFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, SAVE_FILE_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "%s n'est pas un fichier de sauvegarde\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    // Les tailles viennent du fichier : bornées avant d'allouer quoi que ce soit
+    long fileSize = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+        fileSize = ftell(file);
+    if (fileSize < (long)sizeof(header) || fseek(file, sizeof(header), SEEK_SET) != 0 ||
+        header.stored_size > (Uint64)fileSize - sizeof(header) || header.raw_size > SAVE_FILE_MAX_RAW_SIZE)
+    {
+        fprintf(stderr, "Sauvegarde corrompue (tailles invalides): %s\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    Uint8 *stored = Mem_Alloc(MEM_TAG_SAVE, header.stored_size ? header.stored_size : 1);
+    Uint8 *data = Mem_Alloc(MEM_TAG_SAVE, header.raw_size ? header.raw_size : 1);
+    if (!stored || !data)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la sauvegarde %s\n", path);
+        Mem_Free(stored);
+        Mem_Free(data);
+        fclose(file);
+        return NULL;
+    }
+
+    uLongf rawSize = header.raw_size;
+    bool ok = fread(stored, 1, header.stored_size, file) == header.stored_size &&
+              uncompress(data, &rawSize, stored, header.stored_size) == Z_OK &&
+              rawSize == header.raw_size &&
+              (Uint32)adler32(adler32(0L, Z_NULL, 0), data, (uInt)rawSize) == header.checksum;
+    fclose(file);
+    Mem_Free(stored);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Sauvegarde corrompue: %s\n", path);
+        Mem_Free(data);
+        return NULL;
+    }
+
+    *size = rawSize;
+    return data;
+}
@@ -0,0 +1,53 @@
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Écriture des sauvegardes sur un thread dédié : compression zlib, fichier
+// temporaire, fsync puis renommage atomique. Le thread principal ne fait que
+// copier le tampon. Une seule écriture attend à la fois : une sauvegarde plus
+// récente remplace celle qui n'a pas encore commencé.
+
+#define SAVE_FILE_MAGIC "PKSZ"
+
+typedef struct
+{
+    char magic[4];
+    Uint32 raw_size;    // Taille décompressée
+    Uint32 stored_size; // Taille compressée qui suit l'en-tête
+    Uint32 checksum;    // adler32 des données décompressées
+} SaveFileHeader;
+
+// Une sauvegarde plus grande est refusée à la lecture (en-tête corrompu)
+#define SAVE_FILE_MAX_RAW_SIZE (64u << 20)
+
+typedef struct SaveWriter
+{
+    SDL_Thread *thread;
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+
+    // Demande en attente (protégée par mutex)
+    Uint8 *pending;
+    size_t pendingSize;
+    size_t pendingCapacity;
+    char pendingPath[512];
+    bool hasPending;
+    bool busy; // Écriture en cours sur le thread
+    bool quit;
+} SaveWriter;
+
+SaveWriter *SaveWriter_Create(void);
+void SaveWriter_Free(SaveWriter *writer); // Termine d'abord l'écriture demandée
+
+// Copie `data` et programme son écriture dans `path`
+bool SaveWriter_Submit(SaveWriter *writer, const char *path, const void *data, size_t size);
+bool SaveWriter_IsIdle(SaveWriter *writer);
+
+// Lecture bloquante d'une sauvegarde : données décompressées (Mem_Free) ou
+// NULL si le fichier est absent, corrompu ou trop grand
+Uint8 *SaveWriter_ReadFile(const char *path, size_t *size);
+
+#endif // SAVEWRITER_H
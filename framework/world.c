@@ -0,0 +1,290 @@
+#include "world.h"
+#include "memtrack.h"
+#include "pack.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Lecture du .world ---
+// Sous-ensemble du JSON écrit par Tiled : {"maps": [{"fileName": "...",
+// "x": 0, "y": 0, "width": 480, "height": 480}, ...], ...}. Les motifs
+// ("patterns") ne sont pas pris en charge.
+
+static const char *World_SkipSpaces(const char *c)
+{
+    while (*c && isspace((unsigned char)*c))
+        c++;
+    return c;
+}
+
+// Chaîne JSON à partir du guillemet ouvrant ; les échappements sont gardés tels quels
+static const char *World_ReadString(const char *c, char *out, size_t size)
+{
+    if (*c != '"')
+        return NULL;
+    c++;
+
+    size_t length = 0;
+    while (*c && *c != '"')
+    {
+        if (*c == '\\' && c[1])
+            c++;
+        if (length + 1 < size)
+            out[length++] = *c;
+        c++;
+    }
+    out[length] = '\0';
+    return *c == '"' ? c + 1 : NULL;
+}
+
+// Une entrée de "maps" : les membres inconnus sont ignorés
+static const char *World_ReadMap(const char *c, WorldMap *map)
+{
+    memset(map, 0, sizeof(WorldMap));
+    c = World_SkipSpaces(c);
+    if (*c != '{')
+        return NULL;
+    c++;
+
+    char file[256] = "";
+    while (c && *(c = World_SkipSpaces(c)) != '}')
+    {
+        char key[32];
+        c = World_ReadString(c, key, sizeof(key));
+        if (!c || *(c = World_SkipSpaces(c)) != ':')
+            return NULL;
+        c = World_SkipSpaces(c + 1);
+
+        char *end;
+        if (strcmp(key, "fileName") == 0)
+        {
+            c = World_ReadString(c, file, sizeof(file));
+        }
+        else if (*c == '"')
+        {
+            char ignored[256];
+            c = World_ReadString(c, ignored, sizeof(ignored));
+        }
+        else
+        {
+            long value = strtol(c, &end, 10);
+            if (end == c)
+                return NULL;
+            c = end;
+            if (strcmp(key, "x") == 0)
+                map->x = (int)value;
+            else if (strcmp(key, "y") == 0)
+                map->y = (int)value;
+            else if (strcmp(key, "width") == 0)
+                map->width = (int)value;
+            else if (strcmp(key, "height") == 0)
+                map->height = (int)value;
+        }
+
+        if (c && *(c = World_SkipSpaces(c)) == ',')
+            c++;
+    }
+    if (!c)
+        return NULL;
+
+    // Nom de cache : le fichier sans dossier ni extension (.tmx ou .cmap, voir MapManager)
+    const char *base = strrchr(file, '/');
+    snprintf(map->name, sizeof(map->name), "%s", base ? base + 1 : file);
+    char *extension = strrchr(map->name, '.');
+    if (extension)
+        *extension = '\0';
+
+    return map->name[0] != '\0' && map->width > 0 && map->height > 0 ? c + 1 : NULL;
+}
+
+World *World_Load(const char *path)
+{
+    char *text = Asset_LoadFile(path, NULL);
+    if (!text)
+        return NULL;
+
+    const char *c = strstr(text, "\"maps\"");
+    c = c ? strchr(c, '[') : NULL;
+    if (!c)
+    {
+        fprintf(stderr, "Monde %s : liste \"maps\" absente\n", path);
+        Mem_Free(text);
+        return NULL;
+    }
+
+    World *world = Mem_Calloc(MEM_TAG_MAP, 1, sizeof(World));
+    if (!world)
+    {
+        Mem_Free(text);
+        return NULL;
+    }
+
+    int capacity = 0;
+    c = World_SkipSpaces(c + 1);
+    while (c && *c != ']')
+    {
+        if (world->count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 16;
+            WorldMap *maps = Mem_Realloc(MEM_TAG_MAP, world->maps, capacity * sizeof(WorldMap));
+            if (!maps)
+            {
+                fprintf(stderr, "Erreur d'allocation mémoire pour le monde.\n");
+                exit(EXIT_FAILURE);
+            }
+            world->maps = maps;
+        }
+
+        c = World_ReadMap(c, &world->maps[world->count]);
+        if (!c)
+            break;
+        world->count++;
+
+        c = World_SkipSpaces(c);
+        if (*c == ',')
+            c = World_SkipSpaces(c + 1);
+    }
+    Mem_Free(text);
+
+    if (!c)
+    {
+        fprintf(stderr, "Monde %s : entrée %d illisible\n", path, world->count);
+        World_Free(world);
+        return NULL;
+    }
+
+    printf("Monde %s : %d maps\n", path, world->count);
+    return world;
+}
+
+void World_Free(World *world)
+{
+    if (!world)
+        return;
+    Mem_Free(world->maps);
+    Mem_Free(world);
+}
+
+int World_Find(const World *world, const char *map_name)
+{
+    if (!world || !map_name)
+        return -1;
+
+    for (int i = 0; i < world->count; i++)
+    {
+        if (strcmp(world->maps[i].name, map_name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int World_Locate(const World *world, int origin, int x, int y, int *dx, int *dy)
+{
+    if (!world || origin < 0)
+        return -1;
+
+    int world_x = world->maps[origin].x + x, world_y = world->maps[origin].y + y;
+    for (int i = 0; i < world->count; i++)
+    {
+        const WorldMap *map = &world->maps[i];
+        if (world_x >= map->x && world_y >= map->y && world_x < map->x + map->width && world_y < map->y + map->height)
+        {
+            *dx = map->x - world->maps[origin].x;
+            *dy = map->y - world->maps[origin].y;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Maps dont le rectangle touche `area` (coordonnées de `origin`) agrandie de `distance`
+static bool World_IsNear(const World *world, int origin, int index, const SDL_Rect *area, int distance)
+{
+    const WorldMap *from = &world->maps[origin], *map = &world->maps[index];
+    SDL_Rect zone = {from->x + area->x - distance, from->y + area->y - distance, area->w + 2 * distance,
+                     area->h + 2 * distance};
+    SDL_Rect bounds = {map->x, map->y, map->width, map->height};
+    return SDL_HasIntersection(&zone, &bounds);
+}
+
+// Écart entre la zone (coordonnées de `origin`) et la map `index`, 0 si elles se touchent
+static int World_Gap(const World *world, int origin, int index, const SDL_Rect *area)
+{
+    const WorldMap *from = &world->maps[origin], *map = &world->maps[index];
+    int left = from->x + area->x, top = from->y + area->y;
+
+    int gap_x = map->x - (left + area->w);
+    if (left - (map->x + map->width) > gap_x)
+        gap_x = left - (map->x + map->width);
+    int gap_y = map->y - (top + area->h);
+    if (top - (map->y + map->height) > gap_y)
+        gap_y = top - (map->y + map->height);
+
+    int gap = gap_x > gap_y ? gap_x : gap_y;
+    return gap > 0 ? gap : 0;
+}
+
+void World_Preload(const World *world, MapManager *maps, int origin, const SDL_Rect *area, int max)
+{
+    if (!world || origin < 0 || !area || max <= 0)
+        return;
+    if (max > MAP_MAX_NEIGHBOURS)
+        max = MAP_MAX_NEIGHBOURS;
+
+    const WorldMap *from = &world->maps[origin];
+    int distance = (from->width < from->height ? from->width : from->height) / WORLD_PRELOAD_FRACTION;
+
+    // Les plus proches d'abord, par insertion
+    int nearest[MAP_MAX_NEIGHBOURS], gaps[MAP_MAX_NEIGHBOURS];
+    int count = 0;
+    for (int i = 0; i < world->count; i++)
+    {
+        if (i == origin)
+            continue;
+        int gap = World_Gap(world, origin, i, area);
+        if (gap > distance || (count == max && gap >= gaps[count - 1]))
+            continue;
+
+        int slot = count < max ? count++ : count - 1;
+        while (slot > 0 && gaps[slot - 1] > gap)
+        {
+            nearest[slot] = nearest[slot - 1];
+            gaps[slot] = gaps[slot - 1];
+            slot--;
+        }
+        nearest[slot] = i;
+        gaps[slot] = gap;
+    }
+
+    for (int i = 0; i < count; i++)
+        MapManager_Preload(maps, world->maps[nearest[i]].name);
+}
+
+void World_Link(const World *world, MapManager *maps, int origin, Map *map, int distance)
+{
+    if (!map)
+        return;
+
+    map->neighbour_count = 0;
+    map->in_world = world && origin >= 0;
+    if (!map->in_world)
+        return;
+
+    SDL_Rect bounds = {0, 0, world->maps[origin].width, world->maps[origin].height};
+    for (int i = 0; i < world->count && map->neighbour_count < MAP_MAX_NEIGHBOURS; i++)
+    {
+        if (i == origin || !World_IsNear(world, origin, i, &bounds, distance))
+            continue;
+
+        // MapManager_Get ne charge rien : une voisine pas encore prête sera reliée plus tard
+        Map *neighbour = MapManager_Get(maps, world->maps[i].name);
+        if (!neighbour)
+            continue;
+
+        MapNeighbour *link = &map->neighbours[map->neighbour_count++];
+        link->map = neighbour;
+        link->dx = world->maps[i].x - world->maps[origin].x;
+        link->dy = world->maps[i].y - world->maps[origin].y;
+    }
+}
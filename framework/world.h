@@ -0,0 +1,52 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "map.h"
+#include "mapmanager.h"
+
+// Monde : maps placées côte à côte par un fichier .world de Tiled (liste de
+// maps avec leur position et leur taille en pixels). Le jeu reste dans les
+// coordonnées de la map courante : une voisine y est vue décalée de la
+// différence de leurs positions. Les voisines proches du joueur sont
+// préchargées par le cache de maps ; celles qui sont prêtes sont reliées à
+// la map courante (collisions et rendu au-delà du bord). Franchir un bord
+// change de map courante sans écran de chargement.
+
+typedef struct
+{
+    char name[64]; // Nom de la map (sans dossier ni extension)
+    int x, y;      // Position dans le monde, en pixels
+    int width, height;
+} WorldMap;
+
+typedef struct
+{
+    WorldMap *maps;
+    int count;
+} World;
+
+World *World_Load(const char *path); // NULL si absent ou illisible
+void World_Free(World *world);
+
+int World_Find(const World *world, const char *map_name); // -1 hors du monde
+
+// Map du monde sous le point (x, y), donné dans les coordonnées de la map
+// `origin` ; `dx`, `dy` : position de cette map dans ces coordonnées. -1 sinon.
+int World_Locate(const World *world, int origin, int x, int y, int *dx, int *dy);
+
+// Distance de préchargement : une fraction du plus petit côté de la map
+// courante (une demi-map : les voisines sont prêtes avant d'être atteintes)
+#define WORLD_PRELOAD_FRACTION 2
+
+// Précharge les `max` maps les plus proches de la zone (coordonnées de
+// `origin`), parmi celles à portée ; `max` ne doit pas dépasser ce que le
+// cache garde en plus de la map courante, sinon elles s'évinceraient entre elles
+void World_Preload(const World *world, MapManager *maps, int origin, const SDL_Rect *area, int max);
+
+// Relie `map` (la map `origin`) aux maps déjà chargées à moins de `distance`
+// pixels de ses bords
+void World_Link(const World *world, MapManager *maps, int origin, Map *map, int distance);
+
+#endif // WORLD_H
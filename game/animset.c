@@ -0,0 +1,331 @@
+#include "animset.h"
+#include "animsystem.h"
+#include <SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framework/pack.h"
+#include "../framework/hotreload.h"
+#include "../framework/memtrack.h"
+
+// Liste chaînée de tous les ensembles vivants, partagés (avec clé) ou privés
+// (peu d'entrées : une par disposition de feuille)
+static AnimationSet *registryHead = NULL;
+
+static void AnimSet_Destroy(AnimationSet *set)
+{
+    for (int i = 0; i < set->spriteSheetCount; ++i)
+    {
+        if (set->spriteSheets[i].texture)
+        {
+            Mem_DestroyTexture(MEM_TAG_ENTITY, set->spriteSheets[i].texture);
+        }
+    }
+    Mem_Free(set->spriteSheets);
+
+    for (int i = 0; i < set->animationCount; ++i)
+    {
+        Mem_Free(set->animations[i].frames);
+        Mem_Free(set->animations[i].events);
+    }
+    Mem_Free(set->animations);
+    AnimMachine_Free(set->machine);
+    Mem_Free(set);
+}
+
+static void AnimSet_Unregister(AnimationSet *set)
+{
+    AnimationSet **link = &registryHead;
+    while (*link)
+    {
+        if (*link == set)
+        {
+            *link = set->next;
+            set->next = NULL;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+AnimationSet *AnimSet_Get(const char *key)
+{
+    for (AnimationSet *set = registryHead; set; set = set->next)
+    {
+        if (set->key[0] != '\0' && strcmp(set->key, key) == 0)
+        {
+            return set;
+        }
+    }
+    return NULL;
+}
+
+AnimationSet *AnimSet_Create(void)
+{
+    AnimationSet *set = Mem_Calloc(MEM_TAG_ENTITY, 1, sizeof(AnimationSet));
+    if (!set)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour l'ensemble d'animations.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Chaîné même sans clé, pour que le rechargement à chaud le retrouve
+    set->next = registryHead;
+    registryHead = set;
+    return set;
+}
+
+AnimationSet *AnimSet_Register(const char *key)
+{
+    AnimationSet *set = AnimSet_Get(key);
+    if (set)
+    {
+        return set;
+    }
+
+    set = AnimSet_Create();
+    strncpy(set->key, key, sizeof(set->key) - 1);
+    set->key[sizeof(set->key) - 1] = '\0';
+    return set;
+}
+
+void AnimSet_Retain(AnimationSet *set)
+{
+    if (set)
+    {
+        set->refCount++;
+    }
+}
+
+void AnimSet_Release(AnimationSet *set)
+{
+    if (!set)
+        return;
+
+    set->refCount--;
+    if (set->refCount > 0)
+        return;
+
+    // Plus aucune entité ne l'utilise : on le retire du registre et on libère
+    AnimSet_Unregister(set);
+    AnimSet_Destroy(set);
+}
+
+void AnimSet_MakeKey(char *out, size_t size, const char *spriteSheetPath, int spriteWidth, int spriteHeight)
+{
+    snprintf(out, size, "%s#%dx%d", spriteSheetPath, spriteWidth, spriteHeight);
+}
+
+int AnimSet_FindAnimation(const AnimationSet *set, const char *animationName)
+{
+    if (!set)
+        return -1;
+
+    for (int i = 0; i < set->animationCount; ++i)
+    {
+        if (strcmp(set->animations[i].name, animationName) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int AnimSet_FindSpriteSheet(const AnimationSet *set, const char *spriteSheetName)
+{
+    if (!set)
+        return -1;
+
+    for (int i = 0; i < set->spriteSheetCount; ++i)
+    {
+        if (strcmp(set->spriteSheets[i].name, spriteSheetName) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool AnimSet_AddSpriteSheet(AnimationSet *set, SDL_Renderer *renderer,
+                            const char *spriteSheetPath, const char *name,
+                            int spriteWidth, int spriteHeight)
+{
+    SDL_Surface *surface = Asset_LoadImage(spriteSheetPath);
+    if (!surface)
+    {
+        fprintf(stderr, "Erreur de chargement de la feuille de sprites %s: %s\n", spriteSheetPath, IMG_GetError());
+        return false;
+    }
+
+    bool ok = AnimSet_AddSpriteSheetFromSurface(set, renderer, surface, spriteSheetPath, name, spriteWidth, spriteHeight);
+    SDL_FreeSurface(surface);
+    return ok;
+}
+
+// Variante utilisée quand l'image a déjà été décodée (ex : par le loader en arrière-plan).
+// La surface reste la propriété de l'appelant.
+bool AnimSet_AddSpriteSheetFromSurface(AnimationSet *set, SDL_Renderer *renderer,
+                                       SDL_Surface *surface, const char *sourcePath,
+                                       const char *name, int spriteWidth, int spriteHeight)
+{
+    if (AnimSet_FindSpriteSheet(set, name) != -1)
+    {
+        fprintf(stderr, "Une feuille de sprites avec le nom '%s' existe déjà pour cet ensemble.\n", name);
+        return false;
+    }
+
+    // Sans renderer (simulation headless), seules les dimensions de la feuille servent
+    SDL_Texture *texture = renderer ? Mem_CreateTextureFromSurface(MEM_TAG_ENTITY, renderer, surface) : NULL;
+    if (!texture && renderer)
+    {
+        fprintf(stderr, "Erreur de création de la texture pour '%s': %s\n", name, SDL_GetError());
+        return false;
+    }
+
+    // Réallouer le tableau de spriteSheets
+    SpriteSheet *sheets = Mem_Realloc(MEM_TAG_ENTITY, set->spriteSheets, (set->spriteSheetCount + 1) * sizeof(SpriteSheet));
+    if (!sheets)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les feuilles de sprites.\n");
+        exit(EXIT_FAILURE);
+    }
+    set->spriteSheets = sheets;
+
+    SpriteSheet *newSheet = &set->spriteSheets[set->spriteSheetCount++];
+    strncpy(newSheet->name, name, sizeof(newSheet->name) - 1);
+    newSheet->name[sizeof(newSheet->name) - 1] = '\0';
+    snprintf(newSheet->path, sizeof(newSheet->path), "%s", sourcePath ? sourcePath : "");
+    newSheet->texture = texture;
+    newSheet->sheetWidth = surface->w;
+    newSheet->sheetHeight = surface->h;
+    newSheet->spriteWidth = spriteWidth;
+    newSheet->spriteHeight = spriteHeight;
+
+    return true;
+}
+
+bool AnimSet_AddAnimation(AnimationSet *set, const char *animationName,
+                          const char *spriteSheetName,
+                          int startRow, int startCol, int frameCount,
+                          int frameDurationMs, bool loop)
+{
+    if (AnimSet_FindAnimation(set, animationName) != -1)
+    {
+        fprintf(stderr, "L'animation '%s' existe déjà pour cet ensemble.\n", animationName);
+        return false;
+    }
+
+    int spriteSheetIdx = AnimSet_FindSpriteSheet(set, spriteSheetName);
+    if (spriteSheetIdx == -1)
+    {
+        fprintf(stderr, "Erreur: La feuille de sprites '%s' n'existe pas. Impossible d'ajouter l'animation '%s'.\n", spriteSheetName, animationName);
+        return false;
+    }
+
+    // Réallouer le tableau d'animations
+    Animation *animations = Mem_Realloc(MEM_TAG_ENTITY, set->animations, (set->animationCount + 1) * sizeof(Animation));
+    if (!animations)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les animations.\n");
+        exit(EXIT_FAILURE);
+    }
+    set->animations = animations;
+
+    Animation *newAnim = &set->animations[set->animationCount++];
+    strncpy(newAnim->name, animationName, sizeof(newAnim->name) - 1);
+    newAnim->name[sizeof(newAnim->name) - 1] = '\0';
+    newAnim->frameCount = frameCount;
+    newAnim->frameDurationMs = frameDurationMs;
+    newAnim->loop = loop;
+    newAnim->spriteSheetIndex = spriteSheetIdx;
+    newAnim->events = NULL;
+    newAnim->eventCount = 0;
+
+    newAnim->frames = (Frame *)Mem_Alloc(MEM_TAG_ENTITY, frameCount * sizeof(Frame));
+    if (!newAnim->frames)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les cadres de l'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    SpriteSheet *usedSheet = &set->spriteSheets[spriteSheetIdx];
+
+    for (int i = 0; i < frameCount; ++i)
+    {
+        newAnim->frames[i].x = (startCol + i) * usedSheet->spriteWidth;
+        newAnim->frames[i].y = startRow * usedSheet->spriteHeight;
+        newAnim->frames[i].w = usedSheet->spriteWidth;
+        newAnim->frames[i].h = usedSheet->spriteHeight;
+
+        // Assurez-vous que les cadres ne dépassent pas la taille de la feuille de sprites
+        if (newAnim->frames[i].x + newAnim->frames[i].w > usedSheet->sheetWidth ||
+            newAnim->frames[i].y + newAnim->frames[i].h > usedSheet->sheetHeight)
+        {
+            fprintf(stderr, "Avertissement: Le cadre %d de l'animation '%s' dépasse la feuille de sprites '%s'.\n", i, animationName, usedSheet->name);
+        }
+    }
+
+    return true;
+}
+
+bool AnimSet_AddFrameEvent(AnimationSet *set, const char *animationName, int frame, int eventId)
+{
+    int index = AnimSet_FindAnimation(set, animationName);
+    if (index == -1 || frame < 0 || frame >= set->animations[index].frameCount)
+    {
+        fprintf(stderr, "Erreur: événement sur un cadre inexistant (%s, cadre %d).\n", animationName, frame);
+        return false;
+    }
+
+    Animation *animation = &set->animations[index];
+    AnimFrameEvent *events = Mem_Realloc(MEM_TAG_ENTITY, animation->events, (animation->eventCount + 1) * sizeof(AnimFrameEvent));
+    if (!events)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les événements d'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+    animation->events = events;
+    animation->events[animation->eventCount].frame = frame;
+    animation->events[animation->eventCount].eventId = eventId;
+    animation->eventCount++;
+    return true;
+}
+
+int AnimSet_ReloadImage(SDL_Renderer *renderer, const char *imagePath)
+{
+    int reloaded = 0;
+
+    for (AnimationSet *set = registryHead; set; set = set->next)
+    {
+        for (int i = 0; i < set->spriteSheetCount; ++i)
+        {
+            SpriteSheet *sheet = &set->spriteSheets[i];
+            if (sheet->path[0] == '\0' || !HotReload_SamePath(sheet->path, imagePath))
+                continue;
+
+            SDL_Surface *surface = Asset_LoadImage(sheet->path);
+            if (!surface)
+            {
+                fprintf(stderr, "Erreur de rechargement de la feuille de sprites %s: %s\n", sheet->path, IMG_GetError());
+                continue;
+            }
+
+            SDL_Texture *texture = Mem_CreateTextureFromSurface(MEM_TAG_ENTITY, renderer, surface);
+            if (texture)
+            {
+                // Les frames restent valides tant que la disposition de la feuille ne change pas
+                if (surface->w != sheet->sheetWidth || surface->h != sheet->sheetHeight)
+                    fprintf(stderr, "Avertissement: la feuille '%s' a changé de taille, les frames existantes sont conservées.\n", sheet->path);
+
+                Mem_DestroyTexture(MEM_TAG_ENTITY, sheet->texture);
+                sheet->texture = texture;
+                sheet->sheetWidth = surface->w;
+                sheet->sheetHeight = surface->h;
+                reloaded++;
+            }
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    return reloaded;
+}
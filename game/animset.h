@@ -0,0 +1,87 @@
+#ifndef ANIMSET_H
+#define ANIMSET_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+// --- Structures pour l'animation ---
+typedef struct
+{
+    int x, y, w, h;
+} Frame;
+
+// Événement déclenché à l'entrée d'un cadre (voir AnimEventId dans animsystem.h)
+typedef struct
+{
+    int frame;
+    int eventId;
+} AnimFrameEvent;
+
+typedef struct
+{
+    Frame *frames;
+    int frameCount;
+    int frameDurationMs;  // Durée de chaque frame en millisecondes
+    bool loop;            // Indique si l'animation doit boucler
+    char name[64];        // Nom de l'animation (ex: "idle_down", "walk_left")
+    int spriteSheetIndex; // Index de la feuille de sprites à utiliser pour cette animation
+    AnimFrameEvent *events;
+    int eventCount;
+} Animation;
+
+typedef struct
+{
+    SDL_Texture *texture;
+    int sheetWidth;
+    int sheetHeight;
+    int spriteWidth;  // Largeur d'un sprite sur la feuille
+    int spriteHeight; // Hauteur d'un sprite sur la feuille
+    char name[64];    // Nom de la feuille de sprites (pour référence)
+    char path[256];   // Image source, pour le rechargement à chaud (vide si inconnue)
+} SpriteSheet;
+
+// Ensemble d'animations immuable (poids-mouche) : feuilles de sprites, frames,
+// durées et boucles. Construit une seule fois par disposition de feuille puis
+// référencé par pointeur par toutes les entités qui l'utilisent.
+typedef struct AnimationSet
+{
+    char key[256];           // Clé dans le registre (vide si ensemble privé, non partageable)
+    SpriteSheet *spriteSheets;
+    int spriteSheetCount;
+    Animation *animations;
+    int animationCount;
+    struct AnimStateMachine *machine; // Machine à états partagée (NULL si aucune)
+    int refCount;            // Nombre d'entités qui référencent l'ensemble
+    struct AnimationSet *next;
+} AnimationSet;
+
+// Registre des ensembles partagés
+AnimationSet *AnimSet_Get(const char *key);
+AnimationSet *AnimSet_Register(const char *key);
+AnimationSet *AnimSet_Create(void);
+void AnimSet_Retain(AnimationSet *set);
+void AnimSet_Release(AnimationSet *set);
+void AnimSet_MakeKey(char *out, size_t size, const char *spriteSheetPath, int spriteWidth, int spriteHeight);
+
+// Construction (uniquement avant le premier partage)
+bool AnimSet_AddSpriteSheet(AnimationSet *set, SDL_Renderer *renderer,
+                            const char *spriteSheetPath, const char *name,
+                            int spriteWidth, int spriteHeight);
+bool AnimSet_AddSpriteSheetFromSurface(AnimationSet *set, SDL_Renderer *renderer,
+                                       SDL_Surface *surface, const char *sourcePath,
+                                       const char *name, int spriteWidth, int spriteHeight);
+bool AnimSet_AddAnimation(AnimationSet *set, const char *animationName,
+                          const char *spriteSheetName,
+                          int startRow, int startCol, int frameCount,
+                          int frameDurationMs, bool loop);
+
+bool AnimSet_AddFrameEvent(AnimationSet *set, const char *animationName, int frame, int eventId);
+
+int AnimSet_FindAnimation(const AnimationSet *set, const char *animationName);
+int AnimSet_FindSpriteSheet(const AnimationSet *set, const char *spriteSheetName);
+
+// Rechargement à chaud : remplace la texture de toutes les feuilles issues de
+// cette image (les frames sont conservées). Retourne le nombre de feuilles.
+int AnimSet_ReloadImage(SDL_Renderer *renderer, const char *imagePath);
+
+#endif // ANIMSET_H
@@ -0,0 +1,443 @@
+#include "animsystem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../framework/memtrack.h"
+
+// Tableau dense des lectures + table handle -> index (ensemble creux), pour
+// que la passe de mise à jour parcoure une mémoire contiguë sans trous
+static struct
+{
+    AnimPlayback *playbacks;
+    int count;
+    int capacity;
+
+    int *handleToIndex; // -1 si le handle est libre
+    int handleCapacity;
+    AnimHandle *freeHandles;
+    int freeCount;
+
+    AnimEventRecord *events;
+    int eventCount;
+    int eventCapacity;
+} animSystem = {0};
+
+// --- Machines à états ---
+
+AnimStateMachine *AnimMachine_Create(void)
+{
+    AnimStateMachine *machine = Mem_Calloc(MEM_TAG_ENTITY, 1, sizeof(AnimStateMachine));
+    if (!machine)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la machine à états.\n");
+        exit(EXIT_FAILURE);
+    }
+    return machine;
+}
+
+void AnimMachine_Free(AnimStateMachine *machine)
+{
+    if (!machine)
+        return;
+
+    Mem_Free(machine->states);
+    Mem_Free(machine->transitions);
+    Mem_Free(machine);
+}
+
+int AnimMachine_AddState(AnimStateMachine *machine, const AnimationSet *set, const char *name,
+                         const char *animationName, float referenceSpeed)
+{
+    int animationIndex = AnimSet_FindAnimation(set, animationName);
+    if (animationIndex == -1)
+    {
+        fprintf(stderr, "Erreur: l'animation '%s' n'existe pas, état '%s' ignoré.\n", animationName, name);
+        return -1;
+    }
+
+    AnimState *states = Mem_Realloc(MEM_TAG_ENTITY, machine->states, (machine->stateCount + 1) * sizeof(AnimState));
+    if (!states)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les états d'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+    machine->states = states;
+
+    AnimState *state = &machine->states[machine->stateCount];
+    snprintf(state->name, sizeof(state->name), "%s", name);
+    state->animationIndex = animationIndex;
+    state->referenceSpeed = referenceSpeed;
+    return machine->stateCount++;
+}
+
+int AnimMachine_FindState(const AnimStateMachine *machine, const char *name)
+{
+    for (int i = 0; i < machine->stateCount; i++)
+    {
+        if (strcmp(machine->states[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+bool AnimMachine_AddTransition(AnimStateMachine *machine, int from, int to,
+                               const AnimCondition *conditions, int conditionCount)
+{
+    if (to < 0 || to >= machine->stateCount || from >= machine->stateCount ||
+        (from < 0 && from != ANIM_ANY_STATE) || conditionCount > ANIM_MAX_CONDITIONS)
+    {
+        fprintf(stderr, "Erreur: transition d'animation invalide (%d -> %d).\n", from, to);
+        return false;
+    }
+
+    AnimTransition *transitions = Mem_Realloc(MEM_TAG_ENTITY, machine->transitions, (machine->transitionCount + 1) * sizeof(AnimTransition));
+    if (!transitions)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les transitions d'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+    machine->transitions = transitions;
+
+    AnimTransition *transition = &machine->transitions[machine->transitionCount++];
+    memset(transition, 0, sizeof(AnimTransition));
+    transition->from = from;
+    transition->to = to;
+    transition->conditionCount = conditionCount;
+    for (int i = 0; i < conditionCount; i++)
+    {
+        transition->conditions[i] = conditions[i];
+    }
+    return true;
+}
+
+static bool AnimMachine_ConditionHolds(const AnimCondition *condition, const AnimPlayback *playback)
+{
+    float value = playback->params[condition->param];
+    switch (condition->type)
+    {
+    case ANIM_COND_FINISHED:
+        return playback->finished;
+    case ANIM_COND_PARAM_GREATER:
+        return value > condition->value;
+    case ANIM_COND_PARAM_LESS:
+        return value < condition->value;
+    case ANIM_COND_PARAM_EQUAL:
+        return fabsf(value - condition->value) < 0.5f;
+    }
+    return false;
+}
+
+// --- Handles ---
+
+static void AnimSystem_Grow(void **array, int *capacity, int needed, size_t elementSize)
+{
+    if (needed <= *capacity)
+        return;
+
+    int newCapacity = *capacity ? *capacity * 2 : 64;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+
+    void *grown = Mem_Realloc(MEM_TAG_ENTITY, *array, newCapacity * elementSize);
+    if (!grown)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour le système d'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+    *array = grown;
+    *capacity = newCapacity;
+}
+
+AnimPlayback *AnimSystem_Get(AnimHandle handle)
+{
+    if (handle < 0 || handle >= animSystem.handleCapacity)
+        return NULL;
+
+    int index = animSystem.handleToIndex[handle];
+    return index < 0 ? NULL : &animSystem.playbacks[index];
+}
+
+static void AnimSystem_EmitFrameEvents(AnimPlayback *playback, const Animation *animation)
+{
+    for (int i = 0; i < animation->eventCount; i++)
+    {
+        if (animation->events[i].frame != playback->frameIndex)
+            continue;
+
+        AnimSystem_Grow((void **)&animSystem.events, &animSystem.eventCapacity,
+                        animSystem.eventCount + 1, sizeof(AnimEventRecord));
+        AnimEventRecord *record = &animSystem.events[animSystem.eventCount++];
+        record->handle = playback->handle;
+        record->owner = playback->owner;
+        record->eventId = animation->events[i].eventId;
+    }
+}
+
+static void AnimSystem_Start(AnimPlayback *playback, int animationIndex)
+{
+    playback->animationIndex = animationIndex;
+    playback->frameIndex = 0;
+    playback->timeMs = 0.0f;
+    playback->finished = false;
+
+    if (playback->set && animationIndex >= 0 && animationIndex < playback->set->animationCount)
+        AnimSystem_EmitFrameEvents(playback, &playback->set->animations[animationIndex]);
+}
+
+static void AnimSystem_ResetSet(AnimPlayback *playback, const AnimationSet *set)
+{
+    playback->set = set;
+    playback->state = -1;
+    playback->animationIndex = -1;
+    playback->finished = false;
+
+    const AnimStateMachine *machine = set ? set->machine : NULL;
+    if (machine && machine->stateCount > 0)
+    {
+        // Le premier état ajouté est l'état d'entrée
+        playback->state = 0;
+        AnimSystem_Start(playback, machine->states[0].animationIndex);
+    }
+    else if (set && set->animationCount > 0)
+    {
+        AnimSystem_Start(playback, 0);
+    }
+}
+
+// Agrandit la table des handles ; les nouveaux handles vont dans la liste libre
+// (qui a toujours la même capacité que la table)
+static void AnimSystem_GrowHandles(void)
+{
+    int oldCapacity = animSystem.handleCapacity;
+    AnimSystem_Grow((void **)&animSystem.handleToIndex, &animSystem.handleCapacity,
+                    oldCapacity + 1, sizeof(int));
+
+    AnimHandle *freeHandles = Mem_Realloc(MEM_TAG_ENTITY, animSystem.freeHandles, animSystem.handleCapacity * sizeof(AnimHandle));
+    if (!freeHandles)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour le système d'animation.\n");
+        exit(EXIT_FAILURE);
+    }
+    animSystem.freeHandles = freeHandles;
+
+    // Ordre décroissant pour attribuer les petits handles en premier
+    for (int i = animSystem.handleCapacity - 1; i >= oldCapacity; i--)
+    {
+        animSystem.handleToIndex[i] = -1;
+        animSystem.freeHandles[animSystem.freeCount++] = i;
+    }
+}
+
+AnimHandle AnimSystem_Create(const AnimationSet *set, void *owner)
+{
+    if (animSystem.freeCount == 0)
+        AnimSystem_GrowHandles();
+    AnimHandle handle = animSystem.freeHandles[--animSystem.freeCount];
+
+    AnimSystem_Grow((void **)&animSystem.playbacks, &animSystem.capacity,
+                    animSystem.count + 1, sizeof(AnimPlayback));
+
+    int index = animSystem.count++;
+    AnimPlayback *playback = &animSystem.playbacks[index];
+    memset(playback, 0, sizeof(AnimPlayback));
+    playback->handle = handle;
+    playback->owner = owner;
+    playback->rate = 1.0f;
+    playback->targetRate = 1.0f;
+    animSystem.handleToIndex[handle] = index;
+
+    AnimSystem_ResetSet(playback, set);
+    return handle;
+}
+
+void AnimSystem_Destroy(AnimHandle handle)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (!playback)
+        return;
+
+    // Retrait en O(1) : la dernière lecture prend la place libérée
+    int index = animSystem.handleToIndex[handle];
+    int last = --animSystem.count;
+    if (index != last)
+    {
+        animSystem.playbacks[index] = animSystem.playbacks[last];
+        animSystem.handleToIndex[animSystem.playbacks[index].handle] = index;
+    }
+
+    animSystem.handleToIndex[handle] = -1;
+    animSystem.freeHandles[animSystem.freeCount++] = handle;
+}
+
+void AnimSystem_SetSet(AnimHandle handle, const AnimationSet *set)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (playback)
+        AnimSystem_ResetSet(playback, set);
+}
+
+void AnimSystem_Play(AnimHandle handle, int animationIndex)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (!playback || !playback->set || animationIndex < 0 || animationIndex >= playback->set->animationCount)
+        return;
+
+    playback->paused = false;
+    AnimSystem_Start(playback, animationIndex);
+}
+
+void AnimSystem_SetPaused(AnimHandle handle, bool paused)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (playback)
+        playback->paused = paused;
+}
+
+void AnimSystem_SetRate(AnimHandle handle, float rate)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (playback)
+        playback->targetRate = rate;
+}
+
+void AnimSystem_SetParam(AnimHandle handle, AnimParam param, float value)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (playback && param >= 0 && param < ANIM_PARAM_COUNT)
+        playback->params[param] = value;
+}
+
+void AnimSystem_SetScripted(AnimHandle handle, bool scripted)
+{
+    AnimPlayback *playback = AnimSystem_Get(handle);
+    if (!playback || !playback->set || !playback->set->machine || playback->set->machine->stateCount == 0)
+        return;
+
+    const AnimStateMachine *machine = playback->set->machine;
+    if (scripted)
+    {
+        playback->state = -1;
+        playback->targetRate = 1.0f;
+    }
+    else if (playback->state < 0)
+    {
+        playback->state = 0;
+        AnimSystem_Start(playback, machine->states[0].animationIndex);
+    }
+}
+
+// --- Mise à jour groupée ---
+
+static void AnimSystem_UpdateMachine(AnimPlayback *playback)
+{
+    const AnimStateMachine *machine = playback->set->machine;
+
+    for (int i = 0; i < machine->transitionCount; i++)
+    {
+        const AnimTransition *transition = &machine->transitions[i];
+        if (transition->to == playback->state ||
+            (transition->from != ANIM_ANY_STATE && transition->from != playback->state))
+            continue;
+
+        bool holds = true;
+        for (int c = 0; c < transition->conditionCount && holds; c++)
+        {
+            holds = AnimMachine_ConditionHolds(&transition->conditions[c], playback);
+        }
+        if (!holds)
+            continue;
+
+        playback->state = transition->to;
+        AnimSystem_Start(playback, machine->states[transition->to].animationIndex);
+        break;
+    }
+
+    // La vitesse de lecture suit la vitesse de déplacement
+    float referenceSpeed = machine->states[playback->state].referenceSpeed;
+    if (referenceSpeed > 0.0f)
+        playback->targetRate = playback->params[ANIM_PARAM_SPEED] / referenceSpeed;
+}
+
+static void AnimSystem_Advance(AnimPlayback *playback, float deltaMs)
+{
+    const Animation *animation = &playback->set->animations[playback->animationIndex];
+    float duration = (float)animation->frameDurationMs;
+    if (duration <= 0.0f || animation->frameCount <= 0)
+        return;
+
+    playback->timeMs += deltaMs * playback->rate;
+
+    // Grosse pause (chargement, débogueur) : on ne rejoue pas des tours entiers
+    float cycle = duration * animation->frameCount;
+    if (animation->loop && playback->timeMs >= cycle)
+        playback->timeMs = fmodf(playback->timeMs, cycle);
+
+    while (playback->timeMs >= duration)
+    {
+        playback->timeMs -= duration; // Le reste est gardé pour le cadre suivant
+
+        if (playback->frameIndex + 1 >= animation->frameCount)
+        {
+            if (!animation->loop)
+            {
+                playback->timeMs = 0.0f;
+                playback->finished = true;
+                return;
+            }
+            playback->frameIndex = 0;
+        }
+        else
+        {
+            playback->frameIndex++;
+        }
+
+        if (animation->eventCount > 0)
+            AnimSystem_EmitFrameEvents(playback, animation);
+    }
+}
+
+void AnimSystem_Update(float deltaTime)
+{
+    animSystem.eventCount = 0;
+
+    float deltaMs = deltaTime * 1000.0f;
+    float blend = deltaTime * ANIM_RATE_BLEND;
+    if (blend > 1.0f)
+        blend = 1.0f;
+
+    for (int i = 0; i < animSystem.count; i++)
+    {
+        AnimPlayback *playback = &animSystem.playbacks[i];
+        if (playback->paused || !playback->set || playback->animationIndex < 0)
+            continue;
+
+        if (playback->state >= 0 && playback->set->machine)
+            AnimSystem_UpdateMachine(playback);
+
+        playback->rate += (playback->targetRate - playback->rate) * blend;
+
+        if (!playback->finished)
+            AnimSystem_Advance(playback, deltaMs);
+    }
+}
+
+int AnimSystem_GetEvents(const AnimEventRecord **events)
+{
+    *events = animSystem.events;
+    return animSystem.eventCount;
+}
+
+int AnimSystem_Count(void)
+{
+    return animSystem.count;
+}
+
+void AnimSystem_Shutdown(void)
+{
+    Mem_Free(animSystem.playbacks);
+    Mem_Free(animSystem.handleToIndex);
+    Mem_Free(animSystem.freeHandles);
+    Mem_Free(animSystem.events);
+    memset(&animSystem, 0, sizeof(animSystem));
+}
@@ -0,0 +1,133 @@
+#ifndef ANIMSYSTEM_H
+#define ANIMSYSTEM_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "animset.h"
+
+// Système d'animation : tous les états de lecture actifs sont rangés dans un
+// tableau contigu et avancés en une seule passe par frame (AnimSystem_Update).
+// Le temps restant après un changement de cadre est conservé, les cadres
+// peuvent déclencher des événements et une machine à états (partagée par
+// l'ensemble d'animations) choisit l'animation à partir de paramètres.
+
+typedef int AnimHandle;
+#define ANIM_INVALID_HANDLE -1
+
+// Vitesse (par seconde) à laquelle la vitesse de lecture rejoint sa cible
+#define ANIM_RATE_BLEND 8.0f
+
+// Événements de cadre (AnimSet_AddFrameEvent)
+typedef enum
+{
+    ANIM_EVENT_NONE = 0,
+    ANIM_EVENT_FOOTSTEP, // Pied au sol
+    ANIM_EVENT_HIT       // Cadre d'impact d'une attaque
+} AnimEventId;
+
+// Paramètres lus par les transitions des machines à états
+typedef enum
+{
+    ANIM_PARAM_MOVING, // 0 ou 1
+    ANIM_PARAM_FACING, // 0 bas, 1 gauche, 2 droite, 3 haut (convention des PNJ)
+    ANIM_PARAM_SPEED,  // Vitesse de déplacement en pixels/s
+    ANIM_PARAM_COUNT
+} AnimParam;
+
+// --- Machines à états ---
+
+typedef enum
+{
+    ANIM_COND_FINISHED,      // L'animation (sans boucle) est terminée
+    ANIM_COND_PARAM_GREATER, // params[param] > value
+    ANIM_COND_PARAM_LESS,    // params[param] < value
+    ANIM_COND_PARAM_EQUAL    // params[param] == value (valeurs entières)
+} AnimConditionType;
+
+typedef struct
+{
+    AnimConditionType type;
+    AnimParam param;
+    float value;
+} AnimCondition;
+
+#define ANIM_MAX_CONDITIONS 2
+#define ANIM_ANY_STATE -1
+
+typedef struct
+{
+    int from; // ANIM_ANY_STATE : depuis n'importe quel état
+    int to;
+    AnimCondition conditions[ANIM_MAX_CONDITIONS]; // Toutes doivent être vraies
+    int conditionCount;
+} AnimTransition;
+
+typedef struct
+{
+    char name[32];
+    int animationIndex;
+    float referenceSpeed; // > 0 : la lecture suit ANIM_PARAM_SPEED / referenceSpeed
+} AnimState;
+
+typedef struct AnimStateMachine
+{
+    AnimState *states;
+    int stateCount;
+    AnimTransition *transitions; // Évaluées dans l'ordre d'ajout
+    int transitionCount;
+} AnimStateMachine;
+
+AnimStateMachine *AnimMachine_Create(void);
+void AnimMachine_Free(AnimStateMachine *machine);
+int AnimMachine_AddState(AnimStateMachine *machine, const AnimationSet *set, const char *name,
+                         const char *animationName, float referenceSpeed);
+int AnimMachine_FindState(const AnimStateMachine *machine, const char *name);
+bool AnimMachine_AddTransition(AnimStateMachine *machine, int from, int to,
+                               const AnimCondition *conditions, int conditionCount);
+
+// --- Lecture ---
+
+typedef struct
+{
+    const AnimationSet *set;
+    int animationIndex;
+    int frameIndex;
+    float timeMs;     // Temps écoulé dans le cadre courant (reste conservé)
+    float rate;       // Vitesse de lecture courante (1 = normale)
+    float targetRate; // Vitesse visée, rejointe progressivement
+    bool paused;
+    bool finished;    // Animation sans boucle arrivée au dernier cadre
+    int state;        // État de la machine (-1 sans machine)
+    float params[ANIM_PARAM_COUNT];
+    void *owner;      // Renvoyé avec les événements
+    AnimHandle handle;
+} AnimPlayback;
+
+typedef struct
+{
+    AnimHandle handle;
+    void *owner;
+    int eventId;
+} AnimEventRecord;
+
+AnimHandle AnimSystem_Create(const AnimationSet *set, void *owner);
+void AnimSystem_Destroy(AnimHandle handle);
+AnimPlayback *AnimSystem_Get(AnimHandle handle); // Invalide après Create/Destroy
+
+void AnimSystem_SetSet(AnimHandle handle, const AnimationSet *set);
+void AnimSystem_Play(AnimHandle handle, int animationIndex); // Repart du premier cadre
+void AnimSystem_SetPaused(AnimHandle handle, bool paused);
+void AnimSystem_SetRate(AnimHandle handle, float rate);
+void AnimSystem_SetParam(AnimHandle handle, AnimParam param, float value);
+// Lecture pilotée de l'extérieur (cinématique) : la machine à états est
+// ignorée ; rendue, elle repart de son état d'entrée
+void AnimSystem_SetScripted(AnimHandle handle, bool scripted);
+
+// Avance toutes les lectures ; les événements de la passe sont ensuite
+// disponibles via AnimSystem_GetEvents jusqu'au prochain appel
+void AnimSystem_Update(float deltaTime);
+int AnimSystem_GetEvents(const AnimEventRecord **events);
+int AnimSystem_Count(void);
+void AnimSystem_Shutdown(void);
+
+#endif // ANIMSYSTEM_H
@@ -0,0 +1,349 @@
+#include "battle.h"
+#include <string.h>
+
+#define BATTLE_MAX_TURNS 1000 // Au-delà : match nul (camps qui ne font que des attaques de statut)
+#define BATTLE_STAGE_MAX 6
+#define BATTLE_IV 15          // Valeur individuelle fixe, pas de points d'effort
+#define BATTLE_CRIT_CHANCE 24 // Un coup critique sur 24
+#define BATTLE_STRUGGLE_POWER 50
+
+void Battle_Init(BattleState *battle, Uint32 seed)
+{
+    memset(battle, 0, sizeof(BattleState));
+    battle->rng = seed ? seed : 0x9E3779B9u; // xorshift : jamais 0
+    battle->winner = -1;
+}
+
+Uint32 Battle_Random(BattleState *battle)
+{
+    Uint32 x = battle->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    battle->rng = x;
+    return x;
+}
+
+bool Battle_AddMon(BattleState *battle, const BattleData *data, int side, Uint16 species, Uint8 level)
+{
+    BattleSide *team = &battle->sides[side];
+    if (team->count == BATTLE_TEAM_MAX || species >= data->speciesCount || level == 0)
+        return false;
+
+    const BattleSpecies *info = &data->species[species];
+    BattleMon *mon = &team->team[team->count++];
+    memset(mon, 0, sizeof(BattleMon));
+    mon->species = species;
+    mon->level = level;
+
+    mon->stats[STAT_HP] = (Uint16)((2 * info->base[STAT_HP] + BATTLE_IV) * level / 100 + level + 10);
+    for (int stat = STAT_ATTACK; stat < STAT_COUNT; stat++)
+    {
+        mon->stats[stat] = (Uint16)((2 * info->base[stat] + BATTLE_IV) * level / 100 + 5);
+    }
+    mon->hp = mon->stats[STAT_HP];
+
+    // Attaques dans l'ordre d'apprentissage, la plus ancienne oubliée au-delà de quatre
+    Uint16 moves[BATTLE_MAX_MOVES];
+    int known = 0;
+    const BattleRange *range = &data->learnsets[species];
+    for (Uint32 i = range->first; i < range->first + range->count && data->learns[i].level <= level; i++)
+    {
+        Uint16 move = data->learns[i].move;
+        bool already = false;
+        for (int k = 0; k < known; k++)
+            already |= moves[k] == move;
+        if (already || move >= data->moveCount)
+            continue;
+
+        if (known == BATTLE_MAX_MOVES)
+            memmove(moves, moves + 1, (BATTLE_MAX_MOVES - 1) * sizeof(Uint16));
+        else
+            known++;
+        moves[known - 1] = move;
+    }
+
+    for (int i = 0; i < BATTLE_MAX_MOVES; i++)
+    {
+        mon->moves[i] = i < known ? moves[i] : BATTLE_NO_MOVE;
+        mon->pp[i] = i < known ? data->moves[moves[i]].pp : 0;
+    }
+    return true;
+}
+
+static BattleMon *Battle_Active(BattleState *battle, int side)
+{
+    return &battle->sides[side].team[battle->sides[side].active];
+}
+
+// Statistique avec ses crans : x(2+n)/2 au-dessus de 0, x2/(2-n) en dessous
+static int Battle_StageStat(const BattleMon *mon, int stat)
+{
+    int stage = mon->stages[stat];
+    if (stage >= 0)
+        return mon->stats[stat] * (2 + stage) / 2;
+    return mon->stats[stat] * 2 / (2 - stage);
+}
+
+// Multiplicateur de type x4 : 4 neutre, 0 immunité, 16 double faiblesse
+static int Battle_Effectiveness(const BattleData *data, int moveType, const BattleSpecies *target)
+{
+    if (moveType == TYPE_NONE)
+        return 4;
+
+    const Uint8 *row = &data->typeChart[moveType * TYPE_COUNT];
+    int effectiveness = row[target->types[0]];
+    effectiveness *= target->types[1] != TYPE_NONE ? row[target->types[1]] : 2;
+    return effectiveness;
+}
+
+// Dégâts avant facteur aléatoire et coup critique, x100 pour garder la précision
+static int Battle_BaseDamage(const BattleState *battle, const BattleData *data, int side,
+                             const BattleMove *move, int power, int moveType)
+{
+    const BattleMon *attacker = &battle->sides[side].team[battle->sides[side].active];
+    const BattleMon *defender = &battle->sides[1 - side].team[battle->sides[1 - side].active];
+    const BattleSpecies *attackerInfo = &data->species[attacker->species];
+
+    bool physical = !move || move->category == MOVE_PHYSICAL;
+    int attack = Battle_StageStat(attacker, physical ? STAT_ATTACK : STAT_SP_ATTACK);
+    int defense = Battle_StageStat(defender, physical ? STAT_DEFENSE : STAT_SP_DEFENSE);
+    if (defense < 1)
+        defense = 1;
+
+    int damage = ((2 * attacker->level / 5 + 2) * power * attack / defense) / 50 + 2;
+    damage *= 100;
+
+    // Bonus de même type (x1,5)
+    if (moveType != TYPE_NONE && (attackerInfo->types[0] == moveType || attackerInfo->types[1] == moveType))
+        damage = damage * 3 / 2;
+
+    return damage * Battle_Effectiveness(data, moveType, &data->species[defender->species]) / 4;
+}
+
+static void Battle_ApplyStage(BattleMon *mon, int stat, int stages)
+{
+    int stage = mon->stages[stat] + stages;
+    if (stage > BATTLE_STAGE_MAX)
+        stage = BATTLE_STAGE_MAX;
+    if (stage < -BATTLE_STAGE_MAX)
+        stage = -BATTLE_STAGE_MAX;
+    mon->stages[stat] = (Sint8)stage;
+}
+
+static void Battle_DealDamage(BattleMon *mon, int damage)
+{
+    mon->hp = damage >= mon->hp ? 0 : (Uint16)(mon->hp - damage);
+}
+
+static void Battle_UseMove(BattleState *battle, const BattleData *data, int side, int slot)
+{
+    BattleMon *attacker = Battle_Active(battle, side);
+    BattleMon *defender = Battle_Active(battle, 1 - side);
+
+    if (slot == BATTLE_STRUGGLE)
+    {
+        // Lutte : sans type, recul d'un quart des PV max
+        int damage = Battle_BaseDamage(battle, data, side, NULL, BATTLE_STRUGGLE_POWER, TYPE_NONE);
+        damage = (int)((Sint64)damage * (85 + Battle_Random(battle) % 16) / 10000);
+        Battle_DealDamage(defender, damage > 0 ? damage : 1);
+        Battle_DealDamage(attacker, attacker->stats[STAT_HP] / 4 > 0 ? attacker->stats[STAT_HP] / 4 : 1);
+        return;
+    }
+
+    const BattleMove *move = &data->moves[attacker->moves[slot]];
+    attacker->pp[slot]--;
+
+    if (move->accuracy > 0 && Battle_Random(battle) % 100 >= move->accuracy)
+        return; // Raté
+
+    if (move->power > 0)
+    {
+        int damage = Battle_BaseDamage(battle, data, side, move, move->power, move->type);
+        if (damage == 0)
+            return; // Immunité
+
+        if (Battle_Random(battle) % BATTLE_CRIT_CHANCE == 0)
+            damage = damage * 3 / 2;
+        damage = (int)((Sint64)damage * (85 + Battle_Random(battle) % 16) / 10000);
+        Battle_DealDamage(defender, damage > 0 ? damage : 1);
+    }
+
+    if (move->effectStat != STAT_HP && move->effectStat < STAT_COUNT && move->effectStage != 0)
+    {
+        BattleMon *target = move->effectSelf ? attacker : defender;
+        if (target->hp > 0)
+            Battle_ApplyStage(target, move->effectStat, move->effectStage);
+    }
+}
+
+static void Battle_SwitchTo(BattleSide *team, int index)
+{
+    // Les crans ne survivent pas au changement
+    memset(team->team[team->active].stages, 0, sizeof(team->team[team->active].stages));
+    team->active = (Uint8)index;
+}
+
+// Remplace un membre K.O. par le premier valide ; faux si l'équipe est vaincue
+static bool Battle_ReplaceFainted(BattleSide *team)
+{
+    if (team->team[team->active].hp > 0)
+        return true;
+
+    for (int i = 0; i < team->count; i++)
+    {
+        if (team->team[i].hp > 0)
+        {
+            Battle_SwitchTo(team, i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int Battle_GetActions(const BattleState *battle, const BattleData *data, int side, BattleAction *actions)
+{
+    (void)data;
+    const BattleSide *team = &battle->sides[side];
+    const BattleMon *mon = &team->team[team->active];
+    int count = 0;
+
+    for (int i = 0; i < BATTLE_MAX_MOVES; i++)
+    {
+        if (mon->moves[i] != BATTLE_NO_MOVE && mon->pp[i] > 0)
+        {
+            actions[count].type = BATTLE_ACTION_MOVE;
+            actions[count].index = (Uint8)i;
+            count++;
+        }
+    }
+    if (count == 0)
+    {
+        actions[count].type = BATTLE_ACTION_MOVE;
+        actions[count].index = BATTLE_STRUGGLE;
+        count++;
+    }
+
+    for (int i = 0; i < team->count; i++)
+    {
+        if (i != team->active && team->team[i].hp > 0)
+        {
+            actions[count].type = BATTLE_ACTION_SWITCH;
+            actions[count].index = (Uint8)i;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Vrai si le camp 0 attaque avant le camp 1
+static bool Battle_MovesFirst(BattleState *battle, const BattleData *data, const BattleAction actions[2])
+{
+    int priority[2];
+    for (int side = 0; side < 2; side++)
+    {
+        const BattleMon *mon = Battle_Active(battle, side);
+        int slot = actions[side].index;
+        priority[side] = slot < BATTLE_MAX_MOVES && mon->moves[slot] != BATTLE_NO_MOVE ? data->moves[mon->moves[slot]].priority : 0;
+    }
+    if (priority[0] != priority[1])
+        return priority[0] > priority[1];
+
+    int speed0 = Battle_StageStat(Battle_Active(battle, 0), STAT_SPEED);
+    int speed1 = Battle_StageStat(Battle_Active(battle, 1), STAT_SPEED);
+    if (speed0 != speed1)
+        return speed0 > speed1;
+    return Battle_Random(battle) & 1;
+}
+
+void Battle_Turn(BattleState *battle, const BattleData *data, const BattleAction actions[2])
+{
+    if (battle->winner >= 0)
+        return;
+
+    // Les changements passent avant toute attaque
+    for (int side = 0; side < 2; side++)
+    {
+        BattleSide *team = &battle->sides[side];
+        if (actions[side].type == BATTLE_ACTION_SWITCH && actions[side].index < team->count &&
+            team->team[actions[side].index].hp > 0)
+            Battle_SwitchTo(team, actions[side].index);
+    }
+
+    bool attacks[2] = {actions[0].type == BATTLE_ACTION_MOVE, actions[1].type == BATTLE_ACTION_MOVE};
+    int first = 0;
+    if (attacks[0] && attacks[1])
+        first = Battle_MovesFirst(battle, data, actions) ? 0 : 1;
+    else if (attacks[1])
+        first = 1;
+
+    for (int i = 0; i < 2; i++)
+    {
+        int side = i == 0 ? first : 1 - first;
+        if (!attacks[side] || Battle_Active(battle, side)->hp == 0 || Battle_Active(battle, 1 - side)->hp == 0)
+            continue;
+
+        int slot = actions[side].index;
+        const BattleMon *mon = Battle_Active(battle, side);
+        if (slot != BATTLE_STRUGGLE && (slot >= BATTLE_MAX_MOVES || mon->moves[slot] == BATTLE_NO_MOVE || mon->pp[slot] == 0))
+            continue; // Action invalide : le tour est perdu
+        Battle_UseMove(battle, data, side, slot);
+    }
+
+    bool alive0 = Battle_ReplaceFainted(&battle->sides[0]);
+    bool alive1 = Battle_ReplaceFainted(&battle->sides[1]);
+    battle->turn++;
+
+    if (!alive0 && !alive1)
+        battle->winner = BATTLE_DRAW; // Recul de Lutte
+    else if (!alive0)
+        battle->winner = 1;
+    else if (!alive1)
+        battle->winner = 0;
+    else if (battle->turn >= BATTLE_MAX_TURNS)
+        battle->winner = BATTLE_DRAW;
+}
+
+int Battle_EstimateDamage(const BattleState *battle, const BattleData *data, int side, int slot)
+{
+    const BattleMon *mon = &battle->sides[side].team[battle->sides[side].active];
+    if (slot == BATTLE_STRUGGLE)
+        return Battle_BaseDamage(battle, data, side, NULL, BATTLE_STRUGGLE_POWER, TYPE_NONE) * 185 / 20000;
+    if (slot >= BATTLE_MAX_MOVES || mon->moves[slot] == BATTLE_NO_MOVE)
+        return 0;
+
+    const BattleMove *move = &data->moves[mon->moves[slot]];
+    if (move->power == 0)
+        return 0;
+
+    // Facteur aléatoire moyen (92,5 %) et précision
+    int damage = Battle_BaseDamage(battle, data, side, move, move->power, move->type) * 185 / 20000;
+    if (move->accuracy > 0)
+        damage = damage * move->accuracy / 100;
+    return damage;
+}
+
+BattleAction Battle_GreedyAction(BattleState *battle, const BattleData *data, int side)
+{
+    BattleAction actions[BATTLE_MAX_ACTIONS];
+    int count = Battle_GetActions(battle, data, side, actions);
+
+    BattleAction best = actions[0];
+    int bestDamage = -1;
+    int ties = 0;
+    for (int i = 0; i < count && actions[i].type == BATTLE_ACTION_MOVE; i++)
+    {
+        int damage = Battle_EstimateDamage(battle, data, side, actions[i].index);
+        if (damage > bestDamage)
+        {
+            best = actions[i];
+            bestDamage = damage;
+            ties = 1;
+        }
+        else if (damage == bestDamage && Battle_Random(battle) % ++ties == 0)
+        {
+            best = actions[i];
+        }
+    }
+    return best;
+}
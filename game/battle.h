@@ -0,0 +1,167 @@
+#ifndef BATTLE_H
+#define BATTLE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+// Moteur de combat : transition d'état pure, sans allocation ni SDL ni rendu.
+// Un BattleState est une valeur (pas de pointeur) : il se copie tel quel, ce
+// qui permet de simuler des millions de combats (tools/battlesim.c) ou
+// d'explorer des coups à l'avance. Le hasard vient du générateur de l'état :
+// même graine et mêmes actions, même combat.
+
+typedef enum
+{
+    TYPE_NORMAL,
+    TYPE_FIRE,
+    TYPE_WATER,
+    TYPE_ELECTRIC,
+    TYPE_GRASS,
+    TYPE_ICE,
+    TYPE_FIGHTING,
+    TYPE_POISON,
+    TYPE_GROUND,
+    TYPE_FLYING,
+    TYPE_PSYCHIC,
+    TYPE_BUG,
+    TYPE_ROCK,
+    TYPE_GHOST,
+    TYPE_DRAGON,
+    TYPE_DARK,
+    TYPE_STEEL,
+    TYPE_FAIRY,
+    TYPE_COUNT,
+    TYPE_NONE = 0xFF // Second type absent, ou attaque sans type (Lutte)
+} MonType;
+
+typedef enum
+{
+    STAT_HP,
+    STAT_ATTACK,
+    STAT_DEFENSE,
+    STAT_SP_ATTACK,
+    STAT_SP_DEFENSE,
+    STAT_SPEED,
+    STAT_COUNT
+} MonStat;
+
+typedef enum
+{
+    MOVE_PHYSICAL,
+    MOVE_SPECIAL,
+    MOVE_STATUS
+} MoveCategory;
+
+#define BATTLE_NAME_LENGTH 16
+#define BATTLE_MAX_MOVES 4
+#define BATTLE_TEAM_MAX 6
+#define BATTLE_NO_MOVE 0xFFFF
+#define BATTLE_MAX_ACTIONS (BATTLE_MAX_MOVES + BATTLE_TEAM_MAX)
+
+// Enregistrements de taille fixe, sans pointeur : ils sont lus tels quels
+// depuis la base de données projetée en mémoire (gamedb.h)
+typedef struct
+{
+    char name[BATTLE_NAME_LENGTH];
+    Uint8 types[2];         // TYPE_NONE si un seul type
+    Uint8 base[STAT_COUNT]; // Statistiques de base
+} BattleSpecies;
+
+typedef struct
+{
+    char name[BATTLE_NAME_LENGTH];
+    Uint8 type;
+    Uint8 category;    // MoveCategory
+    Uint8 power;       // 0 : pas de dégâts
+    Uint8 accuracy;    // En %, 0 : touche toujours
+    Uint8 pp;
+    Sint8 priority;
+    Uint8 effectStat;  // Statistique modifiée (STAT_HP : aucune)
+    Sint8 effectStage; // Crans ajoutés, sur le lanceur si effectSelf
+    Uint8 effectSelf;
+} BattleMove;
+
+typedef struct
+{
+    Uint8 level;
+    Uint8 reserved;
+    Uint16 move;
+} BattleLearn;
+
+typedef struct
+{
+    Uint32 first, count;
+} BattleRange;
+
+// Tables du jeu : espèces, attaques, attaques apprises et efficacité des
+// types. Le moteur ne fait que les lire (voir GameDB_Open).
+typedef struct
+{
+    const BattleSpecies *species;
+    int speciesCount;
+    const BattleMove *moves;
+    int moveCount;
+    const Uint8 *typeChart;       // [attaque * TYPE_COUNT + défense], multiplicateur x2 : 0, 1, 2 ou 4
+    const BattleRange *learnsets; // [speciesCount] : plage de `learns`
+    const BattleLearn *learns;    // Triées par niveau croissant dans chaque plage
+} BattleData;
+
+typedef struct
+{
+    Uint16 species;
+    Uint8 level;
+    Uint16 hp;
+    Uint16 stats[STAT_COUNT]; // stats[STAT_HP] : PV max
+    Sint8 stages[STAT_COUNT]; // -6 à +6, STAT_HP inutilisé
+    Uint16 moves[BATTLE_MAX_MOVES];
+    Uint8 pp[BATTLE_MAX_MOVES];
+} BattleMon;
+
+typedef struct
+{
+    BattleMon team[BATTLE_TEAM_MAX];
+    Uint8 count;
+    Uint8 active;
+} BattleSide;
+
+typedef struct
+{
+    BattleSide sides[2];
+    Uint32 rng;    // xorshift32, jamais 0
+    Uint16 turn;
+    Sint8 winner;  // -1 tant que le combat continue, sinon camp gagnant ou BATTLE_DRAW
+} BattleState;
+
+#define BATTLE_DRAW 2
+
+typedef enum
+{
+    BATTLE_ACTION_MOVE,    // index : emplacement d'attaque, BATTLE_STRUGGLE sans PP
+    BATTLE_ACTION_SWITCH   // index : membre de l'équipe
+} BattleActionType;
+
+#define BATTLE_STRUGGLE 0xFF
+
+typedef struct
+{
+    Uint8 type;
+    Uint8 index;
+} BattleAction;
+
+void Battle_Init(BattleState *battle, Uint32 seed);
+Uint32 Battle_Random(BattleState *battle);
+// Faux si l'équipe est pleine ou l'espèce inconnue. Le Pokémon connaît les
+// quatre dernières attaques apprises à son niveau.
+bool Battle_AddMon(BattleState *battle, const BattleData *data, int side, Uint16 species, Uint8 level);
+
+// Actions possibles du camp `side` pour ce tour ; retourne leur nombre
+int Battle_GetActions(const BattleState *battle, const BattleData *data, int side, BattleAction *actions);
+// Résout un tour : changements, puis attaques par priorité et vitesse
+void Battle_Turn(BattleState *battle, const BattleData *data, const BattleAction actions[2]);
+
+// Dégâts moyens attendus (sans hasard ni coup critique), pour les IA
+int Battle_EstimateDamage(const BattleState *battle, const BattleData *data, int side, int slot);
+// Attaque aux dégâts attendus les plus élevés (égalités départagées au hasard)
+BattleAction Battle_GreedyAction(BattleState *battle, const BattleData *data, int side);
+
+#endif // BATTLE_H
@@ -0,0 +1,471 @@
+#include "battleai.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framework/memtrack.h"
+
+#define BATTLE_AI_NONE 0xFFFFFFFFu
+#define BATTLE_AI_MAX_DEPTH 32      // Tours descendus dans l'arbre par simulation
+#define BATTLE_AI_ROLLOUT_TURNS 40  // Au-delà, l'issue est estimée par les PV restants
+#define BATTLE_AI_EXPLORATION 0.7f  // Constante d'exploration de UCB (gains dans [0, 1])
+#define BATTLE_AI_TIME_CHECK 32     // Simulations entre deux lectures de l'horloge
+
+struct BattleAINode
+{
+    Uint64 hash;
+    Uint32 visits;
+    Uint8 actionCount[2];
+    BattleAction actions[2][BATTLE_MAX_ACTIONS];
+    Uint32 count[2][BATTLE_MAX_ACTIONS];
+    float value[2][BATTLE_MAX_ACTIONS]; // Somme des gains du camp
+};
+
+static Uint32 BattleAI_Random(Uint32 *state)
+{
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Hachage des équipes et de l'issue, sans le générateur ni le compteur de tours
+static Uint64 BattleAI_Hash(const BattleState *battle)
+{
+    Uint64 hash = 0xCBF29CE484222325ull;
+    const Uint8 *bytes = (const Uint8 *)battle->sides;
+    size_t size = sizeof(battle->sides);
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        Uint64 word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return (hash ^ (Uint64)(Uint8)battle->winner) * 0x9E3779B97F4A7C15ull;
+}
+
+static Uint32 BattleAI_Lookup(BattleAIWorker *worker, Uint64 hash)
+{
+    Uint32 mask = worker->ai->tableSize - 1;
+    for (Uint32 i = (Uint32)hash & mask;; i = (i + 1) & mask)
+    {
+        BattleAIEntry *entry = &worker->table[i];
+        if (entry->generation != worker->generation)
+            return BATTLE_AI_NONE;
+        if (entry->hash == hash)
+            return entry->node;
+    }
+}
+
+// Nouveau nœud, référencé par la table ; BATTLE_AI_NONE si la réserve est pleine
+static Uint32 BattleAI_NewNode(BattleAIWorker *worker, const BattleState *battle, Uint64 hash)
+{
+    if (worker->nodeCount == worker->ai->nodeCapacity)
+        return BATTLE_AI_NONE;
+
+    Uint32 index = (Uint32)worker->nodeCount++;
+    BattleAINode *node = &worker->nodes[index];
+    node->hash = hash;
+    node->visits = 0;
+    for (int side = 0; side < 2; side++)
+    {
+        node->actionCount[side] = (Uint8)Battle_GetActions(battle, worker->ai->data, side, node->actions[side]);
+        memset(node->count[side], 0, sizeof(node->count[side]));
+        memset(node->value[side], 0, sizeof(node->value[side]));
+    }
+
+    // Au plus un nœud pour deux cases : le sondage linéaire s'arrête toujours
+    Uint32 mask = worker->ai->tableSize - 1;
+    Uint32 i = (Uint32)hash & mask;
+    while (worker->table[i].generation == worker->generation)
+        i = (i + 1) & mask;
+    worker->table[i].hash = hash;
+    worker->table[i].node = index;
+    worker->table[i].generation = worker->generation;
+    return index;
+}
+
+// UCB1 pour un camp : actions jamais essayées d'abord
+static int BattleAI_Select(const BattleAINode *node, int side)
+{
+    int count = node->actionCount[side];
+    if (count == 1)
+        return 0;
+
+    float logVisits = logf((float)node->visits + 1.0f);
+    int best = 0;
+    float bestScore = -1.0f;
+    for (int i = 0; i < count; i++)
+    {
+        Uint32 n = node->count[side][i];
+        if (n == 0)
+            return i;
+
+        float score = node->value[side][i] / n + BATTLE_AI_EXPLORATION * sqrtf(logVisits / n);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static float BattleAI_HealthFraction(const BattleSide *team)
+{
+    float health = 0.0f;
+    for (int i = 0; i < team->count; i++)
+    {
+        if (team->team[i].stats[STAT_HP] > 0)
+            health += (float)team->team[i].hp / team->team[i].stats[STAT_HP];
+    }
+    return health;
+}
+
+// Gain du camp 0 : 1 victoire, 0 défaite, 0,5 nul
+static float BattleAI_Outcome(const BattleState *battle)
+{
+    if (battle->winner == 0)
+        return 1.0f;
+    if (battle->winner == 1)
+        return 0.0f;
+    if (battle->winner == BATTLE_DRAW)
+        return 0.5f;
+
+    float health0 = BattleAI_HealthFraction(&battle->sides[0]);
+    float health1 = BattleAI_HealthFraction(&battle->sides[1]);
+    return health0 + health1 > 0.0f ? health0 / (health0 + health1) : 0.5f;
+}
+
+// Fin de partie rapide : glouton trois fois sur quatre, sinon coup au hasard
+static float BattleAI_Rollout(BattleAIWorker *worker, BattleState *battle)
+{
+    const BattleData *data = worker->ai->data;
+    for (int turn = 0; turn < BATTLE_AI_ROLLOUT_TURNS && battle->winner < 0; turn++)
+    {
+        BattleAction actions[2];
+        for (int side = 0; side < 2; side++)
+        {
+            if (BattleAI_Random(&worker->rng) & 3)
+            {
+                actions[side] = Battle_GreedyAction(battle, data, side);
+            }
+            else
+            {
+                BattleAction legal[BATTLE_MAX_ACTIONS];
+                int count = Battle_GetActions(battle, data, side, legal);
+                actions[side] = legal[BattleAI_Random(&worker->rng) % count];
+            }
+        }
+        Battle_Turn(battle, data, actions);
+    }
+    return BattleAI_Outcome(battle);
+}
+
+typedef struct
+{
+    Uint32 node;
+    Uint8 choice[2];
+} BattleAIStep;
+
+static void BattleAI_Search(BattleAIWorker *worker)
+{
+    BattleAI *ai = worker->ai;
+    const BattleData *data = ai->data;
+
+    worker->generation++;
+    worker->nodeCount = 0;
+    worker->rollouts = 0;
+    BattleAI_NewNode(worker, &ai->root, BattleAI_Hash(&ai->root));
+
+    Uint64 iterations = 0;
+    while (!atomic_load(&ai->cancel) && (ai->maxIterations == 0 || iterations < ai->maxIterations))
+    {
+        if (ai->deadline && iterations % BATTLE_AI_TIME_CHECK == 0 && (Sint32)(SDL_GetTicks() - ai->deadline) >= 0)
+            break;
+
+        // Nouveaux tirages à chaque simulation
+        BattleState battle = ai->root;
+        battle.rng = BattleAI_Random(&worker->rng) | 1;
+
+        BattleAIStep path[BATTLE_AI_MAX_DEPTH];
+        int depth = 0;
+        Uint32 index = 0;
+        bool expanded = false;
+
+        // Sélection : on descend tant que les états sont connus
+        while (depth < BATTLE_AI_MAX_DEPTH && battle.winner < 0 && !expanded)
+        {
+            BattleAINode *node = &worker->nodes[index];
+            int choice0 = BattleAI_Select(node, 0);
+            int choice1 = BattleAI_Select(node, 1);
+            path[depth].node = index;
+            path[depth].choice[0] = (Uint8)choice0;
+            path[depth].choice[1] = (Uint8)choice1;
+            depth++;
+
+            BattleAction actions[2] = {node->actions[0][choice0], node->actions[1][choice1]};
+            Battle_Turn(&battle, data, actions);
+            if (battle.winner >= 0)
+                break;
+
+            Uint64 hash = BattleAI_Hash(&battle);
+            Uint32 child = BattleAI_Lookup(worker, hash);
+            if (child == BATTLE_AI_NONE)
+            {
+                // Expansion d'un nœud par simulation (rien si la réserve est pleine)
+                BattleAI_NewNode(worker, &battle, hash);
+                expanded = true;
+            }
+            else
+            {
+                index = child;
+            }
+        }
+
+        float reward = battle.winner >= 0 ? BattleAI_Outcome(&battle) : BattleAI_Rollout(worker, &battle);
+
+        for (int i = 0; i < depth; i++)
+        {
+            BattleAINode *node = &worker->nodes[path[i].node];
+            node->visits++;
+            node->count[0][path[i].choice[0]]++;
+            node->value[0][path[i].choice[0]] += reward;
+            node->count[1][path[i].choice[1]]++;
+            node->value[1][path[i].choice[1]] += 1.0f - reward;
+        }
+        iterations++;
+    }
+    worker->rollouts = iterations;
+}
+
+static int BattleAI_Thread(void *data)
+{
+    BattleAIWorker *worker = (BattleAIWorker *)data;
+    BattleAI *ai = worker->ai;
+    Uint32 seenJob = 0;
+
+    SDL_LockMutex(ai->mutex);
+    while (!ai->quit)
+    {
+        if (ai->job == seenJob)
+        {
+            SDL_CondWait(ai->cond, ai->mutex);
+            continue;
+        }
+        seenJob = ai->job;
+
+        // Recherche hors verrou : l'état racine ne change pas avant la fin
+        SDL_UnlockMutex(ai->mutex);
+        BattleAI_Search(worker);
+        SDL_LockMutex(ai->mutex);
+
+        ai->running--;
+        SDL_CondBroadcast(ai->cond);
+    }
+    SDL_UnlockMutex(ai->mutex);
+    return 0;
+}
+
+BattleAI *BattleAI_Create(int threads, int nodes)
+{
+    if (threads < 1)
+        threads = 1;
+    if (nodes < 1)
+        nodes = 1;
+
+    BattleAI *ai = Mem_Calloc(MEM_TAG_BATTLE, 1, sizeof(BattleAI));
+    if (!ai)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour l'IA de combat.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ai->nodeCapacity = nodes;
+    ai->tableSize = 1;
+    while (ai->tableSize < nodes * 2)
+        ai->tableSize <<= 1;
+    atomic_init(&ai->cancel, false);
+
+    ai->mutex = SDL_CreateMutex();
+    ai->cond = SDL_CreateCond();
+    ai->workers = Mem_Calloc(MEM_TAG_BATTLE, threads, sizeof(BattleAIWorker));
+    if (!ai->mutex || !ai->cond || !ai->workers)
+    {
+        fprintf(stderr, "Erreur de création de l'IA de combat: %s\n", SDL_GetError());
+        BattleAI_Free(ai);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        BattleAIWorker *worker = &ai->workers[i];
+        worker->ai = ai;
+        worker->nodes = Mem_Alloc(MEM_TAG_BATTLE, nodes * sizeof(BattleAINode));
+        worker->table = Mem_Calloc(MEM_TAG_BATTLE, ai->tableSize, sizeof(BattleAIEntry));
+        if (!worker->nodes || !worker->table)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour l'IA de combat.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        worker->thread = SDL_CreateThread(BattleAI_Thread, "BattleAI", worker);
+        if (!worker->thread)
+        {
+            fprintf(stderr, "Impossible de créer le thread de l'IA de combat: %s\n", SDL_GetError());
+            Mem_Free(worker->nodes);
+            Mem_Free(worker->table);
+            break;
+        }
+        ai->workerCount++;
+    }
+
+    if (ai->workerCount == 0)
+    {
+        BattleAI_Free(ai);
+        return NULL;
+    }
+    return ai;
+}
+
+// Attend la fin des threads encore en recherche (verrou tenu)
+static void BattleAI_WaitLocked(BattleAI *ai)
+{
+    while (ai->running > 0)
+        SDL_CondWait(ai->cond, ai->mutex);
+}
+
+void BattleAI_Free(BattleAI *ai)
+{
+    if (!ai)
+        return;
+
+    if (ai->mutex)
+    {
+        atomic_store(&ai->cancel, true);
+        SDL_LockMutex(ai->mutex);
+        BattleAI_WaitLocked(ai);
+        ai->quit = true;
+        SDL_CondBroadcast(ai->cond);
+        SDL_UnlockMutex(ai->mutex);
+    }
+
+    for (int i = 0; i < ai->workerCount; i++)
+    {
+        SDL_WaitThread(ai->workers[i].thread, NULL);
+        Mem_Free(ai->workers[i].nodes);
+        Mem_Free(ai->workers[i].table);
+    }
+    Mem_Free(ai->workers);
+
+    if (ai->cond)
+        SDL_DestroyCond(ai->cond);
+    if (ai->mutex)
+        SDL_DestroyMutex(ai->mutex);
+    Mem_Free(ai);
+}
+
+void BattleAI_Start(BattleAI *ai, const BattleData *data, const BattleState *battle, int side,
+                    Uint32 budgetMs, Uint32 iterations, Uint32 seed)
+{
+    BattleAI_Cancel(ai);
+
+    SDL_LockMutex(ai->mutex);
+    ai->data = data;
+    ai->root = *battle;
+    ai->side = side;
+    ai->startTime = SDL_GetTicks();
+    ai->deadline = budgetMs ? ai->startTime + budgetMs : 0;
+    if (ai->deadline == 0 && budgetMs)
+        ai->deadline = 1;
+    ai->maxIterations = iterations;
+    if (!budgetMs && !iterations)
+        ai->maxIterations = 1; // Jamais de recherche sans fin
+    for (int i = 0; i < ai->workerCount; i++)
+    {
+        // Graine propre à chaque thread, dérivée de celle de la décision
+        ai->workers[i].rng = (seed ^ (0x9E3779B9u * (Uint32)(i + 1))) | 1;
+    }
+    atomic_store(&ai->cancel, false);
+    ai->running = ai->workerCount;
+    ai->busy = true;
+    ai->job++;
+    SDL_CondBroadcast(ai->cond);
+    SDL_UnlockMutex(ai->mutex);
+}
+
+bool BattleAI_Poll(BattleAI *ai, BattleAction *action)
+{
+    if (!ai->busy)
+        return false;
+
+    SDL_LockMutex(ai->mutex);
+    bool done = ai->running == 0;
+    SDL_UnlockMutex(ai->mutex);
+    if (!done)
+        return false;
+
+    // Statistiques de la racine additionnées sur tous les arbres ; les actions
+    // de la racine sont dans le même ordre partout (Battle_GetActions)
+    const BattleAINode *first = &ai->workers[0].nodes[0];
+    int count = first->actionCount[ai->side];
+    Uint64 visits[BATTLE_MAX_ACTIONS] = {0};
+    ai->lastRollouts = 0;
+    for (int w = 0; w < ai->workerCount; w++)
+    {
+        const BattleAINode *root = &ai->workers[w].nodes[0];
+        for (int i = 0; i < count; i++)
+            visits[i] += root->count[ai->side][i];
+        ai->lastRollouts += ai->workers[w].rollouts;
+    }
+
+    int best = 0;
+    for (int i = 1; i < count; i++)
+    {
+        if (visits[i] > visits[best])
+            best = i;
+    }
+    *action = first->actions[ai->side][best];
+    ai->lastTimeMs = SDL_GetTicks() - ai->startTime;
+    ai->busy = false;
+    return true;
+}
+
+void BattleAI_Cancel(BattleAI *ai)
+{
+    if (!ai->busy)
+        return;
+
+    atomic_store(&ai->cancel, true);
+    SDL_LockMutex(ai->mutex);
+    BattleAI_WaitLocked(ai);
+    SDL_UnlockMutex(ai->mutex);
+    ai->busy = false;
+}
+
+void BattleAI_Wait(BattleAI *ai)
+{
+    SDL_LockMutex(ai->mutex);
+    BattleAI_WaitLocked(ai);
+    SDL_UnlockMutex(ai->mutex);
+}
+
+BattleAction BattleAI_Think(BattleAI *ai, const BattleData *data, const BattleState *battle, int side,
+                            Uint32 budgetMs, Uint32 iterations, Uint32 seed)
+{
+    BattleAI_Start(ai, data, battle, side, budgetMs, iterations, seed);
+    BattleAI_Wait(ai);
+
+    BattleAction action;
+    BattleAI_Poll(ai, &action);
+    return action;
+}
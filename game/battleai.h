@@ -0,0 +1,86 @@
+#ifndef BATTLEAI_H
+#define BATTLEAI_H
+
+#include <SDL.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "battle.h"
+
+// IA de combat : recherche arborescente Monte-Carlo sur les coups simultanés
+// (UCT découplé : chaque camp choisit son action par UCB dans chaque nœud).
+// Les tirages aléatoires sont refaits à chaque simulation, l'IA ne connaît
+// donc pas l'avenir ; deux suites de tirages différentes mènent à des états
+// différents, retrouvés par la table de transposition (hachage de l'état).
+//
+// Parallélisation à la racine : chaque thread de travail a son propre arbre
+// (réserve de nœuds et table préallouées, remises à zéro à chaque décision),
+// les statistiques de la racine sont additionnées à la fin. La décision est
+// demandée sans bloquer (BattleAI_Start) puis relevée (BattleAI_Poll) : le
+// rendu continue pendant la réflexion.
+
+typedef struct BattleAINode BattleAINode;
+
+typedef struct
+{
+    Uint64 hash;
+    Uint32 node;
+    Uint32 generation; // Entrée valide seulement pour la décision en cours
+} BattleAIEntry;
+
+typedef struct
+{
+    struct BattleAI *ai;
+    SDL_Thread *thread;
+    BattleAINode *nodes; // Réserve : allocation par simple incrément
+    int nodeCount;
+    BattleAIEntry *table;
+    Uint32 generation;
+    Uint32 rng;
+    Uint64 rollouts; // Simulations de la dernière décision
+} BattleAIWorker;
+
+typedef struct BattleAI
+{
+    BattleAIWorker *workers;
+    int workerCount;
+    int nodeCapacity; // Par thread
+    int tableSize;    // Par thread, puissance de 2
+
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    Uint32 job;      // Incrémenté à chaque décision demandée
+    int running;     // Threads encore en recherche
+    bool quit;
+
+    // Décision en cours (lue par les threads, fixée par BattleAI_Start)
+    const BattleData *data;
+    BattleState root;
+    int side;
+    Uint32 deadline;       // SDL_GetTicks de fin, 0 : pas de limite de temps
+    Uint32 maxIterations;  // Par thread, 0 : pas de limite
+    atomic_bool cancel;
+
+    bool busy;
+    Uint64 lastRollouts;
+    Uint32 lastTimeMs;
+    Uint32 startTime;
+} BattleAI;
+
+// `threads` threads de travail (au moins 1), `nodes` nœuds par thread
+BattleAI *BattleAI_Create(int threads, int nodes);
+void BattleAI_Free(BattleAI *ai);
+
+// Lance la recherche pour le camp `side`, bornée par `budgetMs` et/ou par
+// `iterations` par thread. Sans limite de temps, le résultat ne dépend que
+// de `seed` et du nombre de threads (relecture déterministe).
+void BattleAI_Start(BattleAI *ai, const BattleData *data, const BattleState *battle, int side,
+                    Uint32 budgetMs, Uint32 iterations, Uint32 seed);
+// Vrai quand la décision est prête (écrite dans `action`)
+bool BattleAI_Poll(BattleAI *ai, BattleAction *action);
+void BattleAI_Cancel(BattleAI *ai); // Abandonne la recherche en cours
+void BattleAI_Wait(BattleAI *ai);   // Bloque jusqu'à la fin de la recherche
+// Version bloquante (outils)
+BattleAction BattleAI_Think(BattleAI *ai, const BattleData *data, const BattleState *battle, int side,
+                            Uint32 budgetMs, Uint32 iterations, Uint32 seed);
+
+#endif // BATTLEAI_H
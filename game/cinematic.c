@@ -0,0 +1,396 @@
+#include "cinematic.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constante.h"
+#include "entity.h"
+#include "../framework/memtrack.h"
+#include "../framework/pack.h"
+
+// Agrandit un tableau de la cinématique ; la capacité est gardée d'une scène à l'autre
+static void *Cinematic_Grow(void *data, int *capacity, int needed, size_t itemSize)
+{
+    if (needed <= *capacity)
+        return data;
+
+    int grown = *capacity ? *capacity : 16;
+    while (grown < needed)
+        grown *= 2;
+    void *resized = Mem_Realloc(MEM_TAG_ENTITY, data, grown * itemSize);
+    if (!resized)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la cinématique.\n");
+        exit(EXIT_FAILURE);
+    }
+    *capacity = grown;
+    return resized;
+}
+
+void Cinematic_Free(Cinematic *cinematic)
+{
+    Cinematic_Stop(cinematic);
+    Mem_Free(cinematic->tracks);
+    Mem_Free(cinematic->keys);
+    Mem_Free(cinematic->names);
+    memset(cinematic, 0, sizeof(Cinematic));
+}
+
+static Uint32 Cinematic_Ticks(float seconds)
+{
+    return seconds > 0.0f ? (Uint32)lroundf(seconds * SIM_TICK_RATE) : 0;
+}
+
+static int Cinematic_FindActor(Cinematic *cinematic, const char *name)
+{
+    for (int i = 0; i < cinematic->actor_count; i++)
+    {
+        if (strcmp(cinematic->actors[i].name, name) == 0)
+            return i;
+    }
+    if (cinematic->actor_count == CINEMATIC_MAX_ACTORS)
+        return -1;
+
+    CinematicActor *actor = &cinematic->actors[cinematic->actor_count];
+    memset(actor, 0, sizeof(CinematicActor));
+    snprintf(actor->name, sizeof(actor->name), "%s", name);
+    return cinematic->actor_count++;
+}
+
+// "track ..." : nouvelle piste, vide
+static bool Cinematic_ParseTrack(Cinematic *cinematic, const char *args)
+{
+    char target[16], name[CINEMATIC_NAME_LENGTH] = "", property[16] = "";
+    int fields = sscanf(args, "%15s", target);
+    CinematicTrack track = {.actor = -1};
+
+    if (fields == 1 && strcmp(target, "camera") == 0)
+        track.type = CINEMATIC_TRACK_CAMERA;
+    else if (fields == 1 && strcmp(target, "fade") == 0)
+        track.type = CINEMATIC_TRACK_FADE;
+    else if ((strcmp(target, "player") == 0 && sscanf(args, "%*s %15s", property) == 1) ||
+             (strcmp(target, "npc") == 0 && sscanf(args, "%*s %63s %15s", name, property) == 2))
+    {
+        if (strcmp(property, "position") == 0)
+            track.type = CINEMATIC_TRACK_POSITION;
+        else if (strcmp(property, "animation") == 0)
+            track.type = CINEMATIC_TRACK_ANIMATION;
+        else
+            return false;
+
+        track.actor = Cinematic_FindActor(cinematic, name);
+        if (track.actor < 0)
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    cinematic->tracks = Cinematic_Grow(cinematic->tracks, &cinematic->track_capacity, cinematic->track_count + 1,
+                                       sizeof(CinematicTrack));
+    track.first = cinematic->key_count;
+    cinematic->tracks[cinematic->track_count++] = track;
+    return true;
+}
+
+// "<secondes> <valeurs>" : clé de la dernière piste
+static bool Cinematic_ParseKey(Cinematic *cinematic, const char *line)
+{
+    if (cinematic->track_count == 0)
+        return false;
+
+    CinematicTrack *track = &cinematic->tracks[cinematic->track_count - 1];
+    CinematicKey key = {.name = -1, .animation = -1};
+    float seconds;
+    char animation[CINEMATIC_NAME_LENGTH];
+    bool parsed;
+
+    switch (track->type)
+    {
+    case CINEMATIC_TRACK_ANIMATION:
+        parsed = sscanf(line, "%f %63s", &seconds, animation) == 2;
+        if (parsed)
+        {
+            int length = (int)strlen(animation) + 1;
+            cinematic->names = Cinematic_Grow(cinematic->names, &cinematic->names_capacity,
+                                              cinematic->names_size + length, 1);
+            memcpy(cinematic->names + cinematic->names_size, animation, length);
+            key.name = cinematic->names_size;
+            cinematic->names_size += length;
+        }
+        break;
+    case CINEMATIC_TRACK_FADE:
+        parsed = sscanf(line, "%f %f", &seconds, &key.x) == 2;
+        break;
+    default:
+        parsed = sscanf(line, "%f %f %f", &seconds, &key.x, &key.y) == 3;
+        break;
+    }
+    if (!parsed)
+        return false;
+
+    key.tick = Cinematic_Ticks(seconds);
+    if (track->count > 0 && key.tick <= cinematic->keys[cinematic->key_count - 1].tick)
+        return false; // Les curseurs ne font qu'avancer : clés dans l'ordre
+
+    cinematic->keys = Cinematic_Grow(cinematic->keys, &cinematic->key_capacity, cinematic->key_count + 1,
+                                     sizeof(CinematicKey));
+    cinematic->keys[cinematic->key_count++] = key;
+    track->count++;
+    return true;
+}
+
+bool Cinematic_Load(Cinematic *cinematic, const char *name)
+{
+    if (cinematic->playing)
+        return false;
+    if (cinematic->name[0] != '\0' && strcmp(cinematic->name, name) == 0)
+        return true;
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s%s.cut", CINEMATIC_DIR, name);
+    char *text = Asset_LoadFile(path, NULL);
+    if (!text)
+    {
+        printf("Cinématique introuvable: %s\n", path);
+        return false;
+    }
+
+    cinematic->name[0] = '\0';
+    cinematic->actor_count = 0;
+    cinematic->track_count = 0;
+    cinematic->key_count = 0;
+    cinematic->names_size = 0;
+    cinematic->duration = 0;
+
+    bool ok = true;
+    int lineNumber = 0;
+    for (char *line = text; ok && line;)
+    {
+        char *next = strchr(line, '\n');
+        if (next)
+            *next++ = '\0';
+        lineNumber++;
+
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+        line += strspn(line, " \t\r");
+
+        float seconds;
+        if (*line == '\0')
+        {
+            line = next;
+            continue;
+        }
+
+        if (strncmp(line, "track ", 6) == 0)
+            ok = Cinematic_ParseTrack(cinematic, line + 6);
+        else if (sscanf(line, "duration %f", &seconds) == 1)
+            cinematic->duration = Cinematic_Ticks(seconds);
+        else
+            ok = Cinematic_ParseKey(cinematic, line);
+
+        if (!ok)
+            fprintf(stderr, "%s:%d: ligne de cinématique invalide: %s\n", path, lineNumber, line);
+        line = next;
+    }
+    Mem_Free(text);
+    if (!ok)
+        return false;
+
+    // La scène dure au moins jusqu'à sa dernière clé
+    for (int i = 0; i < cinematic->track_count; i++)
+    {
+        const CinematicTrack *track = &cinematic->tracks[i];
+        if (track->count > 0 && cinematic->keys[track->first + track->count - 1].tick > cinematic->duration)
+            cinematic->duration = cinematic->keys[track->first + track->count - 1].tick;
+    }
+
+    snprintf(cinematic->name, sizeof(cinematic->name), "%s", name);
+    printf("Cinématique %s : %d pistes, %d clés, %.1f s\n", name, cinematic->track_count, cinematic->key_count,
+           cinematic->duration / (float)SIM_TICK_RATE);
+    return true;
+}
+
+// Clés de la piste à `tick` : avance le curseur, faux avant la première clé
+static bool Cinematic_Seek(Cinematic *cinematic, CinematicTrack *track, const CinematicKey **key,
+                           const CinematicKey **next)
+{
+    const CinematicKey *keys = &cinematic->keys[track->first];
+    if (track->count == 0 || keys[0].tick > cinematic->tick)
+        return false;
+
+    while (track->cursor + 1 < track->count && keys[track->cursor + 1].tick <= cinematic->tick)
+        track->cursor++;
+
+    *key = &keys[track->cursor];
+    *next = track->cursor + 1 < track->count ? &keys[track->cursor + 1] : NULL;
+    return true;
+}
+
+static void Cinematic_Interpolate(const Cinematic *cinematic, const CinematicKey *key, const CinematicKey *next,
+                                  float *x, float *y)
+{
+    *x = key->x;
+    *y = key->y;
+    if (next)
+    {
+        float t = (float)(cinematic->tick - key->tick) / (float)(next->tick - key->tick);
+        *x += (next->x - key->x) * t;
+        *y += (next->y - key->y) * t;
+    }
+}
+
+// Applique toutes les pistes au tick courant
+static void Cinematic_Evaluate(Cinematic *cinematic)
+{
+    for (int i = 0; i < cinematic->track_count; i++)
+    {
+        CinematicTrack *track = &cinematic->tracks[i];
+        const CinematicKey *key, *next;
+        if (!Cinematic_Seek(cinematic, track, &key, &next))
+            continue;
+
+        EntityId entity = track->actor >= 0 ? cinematic->actors[track->actor].entity : ENTITY_NONE;
+        float x, y;
+        switch (track->type)
+        {
+        case CINEMATIC_TRACK_POSITION:
+        {
+            Transform *transform = ECS_GetTransform(entity);
+            if (transform)
+                Cinematic_Interpolate(cinematic, key, next, &transform->x, &transform->y);
+            break;
+        }
+        case CINEMATIC_TRACK_ANIMATION:
+            // Jouée une fois, à l'entrée dans la clé
+            if (track->applied != track->cursor)
+            {
+                track->applied = track->cursor;
+                if (entity != ENTITY_NONE && key->animation >= 0)
+                    Entity_SetAnimationIndex(entity, key->animation);
+            }
+            break;
+        case CINEMATIC_TRACK_CAMERA:
+            Cinematic_Interpolate(cinematic, key, next, &cinematic->camera_x, &cinematic->camera_y);
+            break;
+        case CINEMATIC_TRACK_FADE:
+            Cinematic_Interpolate(cinematic, key, next, &x, &y);
+            cinematic->fade = (Uint8)(x < 0.0f ? 0.0f : x > 255.0f ? 255.0f : x);
+            break;
+        }
+    }
+}
+
+// Les acteurs sont figés : ni IA, ni déplacement, ni machine à états
+static void Cinematic_Bind(CinematicActor *actor)
+{
+    AI *ai = ECS_GetAI(actor->entity);
+    actor->had_ai = ai != NULL;
+    if (ai)
+    {
+        actor->behaviour = ai->behaviour;
+        ai->behaviour = AI_STATIC;
+    }
+
+    Mover *mover = ECS_GetMover(actor->entity);
+    if (mover)
+    {
+        mover->dirX = mover->dirY = 0.0f;
+        mover->hasTarget = false;
+    }
+
+    Animator *animator = ECS_GetAnimator(actor->entity);
+    if (animator)
+        AnimSystem_SetScripted(animator->anim, true);
+}
+
+bool Cinematic_Start(Cinematic *cinematic, Map *map, EntityId player)
+{
+    if (cinematic->playing || cinematic->name[0] == '\0')
+        return false;
+
+    for (int i = 0; i < cinematic->actor_count; i++)
+    {
+        CinematicActor *actor = &cinematic->actors[i];
+        actor->entity = actor->name[0] == '\0' ? player : Map_FindNPC(map, actor->name);
+        if (actor->entity == ENTITY_NONE)
+            printf("Cinématique %s : PNJ %s absent de %s\n", cinematic->name, actor->name, map ? map->filename : "?");
+        else
+            Cinematic_Bind(actor);
+    }
+
+    // Indices d'animation résolus une fois pour toute la scène
+    for (int i = 0; i < cinematic->track_count; i++)
+    {
+        CinematicTrack *track = &cinematic->tracks[i];
+        track->cursor = 0;
+        track->applied = -1;
+        if (track->type != CINEMATIC_TRACK_ANIMATION)
+            continue;
+
+        EntityId entity = cinematic->actors[track->actor].entity;
+        const Sprite *sprite = ECS_GetSprite(entity);
+        for (int k = track->first; k < track->first + track->count; k++)
+        {
+            CinematicKey *key = &cinematic->keys[k];
+            key->animation = sprite ? AnimSet_FindAnimation(sprite->set, cinematic->names + key->name) : -1;
+            if (entity != ENTITY_NONE && key->animation < 0)
+                printf("Cinématique %s : animation %s inconnue\n", cinematic->name, cinematic->names + key->name);
+        }
+    }
+
+    cinematic->tick = 0;
+    cinematic->camera_x = cinematic->camera_y = 0.0f;
+    cinematic->fade = 0;
+    cinematic->playing = true;
+    Cinematic_Evaluate(cinematic);
+    return true;
+}
+
+bool Cinematic_Update(Cinematic *cinematic)
+{
+    if (!cinematic->playing)
+        return true;
+    if (cinematic->tick >= cinematic->duration)
+        return true;
+
+    cinematic->tick++;
+    Cinematic_Evaluate(cinematic);
+    return cinematic->tick >= cinematic->duration;
+}
+
+void Cinematic_Skip(Cinematic *cinematic)
+{
+    if (!cinematic->playing)
+        return;
+    cinematic->tick = cinematic->duration;
+    Cinematic_Evaluate(cinematic);
+}
+
+void Cinematic_Stop(Cinematic *cinematic)
+{
+    if (!cinematic->playing)
+        return;
+
+    for (int i = 0; i < cinematic->actor_count; i++)
+    {
+        CinematicActor *actor = &cinematic->actors[i];
+        if (actor->entity == ENTITY_NONE)
+            continue;
+
+        AI *ai = ECS_GetAI(actor->entity);
+        if (ai && actor->had_ai)
+            ai->behaviour = actor->behaviour;
+        Animator *animator = ECS_GetAnimator(actor->entity);
+        if (animator)
+            AnimSystem_SetScripted(animator->anim, false);
+        actor->entity = ENTITY_NONE;
+    }
+
+    cinematic->playing = false;
+    cinematic->camera_x = cinematic->camera_y = 0.0f;
+    cinematic->fade = 0;
+}
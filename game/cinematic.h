@@ -0,0 +1,98 @@
+#ifndef CINEMATIC_H
+#define CINEMATIC_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "ecs.h"
+#include "../framework/map.h"
+
+// Cinématiques (MODE_CINEMATIC) : pistes de clés qui pilotent la position et
+// l'animation des acteurs (joueur, PNJ de la map par leur nom), la caméra et
+// un fondu au noir. Chaque piste garde la dernière clé atteinte : un tick
+// coûte une comparaison par piste, quel que soit le nombre de clés. Le temps
+// est compté en ticks de simulation, une scène rejouée est identique.
+//
+// Fichier texte CINEMATIC_DIR<nom>.cut, temps en secondes, '#' commente :
+//
+//     duration 6                   # Facultatif : sinon la dernière clé
+//     track npc Prof position      # x y (monde), interpolés
+//     0    320 96
+//     2.5  240 96
+//     track npc Prof animation     # Nom de l'animation, jouée à sa clé
+//     0    walk_left
+//     2.5  idle_down
+//     track player animation       # "player" : le joueur
+//     0    idle_top
+//     track camera                 # x y du coin haut gauche de la vue
+//     0    0 0
+//     track fade                   # Opacité du noir, 0 à 255
+//     0    255
+//     1    0
+
+#define CINEMATIC_MAX_ACTORS 16
+#define CINEMATIC_NAME_LENGTH 64
+
+typedef enum
+{
+    CINEMATIC_TRACK_POSITION,
+    CINEMATIC_TRACK_ANIMATION,
+    CINEMATIC_TRACK_CAMERA,
+    CINEMATIC_TRACK_FADE
+} CinematicTrackType;
+
+typedef struct
+{
+    Uint32 tick;
+    float x, y;    // Position, caméra ; fondu : opacité dans x
+    int name;      // Animation : nom dans `names`
+    int animation; // Animation : indice dans l'ensemble de l'acteur (Cinematic_Start)
+} CinematicKey;
+
+typedef struct
+{
+    CinematicTrackType type;
+    int actor;        // -1 : caméra ou fondu
+    int first, count; // Clés [first, first + count), ticks croissants
+    int cursor;       // Dernière clé atteinte : la recherche repart d'ici
+    int applied;      // Animation : dernière clé jouée, -1 aucune
+} CinematicTrack;
+
+typedef struct
+{
+    char name[CINEMATIC_NAME_LENGTH]; // Vide : le joueur
+    EntityId entity;                  // ENTITY_NONE : absent de la map, pistes ignorées
+    bool had_ai;
+    AIBehaviour behaviour; // Rendu à la fin de la scène
+} CinematicActor;
+
+typedef struct
+{
+    char name[CINEMATIC_NAME_LENGTH]; // Scène chargée : pas relue si elle est rejouée
+
+    CinematicActor actors[CINEMATIC_MAX_ACTORS];
+    int actor_count;
+    CinematicTrack *tracks;
+    int track_count, track_capacity;
+    CinematicKey *keys;
+    int key_count, key_capacity;
+    char *names; // Noms d'animations, à la suite
+    int names_size, names_capacity;
+
+    Uint32 duration, tick;
+    bool playing;
+    float camera_x, camera_y; // Lus par le rendu
+    Uint8 fade;
+} Cinematic;
+
+void Cinematic_Free(Cinematic *cinematic);
+bool Cinematic_Load(Cinematic *cinematic, const char *name);
+
+// Prend la main sur les acteurs de `map` (IA et machine à états suspendues)
+// et applique le tick 0
+bool Cinematic_Start(Cinematic *cinematic, Map *map, EntityId player);
+// Un tick ; vrai une fois la scène terminée
+bool Cinematic_Update(Cinematic *cinematic);
+void Cinematic_Skip(Cinematic *cinematic); // Saute à l'état final
+void Cinematic_Stop(Cinematic *cinematic); // Rend les acteurs ; sans effet hors scène
+
+#endif // CINEMATIC_H
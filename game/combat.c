@@ -0,0 +1,245 @@
+#include "combat.h"
+#include <stdio.h>
+#include <string.h>
+
+// Couleur de chaque type, pour les attaques et les combattants
+static const SDL_Color typeColors[TYPE_COUNT] = {
+    {168, 168, 120, 255}, // Normal
+    {240, 128, 48, 255},  // Feu
+    {104, 144, 240, 255}, // Eau
+    {248, 208, 48, 255},  // Électrik
+    {120, 200, 80, 255},  // Plante
+    {152, 216, 216, 255}, // Glace
+    {192, 48, 40, 255},   // Combat
+    {160, 64, 160, 255},  // Poison
+    {224, 192, 104, 255}, // Sol
+    {168, 144, 240, 255}, // Vol
+    {248, 88, 136, 255},  // Psy
+    {168, 184, 32, 255},  // Insecte
+    {184, 160, 56, 255},  // Roche
+    {112, 88, 152, 255},  // Spectre
+    {112, 56, 248, 255},  // Dragon
+    {112, 88, 72, 255},   // Ténèbres
+    {184, 184, 208, 255}, // Acier
+    {238, 153, 172, 255}, // Fée
+};
+
+static SDL_Color Combat_TypeColor(int type)
+{
+    SDL_Color grey = {120, 120, 120, 255};
+    return type < TYPE_COUNT ? typeColors[type] : grey;
+}
+
+void Combat_Start(Combat *combat, const BattleData *data, Uint32 seed, BattleAI *ai)
+{
+    if (ai)
+        BattleAI_Cancel(ai); // Combat précédent interrompu (chargement de sauvegarde)
+
+    memset(combat, 0, sizeof(Combat));
+    combat->data = data;
+    combat->ai = ai;
+    Battle_Init(&combat->battle, seed);
+}
+
+void Combat_End(Combat *combat)
+{
+    if (combat->ai && combat->aiThinking)
+        BattleAI_Cancel(combat->ai);
+    combat->aiThinking = false;
+    combat->aiReady = false;
+}
+
+// Réflexion de l'adversaire sur le tour à venir, lancée dès le début du tour
+static void Combat_UpdateAI(Combat *combat)
+{
+    if (!combat->ai)
+        return;
+
+    if (!combat->aiThinking && !combat->aiReady)
+    {
+        // Graine tirée du combat : même décision à la relecture (sans limite de temps)
+        BattleAI_Start(combat->ai, combat->data, &combat->battle, 1, combat->aiBudgetMs,
+                       combat->aiIterations, Battle_Random(&combat->battle));
+        combat->aiThinking = true;
+    }
+
+    // Sans limite de temps, le résultat est attendu : le tour est résolu au
+    // même tick qu'à l'enregistrement
+    if (combat->aiThinking && combat->hasPending && combat->aiBudgetMs == 0)
+        BattleAI_Wait(combat->ai);
+
+    if (combat->aiThinking && BattleAI_Poll(combat->ai, &combat->aiAction))
+    {
+        combat->aiThinking = false;
+        combat->aiReady = true;
+    }
+}
+
+static void Combat_SelectMove(Combat *combat, const InputState *input);
+
+bool Combat_Update(Combat *combat, const InputState *input)
+{
+    BattleState *battle = &combat->battle;
+    if (battle->winner >= 0)
+        return (input->pressed & INPUT_BIT(INPUT_ACTION_CONFIRM)) != 0;
+
+    if (!combat->hasPending)
+        Combat_SelectMove(combat, input);
+    Combat_UpdateAI(combat);
+
+    if (!combat->hasPending || (combat->ai && !combat->aiReady))
+        return false;
+
+    BattleAction actions[2];
+    actions[0] = combat->pending;
+    actions[1] = combat->ai ? combat->aiAction : Battle_GreedyAction(battle, combat->data, 1);
+    Battle_Turn(battle, combat->data, actions);
+    combat->hasPending = false;
+    combat->aiReady = false;
+    return false;
+}
+
+// Curseur et choix de l'attaque du joueur
+static void Combat_SelectMove(Combat *combat, const InputState *input)
+{
+    BattleState *battle = &combat->battle;
+
+    // Grille 2 x 2 : gauche/droite changent la colonne, haut/bas la ligne
+    if (input->pressed & (INPUT_BIT(INPUT_ACTION_LEFT) | INPUT_BIT(INPUT_ACTION_RIGHT)))
+        combat->cursor ^= 1;
+    if (input->pressed & (INPUT_BIT(INPUT_ACTION_UP) | INPUT_BIT(INPUT_ACTION_DOWN)))
+        combat->cursor ^= 2;
+
+    if (!(input->pressed & INPUT_BIT(INPUT_ACTION_CONFIRM)))
+        return;
+
+    BattleAction legal[BATTLE_MAX_ACTIONS];
+    int count = Battle_GetActions(battle, combat->data, 0, legal);
+
+    combat->pending = legal[0]; // Lutte s'il ne reste aucun PP
+    bool found = legal[0].index == BATTLE_STRUGGLE;
+    for (int i = 0; i < count && !found; i++)
+    {
+        if (legal[i].type == BATTLE_ACTION_MOVE && legal[i].index == combat->cursor)
+        {
+            combat->pending = legal[i];
+            found = true;
+        }
+    }
+    combat->hasPending = found; // Rien si l'emplacement est vide ou sans PP
+}
+
+// Combattant actif : carré de la couleur de son type, barre de PV et équipe
+static void Combat_RenderSide(const Combat *combat, RenderList *list, Font *font, int side, int x, int y, int size)
+{
+    const BattleSide *team = &combat->battle.sides[side];
+    const BattleMon *mon = &team->team[team->active];
+    const BattleSpecies *species = &combat->data->species[mon->species];
+
+    SDL_Color outline = {40, 40, 40, 255};
+    SDL_Rect body = {x, y, size, size};
+    RenderList_Rect(list, &body, Combat_TypeColor(species->types[0]), true);
+    if (species->types[1] != TYPE_NONE)
+    {
+        SDL_Rect second = {x, y + size * 2 / 3, size, size / 3};
+        RenderList_Rect(list, &second, Combat_TypeColor(species->types[1]), true);
+    }
+    RenderList_Rect(list, &body, outline, false);
+
+    // Barre de PV : verte, jaune sous la moitié, rouge sous le quart
+    SDL_Rect bar = {x, y - 16, size, 8};
+    SDL_Color empty = {60, 60, 60, 255};
+    SDL_Color fill = {72, 200, 80, 255};
+    int maxHp = mon->stats[STAT_HP] > 0 ? mon->stats[STAT_HP] : 1;
+    if (mon->hp * 4 < maxHp)
+        fill = (SDL_Color){220, 60, 40, 255};
+    else if (mon->hp * 2 < maxHp)
+        fill = (SDL_Color){230, 190, 40, 255};
+    RenderList_Rect(list, &bar, empty, true);
+    bar.w = size * mon->hp / maxHp;
+    RenderList_Rect(list, &bar, fill, true);
+
+    // Une pastille par membre de l'équipe, grisée s'il est K.O.
+    for (int i = 0; i < team->count; i++)
+    {
+        SDL_Rect dot = {x + i * 12, y - 30, 8, 8};
+        SDL_Color alive = {240, 240, 240, 255};
+        RenderList_Rect(list, &dot, team->team[i].hp > 0 ? alive : empty, true);
+    }
+
+    // Nom et niveau au-dessus des pastilles, PV sous le combattant
+    char text[BATTLE_NAME_LENGTH + 16];
+    snprintf(text, sizeof(text), "%s Nv%d", species->name, mon->level);
+    Font_Draw(font, list, text, x, y - 48, 0, 1, outline, -1);
+    snprintf(text, sizeof(text), "PV %d/%d", mon->hp, mon->stats[STAT_HP]);
+    Font_Draw(font, list, text, x, y + size + 6, 0, 1, outline, -1);
+}
+
+void Combat_Render(const Combat *combat, RenderList *list, Font *font, int width, int height)
+{
+    SDL_Color background = {232, 232, 216, 255};
+    SDL_Rect screen = {0, 0, width, height};
+    RenderList_Rect(list, &screen, background, true);
+
+    int size = height / 5;
+    Combat_RenderSide(combat, list, font, 1, width * 2 / 3, height / 8, size);
+    Combat_RenderSide(combat, list, font, 0, width / 6, height / 2 - size / 2, size);
+
+    // Attaques du joueur : couleur du type, nom et PP restants
+    const BattleMon *mon = &combat->battle.sides[0].team[combat->battle.sides[0].active];
+    int panelY = height * 3 / 4;
+    int slotW = width / 2 - 24;
+    int slotH = (height - panelY) / 2 - 12;
+    SDL_Color cursorColor = {20, 20, 20, 255};
+    SDL_Color emptyColor = {200, 200, 200, 255};
+
+    for (int i = 0; i < BATTLE_MAX_MOVES; i++)
+    {
+        SDL_Rect slot = {16 + (i & 1) * (slotW + 16), panelY + (i >> 1) * (slotH + 8), slotW, slotH};
+        if (mon->moves[i] == BATTLE_NO_MOVE)
+        {
+            RenderList_Rect(list, &slot, emptyColor, true);
+            continue;
+        }
+
+        const BattleMove *move = &combat->data->moves[mon->moves[i]];
+        RenderList_Rect(list, &slot, Combat_TypeColor(move->type), true);
+        Font_Draw(font, list, move->name, slot.x + 8, slot.y + 8, slot.w - 16, 2, cursorColor, -1);
+        if (move->pp > 0)
+        {
+            char pp_text[16];
+            snprintf(pp_text, sizeof(pp_text), "PP %d/%d", mon->pp[i], move->pp);
+            Font_Draw(font, list, pp_text, slot.x + 8, slot.y + slot.h - 20, 0, 1, cursorColor, -1);
+
+            SDL_Rect pp = {slot.x + 4, slot.y + slot.h - 8, (slot.w - 8) * mon->pp[i] / move->pp, 4};
+            RenderList_Rect(list, &pp, cursorColor, true);
+        }
+        if (i == combat->cursor)
+        {
+            RenderList_Rect(list, &slot, cursorColor, false);
+            SDL_Rect inner = {slot.x + 2, slot.y + 2, slot.w - 4, slot.h - 4};
+            RenderList_Rect(list, &inner, cursorColor, false);
+        }
+    }
+
+    // Adversaire encore en réflexion : points de suspension qui s'allongent
+    if (combat->hasPending)
+    {
+        static const char *const dots[] = {".", "..", "..."};
+        Font_Draw(font, list, dots[(SDL_GetTicks() / 250) % 3], width * 2 / 3 + size + 8, height / 8 + size / 2, 0, 2,
+                  cursorColor, -1);
+    }
+
+    // Fin du combat : voile vert (victoire) ou rouge, en attente de validation
+    if (combat->battle.winner >= 0)
+    {
+        SDL_Color won = {40, 160, 60, 90};
+        SDL_Color lost = {160, 40, 40, 90};
+        RenderList_Rect(list, &screen, combat->battle.winner == 0 ? won : lost, true);
+
+        const char *message = combat->battle.winner == 0 ? "Victoire !" : "Défaite...";
+        const FontLayout *layout = Font_Layout(font, message, 0, 4);
+        if (layout)
+            Font_Draw(font, list, message, (width - layout->width) / 2, height / 3, 0, 4, cursorColor, -1);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef COMBAT_H
+#define COMBAT_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "battle.h"
+#include "battleai.h"
+#include "input.h"
+#include "../framework/renderlist.h"
+#include "../framework/font.h"
+
+// Écran de combat (MODE_COMBAT) : entrées du joueur et affichage autour du
+// moteur pur de battle.h. Le joueur est le camp 0, l'adversaire le camp 1.
+// L'adversaire réfléchit (battleai.h) pendant que le joueur choisit ; sans
+// IA, il joue le coup glouton.
+
+typedef struct
+{
+    BattleState battle;
+    const BattleData *data;
+    int cursor; // Attaque sélectionnée, grille 2 x 2
+
+    BattleAI *ai;         // NULL : adversaire glouton
+    Uint32 aiBudgetMs;    // Temps de réflexion par tour (difficulté)
+    Uint32 aiIterations;  // Simulations par thread, 0 : pas de limite
+    bool aiThinking;
+    bool aiReady;
+    BattleAction aiAction;
+    bool hasPending;      // Le joueur a choisi, l'adversaire réfléchit encore
+    BattleAction pending;
+} Combat;
+
+// Combat vide : les équipes sont ajoutées ensuite avec Battle_AddMon. La
+// réflexion de l'adversaire commence au premier Combat_Update.
+void Combat_Start(Combat *combat, const BattleData *data, Uint32 seed, BattleAI *ai);
+void Combat_End(Combat *combat); // Abandonne la réflexion en cours
+// Un tick ; vrai quand le combat est terminé et que le joueur l'a validé
+bool Combat_Update(Combat *combat, const InputState *input);
+// `font` NULL : cases et barres seules, sans texte
+void Combat_Render(const Combat *combat, RenderList *list, Font *font, int width, int height);
+
+#endif // COMBAT_H
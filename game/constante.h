@@ -4,12 +4,64 @@
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
 #define SCREEN_TITLE "Pokemon V2"
+#define GAME_START_MAP "map3"
 #define PLAYER_HITBOX_WIDTH 15
 #define PLAYER_HITBOX_HEIGHT 5
 #define PLAYER_WIDTH 25
 #define PLAYER_HEIGHT 32
 #define PLAYER_SPEED 50
+#define PLAYER_SPRITE_PATH "resources/sprites/player.png"
 #define NPC_HITBOX_WIDTH 25
 #define NPC_HITBOX_HEIGHT 32
+#define NPC_REFERENCE_SPEED 50 // Vitesse (px/s) à laquelle la marche des PNJ est jouée à vitesse normale
+#define LOADER_MAX_THREADS 4
+#define LOADER_FRAME_BUDGET_MS 4
+#define ASSET_PACK_PATH "resources.pak"
+#define MAP_CACHE_CAPACITY 4 // Maps visitées et passages préchargés ; + MAP_MAX_NEIGHBOURS avec un monde
+#define MAP_PRELOAD_DISTANCE 48
+#define GAME_WORLD_PATH "resources/maps/world.world"
+#define WORLD_LINK_DISTANCE 16     // Voisines reliées : celles qui touchent un bord ou un coin
+#define WORLD_SWITCH_MARGIN 8      // Pixels à franchir au-delà du bord avant de changer de map courante
+#define GAME_STATE_STACK_MAX 8
+
+// Budgets mémoire (tas + textures estimées, en octets), 0 pour aucun
+#define MEM_BUDGET_TOTAL (256u * 1024 * 1024)
+#define MEM_BUDGET_MAP (96u * 1024 * 1024)
+#define MEM_BUDGET_TMX (32u * 1024 * 1024)
+#define MEM_BUDGET_ENTITY (32u * 1024 * 1024)
+#define MEM_BUDGET_NPC (1u * 1024 * 1024)
+#define MEM_REPORT_KEY SDLK_F3
+
+// Simulation à pas fixe : indispensable pour rejouer un journal d'entrées
+#define SIM_TICK_RATE 60
+#define SIM_TIMESTEP (1.0f / SIM_TICK_RATE)
+#define SIM_MAX_TICKS_PER_FRAME 8 // Au-delà, le retard est abandonné
+#define REPLAY_FRAME_BUDGET_MS 16 // Relecture : ticks enchaînés entre deux images
+
+// Sauvegardes : instantané capturé entre deux ticks, écrit en arrière-plan
+#define QUICKSAVE_PATH "quicksave.sav"
+#define AUTOSAVE_PATH "autosave.sav"
+#define AUTOSAVE_INTERVAL_TICKS (60u * SIM_TICK_RATE) // Une minute de jeu
+#define QUICKSAVE_KEY SDLK_F5
+#define QUICKLOAD_KEY SDLK_F9
+
+// Combats
+#define GAMEDB_PATH "resources/data/game.db" // make db
+#define PLAYER_STARTER "Charmander"
+#define PLAYER_STARTER_LEVEL 10
+#define BATTLE_DEBUG_KEY SDLK_F6 // Combat contre une espèce tirée au hasard
+#define BATTLE_AI_BUDGET_MS 150   // Réflexion de l'adversaire par tour : la difficulté
+#define BATTLE_AI_ITERATIONS 2000 // Par thread, à la place du temps pendant un enregistrement
+#define BATTLE_AI_NODES 32768     // Nœuds par thread (≈ 4 Mo)
+#define BATTLE_AI_THREADS 3       // Fixe : un journal se rejoue à l'identique sur toute machine
+#define ENCOUNTER_STEP_PERCENT 10 // Chance de rencontre à chaque tuile d'une zone
+
+// Boîtes de dialogue (panneaux)
+#define DIALOGUE_MAX_LENGTH 256
+#define DIALOGUE_REVEAL_CPS 40 // Caractères affichés par seconde
+
+// Cinématiques (déclencheurs "cutscene" des maps)
+#define CINEMATIC_DIR "resources/cutscenes/" // <nom>.cut, voir cinematic.h
+#define CINEMATIC_BAR_HEIGHT 48               // Bandes noires en haut et en bas de l'écran
 
 #endif // CONSTANTE_H
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "ecs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framework/memtrack.h"
+
+#define ENTITY_INDEX_MASK (ENTITY_MAX - 1)
+
+typedef struct
+{
+    size_t size;        // Taille d'un composant
+    void *data;         // Composants, sans trous
+    EntityId *entities; // Propriétaire de chaque composant
+    int count;
+    int capacity;
+    int *sparse; // Index d'entité -> position dans data (-1 si absent)
+    int sparseCapacity;
+} ComponentPool;
+
+static struct
+{
+    Uint32 *generations; // Génération courante de chaque emplacement
+    bool *alive;
+    bool *active;
+    int capacity;     // Emplacements créés
+    int slotCapacity; // Emplacements alloués
+    int *freeSlots;
+    int freeCount;
+    int aliveCount;
+
+    ComponentPool pools[COMPONENT_COUNT];
+} ecs = {0};
+
+static const size_t componentSizes[COMPONENT_COUNT] = {
+    sizeof(Transform), sizeof(Hitbox), sizeof(Sprite), sizeof(Animator),
+    sizeof(Mover), sizeof(AI), sizeof(Collider), sizeof(TriggerContact)};
+
+static void ECS_Grow(void **array, int *capacity, int needed, size_t elementSize)
+{
+    if (needed <= *capacity)
+        return;
+
+    int newCapacity = *capacity ? *capacity * 2 : 64;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+
+    void *grown = Mem_Realloc(MEM_TAG_ENTITY, *array, newCapacity * elementSize);
+    if (!grown)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour les entités.\n");
+        exit(EXIT_FAILURE);
+    }
+    *array = grown;
+    *capacity = newCapacity;
+}
+
+static int ECS_Index(EntityId id)
+{
+    int index = (int)(id & ENTITY_INDEX_MASK);
+    if (id == ENTITY_NONE || index >= ecs.capacity || !ecs.alive[index] ||
+        ecs.generations[index] != id >> ENTITY_INDEX_BITS)
+        return -1;
+    return index;
+}
+
+// --- Entités ---
+
+EntityId ECS_CreateEntity(void)
+{
+    int index;
+    if (ecs.freeCount > 0)
+    {
+        index = ecs.freeSlots[--ecs.freeCount];
+    }
+    else
+    {
+        if (ecs.capacity >= ENTITY_MAX)
+        {
+            fprintf(stderr, "Erreur: nombre maximal d'entités atteint.\n");
+            return ENTITY_NONE;
+        }
+
+        index = ecs.capacity;
+        if (index >= ecs.slotCapacity)
+        {
+            // Les quatre tableaux partagent la même capacité
+            int capacity = ecs.slotCapacity;
+            ECS_Grow((void **)&ecs.generations, &capacity, index + 1, sizeof(Uint32));
+            capacity = ecs.slotCapacity;
+            ECS_Grow((void **)&ecs.alive, &capacity, index + 1, sizeof(bool));
+            capacity = ecs.slotCapacity;
+            ECS_Grow((void **)&ecs.active, &capacity, index + 1, sizeof(bool));
+            capacity = ecs.slotCapacity;
+            ECS_Grow((void **)&ecs.freeSlots, &capacity, index + 1, sizeof(int));
+            ecs.slotCapacity = capacity;
+        }
+
+        ecs.generations[index] = 0;
+        ecs.capacity++;
+    }
+
+    // Génération 0 exclue : l'identifiant n'est jamais ENTITY_NONE
+    Uint32 generation = (ecs.generations[index] + 1) & ((1u << (32 - ENTITY_INDEX_BITS)) - 1);
+    ecs.generations[index] = generation ? generation : 1;
+    ecs.alive[index] = true;
+    ecs.active[index] = true;
+    ecs.aliveCount++;
+
+    return (ecs.generations[index] << ENTITY_INDEX_BITS) | (Uint32)index;
+}
+
+void ECS_DestroyEntity(EntityId id)
+{
+    int index = ECS_Index(id);
+    if (index < 0)
+        return;
+
+    for (int type = 0; type < COMPONENT_COUNT; type++)
+    {
+        ECS_Remove(id, (ComponentType)type);
+    }
+
+    ecs.alive[index] = false;
+    ecs.active[index] = false;
+    ecs.freeSlots[ecs.freeCount++] = index;
+    ecs.aliveCount--;
+}
+
+bool ECS_IsAlive(EntityId id)
+{
+    return ECS_Index(id) >= 0;
+}
+
+void ECS_SetActive(EntityId id, bool active)
+{
+    int index = ECS_Index(id);
+    if (index >= 0)
+        ecs.active[index] = active;
+}
+
+bool ECS_IsActive(EntityId id)
+{
+    int index = ECS_Index(id);
+    return index >= 0 && ecs.active[index];
+}
+
+// --- Composants ---
+
+// Ressources tenues par un composant, rendues à son retrait
+static void ECS_ReleaseComponent(ComponentType type, void *component)
+{
+    switch (type)
+    {
+    case COMPONENT_SPRITE:
+        AnimSet_Release(((Sprite *)component)->set);
+        break;
+    case COMPONENT_ANIMATOR:
+        AnimSystem_Destroy(((Animator *)component)->anim);
+        break;
+    default:
+        break;
+    }
+}
+
+void *ECS_Add(EntityId id, ComponentType type)
+{
+    int index = ECS_Index(id);
+    if (index < 0 || type < 0 || type >= COMPONENT_COUNT)
+        return NULL;
+
+    ComponentPool *pool = &ecs.pools[type];
+    void *existing = ECS_Get(id, type);
+    if (existing)
+        return existing;
+
+    if (index >= pool->sparseCapacity)
+    {
+        int oldCapacity = pool->sparseCapacity;
+        ECS_Grow((void **)&pool->sparse, &pool->sparseCapacity, index + 1, sizeof(int));
+        memset(pool->sparse + oldCapacity, 0xFF, (pool->sparseCapacity - oldCapacity) * sizeof(int));
+    }
+
+    pool->size = componentSizes[type];
+    if (pool->count >= pool->capacity)
+    {
+        int capacity = pool->capacity;
+        ECS_Grow(&pool->data, &capacity, pool->count + 1, pool->size);
+        ECS_Grow((void **)&pool->entities, &pool->capacity, pool->count + 1, sizeof(EntityId));
+    }
+
+    int dense = pool->count++;
+    pool->sparse[index] = dense;
+    pool->entities[dense] = id;
+
+    void *component = (char *)pool->data + dense * pool->size;
+    memset(component, 0, pool->size);
+    return component;
+}
+
+void *ECS_Get(EntityId id, ComponentType type)
+{
+    int index = ECS_Index(id);
+    if (index < 0 || type < 0 || type >= COMPONENT_COUNT)
+        return NULL;
+
+    const ComponentPool *pool = &ecs.pools[type];
+    if (index >= pool->sparseCapacity || pool->sparse[index] < 0)
+        return NULL;
+    return (char *)pool->data + pool->sparse[index] * pool->size;
+}
+
+void ECS_Remove(EntityId id, ComponentType type)
+{
+    void *component = ECS_Get(id, type);
+    if (!component)
+        return;
+
+    ComponentPool *pool = &ecs.pools[type];
+    int index = (int)(id & ENTITY_INDEX_MASK);
+    int dense = pool->sparse[index];
+
+    ECS_ReleaseComponent(type, component);
+
+    // Retrait en O(1) : le dernier composant prend la place libérée
+    int last = --pool->count;
+    if (dense != last)
+    {
+        memcpy(component, (char *)pool->data + last * pool->size, pool->size);
+        pool->entities[dense] = pool->entities[last];
+        pool->sparse[pool->entities[dense] & ENTITY_INDEX_MASK] = dense;
+    }
+    pool->sparse[index] = -1;
+}
+
+int ECS_Count(ComponentType type)
+{
+    return type >= 0 && type < COMPONENT_COUNT ? ecs.pools[type].count : 0;
+}
+
+void *ECS_Components(ComponentType type)
+{
+    return type >= 0 && type < COMPONENT_COUNT ? ecs.pools[type].data : NULL;
+}
+
+const EntityId *ECS_Entities(ComponentType type)
+{
+    return type >= 0 && type < COMPONENT_COUNT ? ecs.pools[type].entities : NULL;
+}
+
+int ECS_EntityCount(void)
+{
+    return ecs.aliveCount;
+}
+
+void ECS_Shutdown(void)
+{
+    if (ecs.aliveCount > 0)
+        fprintf(stderr, "Avertissement: %d entité(s) encore en vie à l'arrêt.\n", ecs.aliveCount);
+
+    for (int type = 0; type < COMPONENT_COUNT; type++)
+    {
+        Mem_Free(ecs.pools[type].data);
+        Mem_Free(ecs.pools[type].entities);
+        Mem_Free(ecs.pools[type].sparse);
+    }
+    Mem_Free(ecs.generations);
+    Mem_Free(ecs.alive);
+    Mem_Free(ecs.active);
+    Mem_Free(ecs.freeSlots);
+    memset(&ecs, 0, sizeof(ecs));
+}
+
+Transform *ECS_GetTransform(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_TRANSFORM);
+}
+
+Hitbox *ECS_GetHitbox(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_HITBOX);
+}
+
+Sprite *ECS_GetSprite(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_SPRITE);
+}
+
+Animator *ECS_GetAnimator(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_ANIMATOR);
+}
+
+Mover *ECS_GetMover(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_MOVER);
+}
+
+AI *ECS_GetAI(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_AI);
+}
+
+Collider *ECS_GetCollider(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_COLLIDER);
+}
+
+TriggerContact *ECS_GetTriggerContact(EntityId id)
+{
+    return ECS_Get(id, COMPONENT_TRIGGER_CONTACT);
+}
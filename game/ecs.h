@@ -0,0 +1,128 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "animset.h"
+#include "animsystem.h"
+
+// Entités et composants : une entité n'est qu'un identifiant, ses données sont
+// rangées par type de composant dans des tableaux denses (ensembles creux).
+// Les systèmes (systems.h) parcourent un tableau et ne consultent les autres
+// composants que par l'identifiant.
+
+// Index (20 bits) + génération (12 bits) : un identifiant détruit n'est jamais
+// confondu avec l'entité qui réutilise son emplacement
+typedef Uint32 EntityId;
+#define ENTITY_NONE 0
+#define ENTITY_INDEX_BITS 20
+#define ENTITY_MAX (1 << ENTITY_INDEX_BITS)
+
+typedef enum
+{
+    COMPONENT_TRANSFORM,
+    COMPONENT_HITBOX,
+    COMPONENT_SPRITE,
+    COMPONENT_ANIMATOR,
+    COMPONENT_MOVER,
+    COMPONENT_AI,
+    COMPONENT_COLLIDER,
+    COMPONENT_TRIGGER_CONTACT,
+    COMPONENT_COUNT
+} ComponentType;
+
+typedef struct
+{
+    float x, y; // Coin haut gauche du sprite, dans le monde
+} Transform;
+
+// Rectangle de collision placé aux pieds du sprite
+typedef struct
+{
+    int width, height;
+    SDL_Rect rect; // Recalculé par System_UpdateHitboxes
+} Hitbox;
+
+typedef struct
+{
+    AnimationSet *set; // Référence retenue (relâchée avec le composant)
+    int width, height; // Taille du sprite de l'animation courante
+} Sprite;
+
+typedef struct
+{
+    AnimHandle anim; // Lecture dans le système d'animation
+} Animator;
+
+// Déplacement : direction continue ou cible à atteindre
+typedef struct
+{
+    float speed;                  // Pixels par seconde
+    float dirX, dirY;             // Direction continue (-1, 0 ou 1)
+    bool hasTarget;               // Aller jusqu'à (targetX, targetY), prioritaire sur la direction nulle
+    float targetX, targetY;
+    int facing;                   // Convention de ANIM_PARAM_FACING
+    bool moved, blocked, arrived; // Résultats de la dernière passe
+} Mover;
+
+typedef enum
+{
+    AI_STATIC, // Reste sur place (orientation fixe)
+    AI_WANDER  // Alterne pauses et petits déplacements au hasard
+} AIBehaviour;
+
+typedef struct
+{
+    AIBehaviour behaviour;
+    float actionTimer;
+    float actionDuration;
+} AI;
+
+typedef struct
+{
+    bool solid; // Bloque les autres entités qui ont un Collider
+} Collider;
+
+// Zones de déclenchement de la map touchées au dernier tick, par indice
+// croissant (System_UpdateTriggers). Au-delà de TRIGGER_MAX_CONTACTS zones
+// superposées, les dernières sont ignorées et la map est signalée.
+#define TRIGGER_MAX_CONTACTS 8
+typedef struct
+{
+    Uint16 zones[TRIGGER_MAX_CONTACTS];
+    int count;
+    bool primed; // Faux : le prochain tick relève les zones touchées sans événement
+} TriggerContact;
+
+EntityId ECS_CreateEntity(void);
+void ECS_DestroyEntity(EntityId id); // Retire aussi tous ses composants
+bool ECS_IsAlive(EntityId id);
+
+// Une entité inactive (PNJ d'une map en cache) est ignorée par les systèmes
+void ECS_SetActive(EntityId id, bool active);
+bool ECS_IsActive(EntityId id);
+
+// Les pointeurs de composants sont invalidés par tout ajout ou retrait du même type
+void *ECS_Add(EntityId id, ComponentType type); // Mis à zéro ; l'existant s'il y en a un
+void *ECS_Get(EntityId id, ComponentType type); // NULL si absent
+void ECS_Remove(EntityId id, ComponentType type);
+
+// Parcours dense d'un type : ECS_Components(type)[i] appartient à ECS_Entities(type)[i]
+int ECS_Count(ComponentType type);
+void *ECS_Components(ComponentType type);
+const EntityId *ECS_Entities(ComponentType type);
+
+int ECS_EntityCount(void);
+void ECS_Shutdown(void);
+
+// Accès typés
+Transform *ECS_GetTransform(EntityId id);
+Hitbox *ECS_GetHitbox(EntityId id);
+Sprite *ECS_GetSprite(EntityId id);
+Animator *ECS_GetAnimator(EntityId id);
+Mover *ECS_GetMover(EntityId id);
+AI *ECS_GetAI(EntityId id);
+Collider *ECS_GetCollider(EntityId id);
+TriggerContact *ECS_GetTriggerContact(EntityId id);
+
+#endif // ECS_H
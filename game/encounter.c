@@ -0,0 +1,179 @@
+#include "encounter.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constante.h"
+#include "../framework/memtrack.h"
+
+static Uint32 Encounters_Random(Encounters *encounters)
+{
+    Uint32 x = encounters->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    encounters->rng = x;
+    return x;
+}
+
+// Entier dans [0, n) sans division (multiplication de Lemire)
+static Uint32 Encounters_Range(Encounters *encounters, Uint32 n)
+{
+    return (Uint32)(((Uint64)Encounters_Random(encounters) * n) >> 32);
+}
+
+void Encounters_Init(Encounters *encounters, Uint32 seed)
+{
+    memset(encounters, 0, sizeof(Encounters));
+    encounters->rate = (Uint32)((Uint64)ENCOUNTER_STEP_PERCENT * 0xFFFFFFFFu / 100);
+    Encounters_Seed(encounters, seed);
+    Encounters_Reset(encounters);
+}
+
+void Encounters_Seed(Encounters *encounters, Uint32 seed)
+{
+    encounters->rng = seed ? seed : 0x9E3779B9u; // xorshift : jamais nul
+}
+
+void Encounters_Free(Encounters *encounters)
+{
+    Mem_Free(encounters->slots);
+    encounters->slots = NULL;
+    encounters->slot_capacity = 0;
+    encounters->zone_count = 0;
+}
+
+void Encounters_Reset(Encounters *encounters)
+{
+    encounters->tile_x = INT_MIN;
+    encounters->tile_y = INT_MIN;
+}
+
+// Méthode de Vose : les entrées sous la moyenne sont complétées par une entrée
+// au-dessus, qui devient leur alias. Poids mis à l'échelle par `count` et
+// comparés au total, en entiers : la table est exacte.
+static void Encounters_BuildTable(EncounterSlot *slots, const GameDBEncounter *entries, Uint32 count, Uint32 total)
+{
+    Uint64 scaled[ENCOUNTER_MAX_SLOTS];
+    Uint32 small[ENCOUNTER_MAX_SLOTS], large[ENCOUNTER_MAX_SLOTS];
+    Uint32 smallCount = 0, largeCount = 0;
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        slots[i].species = entries[i].species;
+        slots[i].min_level = entries[i].min_level;
+        slots[i].level_span = (Uint8)(entries[i].max_level - entries[i].min_level + 1);
+        slots[i].alias = (Uint8)i;
+        slots[i].threshold = 0xFFFFFFFFu;
+
+        scaled[i] = (Uint64)entries[i].weight * count;
+        if (scaled[i] < total)
+            small[smallCount++] = i;
+        else
+            large[largeCount++] = i;
+    }
+
+    while (smallCount > 0 && largeCount > 0)
+    {
+        Uint32 s = small[--smallCount];
+        Uint32 l = large[largeCount - 1];
+
+        slots[s].threshold = (Uint32)((scaled[s] << 32) / total);
+        slots[s].alias = (Uint8)l;
+
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total)
+        {
+            largeCount--;
+            small[smallCount++] = l;
+        }
+    }
+    // Restes (arrondis) : gardés à coup sûr, alias sur eux-mêmes
+}
+
+void Encounters_Build(Encounters *encounters, const GameDB *db, const Map *map)
+{
+    encounters->zone_count = 0;
+    Encounters_Reset(encounters);
+    if (!db || !map)
+        return;
+
+    // Une seule allocation pour toutes les zones de la map
+    int areas[MAP_MAX_ENCOUNTER_ZONES];
+    Uint32 total = 0;
+    for (int z = 0; z < map->encounter_zone_count; z++)
+    {
+        int count = 0;
+        areas[z] = GameDB_FindArea(db, map->encounter_zones[z]);
+        if (areas[z] < 0)
+            printf("Zone de rencontres inconnue de la base: %s (%s)\n", map->encounter_zones[z], map->filename);
+        else if (GameDB_GetEncounters(db, areas[z], &count) && count > 0 && count <= ENCOUNTER_MAX_SLOTS)
+            total += (Uint32)count;
+        else
+            areas[z] = -1; // Vide, ou trop d'entrées pour une table
+    }
+
+    if (total > encounters->slot_capacity)
+    {
+        EncounterSlot *slots = Mem_Realloc(MEM_TAG_BATTLE, encounters->slots, total * sizeof(EncounterSlot));
+        if (!slots)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour les rencontres.\n");
+            exit(EXIT_FAILURE);
+        }
+        encounters->slots = slots;
+        encounters->slot_capacity = total;
+    }
+
+    Uint32 used = 0;
+    for (int z = 0; z < map->encounter_zone_count; z++)
+    {
+        EncounterTable *table = &encounters->tables[z];
+        table->slots = NULL;
+        table->count = 0;
+        if (areas[z] < 0)
+            continue;
+
+        int count;
+        const GameDBEncounter *entries = GameDB_GetEncounters(db, areas[z], &count);
+        Uint32 weight = db->areas[areas[z]].total_weight;
+        if (weight == 0)
+            continue;
+
+        EncounterSlot *slots = encounters->slots + used;
+        Encounters_BuildTable(slots, entries, (Uint32)count, weight);
+        table->slots = slots;
+        table->count = (Uint32)count;
+        used += (Uint32)count;
+    }
+    encounters->zone_count = map->encounter_zone_count;
+}
+
+bool Encounters_Step(Encounters *encounters, const Map *map, int tile_x, int tile_y, int *species, int *level)
+{
+    // Même tuile qu'au tick précédent : rien à faire (cas de presque tous les ticks)
+    if (tile_x == encounters->tile_x && tile_y == encounters->tile_y)
+        return false;
+
+    bool placed = encounters->tile_x != INT_MIN;
+    encounters->tile_x = tile_x;
+    encounters->tile_y = tile_y;
+    if (!placed)
+        return false;
+
+    int zone = Map_GetEncounterZone(map, tile_x, tile_y);
+    if (zone < 0 || zone >= encounters->zone_count || encounters->tables[zone].count == 0)
+        return false;
+    if (Encounters_Random(encounters) >= encounters->rate)
+        return false;
+
+    const EncounterTable *table = &encounters->tables[zone];
+    Uint32 index = Encounters_Range(encounters, table->count);
+    const EncounterSlot *slot = &table->slots[index];
+    if (Encounters_Random(encounters) >= slot->threshold)
+        slot = &table->slots[slot->alias];
+
+    *species = slot->species;
+    *level = slot->min_level + (int)Encounters_Range(encounters, slot->level_span);
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef ENCOUNTER_H
+#define ENCOUNTER_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "gamedb.h"
+#include "../framework/map.h"
+
+// Rencontres sauvages. Chaque zone de la map courante (grille cuite, voir
+// Map_GetEncounterZone) est compilée à l'entrée sur la map en table d'alias
+// de Walker : tirer une espèce et son niveau coûte trois nombres aléatoires,
+// quel que soit le nombre d'entrées. Le test d'un pas est une lecture de la
+// grille, fait seulement quand le joueur change de tuile.
+
+#define ENCOUNTER_MAX_SLOTS 256 // Entrées par zone
+
+typedef struct
+{
+    Uint32 threshold; // Tirage < seuil : cette entrée, sinon son alias
+    Uint16 species;
+    Uint8 alias;
+    Uint8 min_level;
+    Uint8 level_span; // max_level - min_level + 1
+} EncounterSlot;
+
+typedef struct
+{
+    const EncounterSlot *slots; // NULL : zone absente de la base
+    Uint32 count;
+} EncounterTable;
+
+typedef struct
+{
+    EncounterTable tables[MAP_MAX_ENCOUNTER_ZONES]; // Par zone de la map courante
+    int zone_count;
+    EncounterSlot *slots; // Toutes les tables, réutilisé d'une map à l'autre
+    Uint32 slot_capacity;
+
+    Uint32 rng;         // xorshift32
+    Uint32 rate;        // Chance de rencontre par pas, sur 2^32
+    int tile_x, tile_y; // Dernière tuile du joueur
+} Encounters;
+
+void Encounters_Init(Encounters *encounters, Uint32 seed);
+void Encounters_Free(Encounters *encounters);
+// Même graine, mêmes rencontres : celle de la partie, enregistrée avec les entrées
+void Encounters_Seed(Encounters *encounters, Uint32 seed);
+
+// Compile les tables des zones de `map` (db NULL : aucune rencontre)
+void Encounters_Build(Encounters *encounters, const GameDB *db, const Map *map);
+// Oublie la dernière tuile (téléportation, chargement) : pas de test sur place
+void Encounters_Reset(Encounters *encounters);
+
+// Pas du joueur sur la tuile (x, y) : vrai si une rencontre se déclenche
+bool Encounters_Step(Encounters *encounters, const Map *map, int tile_x, int tile_y, int *species, int *level);
+
+#endif // ENCOUNTER_H
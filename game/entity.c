@@ -1,203 +1,182 @@
 #include "entity.h"
-#include <SDL_image.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
 // --- Fonctions d'aide internes ---
 
-static int findAnimationIndex(Entity *entity, const char *animationName)
+// Retourne l'ensemble privé de l'entité, en le créant si besoin.
+// Un ensemble partagé via le registre ne doit plus être modifié.
+static AnimationSet *Entity_GetPrivateSet(EntityId entity)
 {
-    for (int i = 0; i < entity->animationCount; ++i)
+    Sprite *sprite = ECS_GetSprite(entity);
+    if (!sprite)
+        return NULL;
+
+    if (!sprite->set)
+    {
+        sprite->set = AnimSet_Create();
+        AnimSet_Retain(sprite->set);
+    }
+    else if (sprite->set->key[0] != '\0')
     {
-        if (strcmp(entity->animations[i].name, animationName) == 0)
-        {
-            return i;
-        }
+        fprintf(stderr, "Erreur: l'ensemble d'animations '%s' est partagé et ne peut plus être modifié.\n", sprite->set->key);
+        return NULL;
     }
-    return -1;
+    return sprite->set;
 }
 
-// Fonction d'aide pour trouver l'index d'une feuille de sprites par son nom
-static int findSpriteSheetIndex(Entity *entity, const char *spriteSheetName)
+static int Entity_CurrentIndex(EntityId entity)
 {
-    for (int i = 0; i < entity->spriteSheetCount; ++i)
-    {
-        if (strcmp(entity->spriteSheets[i].name, spriteSheetName) == 0)
-        {
-            return i;
-        }
-    }
-    return -1;
+    const Animator *animator = ECS_GetAnimator(entity);
+    const AnimPlayback *playback = animator ? AnimSystem_Get(animator->anim) : NULL;
+    return playback ? playback->animationIndex : -1;
 }
 
-// Initialisation de l'entité, sans chargement de spriteSheet.
-bool Entity_Init(Entity *entity, int spriteWidth, int spriteHeight, float x, float y, int hitboxWidth, int hitboxHeight, bool traversable)
+// Aligne la taille du sprite sur la feuille de l'animation courante
+static void Entity_UpdateSpriteSize(EntityId entity)
 {
-    memset(entity, 0, sizeof(Entity)); // Initialise à zéro
+    Sprite *sprite = ECS_GetSprite(entity);
+    Animation *currentAnim = Entity_GetCurrentAnimation(entity);
+    if (!sprite || !currentAnim)
+        return;
 
-    entity->x = x;
-    entity->y = y;
-    // La hitbox est initialisée ici mais ses dimensions peuvent être ajustées plus tard
-    entity->hitbox.x = (int)(x + spriteWidth / 2 - hitboxWidth / 2);
-    entity->hitbox.y = (int)(y + spriteHeight - hitboxHeight);
-    entity->hitbox.w = hitboxWidth;
-    entity->hitbox.h = hitboxHeight;
-    entity->traversable = traversable;
-
-    // Initialisation des listes de spriteSheets et d'animations
-    entity->spriteSheets = NULL;
-    entity->spriteSheetCount = 0;
-    entity->animations = NULL;
-    entity->animationCount = 0;
-
-    entity->currentAnimationIndex = -1;
-    entity->currentFrameIndex = 0;
-    entity->frameTimer = 0.0f;
-    entity->animationPaused = false;
-    entity->spriteWidth = spriteWidth;
-    entity->spriteHeight = spriteHeight;
-    entity->currentAnimation = NULL;
-
-    return true;
+    SpriteSheet *usedSheet = &sprite->set->spriteSheets[currentAnim->spriteSheetIndex];
+    sprite->width = usedSheet->spriteWidth;
+    sprite->height = usedSheet->spriteHeight;
 }
 
-// Fonction pour ajouter une feuille de sprites à l'entité
-bool Entity_AddSpriteSheet(Entity *entity, SDL_Renderer *renderer,
-                           const char *spriteSheetPath, const char *name,
-                           int spriteWidth, int spriteHeight)
+// Crée la lecture au premier besoin ; le système d'animation l'avance ensuite avec les autres
+static Animator *Entity_GetAnimator(EntityId entity, const AnimationSet *set)
 {
-    if (findSpriteSheetIndex(entity, name) != -1)
-    {
-        fprintf(stderr, "Une feuille de sprites avec le nom '%s' existe déjà pour cette entité.\n", name);
-        return false;
-    }
+    Animator *animator = ECS_GetAnimator(entity);
+    if (animator)
+        return animator;
+
+    AnimHandle anim = AnimSystem_Create(set, (void *)(uintptr_t)entity);
+    animator = ECS_Add(entity, COMPONENT_ANIMATOR);
+    animator->anim = anim;
+    return animator;
+}
 
-    // Réallouer le tableau de spriteSheets
-    entity->spriteSheetCount++;
-    entity->spriteSheets = (SpriteSheet *)realloc(entity->spriteSheets, entity->spriteSheetCount * sizeof(SpriteSheet));
-    if (!entity->spriteSheets)
-    {
-        fprintf(stderr, "Erreur d'allocation mémoire pour les feuilles de sprites.\n");
-        exit(EXIT_FAILURE);
-    }
+static void Entity_ApplyAnimation(EntityId entity, int index)
+{
+    Sprite *sprite = ECS_GetSprite(entity);
+    Animator *animator = Entity_GetAnimator(entity, sprite->set);
+    AnimSystem_Play(animator->anim, index); // Repart du premier cadre, sans pause
+
+    // Mettre à jour les dimensions générales du sprite de l'entité
+    // pour qu'elles correspondent à la feuille de sprites de l'animation courante
+    Entity_UpdateSpriteSize(entity);
+}
 
-    SpriteSheet *newSheet = &entity->spriteSheets[entity->spriteSheetCount - 1];
-    strncpy(newSheet->name, name, sizeof(newSheet->name) - 1);
-    newSheet->name[sizeof(newSheet->name) - 1] = '\0';
+// Création de l'entité, sans chargement de spriteSheet.
+EntityId Entity_Create(int spriteWidth, int spriteHeight, float x, float y, int hitboxWidth, int hitboxHeight, bool traversable)
+{
+    EntityId entity = ECS_CreateEntity();
+    if (entity == ENTITY_NONE)
+        return ENTITY_NONE;
 
-    SDL_Surface *surface = IMG_Load(spriteSheetPath);
-    if (!surface)
-    {
-        fprintf(stderr, "Erreur de chargement de la feuille de sprites %s: %s\n", spriteSheetPath, IMG_GetError());
-        return false;
-    }
+    Transform *transform = ECS_Add(entity, COMPONENT_TRANSFORM);
+    transform->x = x;
+    transform->y = y;
 
-    newSheet->texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!newSheet->texture)
-    {
-        fprintf(stderr, "Erreur de création de la texture pour %s: %s\n", spriteSheetPath, SDL_GetError());
-        SDL_FreeSurface(surface);
+    Sprite *sprite = ECS_Add(entity, COMPONENT_SPRITE);
+    sprite->set = NULL;
+    sprite->width = spriteWidth;
+    sprite->height = spriteHeight;
+
+    // La hitbox est initialisée ici mais ses dimensions peuvent être ajustées plus tard
+    Hitbox *hitbox = ECS_Add(entity, COMPONENT_HITBOX);
+    hitbox->width = hitboxWidth;
+    hitbox->height = hitboxHeight;
+    hitbox->rect = Entity_HitboxAt(entity, x, y);
+
+    Collider *collider = ECS_Add(entity, COMPONENT_COLLIDER);
+    collider->solid = !traversable;
+
+    // Entrées et sorties des zones de déclenchement (System_UpdateTriggers)
+    ECS_Add(entity, COMPONENT_TRIGGER_CONTACT);
+
+    return entity;
+}
+
+// Fonction pour ajouter une feuille de sprites à l'ensemble privé de l'entité
+bool Entity_AddSpriteSheet(EntityId entity, SDL_Renderer *renderer,
+                           const char *spriteSheetPath, const char *name,
+                           int spriteWidth, int spriteHeight)
+{
+    AnimationSet *set = Entity_GetPrivateSet(entity);
+    if (!set)
         return false;
-    }
-    newSheet->sheetWidth = surface->w;
-    newSheet->sheetHeight = surface->h;
-    newSheet->spriteWidth = spriteWidth;
-    newSheet->spriteHeight = spriteHeight;
-    SDL_FreeSurface(surface);
 
-    return true;
+    return AnimSet_AddSpriteSheet(set, renderer, spriteSheetPath, name, spriteWidth, spriteHeight);
 }
 
-void Entity_AddAnimation(Entity *entity, const char *animationName,
+void Entity_AddAnimation(EntityId entity, const char *animationName,
                          const char *spriteSheetName,
                          int startRow, int startCol, int frameCount,
                          int frameDurationMs, bool loop)
 {
-    if (findAnimationIndex(entity, animationName) != -1)
-    {
-        fprintf(stderr, "L'animation '%s' existe déjà pour cette entité.\n", animationName);
+    AnimationSet *set = Entity_GetPrivateSet(entity);
+    if (!set)
         return;
-    }
 
-    int spriteSheetIdx = findSpriteSheetIndex(entity, spriteSheetName);
-    if (spriteSheetIdx == -1)
-    {
-        fprintf(stderr, "Erreur: La feuille de sprites '%s' n'existe pas pour cette entité. Impossible d'ajouter l'animation '%s'.\n", spriteSheetName, animationName);
+    if (!AnimSet_AddAnimation(set, animationName, spriteSheetName, startRow, startCol, frameCount, frameDurationMs, loop))
         return;
-    }
 
-    // Réallouer le tableau d'animations
-    entity->animationCount++;
-    entity->animations = (Animation *)realloc(entity->animations, entity->animationCount * sizeof(Animation));
-    if (!entity->animations)
+    // Si c'est la première animation ajoutée, la définir comme courante
+    if (set->animationCount == 1)
     {
-        fprintf(stderr, "Erreur d'allocation mémoire pour les animations.\n");
-        exit(EXIT_FAILURE);
+        Entity_ApplyAnimation(entity, 0);
     }
+}
+
+// Associe un ensemble (partagé ou non) à l'entité ; l'ancien est relâché.
+void Entity_SetAnimationSet(EntityId entity, AnimationSet *set)
+{
+    Sprite *sprite = ECS_GetSprite(entity);
+    if (!sprite || sprite->set == set)
+        return;
 
-    Animation *newAnim = &entity->animations[entity->animationCount - 1];
-    strncpy(newAnim->name, animationName, sizeof(newAnim->name) - 1);
-    newAnim->name[sizeof(newAnim->name) - 1] = '\0';
-    newAnim->frameCount = frameCount;
-    newAnim->frameDurationMs = frameDurationMs;
-    newAnim->loop = loop;
-    newAnim->spriteSheetIndex = spriteSheetIdx; // ENREGISTRE L'INDEX DE LA FEUILLE DE SPRITES
+    AnimSet_Retain(set);
+    AnimSet_Release(sprite->set);
+    sprite->set = set;
 
-    newAnim->frames = (Frame *)malloc(frameCount * sizeof(Frame));
-    if (!newAnim->frames)
+    Animator *animator = ECS_GetAnimator(entity);
+    if (animator)
     {
-        fprintf(stderr, "Erreur d'allocation mémoire pour les cadres de l'animation.\n");
-        exit(EXIT_FAILURE);
+        AnimSystem_SetSet(animator->anim, set);
     }
-
-    SpriteSheet *usedSheet = &entity->spriteSheets[spriteSheetIdx];
-
-    for (int i = 0; i < frameCount; ++i)
+    else if (set && set->animationCount > 0)
     {
-        newAnim->frames[i].x = (startCol + i) * usedSheet->spriteWidth;
-        newAnim->frames[i].y = startRow * usedSheet->spriteHeight;
-        newAnim->frames[i].w = usedSheet->spriteWidth;
-        newAnim->frames[i].h = usedSheet->spriteHeight;
-
-        // Assurez-vous que les cadres ne dépassent pas la taille de la feuille de sprites
-        if (newAnim->frames[i].x + newAnim->frames[i].w > usedSheet->sheetWidth ||
-            newAnim->frames[i].y + newAnim->frames[i].h > usedSheet->sheetHeight)
-        {
-            fprintf(stderr, "Avertissement: Le cadre %d de l'animation '%s' dépasse la feuille de sprites '%s'.\n", i, animationName, usedSheet->name);
-        }
+        Entity_GetAnimator(entity, set);
     }
 
-    // Si c'est la première animation ajoutée, la définir comme courante
-    if (entity->animationCount == 1)
+    Entity_UpdateSpriteSize(entity);
+}
+
+// Chemin rapide : index résolu à l'avance (voir AnimSet_FindAnimation)
+void Entity_SetAnimationIndex(EntityId entity, int index)
+{
+    Sprite *sprite = ECS_GetSprite(entity);
+    if (!sprite || !sprite->set || index < 0 || index >= sprite->set->animationCount)
+        return;
+
+    if (index != Entity_CurrentIndex(entity))
     {
-        entity->currentAnimationIndex = 0;
-        entity->currentAnimation = &entity->animations[0];
-        entity->currentFrameIndex = 0;
-        entity->frameTimer = 0.0f;
-        // Mettre à jour les dimensions du sprite de l'entité avec celles de la première animation
-        entity->spriteWidth = usedSheet->spriteWidth;
-        entity->spriteHeight = usedSheet->spriteHeight;
+        Entity_ApplyAnimation(entity, index);
     }
 }
 
-void Entity_SetAnimation(Entity *entity, const char *animationName)
+void Entity_SetAnimation(EntityId entity, const char *animationName)
 {
-    int newIndex = findAnimationIndex(entity, animationName);
-    if (newIndex != -1 && newIndex != entity->currentAnimationIndex)
+    Sprite *sprite = ECS_GetSprite(entity);
+    int newIndex = sprite ? AnimSet_FindAnimation(sprite->set, animationName) : -1;
+    if (newIndex != -1 && newIndex != Entity_CurrentIndex(entity))
     {
-        entity->currentAnimationIndex = newIndex;
-        entity->currentAnimation = &entity->animations[newIndex];
-        entity->currentFrameIndex = 0; // Réinitialise le cadre au début de la nouvelle animation
-        entity->frameTimer = 0.0f;     // Réinitialise le temps du dernier cadre
-        entity->animationPaused = false;
-
-        // IMPORTANT: Mettre à jour les dimensions générales du sprite de l'entité
-        // pour qu'elles correspondent à la feuille de sprites de l'animation courante
-        Animation *currentAnim = &entity->animations[entity->currentAnimationIndex];
-        SpriteSheet *usedSheet = &entity->spriteSheets[currentAnim->spriteSheetIndex];
-        entity->spriteWidth = usedSheet->spriteWidth;
-        entity->spriteHeight = usedSheet->spriteHeight;
+        Entity_ApplyAnimation(entity, newIndex);
     }
     else if (newIndex == -1)
     {
@@ -205,118 +184,85 @@ void Entity_SetAnimation(Entity *entity, const char *animationName)
     }
 }
 
-void Entity_UpdateAnimation(Entity *entity, float deltaTime)
+Animation *Entity_GetCurrentAnimation(EntityId entity)
 {
-    if (entity->animationPaused || entity->currentAnimationIndex == -1)
+    const Sprite *sprite = ECS_GetSprite(entity);
+    int index = Entity_CurrentIndex(entity);
+    if (!sprite || !sprite->set || index < 0 || index >= sprite->set->animationCount)
     {
-        return;
-    }
-
-    Animation *currentAnim = &entity->animations[entity->currentAnimationIndex];
-
-    // Accumuler le temps écoulé
-    entity->frameTimer += deltaTime * 1000.0f; // Convertir deltaTime en ms
-
-    if (entity->frameTimer >= currentAnim->frameDurationMs)
-    {
-        entity->currentFrameIndex++;
-        if (entity->currentFrameIndex >= currentAnim->frameCount)
-        {
-            if (currentAnim->loop)
-            {
-                entity->currentFrameIndex = 0; // Boucle
-            }
-            else
-            {
-                entity->currentFrameIndex = currentAnim->frameCount - 1; // S'arrête au dernier cadre
-                entity->animationPaused = true;                          // Met en pause l'animation à la fin si elle ne boucle pas
-            }
-        }
-        entity->frameTimer = 0.0f; // Réinitialiser le timer
+        return NULL;
     }
+    return &sprite->set->animations[index];
 }
 
-void Entity_Draw(Entity *entity, SDL_Renderer *renderer)
+void Entity_Draw(EntityId entity, RenderList *list)
 {
-    if (entity->currentAnimationIndex == -1 || entity->spriteSheetCount == 0)
-    {
+    Animation *currentAnim = Entity_GetCurrentAnimation(entity);
+    const Sprite *sprite = ECS_GetSprite(entity);
+    const Transform *transform = ECS_GetTransform(entity);
+    if (!currentAnim || !transform)
         return;
-    }
 
-    if (!entity->currentAnimation)
-        return;
     // S'assurer que l'index de la feuille de sprites est valide
-    if (entity->currentAnimation->spriteSheetIndex >= entity->spriteSheetCount || entity->currentAnimation->spriteSheetIndex < 0)
+    if (currentAnim->spriteSheetIndex >= sprite->set->spriteSheetCount || currentAnim->spriteSheetIndex < 0)
     {
-        fprintf(stderr, "Erreur: Index de feuille de sprites invalide pour l'animation '%s'.\n", entity->currentAnimation->name);
+        fprintf(stderr, "Erreur: Index de feuille de sprites invalide pour l'animation '%s'.\n", currentAnim->name);
         return;
     }
 
-    SpriteSheet *usedSheet = &entity->spriteSheets[entity->currentAnimation->spriteSheetIndex];
+    SpriteSheet *usedSheet = &sprite->set->spriteSheets[currentAnim->spriteSheetIndex];
     if (!usedSheet->texture) // Vérifier si la texture est chargée
     {
-        fprintf(stderr, "Erreur: Texture manquante pour la feuille de sprites '%s' utilisée par l'animation '%s'.\n", usedSheet->name, entity->currentAnimation->name);
+        fprintf(stderr, "Erreur: Texture manquante pour la feuille de sprites '%s' utilisée par l'animation '%s'.\n", usedSheet->name, currentAnim->name);
         return;
     }
 
-    Frame *currentFrame = &entity->currentAnimation->frames[entity->currentFrameIndex];
+    const AnimPlayback *playback = AnimSystem_Get(ECS_GetAnimator(entity)->anim);
+    Frame *currentFrame = &currentAnim->frames[playback->frameIndex];
 
     SDL_Rect srcRect = {currentFrame->x, currentFrame->y, currentFrame->w, currentFrame->h};
-    SDL_Rect destRect = {(int)entity->x, (int)entity->y, currentFrame->w, currentFrame->h};
+    SDL_Rect destRect = {(int)transform->x, (int)transform->y, currentFrame->w, currentFrame->h};
 
     // Rendu de la bonne texture
-    SDL_RenderCopy(renderer, usedSheet->texture, &srcRect, &destRect);
+    RenderList_Quad(list, usedSheet->texture, &srcRect, &destRect, SDL_FLIP_NONE);
 
-    DrawHitbox(renderer, &entity->hitbox);
+    Hitbox *hitbox = ECS_GetHitbox(entity);
+    if (hitbox)
+        DrawHitbox(list, &hitbox->rect);
 }
 
-void DrawHitbox(SDL_Renderer *renderer, SDL_Rect *hitbox)
+void DrawHitbox(RenderList *list, SDL_Rect *hitbox)
 {
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Rouge
-    SDL_RenderDrawRect(renderer, hitbox);
+    SDL_Color red = {255, 0, 0, 255}; // Rouge
+    RenderList_Rect(list, hitbox, red, false);
 }
 
-void Entity_PauseAnimation(Entity *entity, bool pause)
+void Entity_PauseAnimation(EntityId entity, bool pause)
 {
-    entity->animationPaused = pause;
+    Animator *animator = ECS_GetAnimator(entity);
+    if (animator)
+        AnimSystem_SetPaused(animator->anim, pause);
 }
 
-void Entity_Free(Entity *entity)
+void Entity_Destroy(EntityId entity)
 {
-
-    if (entity->spriteSheets)
-    {
-        for (int i = 0; i < entity->spriteSheetCount; ++i)
-        {
-            if (entity->spriteSheets[i].texture)
-            {
-                SDL_DestroyTexture(entity->spriteSheets[i].texture);
-                entity->spriteSheets[i].texture = NULL;
-            }
-        }
-        free(entity->spriteSheets);
-        entity->spriteSheets = NULL;
-        entity->spriteSheetCount = 0;
-    }
-
-    if (entity->animations)
-    {
-        for (int i = 0; i < entity->animationCount; ++i)
-        {
-            free(entity->animations[i].frames);
-            entity->animations[i].frames = NULL;
-        }
-        free(entity->animations);
-        entity->animations = NULL;
-        entity->animationCount = 0;
-    }
-    memset(entity, 0, sizeof(Entity));
+    // Le retrait du Sprite relâche l'ensemble d'animations, celui de l'Animator sa lecture
+    ECS_DestroyEntity(entity);
 }
 
-void Entity_setHitbox(Entity *entity, int x, int y, int w, int h)
+SDL_Rect Entity_HitboxAt(EntityId entity, float x, float y)
 {
-    entity->hitbox.x = x;
-    entity->hitbox.y = y;
-    entity->hitbox.w = w;
-    entity->hitbox.h = h;
-}
\ No newline at end of file
+    const Hitbox *hitbox = ECS_GetHitbox(entity);
+    const Sprite *sprite = ECS_GetSprite(entity);
+    if (!hitbox)
+        return (SDL_Rect){(int)x, (int)y, 0, 0};
+
+    int spriteWidth = sprite ? sprite->width : hitbox->width;
+    int spriteHeight = sprite ? sprite->height : hitbox->height;
+    SDL_Rect rect = {
+        (int)(x + spriteWidth / 2 - hitbox->width / 2),
+        (int)(y + spriteHeight - hitbox->height),
+        hitbox->width,
+        hitbox->height};
+    return rect;
+}
@@ -1,11 +1,37 @@
 #include "game.h"
 #include <unistd.h>
 #include <limits.h>
+#include <time.h>
 
 static Map *Game_LoadAndInitMap(const char *name, SDL_Renderer *renderer);
 static bool Game_HandleInputEvents(Game *game, SDL_Event *event);
 void Game_UpdateData(Game *game, float deltaTime);
-static void Game_UpdateGraphics(Game *game);
+static void Game_RecordFrame(Game *game, RenderList *list);
+static void Game_StopSimulation(Game *game);
+static void Game_UpdateMapLoad(Game *game);
+static void Game_UpdateWarps(Game *game);
+static void Game_SetCurrentMap(Game *game, Map *map, const char *map_name);
+static void Game_UpdateWorld(Game *game, const SDL_Rect *hitbox);
+static void Game_RecordMaps(Game *game, RenderList *list);
+static void Game_HandleTriggerEvents(Game *game);
+static void Game_CheckEncounter(Game *game);
+static void Game_WatchMapFiles(Game *game, Map *map);
+static void Game_UpdateHotReload(Game *game);
+static void Game_RenderLoadingScreen(Game *game, RenderList *list);
+static void Game_UpdateAutosave(Game *game);
+static void Game_UpdateBackground(Game *game);
+static int Game_DialogueVisible(const Game *game);
+static void Game_EndCinematic(Game *game);
+
+static int Game_LoaderThreadCount(void)
+{
+    int threads = SDL_GetCPUCount() - 1;
+    if (threads < 1)
+        threads = 1;
+    if (threads > LOADER_MAX_THREADS)
+        threads = LOADER_MAX_THREADS;
+    return threads;
+}
 
 bool Game_InitSDL(Game *game, const char *title, int width, int height)
 {
@@ -44,38 +70,344 @@ bool Game_InitSDL(Game *game, const char *title, int width, int height)
     game->window_width = width;
     game->window_height = height;
 
+    // Threads de décodage des assets (le thread principal garde la création des textures)
+    game->loader = Loader_Create(game->renderer, Game_LoaderThreadCount());
+    if (!game->loader)
+    {
+        fprintf(stderr, "Asset loader could not be created!\n");
+        return false;
+    }
+
     return true;
 }
 
 bool Game_InitMap(Game *game, const char *map_name)
 {
-    char map_path[256];
-    snprintf(map_path, sizeof(map_path), "resources/maps/%s.tmx", map_name);
+    if (!game->maps)
+    {
+        // Les voisines du monde ont leurs propres places : elles ne chassent pas les maps visitées
+        game->maps = MapManager_Create(game->loader, MAP_CACHE_CAPACITY + (game->world ? MAP_MAX_NEIGHBOURS : 0));
+        if (!game->maps)
+            return false;
+    }
 
-    game->current_map = Map_Load(map_path, game->renderer);
+    game->current_map = MapManager_LoadNow(game->maps, map_name);
     if (!game->current_map)
     {
-        fprintf(stderr, "Failed to load map: %s\n", map_path);
+        fprintf(stderr, "Failed to load map: %s\n", map_name);
+        return false;
+    }
+
+    Game_SetCurrentMap(game, game->current_map, map_name);
+    return true;
+}
+
+// Map courante : réveille ses PNJ, surveille ses fichiers, reconstruit ses
+// rencontres. Le joueur doit sortir des zones où il arrive avant qu'elles ne
+// se déclenchent.
+static void Game_SetCurrentMap(Game *game, Map *map, const char *map_name)
+{
+    game->current_map = map;
+    if (map_name != game->map_name)
+        snprintf(game->map_name, sizeof(game->map_name), "%s", map_name);
+    MapManager_SetCurrent(game->maps, map);
+    Game_WatchMapFiles(game, map);
+    Encounters_Build(&game->encounters, game->db, map);
+    System_ResetTriggers();
+}
+
+// Change de map : instantané si la map est déjà en cache (préchargée ou déjà
+// visitée) ; sinon elle est chargée en arrière-plan et la map courante reste
+// affichée (écran de chargement par-dessus) jusqu'à ce qu'elle soit prête.
+// Une position négative place le joueur sur le spawn de la map.
+bool Game_ChangeMap(Game *game, const char *map_name, float x, float y)
+{
+    if (game->pending_map[0] != '\0')
+    {
+        fprintf(stderr, "A map is already loading, ignoring request for %s\n", map_name);
+        return false;
+    }
+
+    if (!MapManager_Preload(game->maps, map_name))
+    {
+        fprintf(stderr, "Failed to load map: %s\n", map_name);
         return false;
     }
 
+    snprintf(game->pending_map, sizeof(game->pending_map), "%s", map_name);
+    game->pending_x = x;
+    game->pending_y = y;
+
+    // Si elle est prête, on bascule tout de suite
+    Game_UpdateMapLoad(game);
     return true;
 }
 
+static void Game_UpdateMapLoad(Game *game)
+{
+    // Création des textures sous budget, pour ne pas faire sauter de frame
+    Loader_Pump(game->loader, LOADER_FRAME_BUDGET_MS);
+    MapManager_Update(game->maps);
+
+    if (game->pending_map[0] == '\0')
+        return;
+
+    Map *map = MapManager_Get(game->maps, game->pending_map);
+    if (!map)
+    {
+        if (MapManager_HasFailed(game->maps, game->pending_map))
+        {
+            fprintf(stderr, "Failed to load map: %s\n", game->pending_map);
+            game->pending_map[0] = '\0';
+        }
+        return;
+    }
+
+    // L'ancienne map reste en cache avec l'état de ses PNJ
+    Game_SetCurrentMap(game, map, game->pending_map);
+    game->pending_map[0] = '\0';
+
+    if (game->player)
+    {
+        Transform *transform = ECS_GetTransform(game->player->entity);
+        if (game->pending_x >= 0.0f && game->pending_y >= 0.0f)
+        {
+            transform->x = game->pending_x;
+            transform->y = game->pending_y;
+        }
+        else
+        {
+            Map_GetSpawnPosition(map, &transform->x, &transform->y);
+        }
+    }
+}
+
+// --- Rechargement à chaud ---
+
+// Surveille les fichiers dont dépend la map : TMX source, TSX externes, images
+static void Game_WatchMapFiles(Game *game, Map *map)
+{
+    if (!game->hot_reload || !map)
+        return;
+
+    HotReload_WatchFile(game->hot_reload, map->filename);
+    for (int i = 0; i < map->tileset_count; i++)
+    {
+        if (map->tilesets[i].image)
+            HotReload_WatchFile(game->hot_reload, map->tilesets[i].image);
+    }
+    for (int i = 0; i < map->pnj_count; i++)
+    {
+        if (map->pnj_list[i] && map->pnj_list[i]->sprite_path)
+            HotReload_WatchFile(game->hot_reload, map->pnj_list[i]->sprite_path);
+    }
+
+    if (map->tmx_map)
+    {
+        const char *last_slash = strrchr(map->filename, '/');
+        int dir_len = last_slash ? (int)(last_slash - map->filename) + 1 : 0;
+        for (tmx_tileset_list *ts = map->tmx_map->ts_head; ts; ts = ts->next)
+        {
+            char tsx_path[1024];
+            if (!ts->source)
+                continue;
+            snprintf(tsx_path, sizeof(tsx_path), "%.*s%s", dir_len, map->filename, ts->source);
+            HotReload_WatchFile(game->hot_reload, tsx_path);
+        }
+    }
+}
+
+// Chemin TMX d'une map cuite (resources/maps/x.cmap -> resources/maps/x.tmx)
+static void Game_GetSourceTMX(const Map *map, char *out, size_t size)
+{
+    snprintf(out, size, "%s", map->filename);
+    char *ext = strrchr(out, '.');
+    if (ext && Map_IsCookedPath(map->filename) && (size_t)(ext - out) + 5 <= size)
+        strcpy(ext, ".tmx");
+}
+
+static void Game_OnFileChanged(const char *path, void *userdata)
+{
+    Game *game = (Game *)userdata;
+    Uint32 start = SDL_GetTicks();
+    const char *ext = strrchr(path, '.');
+    int reloaded = 0;
+
+    if (!ext)
+        return;
+
+    if (strcmp(ext, ".png") == 0)
+    {
+        // Une texture par tileset ou feuille de sprites concernée
+        reloaded += AnimSet_ReloadImage(game->renderer, path);
+        for (int i = 0; i < game->maps->capacity; i++)
+        {
+            reloaded += Map_ReloadTilesetImage(game->maps->entries[i].map, game->renderer, path);
+        }
+    }
+    else if (strcmp(ext, ".tmx") == 0 || strcmp(ext, ".tsx") == 0)
+    {
+        for (int i = 0; i < game->maps->capacity; i++)
+        {
+            Map *map = game->maps->entries[i].map;
+            if (!map)
+                continue;
+
+            // Une map cuite dont on modifie le TMX est rechargée depuis le TMX
+            char source[512];
+            Game_GetSourceTMX(map, source, sizeof(source));
+            bool from_source = strcmp(ext, ".tmx") == 0 && HotReload_SamePath(source, path);
+
+            if (from_source || Map_UsesFile(map, path))
+            {
+                if (Map_Reload(map, from_source ? source : map->filename, game->renderer))
+                    reloaded++;
+                if (map == game->current_map)
+                {
+                    Game_WatchMapFiles(game, map);
+                    Encounters_Build(&game->encounters, game->db, map);
+                    System_ResetTriggers(); // Les indices des zones ont pu changer
+                }
+            }
+        }
+    }
+
+    if (reloaded > 0)
+        printf("Rechargé: %s (%d ressource(s), %u ms)\n", path, reloaded, SDL_GetTicks() - start);
+}
+
+static void Game_UpdateHotReload(Game *game)
+{
+    HotReload_Poll(game->hot_reload, Game_OnFileChanged, game);
+}
+
+// Entrées du joueur dans les zones, pendant le tick. Le changement de map
+// touche au cache (et aux textures) : il est seulement demandé, et le monde
+// reste figé jusqu'à ce que Game_UpdateWarps l'exécute sur le thread principal.
+// Les événements des PNJ restent disponibles pour la logique de map.
+static void Game_HandleTriggerEvents(Game *game)
+{
+    const TriggerEvent *events;
+    int count = System_GetTriggerEvents(&events);
+    for (int i = 0; i < count; i++)
+    {
+        if (events[i].entity != game->player->entity || events[i].type != TRIGGER_ENTER)
+            continue;
+
+        const MapTrigger *trigger = &game->current_map->triggers[events[i].trigger];
+        switch (trigger->type)
+        {
+        case MAP_TRIGGER_WARP:
+            if (game->warp_map[0] == '\0')
+            {
+                snprintf(game->warp_map, sizeof(game->warp_map), "%s", trigger->value);
+                game->warp_x = trigger->target_x;
+                game->warp_y = trigger->target_y;
+            }
+            break;
+        case MAP_TRIGGER_SIGN:
+            Game_OpenDialogue(game, trigger->value);
+            break;
+        case MAP_TRIGGER_CUTSCENE:
+            Game_StartCinematic(game, trigger->value);
+            break;
+        default:
+            // Rencontres : lues dans la grille à chaque pas (Game_CheckEncounter)
+            break;
+        }
+    }
+}
+
+// Rencontres sauvages, pendant le tick : seulement quand le joueur change de
+// tuile, sur la tuile sous le centre de sa hitbox
+static void Game_CheckEncounter(Game *game)
+{
+    if (game->warp_map[0] != '\0' || game->current_map->tile_width <= 0 || game->current_map->tile_height <= 0)
+        return;
+
+    const Transform *transform = ECS_GetTransform(game->player->entity);
+    SDL_Rect hitbox = Entity_HitboxAt(game->player->entity, transform->x, transform->y);
+    int tile_x = (hitbox.x + hitbox.w / 2) / game->current_map->tile_width;
+    int tile_y = (hitbox.y + hitbox.h / 2) / game->current_map->tile_height;
+
+    int species, level;
+    if (Encounters_Step(&game->encounters, game->current_map, tile_x, tile_y, &species, &level))
+        Game_StartBattle(game, species, level);
+}
+
+// Préchargement des maps voisines et passage demandé par le dernier tick
+static void Game_UpdateWarps(Game *game)
+{
+    const Transform *transform = ECS_GetTransform(game->player->entity);
+    SDL_Rect hitbox = Entity_HitboxAt(game->player->entity, transform->x, transform->y);
+
+    MapManager_PreloadNeighbours(game->maps, game->current_map, &hitbox, MAP_PRELOAD_DISTANCE);
+
+    if (game->warp_map[0] != '\0')
+    {
+        Game_ChangeMap(game, game->warp_map, game->warp_x, game->warp_y);
+        game->warp_map[0] = '\0';
+        return;
+    }
+
+    Game_UpdateWorld(game, &hitbox);
+}
+
+// Monde continu : précharge les maps proches du joueur, bascule sur la voisine
+// quand le centre de sa hitbox y est entré de WORLD_SWITCH_MARGIN pixels (le
+// joueur passe dans ses coordonnées), puis relie la map courante aux voisines
+// prêtes. La marge évite de rebasculer à chaque pas sur la frontière.
+static void Game_UpdateWorld(Game *game, const SDL_Rect *hitbox)
+{
+    int origin = World_Find(game->world, game->map_name);
+    if (origin >= 0)
+    {
+        World_Preload(game->world, game->maps, origin, hitbox, MAP_MAX_NEIGHBOURS);
+
+        const WorldMap *current = &game->world->maps[origin];
+        int center_x = hitbox->x + hitbox->w / 2, center_y = hitbox->y + hitbox->h / 2;
+        bool beyond = center_x < -WORLD_SWITCH_MARGIN || center_y < -WORLD_SWITCH_MARGIN ||
+                      center_x >= current->width + WORLD_SWITCH_MARGIN ||
+                      center_y >= current->height + WORLD_SWITCH_MARGIN;
+
+        int dx, dy;
+        int index = beyond ? World_Locate(game->world, origin, center_x, center_y, &dx, &dy) : -1;
+        Map *next = index >= 0 && index != origin ? MapManager_Get(game->maps, game->world->maps[index].name) : NULL;
+        if (next)
+        {
+            Transform *transform = ECS_GetTransform(game->player->entity);
+            transform->x -= dx;
+            transform->y -= dy;
+            Mover *mover = ECS_GetMover(game->player->entity);
+            if (mover && mover->hasTarget)
+            {
+                mover->targetX -= dx;
+                mover->targetY -= dy;
+            }
+            System_UpdateHitboxes();
+
+            Game_SetCurrentMap(game, next, game->world->maps[index].name);
+            origin = index;
+        }
+    }
+
+    World_Link(game->world, game->maps, origin, game->current_map, WORLD_LINK_DISTANCE);
+}
+
 bool Game_InitPlayer(Game *game)
 {
 
-    game->player = (Player *)malloc(sizeof(Player));
+    game->player = (Player *)Mem_Alloc(MEM_TAG_ENTITY, sizeof(Player));
     if (!game->player)
     {
         fprintf(stderr, "Failed to allocate memory for player!\n");
         return false;
     }
 
-    if (!Player_Init(game->player, game->renderer, "resources/sprites/player.png", 25, 32, 100.0f, 100.0f, PLAYER_HITBOX_WIDTH, PLAYER_HITBOX_HEIGHT))
+    if (!Player_Init(game->player, game->renderer, PLAYER_SPRITE_PATH, 25, 32, 100.0f, 100.0f, PLAYER_HITBOX_WIDTH, PLAYER_HITBOX_HEIGHT))
     {
         fprintf(stderr, "Failed to initialize player!\n");
-        free(game->player);
+        Mem_Free(game->player);
         game->player = NULL;
         return false;
     }
@@ -86,21 +418,29 @@ bool testAjoutSpriteSheet(Game *game, SDL_Renderer *renderer)
 {
 
     // exemple ajout sprite sheet
-    if (!Entity_AddSpriteSheet(&game->player->baseEntity, game->renderer,
+    if (!Entity_AddSpriteSheet(game->player->entity, game->renderer,
                                "resources/sprites/pnj.png", "player_combat", 25, 32))
     {
         fprintf(stderr, "Failed to load combat spritesheet!\n");
         Player_Free(game->player);
-        free(game->player);
+        Mem_Free(game->player);
         game->player = NULL;
         return false;
     }
 
-    Entity_AddAnimation(&game->player->baseEntity, "test", "player_combat", 1, 0, 4, 200, true);
+    Entity_AddAnimation(game->player->entity, "test", "player_combat", 1, 0, 4, 200, true);
 }
 
-Game *Game_Create(const char *title, int width, int height)
+// Allocation et état communs au jeu et à la simulation headless
+static Game *Game_Alloc(void)
 {
+    // libtmx doit allouer via le suivi dès le premier TMX
+    Mem_Init();
+    Mem_SetBudget(MEM_TAG_COUNT, MEM_BUDGET_TOTAL);
+    Mem_SetBudget(MEM_TAG_MAP, MEM_BUDGET_MAP);
+    Mem_SetBudget(MEM_TAG_TMX, MEM_BUDGET_TMX);
+    Mem_SetBudget(MEM_TAG_ENTITY, MEM_BUDGET_ENTITY);
+    Mem_SetBudget(MEM_TAG_NPC, MEM_BUDGET_NPC);
 
     Game *game = (Game *)malloc(sizeof(Game));
     if (!game)
@@ -110,9 +450,49 @@ Game *Game_Create(const char *title, int width, int height)
     }
 
     memset(game, 0, sizeof(Game));
+    RenderBuffer_Init(&game->render_buffer);
+    Input_Init(&game->input);
+
+    // Graine de l'IA, enregistrée avec les entrées (Game_StartReplay la remplace)
+    game->seed = (Uint32)time(NULL);
+    srand(game->seed);
+    Encounters_Init(&game->encounters, game->seed);
 
     game->running = true;
-    game->state = MODE_WORLD;
+    game->states[0].mode = MODE_WORLD;
+    game->state_count = 1;
+    return game;
+}
+
+// Map de départ et joueur
+static bool Game_InitWorld(Game *game)
+{
+    // Archive d'assets optionnelle (make pack) : sinon tout est lu sur le disque
+    Pack_Mount(ASSET_PACK_PATH);
+
+    // Sans base de données (make db), pas de combats
+    game->db = GameDB_Open(GAMEDB_PATH);
+    game->battle_data = game->db ? &game->db->battle : NULL;
+
+    // Même nombre de threads partout (fenêtre, headless, toute machine) : à
+    // itérations fixées, la décision en dépend. Sans IA, l'adversaire joue le
+    // coup glouton.
+    game->battle_ai = BattleAI_Create(BATTLE_AI_THREADS, BATTLE_AI_NODES);
+
+    // Sans fichier .world, chaque map reste isolée (passages seulement)
+    game->world = World_Load(GAME_WORLD_PATH);
+
+    if (!Game_InitMap(game, GAME_START_MAP))
+        return false;
+
+    return Game_InitPlayer(game);
+}
+
+Game *Game_Create(const char *title, int width, int height)
+{
+    Game *game = Game_Alloc();
+    if (!game)
+        return NULL;
 
     if (!Game_InitSDL(game, title, width, height))
     {
@@ -120,18 +500,54 @@ Game *Game_Create(const char *title, int width, int height)
         return NULL;
     }
 
-    if (!Game_InitMap(game, "map3"))
+    // Sans atlas, les écrans s'affichent sans leurs textes
+    game->font = Font_Create(game->renderer);
+
+    // Rechargement à chaud des ressources modifiées sur le disque (facultatif)
+    game->hot_reload = HotReload_Create();
+
+    // Sans thread d'écriture, les sauvegardes restent en mémoire
+    game->save_writer = SaveWriter_Create();
+
+    if (!Game_InitWorld(game))
     {
         Game_Free(game);
         return NULL;
     }
+    HotReload_WatchFile(game->hot_reload, PLAYER_SPRITE_PATH);
 
-    if (!Game_InitPlayer(game))
+    return game;
+}
+
+// Jeu sans fenêtre ni textures : collisions, déplacements, IA et PNJ
+// seulement. Les images sont décodées pour leurs dimensions puis libérées.
+Game *Game_CreateHeadless(void)
+{
+    Game *game = Game_Alloc();
+    if (!game)
+        return NULL;
+
+    if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
     {
+        fprintf(stderr, "SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
         Game_Free(game);
         return NULL;
     }
 
+    game->loader = Loader_Create(NULL, Game_LoaderThreadCount());
+    if (!game->loader)
+    {
+        fprintf(stderr, "Asset loader could not be created!\n");
+        Game_Free(game);
+        return NULL;
+    }
+    game->loader->headless = true;
+
+    if (!Game_InitWorld(game))
+    {
+        Game_Free(game);
+        return NULL;
+    }
     return game;
 }
 
@@ -140,8 +556,33 @@ void Game_Free(Game *game)
     if (!game)
         return;
 
-    Map_Free(game->current_map);
-    printf("Map freed\n");
+    // Arrêter les threads avant de libérer ce qu'ils pourraient encore référencer
+    Game_StopSimulation(game);
+    Input_Close(&game->input);
+    SaveWriter_Free(game->save_writer); // Termine l'écriture en cours
+    game->save_writer = NULL;
+    BattleAI_Free(game->battle_ai);
+    game->battle_ai = NULL;
+    Encounters_Free(&game->encounters);
+    Cinematic_Free(&game->cinematic);
+    Loader_Free(game->loader);
+    game->loader = NULL;
+
+    HotReload_Free(game->hot_reload);
+    game->hot_reload = NULL;
+
+    // La map courante appartient au cache
+    MapManager_Free(game->maps);
+    game->maps = NULL;
+    game->current_map = NULL;
+    World_Free(game->world);
+    game->world = NULL;
+    printf("Maps freed (pic d'arène : %zu octets, blocs de %d)\n", Map_GetArenaPeak(), MAP_ARENA_BLOCK_SIZE);
+
+    Mem_DestroyTexture(MEM_TAG_RENDER, game->background);
+    game->background = NULL;
+    Font_Free(game->font);
+    game->font = NULL;
 
     if (game->renderer)
     {
@@ -159,58 +600,377 @@ void Game_Free(Game *game)
     if (game->player)
     {
         Player_Free(game->player);
-        free(game->player);
+        Mem_Free(game->player);
         game->player = NULL;
         printf("Player freed\n");
     }
 
+    // Toutes les entités sont libérées : plus aucun composant ni lecture active
+    RenderBuffer_Free(&game->render_buffer);
+    RenderList_Free(&game->background_list);
+    SaveState_Free(&game->quick_save);
+    SaveState_Free(&game->autosave);
+    System_Shutdown();
+    ECS_Shutdown();
+    AnimSystem_Shutdown();
+    GameDB_Close(game->db); // Peut être une entrée de l'archive
+    game->db = NULL;
+    game->battle_data = NULL;
+    Pack_Unmount();
     IMG_Quit();
     SDL_Quit();
     free(game);
+
+    // Tout est libéré : ce qui reste en « tas » est une fuite
+    Mem_Report();
 }
 
+// Simulation : ne touche ni à SDL ni aux textures, elle peut tourner sur le
+// thread de simulation (sous world_lock)
 void Game_UpdateData(Game *game, float deltaTime)
 {
-    switch (game->state)
+    // Seul le sommet de la pile avance : les états recouverts sont figés
+    Game_HandleGameStateEvent(game, deltaTime);
+
+    switch (Game_GetState(game))
     {
     case MODE_WORLD:
         Map_Update(game->current_map, deltaTime);
-        Game_UpdatePlayerMovement(game, deltaTime);
         Player_Update(game->player, deltaTime);
+        System_UpdateAI(deltaTime);
+        System_UpdateMovement(game->current_map, deltaTime);
+        System_UpdateHitboxes();
+        Player_SyncMovement(game->player);
+        System_UpdateTriggers(game->current_map);
+        // Toutes les animations (joueur et PNJ de la map courante) en une passe
+        AnimSystem_Update(deltaTime);
+        Game_HandleTriggerEvents(game);
+        Game_CheckEncounter(game);
+        break;
+    case MODE_CINEMATIC:
+        // Le reste de la map vit pendant la scène : seuls les acteurs sont pilotés
+        Map_Update(game->current_map, deltaTime);
+        bool finished = Cinematic_Update(&game->cinematic);
+        System_UpdateAI(deltaTime);
+        System_UpdateMovement(game->current_map, deltaTime);
+        System_UpdateHitboxes();
+        AnimSystem_Update(deltaTime);
+        if (finished)
+            Game_EndCinematic(game);
+        break;
+    case MODE_COMBAT:
+        if (Combat_Update(&game->combat, &game->input.state))
+        {
+            Combat_End(&game->combat);
+            Game_PopState(game);
+        }
         break;
     default:
         break;
     }
 }
-static void Game_UpdateGraphics(Game *game)
+
+// Un pas de simulation de durée fixe. Faux si le monde est figé par un
+// changement de map : le tick n'est alors pas compté, pour qu'un journal
+// rejoué retombe sur les mêmes ticks quelle que soit la durée du chargement.
+bool Game_Tick(Game *game)
+{
+    if (game->pending_map[0] != '\0' || game->warp_map[0] != '\0')
+        return false;
+
+    Input_BeginTick(&game->input);
+    Game_UpdateData(game, SIM_TIMESTEP);
+    Input_EndTick(&game->input);
+    return true;
+}
+
+// Avance la simulation du temps réel écoulé, par ticks entiers
+void Game_Advance(Game *game, float elapsed)
+{
+    game->accumulator += elapsed;
+
+    int ticks = 0;
+    while (game->accumulator >= SIM_TIMESTEP)
+    {
+        if (ticks == SIM_MAX_TICKS_PER_FRAME || !Game_Tick(game))
+        {
+            // Retard trop important ou monde figé : on ne rattrape pas
+            game->accumulator = 0.0f;
+            break;
+        }
+        game->accumulator -= SIM_TIMESTEP;
+        ticks++;
+    }
+}
+
+// Partie de la frame qui doit rester sur le thread principal : création et
+// destruction de textures (chargements, cache, rechargement à chaud)
+void Game_SyncWorld(Game *game)
 {
-    SDL_SetRenderDrawColor(game->renderer, 30, 30, 30, 255);
-    SDL_RenderClear(game->renderer);
+    Game_UpdateHotReload(game);
+    Game_UpdateMapLoad(game);
+    Game_UpdateBackground(game);
+
+    if (game->pending_map[0] == '\0' && Game_GetState(game) == MODE_WORLD)
+    {
+        Game_UpdateWarps(game);
+        Game_UpdateAutosave(game);
+    }
+}
 
-    switch (game->state)
+// Enregistre la frame dans la liste de rendu (aucun appel au renderer)
+// Contenu propre d'un état, sans ce qu'il recouvre
+static void Game_RecordState(Game *game, RenderList *list, GameState mode)
+{
+    switch (mode)
     {
     case MODE_WORLD:
-        // Afficher la map
-        if (game->current_map)
+        if (game->current_map && game->current_map->in_world && game->player)
+        {
+            // Dans le monde, la caméra suit le joueur d'une map à l'autre
+            const Transform *transform = ECS_GetTransform(game->player->entity);
+            RenderList_SetOffset(list, game->window_width / 2 - (int)transform->x - PLAYER_WIDTH / 2,
+                                 game->window_height / 2 - (int)transform->y - PLAYER_HEIGHT / 2);
+            Game_RecordMaps(game, list);
+            RenderList_SetOffset(list, 0, 0);
+        }
+        else
         {
-            Map_RenderLayer(game->current_map, game->renderer, "BackgroundCalque");
-            Map_RenderLayer(game->current_map, game->renderer, "PremierPlanCalque");
-            Player_Draw(game->player, game->renderer);
-            Map_RenderNPC(game->current_map, game->renderer);
-            Map_RenderLayer(game->current_map, game->renderer, "SecondPlanCalque");
+            Game_RecordMaps(game, list);
         }
+        break;
+
+    case MODE_MENU:
+    {
+        // Assombrit le fond puis panneau à droite de l'écran
+        SDL_Color shade = {0, 0, 0, 120};
+        SDL_Color panel = {245, 245, 235, 255};
+        SDL_Color border = {40, 40, 60, 255};
+        SDL_Rect screen = {0, 0, game->window_width, game->window_height};
+        SDL_Rect box = {game->window_width * 2 / 3, 16, game->window_width / 3 - 16, game->window_height / 2};
+        RenderList_Rect(list, &screen, shade, true);
+        RenderList_Rect(list, &box, panel, true);
+        RenderList_Rect(list, &box, border, false);
 
+        const FontLayout *title = Font_Draw(game->font, list, "MENU", box.x + 12, box.y + 12, 0, 3, border, -1);
+        int y = box.y + 24 + (title ? title->height : 0);
+        Font_Draw(game->font, list, "Échap : reprendre\nF5 : sauvegarde rapide\nF9 : chargement rapide", box.x + 12, y,
+                  box.w - 24, 1, border, -1);
+        break;
+    }
+
+    case MODE_COMBAT:
+        Combat_Render(&game->combat, list, game->font, game->window_width, game->window_height);
         break;
 
+    case MODE_CINEMATIC:
+    {
+        // Le monde vu par la caméra de la scène, entre deux bandes noires
+        const Cinematic *cinematic = &game->cinematic;
+        RenderList_SetOffset(list, -(int)cinematic->camera_x, -(int)cinematic->camera_y);
+        Game_RecordMaps(game, list);
+        RenderList_SetOffset(list, 0, 0);
+
+        SDL_Color black = {0, 0, 0, 255};
+        SDL_Rect bar = {0, 0, game->window_width, CINEMATIC_BAR_HEIGHT};
+        RenderList_Rect(list, &bar, black, true);
+        bar.y = game->window_height - CINEMATIC_BAR_HEIGHT;
+        RenderList_Rect(list, &bar, black, true);
+        if (cinematic->fade > 0)
+        {
+            SDL_Rect screen = {0, 0, game->window_width, game->window_height};
+            black.a = cinematic->fade;
+            RenderList_Rect(list, &screen, black, true);
+        }
+        break;
+    }
+
+    case MODE_DIALOGUE:
+    {
+        // Boîte en bas de l'écran, texte affiché au fil des ticks
+        SDL_Color panel = {245, 245, 235, 255};
+        SDL_Color border = {40, 40, 60, 255};
+        SDL_Rect box = {16, game->window_height * 3 / 4 - 16, game->window_width - 32, game->window_height / 4};
+        RenderList_Rect(list, &box, panel, true);
+        RenderList_Rect(list, &box, border, false);
+
+        int visible = Game_DialogueVisible(game);
+        Font_Draw(game->font, list, game->dialogue, box.x + 12, box.y + 12, box.w - 24, 2, border, visible);
+        if (visible >= game->dialogue_length)
+            Font_Draw(game->font, list, "v", box.x + box.w - 28, box.y + box.h - 24, 0, 2, border, -1);
+        break;
+    }
+
     default:
         break;
     }
+}
 
-    SDL_RenderPresent(game->renderer);
+// Une couche de la map courante et des voisines reliées, chacune à sa place
+static void Game_RecordLayer(Game *game, RenderList *list, const char *layer_name)
+{
+    int offset_x = list->offset_x, offset_y = list->offset_y;
+    Map *map = game->current_map;
+    for (int i = 0; i < map->neighbour_count; i++)
+    {
+        RenderList_SetOffset(list, offset_x + map->neighbours[i].dx, offset_y + map->neighbours[i].dy);
+        Map_RenderLayer(map->neighbours[i].map, list, layer_name);
+    }
+    RenderList_SetOffset(list, offset_x, offset_y);
+    Map_RenderLayer(map, list, layer_name);
+}
+
+// La map et ses entités, dans le repère déjà posé sur la liste (caméra)
+static void Game_RecordMaps(Game *game, RenderList *list)
+{
+    if (!game->current_map)
+        return;
+
+    Game_RecordLayer(game, list, "BackgroundCalque");
+    Game_RecordLayer(game, list, "PremierPlanCalque");
+    // Joueur et PNJ, ceux des voisines compris (en pause), triés par profondeur
+    System_Render(list, game->current_map);
+    Game_RecordLayer(game, list, "SecondPlanCalque");
+}
+
+// États 0 à `top` : une surimpression est dessinée sur ceux du dessous
+static void Game_RecordStack(Game *game, RenderList *list, int top)
+{
+    if (top > 0 && game->states[top].overlay)
+        Game_RecordStack(game, list, top - 1);
+    Game_RecordState(game, list, game->states[top].mode);
+}
+
+static void Game_RecordFrame(Game *game, RenderList *list)
+{
+    RenderList_Reset(list, Mem_GetTextureGeneration());
+    RenderList_SetView(list, game->window_width, game->window_height);
+    SDL_Color background = {30, 30, 30, 255};
+    RenderList_Clear(list, background);
+
+    int top = game->state_count - 1;
+    if (top > 0 && game->states[top].overlay && game->background && !game->background_dirty)
+    {
+        // Les états du dessous sont figés : leur image suffit
+        SDL_Rect screen = {0, 0, game->window_width, game->window_height};
+        RenderList_Quad(list, game->background, &screen, &screen, SDL_FLIP_NONE);
+        Game_RecordState(game, list, game->states[top].mode);
+    }
+    else
+    {
+        Game_RecordStack(game, list, top);
+    }
+
+    if (game->pending_map[0] != '\0')
+    {
+        Game_RenderLoadingScreen(game, list);
+    }
+}
+
+static void Game_RenderLoadingScreen(Game *game, RenderList *list)
+{
+    float progress = MapManager_Progress(game->maps, game->pending_map);
+
+    // Fondu au noir puis barre de progression
+    SDL_Color shade = {0, 0, 0, 200};
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Rect screen = {0, 0, game->window_width, game->window_height};
+    RenderList_Rect(list, &screen, shade, true);
+
+    SDL_Rect bar = {game->window_width / 4, game->window_height / 2 - 5, game->window_width / 2, 10};
+    RenderList_Rect(list, &bar, white, false);
+    bar.w = (int)(bar.w * progress);
+    RenderList_Rect(list, &bar, white, true);
+}
+
+// --- Thread de simulation ---
+
+static int Game_SimulationThread(void *data)
+{
+    Game *game = data;
+    Uint32 lastTime = SDL_GetTicks();
+
+    while (atomic_load(&game->sim_running))
+    {
+        // Au plus une frame d'avance sur le rendu
+        if (SDL_SemWaitTimeout(game->frame_sem, 100) != 0)
+            continue;
+
+        Uint32 currentTime = SDL_GetTicks();
+        float deltaTime = (float)(currentTime - lastTime) / 1000.0f;
+        lastTime = currentTime;
+
+        SDL_LockMutex(game->world_lock);
+        Game_Advance(game, deltaTime);
+        Game_RecordFrame(game, RenderBuffer_Back(&game->render_buffer));
+        SDL_UnlockMutex(game->world_lock);
+
+        RenderBuffer_Publish(&game->render_buffer);
+    }
+    return 0;
+}
+
+bool Game_StartSimulation(Game *game)
+{
+    game->world_lock = SDL_CreateMutex();
+    game->frame_sem = SDL_CreateSemaphore(1);
+    if (!game->world_lock || !game->frame_sem)
+    {
+        fprintf(stderr, "Simulation thread unavailable: %s\n", SDL_GetError());
+        Game_StopSimulation(game);
+        return false;
+    }
+
+    atomic_store(&game->sim_running, true);
+    game->sim_thread = SDL_CreateThread(Game_SimulationThread, "Simulation", game);
+    if (!game->sim_thread)
+    {
+        fprintf(stderr, "Simulation thread unavailable: %s\n", SDL_GetError());
+        Game_StopSimulation(game);
+        return false;
+    }
+    return true;
+}
+
+static void Game_StopSimulation(Game *game)
+{
+    atomic_store(&game->sim_running, false);
+    if (game->sim_thread)
+    {
+        SDL_SemPost(game->frame_sem);
+        SDL_WaitThread(game->sim_thread, NULL);
+        game->sim_thread = NULL;
+    }
+    if (game->frame_sem)
+    {
+        SDL_DestroySemaphore(game->frame_sem);
+        game->frame_sem = NULL;
+    }
+    if (game->world_lock)
+    {
+        SDL_DestroyMutex(game->world_lock);
+        game->world_lock = NULL;
+    }
+}
+
+// Sauvegarde, chargement et combat de débogage agissent directement sur le monde
+static bool Game_IsDebugKey(SDL_Keycode key)
+{
+    return key == QUICKSAVE_KEY || key == QUICKLOAD_KEY || key == BATTLE_DEBUG_KEY;
+}
+
+static bool Game_IsInputLogged(const Game *game)
+{
+    return game->input.record || Input_IsReplaying(&game->input);
 }
 
 void Game_HandleEvent(Game *game, float deltaTime)
 {
+    (void)deltaTime; // Les actions sont horodatées et consommées par Game_Tick
+
+    if (game->world_lock)
+        SDL_LockMutex(game->world_lock);
+
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -218,186 +978,358 @@ void Game_HandleEvent(Game *game, float deltaTime)
         {
             game->running = false;
         }
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == MEM_REPORT_KEY && !event.key.repeat)
+        {
+            Mem_Report();
+        }
+        else if (event.type == SDL_KEYDOWN && !event.key.repeat && Game_IsDebugKey(event.key.keysym.sym) &&
+                 Game_IsInputLogged(game))
+        {
+            // Hors de la file d'entrées, donc absents du journal : la relecture divergerait
+            printf("Touche de débogage ignorée pendant un enregistrement ou une relecture\n");
+        }
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == QUICKSAVE_KEY && !event.key.repeat)
+        {
+            Game_QuickSave(game);
+        }
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == QUICKLOAD_KEY && !event.key.repeat)
+        {
+            Game_QuickLoad(game);
+        }
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == BATTLE_DEBUG_KEY && !event.key.repeat &&
+                 game->battle_data)
+        {
+            Game_StartBattle(game, rand() % game->battle_data->speciesCount, PLAYER_STARTER_LEVEL);
+        }
+        else
+        {
+            Input_HandleEvent(&game->input, &event);
+        }
     }
-    Game_HandleGameStateEvent(game, deltaTime);
+
+    Game_SyncWorld(game);
+    if (game->world_lock)
+        SDL_UnlockMutex(game->world_lock);
+}
+
+// --- Enregistrement et relecture des entrées ---
+
+bool Game_StartRecording(Game *game, const char *path)
+{
+    if (!Input_StartRecording(&game->input, path, game->seed))
+        return false;
+    printf("Enregistrement des entrées dans %s\n", path);
+    return true;
 }
 
+// À appeler avant Game_StartSimulation : la relecture tourne sur le thread
+// principal, sans attendre le temps réel (Game_AdvanceReplay)
+bool Game_StartReplay(Game *game, const char *path)
+{
+    if (!Input_StartReplay(&game->input, path, &game->seed))
+        return false;
+
+    srand(game->seed);
+    Encounters_Seed(&game->encounters, game->seed);
+    game->replay_start = SDL_GetTicks();
+    printf("Relecture de %s\n", path);
+    return true;
+}
+
+// Enchaîne les ticks rejoués pendant `budgetMs`, puis rend la main pour
+// l'affichage ; arrête le jeu à la fin du journal
+void Game_AdvanceReplay(Game *game, Uint32 budgetMs)
+{
+    Uint32 start = SDL_GetTicks();
+    while (!Input_ReplayFinished(&game->input) && SDL_GetTicks() - start < budgetMs)
+    {
+        if (!Game_Tick(game))
+            return; // Changement de map : Game_HandleEvent le termine
+    }
+
+    if (Input_ReplayFinished(&game->input))
+    {
+        Uint32 elapsed = SDL_GetTicks() - game->replay_start;
+        Uint32 ticks = game->input.tick;
+        printf("Relecture terminée : %u ticks (%.1f s de jeu) en %u ms, %.0f ticks/s\n",
+               ticks, ticks * SIM_TIMESTEP, elapsed, elapsed ? ticks * 1000.0f / elapsed : 0.0f);
+        game->running = false;
+    }
+}
+
+// --- Sauvegardes ---
+// Appelées entre deux ticks, sous world_lock : le monde ne bouge pas pendant
+// la copie. La compression et l'écriture se font sur le thread du SaveWriter.
+
+bool Game_QuickSave(Game *game)
+{
+    // L'instantané ne décrit que le monde : pendant une cinématique, les PNJ
+    // ont un comportement et une animation imposés par la scène, qu'un
+    // chargement figerait
+    if (Game_GetState(game) != MODE_WORLD)
+    {
+        fprintf(stderr, "Sauvegarde rapide impossible hors de l'exploration\n");
+        return false;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!SaveState_Capture(game, &game->quick_save))
+        return false;
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+    printf("Sauvegarde rapide : %zu octets capturés en %.1f µs\n", game->quick_save.size,
+           elapsed * 1000000.0 / (double)SDL_GetPerformanceFrequency());
+    SaveWriter_Submit(game->save_writer, QUICKSAVE_PATH, game->quick_save.data, game->quick_save.size);
+    return true;
+}
+
+// Restaure la sauvegarde rapide en mémoire, sinon celle du disque
+bool Game_QuickLoad(Game *game)
+{
+    if (game->quick_save.size > 0)
+        return SaveState_Restore(game, game->quick_save.data, game->quick_save.size);
+
+    size_t size;
+    Uint8 *data = SaveWriter_ReadFile(QUICKSAVE_PATH, &size);
+    if (!data)
+        return false;
+
+    bool restored = SaveState_Restore(game, data, size);
+    Mem_Free(data);
+    if (restored)
+        printf("Sauvegarde %s restaurée\n", QUICKSAVE_PATH);
+    return restored;
+}
+
+static void Game_UpdateAutosave(Game *game)
+{
+    // Hors de l'exploration, reportée au retour dans le monde (voir Game_QuickSave)
+    if (!game->save_writer || Input_IsReplaying(&game->input) || Game_GetState(game) != MODE_WORLD ||
+        game->input.tick - game->autosave_tick < AUTOSAVE_INTERVAL_TICKS)
+        return;
+
+    game->autosave_tick = game->input.tick;
+    if (SaveState_Capture(game, &game->autosave))
+        SaveWriter_Submit(game->save_writer, AUTOSAVE_PATH, game->autosave.data, game->autosave.size);
+}
+
+// Soumet la dernière frame enregistrée ; l'attente de la synchronisation
+// verticale ne bloque plus que ce thread
 void Game_Render(Game *game)
 {
-    Game_UpdateGraphics(game);
+    if (!game->sim_thread)
+    {
+        Game_RecordFrame(game, RenderBuffer_Back(&game->render_buffer));
+        RenderBuffer_Publish(&game->render_buffer);
+    }
+
+    bool fresh;
+    const RenderList *list = RenderBuffer_Acquire(&game->render_buffer, &fresh);
+    if (fresh && game->sim_thread)
+        SDL_SemPost(game->frame_sem);
+
+    // Une texture a été détruite depuis l'enregistrement : on attend la suivante
+    if (list->generation != Mem_GetTextureGeneration())
+    {
+        SDL_Delay(1);
+        return;
+    }
+
+    RenderList_Submit(list, game->renderer);
+    SDL_RenderPresent(game->renderer);
 }
 
 void Game_HandleGameStateEvent(Game *game, float deltaTime)
 {
-    switch (game->state)
+    bool menuPressed = (game->input.state.pressed & INPUT_BIT(INPUT_ACTION_MENU)) != 0;
+
+    switch (Game_GetState(game))
     {
     case MODE_WORLD:
 
-        HandlePlayerInput(game);
+        if (menuPressed)
+            Game_PushState(game, MODE_MENU, true);
+        else
+            HandlePlayerInput(game);
 
+        break;
+    case MODE_MENU:
+        if (menuPressed)
+            Game_PopState(game);
+        break;
+    case MODE_CINEMATIC:
+        if (menuPressed)
+            Cinematic_Skip(&game->cinematic); // Terminée au Cinematic_Update suivant
+        break;
+    case MODE_DIALOGUE:
+        // Première validation : tout le texte ; la suivante ferme la boîte
+        if (game->input.state.pressed & INPUT_BIT(INPUT_ACTION_CONFIRM))
+        {
+            if (Game_DialogueVisible(game) < game->dialogue_length)
+                game->dialogue_ticks = ((Uint32)game->dialogue_length * SIM_TICK_RATE + DIALOGUE_REVEAL_CPS - 1) /
+                                       DIALOGUE_REVEAL_CPS;
+            else
+                Game_PopState(game);
+        }
+        else
+        {
+            game->dialogue_ticks++;
+        }
         break;
     default:
         break;
     }
 }
 
-static bool Game_CanPlayerMoveTo(Game *game, float newX, float newY)
+// Combat contre une espèce sauvage ; le monde reste figé en dessous
+bool Game_StartBattle(Game *game, int species, int level)
 {
-    // Créer une hitbox temporaire
-    SDL_Rect tempHitbox = {
-        (int)(newX + game->player->baseEntity.spriteWidth / 2 - PLAYER_HITBOX_WIDTH / 2),
-        (int)(newY + game->player->baseEntity.spriteHeight - PLAYER_HITBOX_HEIGHT),
-        PLAYER_HITBOX_WIDTH,
-        PLAYER_HITBOX_HEIGHT};
+    if (!game->db)
+        return false;
+    int starter = GameDB_FindSpecies(game->db, PLAYER_STARTER);
+    if (Game_GetState(game) != MODE_WORLD || starter < 0)
+        return false;
 
-    // Vérifier les collisions avec la map
-    if (Map_CheckCollision(game->current_map, &tempHitbox))
+    // Tout est vérifié avant Combat_Start : un refus ne doit ni interrompre
+    // l'IA ni consommer de tirage de rand(), dont dépend la relecture
+    if (species < 0 || species >= game->battle_data->speciesCount || level < 1 || level > 255)
     {
+        fprintf(stderr, "Combat refusé : espèce %d niveau %d invalide\n", species, level);
         return false;
     }
 
-    for (int i = 0; i < game->current_map->npc_count; i++)
+    // Graine tirée de rand() : un combat déclenché pendant un tick (rencontre)
+    // est identique à la relecture ; le combat de débogage est refusé pendant
+    // un enregistrement (Game_HandleEvent)
+    Combat_Start(&game->combat, game->battle_data, (Uint32)rand(), game->battle_ai);
+    if (Game_IsInputLogged(game))
+        game->combat.aiIterations = BATTLE_AI_ITERATIONS; // Décision indépendante de la vitesse de la machine
+    else
+        game->combat.aiBudgetMs = BATTLE_AI_BUDGET_MS;
+    if (!Battle_AddMon(&game->combat.battle, game->battle_data, 0, (Uint16)starter, PLAYER_STARTER_LEVEL) ||
+        !Battle_AddMon(&game->combat.battle, game->battle_data, 1, (Uint16)species, (Uint8)level) ||
+        !Game_PushState(game, MODE_COMBAT, false))
     {
-        NPC *npc = game->current_map->npc[i];
-        // printf("NPC hitbox traversable : %s\n", npc->baseEntity.traversable ? "oui" : "non");
-        if (!npc->baseEntity.traversable)
-        {
-            SDL_Rect npcHitbox = npc->baseEntity.hitbox;
-            if (SDL_HasIntersection(&tempHitbox, &npcHitbox))
-            {
-                return false;
-            }
-        }
+        Combat_End(&game->combat);
+        return false;
     }
+    return true;
+}
 
+// Scène jouée sur la map courante ; le monde n'est pas recouvert, la
+// cinématique le dessine elle-même à travers sa caméra
+bool Game_StartCinematic(Game *game, const char *name)
+{
+    if (Game_GetState(game) != MODE_WORLD || !Cinematic_Load(&game->cinematic, name))
+        return false;
+    if (!Game_PushState(game, MODE_CINEMATIC, false))
+        return false;
+
+    Cinematic_Start(&game->cinematic, game->current_map, game->player->entity);
     return true;
 }
 
-static void Game_UpdatePlayerMovement(Game *game, float deltaTime)
+static void Game_EndCinematic(Game *game)
 {
-    Player *player = game->player;
+    Cinematic_Stop(&game->cinematic);
+    Game_PopState(game);
 
-    // Traitement des inputs de mouvement
-    if (player->targetDirection != DIRECTION_NONE)
-    {
-        // Mouvement libre continu
-        float moveDistance = player->speed * deltaTime;
-        float newX = player->baseEntity.x;
-        float newY = player->baseEntity.y;
+    // Le joueur repart immobile, là où la scène l'a laissé
+    Mover *mover = ECS_GetMover(game->player->entity);
+    mover->dirX = mover->dirY = 0.0f;
+    mover->hasTarget = false;
+    game->player->hasTarget = false;
+    game->player->state = PLAYER_STATE_IDLE;
+    Player_UpdateAnimation(game->player);
+    Encounters_Reset(&game->encounters);
+}
 
-        switch (player->targetDirection)
-        {
-        case DIRECTION_UP:
-            newY -= moveDistance;
-            break;
-        case DIRECTION_DOWN:
-            newY += moveDistance;
-            break;
-        case DIRECTION_LEFT:
-            newX -= moveDistance;
-            break;
-        case DIRECTION_RIGHT:
-            newX += moveDistance;
-            break;
-        default:
-            break;
-        }
+// Boîte de dialogue en surimpression du monde (panneaux)
+bool Game_OpenDialogue(Game *game, const char *text)
+{
+    if (Game_GetState(game) != MODE_WORLD)
+        return false;
 
-        // Vérifier les collisions et se coller si nécessaire
-        if (Game_CanPlayerMoveTo(game, newX, newY))
-        {
-            player->baseEntity.x = newX;
-            player->baseEntity.y = newY;
-            player->state = PLAYER_STATE_MOVING;
-        }
-        else
-        {
-            // Se coller à la collision
-            float stepX = (player->targetDirection == DIRECTION_LEFT) ? -1.0f : (player->targetDirection == DIRECTION_RIGHT) ? 1.0f
-                                                                                                                             : 0.0f;
-            float stepY = (player->targetDirection == DIRECTION_UP) ? -1.0f : (player->targetDirection == DIRECTION_DOWN) ? 1.0f
-                                                                                                                          : 0.0f;
+    snprintf(game->dialogue, sizeof(game->dialogue), "%s", text);
+    game->dialogue_length = Font_CountGlyphs(game->dialogue);
+    game->dialogue_ticks = 0;
+    return Game_PushState(game, MODE_DIALOGUE, true);
+}
 
-            // Avancer pixel par pixel jusqu'à collision
-            float testX = player->baseEntity.x;
-            float testY = player->baseEntity.y;
+// Caractères déjà affichés : calculé des ticks, identique à la relecture
+static int Game_DialogueVisible(const Game *game)
+{
+    Uint32 visible = game->dialogue_ticks * DIALOGUE_REVEAL_CPS / SIM_TICK_RATE;
+    return visible < (Uint32)game->dialogue_length ? (int)visible : game->dialogue_length;
+}
 
-            while (Game_CanPlayerMoveTo(game, testX + stepX, testY + stepY))
-            {
-                testX += stepX;
-                testY += stepY;
-            }
+// --- Pile d'états ---
+// Push et pop ne touchent pas à SDL : ils peuvent être appelés pendant un
+// tick. L'image de fond est rendue ensuite sur le thread principal.
 
-            player->baseEntity.x = testX;
-            player->baseEntity.y = testY;
-            player->state = PLAYER_STATE_IDLE;
-            Player_UpdateAnimation(player);
-        }
-    }
-    else if (player->hasTarget)
+GameState Game_GetState(const Game *game)
+{
+    return game->states[game->state_count - 1].mode;
+}
+
+bool Game_PushState(Game *game, GameState mode, bool overlay)
+{
+    if (game->state_count == GAME_STATE_STACK_MAX)
     {
-        // Alignement sur la grille
-        int n = 16;
-        float alignedX = player->baseEntity.x;
-        float alignedY = player->baseEntity.y;
+        fprintf(stderr, "Pile d'états pleine, état %d ignoré\n", mode);
+        return false;
+    }
 
-        // Calculer la prochaine position alignée selon la direction
-        switch (player->currentDirection)
-        {
-        case DIRECTION_LEFT:
-            alignedX = floor(player->baseEntity.x / n) * n;
-            break;
-        case DIRECTION_RIGHT:
-            alignedX = ceil(player->baseEntity.x / n) * n;
-            break;
-        case DIRECTION_UP:
-            alignedY = floor(player->baseEntity.y / n) * n;
-            break;
-        case DIRECTION_DOWN:
-            alignedY = ceil(player->baseEntity.y / n) * n;
-            break;
-        default:
-            break;
-        }
+    game->states[game->state_count].mode = mode;
+    game->states[game->state_count].overlay = overlay;
+    game->state_count++;
+    game->background_dirty = overlay;
+    return true;
+}
 
-        // Mouvement vers l'alignement
-        float dx = alignedX - player->baseEntity.x;
-        float dy = alignedY - player->baseEntity.y;
-        float distance = sqrt(dx * dx + dy * dy);
+bool Game_PopState(Game *game)
+{
+    if (game->state_count <= 1)
+        return false;
 
-        if (distance > 1.0f)
-        {
-            float moveDistance = player->speed * deltaTime;
-            if (moveDistance > distance)
-                moveDistance = distance;
+    game->state_count--;
+    // Le nouveau sommet peut lui-même être une surimpression sur un autre fond
+    game->background_dirty = game->states[game->state_count - 1].overlay;
+    return true;
+}
 
-            float newX = player->baseEntity.x + (dx / distance) * moveDistance;
-            float newY = player->baseEntity.y + (dy / distance) * moveDistance;
+// Rend une fois les états sous la surimpression du sommet dans `background`
+static void Game_UpdateBackground(Game *game)
+{
+    if (!game->background_dirty || !game->renderer)
+        return;
+    game->background_dirty = false;
 
-            if (Game_CanPlayerMoveTo(game, newX, newY))
-            {
-                player->baseEntity.x = newX;
-                player->baseEntity.y = newY;
-            }
-        }
-        else
+    if (!game->background)
+    {
+        game->background = Mem_CreateTexture(MEM_TAG_RENDER, game->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_TARGET, game->window_width, game->window_height);
+        if (!game->background)
         {
-            // Alignement terminé
-            player->baseEntity.x = alignedX;
-            player->baseEntity.y = alignedY;
-            player->hasTarget = false;
-            player->state = PLAYER_STATE_IDLE;
-            Player_UpdateAnimation(player);
+            // Sans texture cible, la pile est redessinée à chaque frame
+            fprintf(stderr, "Impossible de créer l'image de fond: %s\n", SDL_GetError());
+            return;
         }
     }
-    else
-    {
-        player->state = PLAYER_STATE_IDLE;
-        Player_UpdateAnimation(player);
-    }
+
+    RenderList *list = &game->background_list;
+    RenderList_Reset(list, Mem_GetTextureGeneration());
+    RenderList_SetView(list, game->window_width, game->window_height);
+    SDL_Color clear = {30, 30, 30, 255};
+    RenderList_Clear(list, clear);
+    Game_RecordStack(game, list, game->state_count - 2);
+
+    SDL_SetRenderTarget(game->renderer, game->background);
+    RenderList_Submit(list, game->renderer);
+    SDL_SetRenderTarget(game->renderer, NULL);
 }
 
 void HandlePlayerInput(Game *game)
 {
-    Player_HandleInput(game->player);
+    Player_HandleInput(game->player, &game->input.state);
 }
\ No newline at end of file
@@ -7,19 +7,44 @@
 #include <SDL2/SDL_image.h>
 
 #include "../framework/map.h"
+#include "../framework/pack.h"
+#include "../framework/mapmanager.h"
+#include "../framework/world.h"
+#include "../framework/hotreload.h"
+#include "../framework/memtrack.h"
+#include "../framework/savewriter.h"
+#include "../framework/font.h"
 #include "player.h"
 #include "constante.h"
 #include "npc.h"
+#include "input.h"
+#include "systems.h"
+#include "savestate.h"
+#include "combat.h"
+#include "gamedb.h"
+#include "encounter.h"
+#include "cinematic.h"
 
 typedef enum
 {
     MODE_WORLD,
     MODE_MENU,
     MODE_COMBAT,
-    MODE_CINEMATIC
+    MODE_CINEMATIC,
+    MODE_DIALOGUE
 
 } GameState;
 
+// Pile d'états : seul le sommet est mis à jour. Les états recouverts sont
+// suspendus tels quels (map, PNJ et textures restent en cache). Un état en
+// surimpression est dessiné sur l'image figée de ceux du dessous, rendue une
+// seule fois dans une texture ; un état opaque les masque entièrement.
+typedef struct
+{
+    GameState mode;
+    bool overlay;
+} GameStateEntry;
+
 typedef struct Game
 {
     SDL_Window *window;
@@ -27,30 +52,93 @@ typedef struct Game
     int window_width;
     int window_height;
 
-    GameState state;
+    GameStateEntry states[GAME_STATE_STACK_MAX]; // states[0] : le monde
+    int state_count;
+    SDL_Texture *background;  // Image figée des états sous la surimpression du sommet
+    bool background_dirty;    // À rendre sur le thread principal (Game_SyncWorld)
+    RenderList background_list;
+    Font *font; // Textes : combat, menu, dialogues
+
+    char dialogue[DIALOGUE_MAX_LENGTH]; // Texte de la boîte ouverte (MODE_DIALOGUE)
+    int dialogue_length;                // En caractères affichables
+    Uint32 dialogue_ticks;              // Depuis l'ouverture : défilement du texte
 
-    Map *current_map;
+    GameDB *db;                    // Espèces, attaques, rencontres (NULL sans make db)
+    const BattleData *battle_data; // Tables de combat de la base, lues en place
+    Combat combat; // Combat en cours (MODE_COMBAT)
+    BattleAI *battle_ai; // Threads de réflexion des adversaires, NULL en headless
+    Encounters encounters; // Tables de rencontres de la map courante
+    Cinematic cinematic;   // Scène en cours (MODE_CINEMATIC)
+
+    Map *current_map;       // Appartient au cache de maps
+    char map_name[64];      // Nom de la map courante
+    Loader *loader;
+    MapManager *maps;
+    World *world;           // Maps raccordées (NULL sans fichier .world)
+    char pending_map[64];   // Changement de map en cours (vide sinon)
+    float pending_x, pending_y;
+    char warp_map[64];      // Passage déclenché par le dernier tick (vide sinon)
+    float warp_x, warp_y;
+    HotReload *hot_reload;  // NULL si indisponible
     Player *player;
     Uint32 lastTime;
 
+    Input input;
+    Uint32 seed;         // Graine de rand(), enregistrée avec les entrées
+    float accumulator;   // Temps réel pas encore simulé (< SIM_TIMESTEP)
+    Uint32 replay_start; // SDL_GetTicks au début de la relecture
+
+    // Simulation sur son propre thread (Game_StartSimulation) ; le thread
+    // principal garde SDL : événements, textures et soumission du rendu
+    SDL_Thread *sim_thread; // NULL : la simulation est appelée par main.c
+    SDL_mutex *world_lock;  // Monde : simulation d'une frame ou synchronisation
+    SDL_sem *frame_sem;     // Une frame d'avance au plus sur le rendu
+    atomic_bool sim_running;
+    RenderBuffer render_buffer;
+
+    // Sauvegardes : capture sur le thread principal, écriture en arrière-plan
+    SaveWriter *save_writer; // NULL : aucune écriture (headless)
+    SaveSnapshot quick_save; // Point de restauration rapide (QUICKSAVE_KEY / QUICKLOAD_KEY)
+    SaveSnapshot autosave;
+    Uint32 autosave_tick;    // Tick de la dernière sauvegarde automatique
+
     // test NPC
-    NPC *npc;
+    EntityId npc;
 
     bool running;
 } Game;
 
 Game *Game_Create(const char *title, int width, int height);
+Game *Game_CreateHeadless(void); // Sans fenêtre ni textures (tools/headless.c)
 void Game_Free(Game *game);
 void Game_HandleEvent(Game *gamen, float deltaTime);
 void Game_HandleGameStateEvent(Game *game, float deltaTime);
+GameState Game_GetState(const Game *game);
+bool Game_PushState(Game *game, GameState mode, bool overlay);
+bool Game_PopState(Game *game); // Faux s'il ne reste que le monde
 void Game_UpdateData(Game *game, float deltaTime);
+bool Game_Tick(Game *game);
+void Game_SyncWorld(Game *game); // Thread principal : chargements, cache, passages
+void Game_Advance(Game *game, float elapsed);
 void Game_Render(Game *game);
+bool Game_StartSimulation(Game *game); // Faux : la simulation reste sur le thread appelant
+
+bool Game_StartRecording(Game *game, const char *path);
+bool Game_StartReplay(Game *game, const char *path);
+void Game_AdvanceReplay(Game *game, Uint32 budgetMs);
+
+bool Game_StartBattle(Game *game, int species, int level);
+bool Game_OpenDialogue(Game *game, const char *text);
+bool Game_StartCinematic(Game *game, const char *name);
+
+bool Game_QuickSave(Game *game);
+bool Game_QuickLoad(Game *game);
 
 // Fonctions d'initialisation internes
 bool Game_InitSDL(Game *game, const char *title, int width, int height);
 bool Game_InitMap(Game *game, const char *map_name);
+bool Game_ChangeMap(Game *game, const char *map_name, float x, float y);
 bool Game_InitPlayer(Game *game);
 void HandlePlayerInput(Game *game);
-static void Game_UpdatePlayerMovement(Game *game, float deltaTime);
 
 #endif // GAME_H
\ No newline at end of file
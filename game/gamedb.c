@@ -0,0 +1,311 @@
+#include "gamedb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../framework/memtrack.h"
+#include "../framework/pack.h"
+
+Uint32 GameDB_HashName(const char *name)
+{
+    Uint32 hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool GameDB_RangeValid(const GameDBHeader *header, Uint32 offset, Uint32 count, size_t elem_size)
+{
+    Uint64 end = (Uint64)offset + (Uint64)count * elem_size;
+    return (offset % GAMEDB_ALIGNMENT) == 0 && end <= header->file_size;
+}
+
+static bool GameDB_Validate(const GameDBHeader *header, size_t size)
+{
+    if (size < sizeof(GameDBHeader) || memcmp(header->magic, GAMEDB_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "Base de données invalide (signature)\n");
+        return false;
+    }
+    if (header->version != GAMEDB_VERSION)
+    {
+        fprintf(stderr, "Base de données de version %u non supportée (attendue %d), la recompiler\n", header->version, GAMEDB_VERSION);
+        return false;
+    }
+    if (header->file_size != size)
+    {
+        fprintf(stderr, "Base de données tronquée\n");
+        return false;
+    }
+    if (header->index_size == 0 || (header->index_size & (header->index_size - 1)) != 0 ||
+        header->index_size <= header->species_count || header->index_size <= header->move_count ||
+        header->index_size <= header->area_count)
+    {
+        fprintf(stderr, "Base de données invalide (index)\n");
+        return false;
+    }
+
+    const char *base = (const char *)header;
+    return GameDB_RangeValid(header, header->species_offset, header->species_count, sizeof(BattleSpecies)) &&
+           GameDB_RangeValid(header, header->moves_offset, header->move_count, sizeof(BattleMove)) &&
+           GameDB_RangeValid(header, header->type_chart_offset, TYPE_COUNT * TYPE_COUNT, 1) &&
+           GameDB_RangeValid(header, header->learnsets_offset, header->species_count, sizeof(BattleRange)) &&
+           GameDB_RangeValid(header, header->learns_offset, header->learn_count, sizeof(BattleLearn)) &&
+           GameDB_RangeValid(header, header->evolution_ranges_offset, header->species_count, sizeof(BattleRange)) &&
+           GameDB_RangeValid(header, header->evolutions_offset, header->evolution_count, sizeof(GameDBEvolution)) &&
+           GameDB_RangeValid(header, header->areas_offset, header->area_count, sizeof(GameDBArea)) &&
+           GameDB_RangeValid(header, header->encounters_offset, header->encounter_count, sizeof(GameDBEncounter)) &&
+           GameDB_RangeValid(header, header->species_index_offset, header->index_size, sizeof(Uint32)) &&
+           GameDB_RangeValid(header, header->move_index_offset, header->index_size, sizeof(Uint32)) &&
+           GameDB_RangeValid(header, header->area_index_offset, header->index_size, sizeof(Uint32)) &&
+           (Uint64)header->strings_offset + header->strings_size <= header->file_size &&
+           (header->strings_size == 0 || base[header->strings_offset + header->strings_size - 1] == '\0');
+}
+
+// Type lu dans la base : TYPE_NONE n'est permis que là où `none` l'autorise
+static bool GameDB_TypeValid(Uint8 type, bool none)
+{
+    return type < TYPE_COUNT || (none && type == TYPE_NONE);
+}
+
+// Plages, types et poids : vérifiés une fois, pour que les accès suivants
+// n'aient rien à contrôler
+static bool GameDB_ValidateRanges(const GameDB *db)
+{
+    const GameDBHeader *header = db->header;
+    for (Uint32 i = 0; i < header->species_count; i++)
+    {
+        const BattleSpecies *species = &db->battle.species[i];
+        if (!GameDB_TypeValid(species->types[0], false) || !GameDB_TypeValid(species->types[1], true))
+        {
+            fprintf(stderr, "Espèce %u : type invalide\n", i);
+            return false;
+        }
+
+        const BattleRange *learn = &db->battle.learnsets[i];
+        const BattleRange *evo = &db->evolution_ranges[i];
+        if ((Uint64)learn->first + learn->count > header->learn_count ||
+            (Uint64)evo->first + evo->count > header->evolution_count)
+            return false;
+    }
+    for (Uint32 i = 0; i < header->move_count; i++)
+    {
+        const BattleMove *move = &db->battle.moves[i];
+        if (!GameDB_TypeValid(move->type, true) || move->category > MOVE_STATUS)
+        {
+            fprintf(stderr, "Attaque %u : type ou catégorie invalide\n", i);
+            return false;
+        }
+    }
+    for (Uint32 i = 0; i < header->learn_count; i++)
+    {
+        if (db->battle.learns[i].move >= header->move_count)
+            return false;
+    }
+    for (Uint32 i = 0; i < header->evolution_count; i++)
+    {
+        if (db->evolutions[i].into >= header->species_count)
+            return false;
+    }
+    for (Uint32 i = 0; i < header->encounter_count; i++)
+    {
+        if (db->encounters[i].species >= header->species_count)
+            return false;
+    }
+    for (Uint32 i = 0; i < header->area_count; i++)
+    {
+        const GameDBArea *area = &db->areas[i];
+        if ((Uint64)area->first + area->count > header->encounter_count || area->name >= header->strings_size)
+            return false;
+
+        // Le tirage des rencontres répartit total_weight entre les entrées
+        Uint64 weight = 0;
+        for (Uint32 e = 0; e < area->count; e++)
+            weight += db->encounters[area->first + e].weight;
+        if (weight != area->total_weight)
+        {
+            fprintf(stderr, "Zone %s : poids total %u, somme des poids %llu\n", db->strings + area->name,
+                    area->total_weight, (unsigned long long)weight);
+            return false;
+        }
+    }
+    return true;
+}
+
+static GameDB *GameDB_Resolve(void *data, size_t size, bool borrowed, const char *path)
+{
+    const GameDBHeader *header = (const GameDBHeader *)data;
+    if (!GameDB_Validate(header, size))
+    {
+        fprintf(stderr, "Base de données refusée: %s\n", path);
+        if (!borrowed)
+            munmap(data, size);
+        return NULL;
+    }
+
+    GameDB *db = Mem_Calloc(MEM_TAG_BATTLE, 1, sizeof(GameDB));
+    if (!db)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour la base de données.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const char *base = (const char *)data;
+    db->data = data;
+    db->size = size;
+    db->borrowed = borrowed;
+    db->header = header;
+
+    db->battle.species = (const BattleSpecies *)(base + header->species_offset);
+    db->battle.speciesCount = (int)header->species_count;
+    db->battle.moves = (const BattleMove *)(base + header->moves_offset);
+    db->battle.moveCount = (int)header->move_count;
+    db->battle.typeChart = (const Uint8 *)(base + header->type_chart_offset);
+    db->battle.learnsets = (const BattleRange *)(base + header->learnsets_offset);
+    db->battle.learns = (const BattleLearn *)(base + header->learns_offset);
+
+    db->evolution_ranges = (const BattleRange *)(base + header->evolution_ranges_offset);
+    db->evolutions = (const GameDBEvolution *)(base + header->evolutions_offset);
+    db->areas = (const GameDBArea *)(base + header->areas_offset);
+    db->encounters = (const GameDBEncounter *)(base + header->encounters_offset);
+    db->species_index = (const Uint32 *)(base + header->species_index_offset);
+    db->move_index = (const Uint32 *)(base + header->move_index_offset);
+    db->area_index = (const Uint32 *)(base + header->area_index_offset);
+    db->strings = base + header->strings_offset;
+
+    if (!GameDB_ValidateRanges(db))
+    {
+        fprintf(stderr, "Base de données invalide (plages): %s\n", path);
+        GameDB_Close(db);
+        return NULL;
+    }
+    return db;
+}
+
+GameDB *GameDB_Open(const char *path)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    fprintf(stderr, "La base de données est petit-boutiste, non supportée sur cette plateforme: %s\n", path);
+    return NULL;
+#endif
+
+    // Entrée non compressée de l'archive : utilisée en place, sans copie
+    size_t packed_size = 0;
+    const void *packed = Pack_GetMapped(path, &packed_size);
+    if (packed)
+        return GameDB_Resolve((void *)packed, packed_size, true, path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Impossible d'ouvrir la base de données: %s (make db)\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GameDBHeader))
+    {
+        close(fd);
+        fprintf(stderr, "Base de données invalide: %s\n", path);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        fprintf(stderr, "mmap impossible pour la base de données: %s\n", path);
+        return NULL;
+    }
+    return GameDB_Resolve(data, st.st_size, false, path);
+}
+
+void GameDB_Close(GameDB *db)
+{
+    if (!db)
+        return;
+    if (!db->borrowed)
+        munmap(db->data, db->size);
+    Mem_Free(db);
+}
+
+// Sondage linéaire jusqu'à une case vide ; `matches` compare le nom de l'identifiant
+static int GameDB_Lookup(const GameDB *db, const Uint32 *index, const char *name,
+                         bool (*matches)(const GameDB *db, Uint32 id, const char *name))
+{
+    Uint32 mask = db->header->index_size - 1;
+    for (Uint32 i = GameDB_HashName(name) & mask, probes = 0; probes <= mask; i = (i + 1) & mask, probes++)
+    {
+        Uint32 id = index[i];
+        if (id == GAMEDB_NONE)
+            return -1;
+        if (matches(db, id, name))
+            return (int)id;
+    }
+    return -1;
+}
+
+static bool GameDB_SpeciesMatches(const GameDB *db, Uint32 id, const char *name)
+{
+    return id < db->header->species_count && strncmp(db->battle.species[id].name, name, BATTLE_NAME_LENGTH) == 0;
+}
+
+static bool GameDB_MoveMatches(const GameDB *db, Uint32 id, const char *name)
+{
+    return id < db->header->move_count && strncmp(db->battle.moves[id].name, name, BATTLE_NAME_LENGTH) == 0;
+}
+
+static bool GameDB_AreaMatches(const GameDB *db, Uint32 id, const char *name)
+{
+    return id < db->header->area_count && strcmp(db->strings + db->areas[id].name, name) == 0;
+}
+
+int GameDB_FindSpecies(const GameDB *db, const char *name)
+{
+    return GameDB_Lookup(db, db->species_index, name, GameDB_SpeciesMatches);
+}
+
+int GameDB_FindMove(const GameDB *db, const char *name)
+{
+    return GameDB_Lookup(db, db->move_index, name, GameDB_MoveMatches);
+}
+
+int GameDB_FindArea(const GameDB *db, const char *name)
+{
+    return GameDB_Lookup(db, db->area_index, name, GameDB_AreaMatches);
+}
+
+const char *GameDB_AreaName(const GameDB *db, int area)
+{
+    if (area < 0 || (Uint32)area >= db->header->area_count)
+        return NULL;
+    return db->strings + db->areas[area].name;
+}
+
+const GameDBEncounter *GameDB_GetEncounters(const GameDB *db, int area, int *count)
+{
+    if (area < 0 || (Uint32)area >= db->header->area_count)
+    {
+        *count = 0;
+        return NULL;
+    }
+    *count = (int)db->areas[area].count;
+    return &db->encounters[db->areas[area].first];
+}
+
+const GameDBEvolution *GameDB_GetEvolutions(const GameDB *db, int species, int *count)
+{
+    if (species < 0 || (Uint32)species >= db->header->species_count)
+    {
+        *count = 0;
+        return NULL;
+    }
+    *count = (int)db->evolution_ranges[species].count;
+    return &db->evolutions[db->evolution_ranges[species].first];
+}
@@ -0,0 +1,106 @@
+#ifndef GAMEDB_H
+#define GAMEDB_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "battle.h"
+
+// Base de données du jeu (.db), compilée depuis les tables CSV de
+// resources/data par tools/dbcook.c et projetée en mémoire avec mmap : aucune
+// analyse au démarrage. Petit-boutiste, sections alignées sur 8 octets :
+//
+//   GameDBHeader
+//   BattleSpecies[species_count]     identifiant = indice
+//   BattleMove[move_count]           identifiant = indice
+//   Uint8 type_chart[TYPE_COUNT * TYPE_COUNT]
+//   BattleRange[species_count]       attaques apprises de chaque espèce
+//   BattleLearn[learn_count]
+//   BattleRange[species_count]       évolutions de chaque espèce
+//   GameDBEvolution[evolution_count]
+//   GameDBArea[area_count]           + GameDBEncounter[encounter_count]
+//   index par nom : Uint32[index_size] pour les espèces, les attaques et les zones
+//   table de chaînes (terminées par '\0')
+//
+// Les index par nom sont des tables de hachage à adressage ouvert (sondage
+// linéaire depuis GameDB_HashName(nom) & (index_size - 1), GAMEDB_NONE pour
+// une case vide) : recherche en O(1), comme l'accès par identifiant.
+
+#define GAMEDB_MAGIC "PKDB"
+#define GAMEDB_VERSION 1
+#define GAMEDB_ALIGNMENT 8
+#define GAMEDB_NONE 0xFFFFFFFFu
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 file_size;
+    Uint32 species_count, species_offset;
+    Uint32 move_count, moves_offset;
+    Uint32 type_chart_offset;
+    Uint32 learnsets_offset;
+    Uint32 learn_count, learns_offset;
+    Uint32 evolution_ranges_offset;
+    Uint32 evolution_count, evolutions_offset;
+    Uint32 area_count, areas_offset;
+    Uint32 encounter_count, encounters_offset;
+    Uint32 index_size; // Puissance de 2, commune aux trois index
+    Uint32 species_index_offset, move_index_offset, area_index_offset;
+    Uint32 strings_offset, strings_size;
+} GameDBHeader;
+
+typedef struct
+{
+    Uint16 into;  // Espèce obtenue
+    Uint8 level;  // Niveau requis
+    Uint8 reserved;
+} GameDBEvolution;
+
+// Zone de rencontres sauvages (hautes herbes, grotte...)
+typedef struct
+{
+    Uint32 name;         // Dans la table de chaînes
+    Uint32 first, count; // Plage de GameDBEncounter
+    Uint32 total_weight;
+} GameDBArea;
+
+typedef struct
+{
+    Uint16 species;
+    Uint8 min_level, max_level;
+    Uint16 weight; // Chance relative dans la zone
+    Uint16 reserved;
+} GameDBEncounter;
+
+typedef struct
+{
+    void *data; // Projection mmap, ou entrée de l'archive (empruntée)
+    size_t size;
+    bool borrowed;
+
+    const GameDBHeader *header;
+    BattleData battle; // Pointe dans la projection : lu tel quel par le moteur
+    const BattleRange *evolution_ranges;
+    const GameDBEvolution *evolutions;
+    const GameDBArea *areas;
+    const GameDBEncounter *encounters;
+    const Uint32 *species_index, *move_index, *area_index;
+    const char *strings;
+} GameDB;
+
+// Archive montée d'abord (entrée non compressée, lue en place), puis fichier
+GameDB *GameDB_Open(const char *path);
+void GameDB_Close(GameDB *db);
+
+Uint32 GameDB_HashName(const char *name); // FNV-1a 32 bits, partagé avec dbcook
+
+// Recherches par nom, -1 si inconnu
+int GameDB_FindSpecies(const GameDB *db, const char *name);
+int GameDB_FindMove(const GameDB *db, const char *name);
+int GameDB_FindArea(const GameDB *db, const char *name);
+
+const char *GameDB_AreaName(const GameDB *db, int area);
+const GameDBEncounter *GameDB_GetEncounters(const GameDB *db, int area, int *count);
+const GameDBEvolution *GameDB_GetEvolutions(const GameDB *db, int species, int *count);
+
+#endif // GAMEDB_H
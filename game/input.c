@@ -0,0 +1,277 @@
+#include "input.h"
+#include "constante.h"
+#include <string.h>
+
+#define INPUT_LOG_MAGIC "PKIN"
+#define INPUT_LOG_VERSION 1
+#define INPUT_LOG_END 0x7F     // Action de fin : tick final de la session
+#define INPUT_LOG_PRESSED 0x80 // Bit d'appui dans l'octet d'action
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 tick_rate; // SIM_TICK_RATE à l'enregistrement
+    Uint32 seed;      // Graine de rand() (IA)
+} InputLogHeader;
+
+// Enregistrement : écart en ticks depuis le précédent (varint LEB128), puis
+// action | INPUT_LOG_PRESSED. Un appui tient en 2 octets la plupart du temps.
+
+void Input_Init(Input *input)
+{
+    memset(input, 0, sizeof(Input));
+}
+
+static int Input_ActionOf(SDL_Scancode scancode)
+{
+    switch (scancode)
+    {
+    case SDL_SCANCODE_UP:
+    case SDL_SCANCODE_W:
+        return INPUT_ACTION_UP;
+    case SDL_SCANCODE_DOWN:
+    case SDL_SCANCODE_S:
+        return INPUT_ACTION_DOWN;
+    case SDL_SCANCODE_LEFT:
+    case SDL_SCANCODE_A:
+        return INPUT_ACTION_LEFT;
+    case SDL_SCANCODE_RIGHT:
+    case SDL_SCANCODE_D:
+        return INPUT_ACTION_RIGHT;
+    case SDL_SCANCODE_SPACE:
+        return INPUT_ACTION_TOGGLE_BIKE;
+    case SDL_SCANCODE_ESCAPE:
+        return INPUT_ACTION_MENU;
+    case SDL_SCANCODE_RETURN:
+        return INPUT_ACTION_CONFIRM;
+    default:
+        return -1;
+    }
+}
+
+bool Input_HandleEvent(Input *input, const SDL_Event *event)
+{
+    if (event->type != SDL_KEYDOWN && event->type != SDL_KEYUP)
+        return false;
+    if (event->key.repeat)
+        return false;
+
+    int action = Input_ActionOf(event->key.keysym.scancode);
+    if (action < 0)
+        return false;
+
+    // Pendant une relecture, seul le journal pilote le joueur
+    if (!input->replay)
+        Input_Push(input, (InputAction)action, event->type == SDL_KEYDOWN, event->key.timestamp);
+    return true;
+}
+
+void Input_Push(Input *input, InputAction action, bool pressed, Uint32 timestamp)
+{
+    if (input->count == INPUT_QUEUE_CAPACITY)
+    {
+        fprintf(stderr, "File d'entrées pleine, action ignorée\n");
+        return;
+    }
+
+    InputEvent *event = &input->queue[(input->head + input->count) % INPUT_QUEUE_CAPACITY];
+    event->timestamp = timestamp;
+    event->action = (Uint8)action;
+    event->pressed = pressed;
+    input->count++;
+}
+
+static void Input_WriteVarint(FILE *file, Uint32 value)
+{
+    do
+    {
+        Uint8 byte = value & 0x7F;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        fputc(byte, file);
+    } while (value);
+}
+
+static bool Input_ReadVarint(FILE *file, Uint32 *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        int byte = fgetc(file);
+        if (byte == EOF)
+            return false;
+        *value |= (Uint32)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static void Input_WriteRecord(Input *input, Uint8 action, bool pressed)
+{
+    Input_WriteVarint(input->record, input->tick - input->recordTick);
+    fputc(action | (pressed ? INPUT_LOG_PRESSED : 0), input->record);
+    input->recordTick = input->tick;
+}
+
+// Lit l'enregistrement suivant du journal rejoué
+static void Input_ReadNext(Input *input)
+{
+    Uint32 delta;
+    int byte;
+    if (!Input_ReadVarint(input->replay, &delta) || (byte = fgetc(input->replay)) == EOF)
+    {
+        // Journal tronqué (jeu interrompu) : on rejoue ce qu'il contient
+        input->replayHasNext = false;
+        input->replayFinished = true;
+        return;
+    }
+
+    input->replayHasNext = true;
+    input->replayNextTick += delta;
+    input->replayNextAction = byte & ~INPUT_LOG_PRESSED;
+    input->replayNextPressed = (byte & INPUT_LOG_PRESSED) != 0;
+}
+
+static void Input_Apply(Input *input, Uint8 action, bool pressed)
+{
+    if (action >= INPUT_ACTION_COUNT)
+        return;
+
+    if (pressed)
+    {
+        input->state.held |= INPUT_BIT(action);
+        input->state.pressed |= INPUT_BIT(action);
+    }
+    else
+    {
+        input->state.held &= ~INPUT_BIT(action);
+    }
+}
+
+void Input_BeginTick(Input *input)
+{
+    input->state.pressed = 0;
+
+    if (input->replay)
+    {
+        while (input->replayHasNext && input->replayNextTick <= input->tick)
+        {
+            if (input->replayNextAction == INPUT_LOG_END)
+            {
+                input->replayHasNext = false;
+                input->replayFinished = true;
+                break;
+            }
+            Input_Apply(input, input->replayNextAction, input->replayNextPressed);
+            Input_ReadNext(input);
+        }
+        return;
+    }
+
+    // Toute la file, dans l'ordre d'arrivée : un appui et son relâchement
+    // dans le même tick laissent une trace dans `pressed`
+    while (input->count > 0)
+    {
+        InputEvent *event = &input->queue[input->head];
+        Input_Apply(input, event->action, event->pressed);
+        if (input->record)
+            Input_WriteRecord(input, event->action, event->pressed);
+
+        input->head = (input->head + 1) % INPUT_QUEUE_CAPACITY;
+        input->count--;
+    }
+}
+
+void Input_EndTick(Input *input)
+{
+    input->tick++;
+}
+
+bool Input_StartRecording(Input *input, const char *path, Uint32 seed)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible de créer le journal d'entrées %s\n", path);
+        return false;
+    }
+
+    InputLogHeader header;
+    memcpy(header.magic, INPUT_LOG_MAGIC, 4);
+    header.version = INPUT_LOG_VERSION;
+    header.tick_rate = SIM_TICK_RATE;
+    header.seed = seed;
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        fclose(file);
+        return false;
+    }
+
+    input->record = file;
+    input->recordTick = input->tick;
+    return true;
+}
+
+bool Input_StartReplay(Input *input, const char *path, Uint32 *seed)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Journal d'entrées introuvable: %s\n", path);
+        return false;
+    }
+
+    InputLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, INPUT_LOG_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "%s n'est pas un journal d'entrées\n", path);
+        fclose(file);
+        return false;
+    }
+    if (header.version != INPUT_LOG_VERSION || header.tick_rate != SIM_TICK_RATE)
+    {
+        fprintf(stderr, "Journal d'entrées incompatible (version %u, %u ticks/s)\n", header.version, header.tick_rate);
+        fclose(file);
+        return false;
+    }
+
+    input->replay = file;
+    input->replayNextTick = input->tick;
+    input->replayFinished = false;
+    *seed = header.seed;
+    Input_ReadNext(input);
+    return true;
+}
+
+bool Input_IsReplaying(const Input *input)
+{
+    return input->replay != NULL;
+}
+
+// Vrai dès que le tick courant atteint la fin du journal, avant de le simuler
+bool Input_ReplayFinished(const Input *input)
+{
+    if (!input->replay)
+        return false;
+    return input->replayFinished ||
+           (input->replayHasNext && input->replayNextAction == INPUT_LOG_END && input->replayNextTick <= input->tick);
+}
+
+void Input_Close(Input *input)
+{
+    if (input->record)
+    {
+        // Tick final : la relecture s'arrête au même instant
+        Input_WriteRecord(input, INPUT_LOG_END, false);
+        fclose(input->record);
+        input->record = NULL;
+    }
+    if (input->replay)
+    {
+        fclose(input->replay);
+        input->replay = NULL;
+    }
+}
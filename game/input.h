@@ -0,0 +1,80 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Entrées du jeu : les événements SDL deviennent des actions horodatées,
+// mises en file puis consommées au début de chaque tick de simulation. Un
+// appui bref entre deux ticks n'est donc plus perdu. La file peut être
+// enregistrée dans un journal binaire compact et rejouée à l'identique.
+
+typedef enum
+{
+    INPUT_ACTION_UP,
+    INPUT_ACTION_DOWN,
+    INPUT_ACTION_LEFT,
+    INPUT_ACTION_RIGHT,
+    INPUT_ACTION_TOGGLE_BIKE,
+    INPUT_ACTION_MENU,
+    INPUT_ACTION_CONFIRM,
+    INPUT_ACTION_COUNT
+} InputAction;
+
+#define INPUT_BIT(action) (1u << (action))
+#define INPUT_QUEUE_CAPACITY 64
+
+typedef struct
+{
+    Uint32 timestamp; // SDL_GetTicks de l'événement (ms)
+    Uint8 action;
+    bool pressed;
+} InputEvent;
+
+// État vu par la simulation pendant un tick
+typedef struct
+{
+    Uint32 held;    // Actions maintenues à la fin de la file
+    Uint32 pressed; // Actions enfoncées pendant ce tick, même relâchées depuis
+} InputState;
+
+typedef struct
+{
+    InputEvent queue[INPUT_QUEUE_CAPACITY]; // File circulaire
+    int head;
+    int count;
+
+    InputState state;
+    Uint32 tick; // Ticks de simulation écoulés
+
+    FILE *record;
+    Uint32 recordTick; // Tick du dernier événement écrit
+
+    FILE *replay;
+    bool replayHasNext;
+    Uint32 replayNextTick;
+    Uint8 replayNextAction;
+    bool replayNextPressed;
+    bool replayFinished;
+} Input;
+
+void Input_Init(Input *input);
+void Input_Close(Input *input); // Termine l'enregistrement ou la relecture
+
+// Convertit un événement clavier en action ; ignoré pendant une relecture.
+// Retourne vrai si l'événement a été consommé.
+bool Input_HandleEvent(Input *input, const SDL_Event *event);
+void Input_Push(Input *input, InputAction action, bool pressed, Uint32 timestamp);
+
+// Vide la file (ou le journal rejoué) dans l'état du tick courant
+void Input_BeginTick(Input *input);
+void Input_EndTick(Input *input);
+
+// Journal : en-tête (tick rate, graine) puis un enregistrement par action
+bool Input_StartRecording(Input *input, const char *path, Uint32 seed);
+bool Input_StartReplay(Input *input, const char *path, Uint32 *seed);
+bool Input_IsReplaying(const Input *input);
+bool Input_ReplayFinished(const Input *input);
+
+#endif // INPUT_H
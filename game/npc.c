@@ -2,62 +2,139 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <stdlib.h>
 
-// Update the NPC_Init function definition
-bool NPC_Init(NPC *npc, SDL_Renderer *renderer, const char *spriteSheetPath,
-              int spriteWidth, int spriteHeight, float x, float y,
-              int hitboxWidth, int hitboxHeight, float speed)
+// Construit une seule fois l'ensemble d'animations commun à tous les PNJ d'une feuille
+// (surface peut être NULL : l'image est alors chargée depuis spriteSheetPath)
+static bool NPC_BuildAnimationSet(AnimationSet *set, SDL_Renderer *renderer, const char *spriteSheetPath,
+                                  SDL_Surface *surface, int spriteWidth, int spriteHeight)
 {
-    if (!Entity_Init(&npc->baseEntity, spriteWidth, spriteHeight, x, y, hitboxWidth, hitboxHeight, false))
+    bool sheetAdded = surface
+                          ? AnimSet_AddSpriteSheetFromSurface(set, renderer, surface, spriteSheetPath, "DEFAULT", spriteWidth, spriteHeight)
+                          : AnimSet_AddSpriteSheet(set, renderer, spriteSheetPath, "DEFAULT", spriteWidth, spriteHeight);
+    if (!sheetAdded)
     {
-        fprintf(stderr, "Failed to initialize base entity for NPC!\\n");
         return false;
     }
 
-    npc->speed = speed; // Initialize the speed member
-    npc->actionTimer = 0.0f;
-    npc->actionDuration = 0.0f;
+    AnimSet_AddAnimation(set, "idle_down", "DEFAULT", 0, 0, 1, 200, false);
+    AnimSet_AddAnimation(set, "idle_left", "DEFAULT", 1, 0, 1, 200, false);
+    AnimSet_AddAnimation(set, "idle_right", "DEFAULT", 2, 0, 1, 200, false);
+    AnimSet_AddAnimation(set, "idle_top", "DEFAULT", 3, 0, 1, 200, false);
+
+    AnimSet_AddAnimation(set, "walk_down", "DEFAULT", 0, 0, 4, 200, true);
+    AnimSet_AddAnimation(set, "walk_left", "DEFAULT", 1, 0, 4, 200, true);
+    AnimSet_AddAnimation(set, "walk_right", "DEFAULT", 2, 0, 4, 200, true);
+    AnimSet_AddAnimation(set, "walk_top", "DEFAULT", 3, 0, 4, 150, true);
+
+    // Machine à états partagée : l'animation découle de MOVING et FACING,
+    // la marche est jouée au rythme de la vitesse réelle du PNJ
+    static const char *suffixes[] = {"down", "left", "right", "top"}; // Ordre de ANIM_PARAM_FACING
+    AnimStateMachine *machine = AnimMachine_Create();
+    set->machine = machine;
 
-    if (!Entity_AddSpriteSheet(&npc->baseEntity, renderer, spriteSheetPath, "DEFAULT", spriteWidth, spriteHeight))
+    for (int facing = 0; facing < 4; facing++)
     {
-        fprintf(stderr, "Failed to add default spritesheet for NPC!\\n");
-        return false;
+        char name[32];
+        snprintf(name, sizeof(name), "idle_%s", suffixes[facing]);
+        int idle = AnimMachine_AddState(machine, set, name, name, 0.0f);
+        snprintf(name, sizeof(name), "walk_%s", suffixes[facing]);
+        int walk = AnimMachine_AddState(machine, set, name, name, NPC_REFERENCE_SPEED);
+
+        AnimCondition toIdle[] = {{ANIM_COND_PARAM_LESS, ANIM_PARAM_MOVING, 0.5f},
+                                  {ANIM_COND_PARAM_EQUAL, ANIM_PARAM_FACING, (float)facing}};
+        AnimCondition toWalk[] = {{ANIM_COND_PARAM_GREATER, ANIM_PARAM_MOVING, 0.5f},
+                                  {ANIM_COND_PARAM_EQUAL, ANIM_PARAM_FACING, (float)facing}};
+        AnimMachine_AddTransition(machine, ANIM_ANY_STATE, idle, toIdle, 2);
+        AnimMachine_AddTransition(machine, ANIM_ANY_STATE, walk, toWalk, 2);
     }
 
-    Entity_AddAnimation(&npc->baseEntity, "idle_down", "DEFAULT", 0, 0, 1, 200, false);
-    Entity_AddAnimation(&npc->baseEntity, "idle_left", "DEFAULT", 1, 0, 1, 200, false);
-    Entity_AddAnimation(&npc->baseEntity, "idle_right", "DEFAULT", 2, 0, 1, 200, false);
-    Entity_AddAnimation(&npc->baseEntity, "idle_top", "DEFAULT", 3, 0, 1, 200, false);
+    return true;
+}
 
-    Entity_SetAnimation(&npc->baseEntity, "idle_down");
+// Construit dans le registre l'ensemble d'une feuille déjà décodée, pour que
+// les NPC_Create suivants n'aient plus rien à charger. La référence prise
+// garde l'ensemble en vie tant qu'aucun PNJ ne l'utilise encore.
+AnimationSet *NPC_PreloadAnimationSet(SDL_Renderer *renderer, const char *spriteSheetPath, SDL_Surface *surface,
+                                      int spriteWidth, int spriteHeight)
+{
+    char key[256];
+    AnimSet_MakeKey(key, sizeof(key), spriteSheetPath, spriteWidth, spriteHeight);
+    AnimationSet *set = AnimSet_Register(key);
+    AnimSet_Retain(set);
+    if (set->animationCount > 0 ||
+        NPC_BuildAnimationSet(set, renderer, spriteSheetPath, surface, spriteWidth, spriteHeight))
+        return set;
 
-    return true;
+    AnimSet_Release(set); // Ensemble vide retiré du registre
+    return NULL;
 }
 
-void NPC_Free(NPC *npc)
+// Crée un PNJ : entité animée, solide sauf indication contraire, avec
+// déplacement et IA (immobile par défaut)
+EntityId NPC_Create(SDL_Renderer *renderer, const char *spriteSheetPath,
+                    int spriteWidth, int spriteHeight, float x, float y,
+                    int hitboxWidth, int hitboxHeight, float speed)
 {
-    if (npc)
+    EntityId npc = Entity_Create(spriteWidth, spriteHeight, x, y, hitboxWidth, hitboxHeight, false);
+    if (npc == ENTITY_NONE)
+    {
+        fprintf(stderr, "Failed to initialize base entity for NPC!\n");
+        return ENTITY_NONE;
+    }
+
+    Mover *mover = ECS_Add(npc, COMPONENT_MOVER);
+    mover->speed = speed;
+
+    AI *ai = ECS_Add(npc, COMPONENT_AI);
+    ai->behaviour = AI_STATIC;
+
+    // Les PNJ partageant la même feuille réutilisent le même ensemble d'animations
+    char key[256];
+    AnimSet_MakeKey(key, sizeof(key), spriteSheetPath, spriteWidth, spriteHeight);
+    AnimationSet *set = AnimSet_Register(key);
+    Entity_SetAnimationSet(npc, set);
+
+    if (set->animationCount == 0 && !NPC_BuildAnimationSet(set, renderer, spriteSheetPath, NULL, spriteWidth, spriteHeight))
     {
-        Entity_Free(&npc->baseEntity);
+        fprintf(stderr, "Failed to add default spritesheet for NPC!\n");
+        Entity_Destroy(npc);
+        return ENTITY_NONE;
     }
+
+    // Crée la lecture si l'ensemble vient d'être construit (état d'entrée de la machine)
+    Entity_SetAnimation(npc, "idle_down");
+
+    Animator *animator = ECS_GetAnimator(npc);
+    AnimSystem_SetParam(animator->anim, ANIM_PARAM_SPEED, speed);
+    NPC_SetFacing(npc, 0);
+
+    return npc;
 }
 
-void NPC_Update(NPC *npc, float deltaTime)
+// Orientation du PNJ (0 bas, 1 gauche, 2 droite, 3 haut) ; la machine à
+// états choisit l'animation correspondante à la prochaine mise à jour
+void NPC_SetFacing(EntityId npc, int direction)
 {
-    Entity_UpdateAnimation(&npc->baseEntity, deltaTime);
+    if (direction < 0 || direction > 3)
+        direction = 0;
 
-    Entity *entity = &npc->baseEntity;
-    entity->hitbox.x = (int)(entity->x + entity->spriteWidth / 2 - NPC_HITBOX_WIDTH / 2);
-    entity->hitbox.y = (int)(entity->y + entity->spriteHeight - NPC_HITBOX_HEIGHT);
+    Mover *mover = ECS_GetMover(npc);
+    if (mover)
+        mover->facing = direction;
+
+    Animator *animator = ECS_GetAnimator(npc);
+    if (animator)
+        AnimSystem_SetParam(animator->anim, ANIM_PARAM_FACING, (float)direction);
 }
 
-void NPC_Draw(NPC *npc, SDL_Renderer *renderer)
+// Un PNJ en pause n'est ni animé, ni déplacé, ni affiché, ni solide
+void NPC_SetPaused(EntityId npc, bool paused)
 {
-    Entity_Draw(&npc->baseEntity, renderer);
+    Entity_PauseAnimation(npc, paused);
+    ECS_SetActive(npc, !paused);
 }
 
-void NPC_AddAnimation(NPC *npc, const char *animationName, const char *spriteSheetName, int frameDurationMs, bool loop, int startRow, int startCol, int frameCount)
+void NPC_Free(EntityId npc)
 {
-    Entity_AddAnimation(&npc->baseEntity, animationName, spriteSheetName, startRow, startCol, frameCount, frameDurationMs, loop);
-}
\ No newline at end of file
+    Entity_Destroy(npc);
+}
@@ -5,24 +5,20 @@
 #include "entity.h"
 #include "constante.h"
 
-typedef struct NPC
-{
-    Entity baseEntity;
-    float speed;
-    float actionTimer;
-    float actionDuration;
-    int currentAction;
-    char *name;
-    int direction;
-} NPC;
+// Un PNJ est une entité (voir ecs.h) : Transform, Hitbox, Sprite, Animator,
+// Collider, Mover et AI
 
-bool NPC_Init(NPC *npc, SDL_Renderer *renderer, const char *spriteSheetPath,
-              int spriteWidth, int spriteHeight, float x, float y,
-              int hitboxWidth, int hitboxHeight, float speed);
+EntityId NPC_Create(SDL_Renderer *renderer, const char *spriteSheetPath,
+                    int spriteWidth, int spriteHeight, float x, float y,
+                    int hitboxWidth, int hitboxHeight, float speed);
 
-void NPC_Free(NPC *npc);
-void NPC_Update(NPC *npc, float deltaTime);
-void NPC_Draw(NPC *npc, SDL_Renderer *renderer);
-void NPC_AddAnimation(NPC *npc, const char *animationName, const char *spriteSheetName, int frameDurationMs, bool loop, int startRow, int startCol, int frameCount);
+// Ensemble d'une feuille construit dans le registre, avec une référence pour
+// l'appelant (à rendre avec AnimSet_Release) ; NULL en cas d'échec
+AnimationSet *NPC_PreloadAnimationSet(SDL_Renderer *renderer, const char *spriteSheetPath, SDL_Surface *surface,
+                                      int spriteWidth, int spriteHeight);
 
-#endif // NPC_H
\ No newline at end of file
+void NPC_SetFacing(EntityId npc, int direction);
+void NPC_SetPaused(EntityId npc, bool paused);
+void NPC_Free(EntityId npc);
+
+#endif // NPC_H
@@ -1,19 +1,15 @@
 #include "player.h"
 #include <stdio.h>
 
-const int LARGEUR_HITBOX = PLAYER_HITBOX_WIDTH;
-const int HAUTEUR_HITBOX = PLAYER_HITBOX_HEIGHT;
-
-static void Player_StartMovement(Player *player, Direction direction, float targetX, float targetY);
-static void Player_FinishMovement(Player *player, float deltaTime);
-static float Player_AlignToGrid(float position, int gridSize);
 void Player_UpdateAnimation(Player *player);
 
 bool Player_Init(Player *player, SDL_Renderer *renderer, const char *initialSpriteSheetPath,
                  int spriteWidth, int spriteHeight, float x, float y,
                  int hitboxWidth, int hitboxHeight)
 {
-    if (!Entity_Init(&player->baseEntity, spriteWidth, spriteHeight, x, y, hitboxWidth, hitboxHeight, true))
+    // Le joueur est traversable : ce sont les autres qui le contournent
+    player->entity = Entity_Create(spriteWidth, spriteHeight, x, y, hitboxWidth, hitboxHeight, true);
+    if (player->entity == ENTITY_NONE)
     {
         return false;
     }
@@ -22,78 +18,146 @@ bool Player_Init(Player *player, SDL_Renderer *renderer, const char *initialSpri
     player->currentDirection = DIRECTION_DOWN;
     player->targetDirection = DIRECTION_NONE;
     player->lastDirection = DIRECTION_DOWN;
-    player->targetX = x;
-    player->targetY = y;
+    player->facing = DIRECTION_DOWN;
     player->hasTarget = false;
     player->wasMovingLastFrame = false;
     player->currentMovementMode = MOVEMENT_WALK;
     player->walkSpeed = PLAYER_SPEED;
     player->runSpeed = PLAYER_SPEED * 1.5f;
     player->bikeSpeed = PLAYER_SPEED * 2.0f;
-    player->speed = player->walkSpeed;
 
-    if (!Entity_AddSpriteSheet(&player->baseEntity, renderer, initialSpriteSheetPath, "WALK", spriteWidth, spriteHeight))
+    Mover *mover = ECS_Add(player->entity, COMPONENT_MOVER);
+    mover->speed = player->walkSpeed;
+
+    if (!Entity_AddSpriteSheet(player->entity, renderer, initialSpriteSheetPath, "WALK", spriteWidth, spriteHeight))
     {
+        Entity_Destroy(player->entity);
+        player->entity = ENTITY_NONE;
         return false;
     }
 
-    Entity_AddAnimation(&player->baseEntity, "idle_down", "WALK", 0, 0, 1, 200, false);
-    Entity_AddAnimation(&player->baseEntity, "idle_left", "WALK", 1, 0, 1, 200, false);
-    Entity_AddAnimation(&player->baseEntity, "idle_right", "WALK", 2, 0, 1, 200, false);
-    Entity_AddAnimation(&player->baseEntity, "idle_top", "WALK", 3, 0, 1, 150, false);
+    Entity_AddAnimation(player->entity, "idle_down", "WALK", 0, 0, 1, 200, false);
+    Entity_AddAnimation(player->entity, "idle_left", "WALK", 1, 0, 1, 200, false);
+    Entity_AddAnimation(player->entity, "idle_right", "WALK", 2, 0, 1, 200, false);
+    Entity_AddAnimation(player->entity, "idle_top", "WALK", 3, 0, 1, 150, false);
 
-    Entity_AddAnimation(&player->baseEntity, "walk_down", "WALK", 0, 0, 4, 200, true);
-    Entity_AddAnimation(&player->baseEntity, "walk_left", "WALK", 1, 0, 4, 200, true);
-    Entity_AddAnimation(&player->baseEntity, "walk_right", "WALK", 2, 0, 4, 200, true);
-    Entity_AddAnimation(&player->baseEntity, "walk_top", "WALK", 3, 0, 4, 150, true);
+    Entity_AddAnimation(player->entity, "walk_down", "WALK", 0, 0, 4, 200, true);
+    Entity_AddAnimation(player->entity, "walk_left", "WALK", 1, 0, 4, 200, true);
+    Entity_AddAnimation(player->entity, "walk_right", "WALK", 2, 0, 4, 200, true);
+    Entity_AddAnimation(player->entity, "walk_top", "WALK", 3, 0, 4, 150, true);
 
-    Entity_AddSpriteSheet(&player->baseEntity, renderer, "resources/sprites/player_bike.png", "BIKE", spriteWidth, spriteHeight);
-    Entity_AddAnimation(&player->baseEntity, "bike_idle_down", "BIKE", 0, 0, 1, 100, false);
-    Entity_AddAnimation(&player->baseEntity, "bike_idle_left", "BIKE", 1, 0, 1, 100, false);
-    Entity_AddAnimation(&player->baseEntity, "bike_idle_right", "BIKE", 2, 0, 1, 100, false);
-    Entity_AddAnimation(&player->baseEntity, "bike_idle_top", "BIKE", 3, 0, 1, 100, false);
+    Entity_AddSpriteSheet(player->entity, renderer, "resources/sprites/player_bike.png", "BIKE", spriteWidth, spriteHeight);
+    Entity_AddAnimation(player->entity, "bike_idle_down", "BIKE", 0, 0, 1, 100, false);
+    Entity_AddAnimation(player->entity, "bike_idle_left", "BIKE", 1, 0, 1, 100, false);
+    Entity_AddAnimation(player->entity, "bike_idle_right", "BIKE", 2, 0, 1, 100, false);
+    Entity_AddAnimation(player->entity, "bike_idle_top", "BIKE", 3, 0, 1, 100, false);
 
-    Entity_AddAnimation(&player->baseEntity, "bike_down", "BIKE", 0, 0, 4, 100, true);
-    Entity_AddAnimation(&player->baseEntity, "bike_left", "BIKE", 1, 0, 4, 100, true);
-    Entity_AddAnimation(&player->baseEntity, "bike_right", "BIKE", 2, 0, 4, 100, true);
-    Entity_AddAnimation(&player->baseEntity, "bike_top", "BIKE", 3, 0, 4, 100, true);
+    Entity_AddAnimation(player->entity, "bike_down", "BIKE", 0, 0, 4, 100, true);
+    Entity_AddAnimation(player->entity, "bike_left", "BIKE", 1, 0, 4, 100, true);
+    Entity_AddAnimation(player->entity, "bike_right", "BIKE", 2, 0, 4, 100, true);
+    Entity_AddAnimation(player->entity, "bike_top", "BIKE", 3, 0, 4, 100, true);
 
-    Entity_SetAnimation(&player->baseEntity, "idle_down");
-    player->baseEntity.currentAnimation = &player->baseEntity.animations[0];
+    Player_BuildAnimationTable(player);
+    Player_UpdateAnimation(player);
 
     return true;
 }
+// Traduit l'intention du joueur en consigne de déplacement pour
+// System_UpdateMovement (collisions comprises)
 void Player_Update(Player *player, float deltaTime)
 {
-    // Mise à jour de l'animation
-    Entity_UpdateAnimation(&player->baseEntity, deltaTime);
+    (void)deltaTime; // Le déplacement est avancé par System_UpdateMovement
 
-    // Recalculer la hitbox
-    Entity *entity = &player->baseEntity;
-    entity->hitbox.x = (int)(entity->x + entity->spriteWidth / 2 - LARGEUR_HITBOX / 2);
-    entity->hitbox.y = (int)(entity->y + entity->spriteHeight - HAUTEUR_HITBOX);
+    Mover *mover = ECS_GetMover(player->entity);
+    const Transform *transform = ECS_GetTransform(player->entity);
+
+    mover->dirX = mover->dirY = 0.0f;
+    if (player->targetDirection != DIRECTION_NONE)
+    {
+        // Mouvement libre continu
+        mover->hasTarget = false;
+        switch (player->targetDirection)
+        {
+        case DIRECTION_UP:
+            mover->dirY = -1.0f;
+            break;
+        case DIRECTION_DOWN:
+            mover->dirY = 1.0f;
+            break;
+        case DIRECTION_LEFT:
+            mover->dirX = -1.0f;
+            break;
+        case DIRECTION_RIGHT:
+            mover->dirX = 1.0f;
+            break;
+        default:
+            break;
+        }
+    }
+    else if (player->hasTarget && !mover->hasTarget)
+    {
+        // Alignement sur la grille : prochaine case dans le sens du mouvement
+        int n = 16;
+        mover->targetX = transform->x;
+        mover->targetY = transform->y;
+
+        switch (player->currentDirection)
+        {
+        case DIRECTION_LEFT:
+            mover->targetX = floorf(transform->x / n) * n;
+            break;
+        case DIRECTION_RIGHT:
+            mover->targetX = ceilf(transform->x / n) * n;
+            break;
+        case DIRECTION_UP:
+            mover->targetY = floorf(transform->y / n) * n;
+            break;
+        case DIRECTION_DOWN:
+            mover->targetY = ceilf(transform->y / n) * n;
+            break;
+        default:
+            break;
+        }
+        mover->hasTarget = true;
+    }
 }
 
-void Player_Draw(Player *player, SDL_Renderer *renderer)
+// Met à jour l'état et l'animation d'après le résultat du système de déplacement
+void Player_SyncMovement(Player *player)
 {
-    Entity_Draw(&player->baseEntity, renderer);
+    Mover *mover = ECS_GetMover(player->entity);
+
+    if (mover->arrived || (player->hasTarget && mover->blocked))
+    {
+        // Alignement terminé (ou impossible : on reste sur place)
+        player->hasTarget = false;
+        mover->hasTarget = false;
+        player->state = PLAYER_STATE_IDLE;
+    }
+    else if (mover->moved)
+    {
+        player->state = PLAYER_STATE_MOVING;
+    }
+    else
+    {
+        player->state = PLAYER_STATE_IDLE;
+    }
+
+    Player_UpdateAnimation(player);
 }
 
 void Player_Free(Player *player)
 {
-    Entity_Free(&player->baseEntity);
+    Entity_Destroy(player->entity);
+    player->entity = ENTITY_NONE;
 }
 
-void Player_HandleInput(Player *player)
+void Player_HandleInput(Player *player, const InputState *input)
 {
-    Direction inputDir = Player_GetInputDirection();
+    Direction inputDir = Player_GetInputDirection(input);
     bool hasMovementInput = (inputDir != DIRECTION_NONE);
 
-    const Uint8 *state = SDL_GetKeyboardState(NULL);
-    static bool spaceWasPressed = false;
-    bool spaceIsPressed = state[SDL_SCANCODE_SPACE];
-
-    if (spaceIsPressed && !spaceWasPressed)
+    if (input->pressed & INPUT_BIT(INPUT_ACTION_TOGGLE_BIKE))
     {
         if (player->currentMovementMode == MOVEMENT_WALK)
         {
@@ -125,23 +189,24 @@ void Player_HandleInput(Player *player)
     player->wasMovingLastFrame = hasMovementInput;
 }
 
-Direction Player_GetInputDirection(void)
+// Une direction tapée et relâchée pendant le tick compte comme maintenue
+Direction Player_GetInputDirection(const InputState *input)
 {
-    const Uint8 *state = SDL_GetKeyboardState(NULL);
+    Uint32 active = input->held | input->pressed;
 
-    if (state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_W])
+    if (active & INPUT_BIT(INPUT_ACTION_UP))
     {
         return DIRECTION_UP;
     }
-    if (state[SDL_SCANCODE_DOWN] || state[SDL_SCANCODE_S])
+    if (active & INPUT_BIT(INPUT_ACTION_DOWN))
     {
         return DIRECTION_DOWN;
     }
-    if (state[SDL_SCANCODE_LEFT] || state[SDL_SCANCODE_A])
+    if (active & INPUT_BIT(INPUT_ACTION_LEFT))
     {
         return DIRECTION_LEFT;
     }
-    if (state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_D])
+    if (active & INPUT_BIT(INPUT_ACTION_RIGHT))
     {
         return DIRECTION_RIGHT;
     }
@@ -149,235 +214,81 @@ Direction Player_GetInputDirection(void)
     return DIRECTION_NONE;
 }
 
-bool Player_TryMove(Player *player, Direction direction, float newX, float newY)
+static int Player_FacingIndex(Direction direction)
 {
-    if (player->state != PLAYER_STATE_IDLE)
+    switch (direction)
     {
-        return false;
+    case DIRECTION_UP:
+        return 0;
+    case DIRECTION_LEFT:
+        return 2;
+    case DIRECTION_RIGHT:
+        return 3;
+    default:
+        return 1; // Bas
     }
-
-    Player_StartMovement(player, direction, newX, newY);
-    return true;
 }
 
-static void Player_StartMovement(Player *player, Direction direction, float targetX, float targetY)
+// Résout une fois les noms d'animation en index, par mode, état et direction.
+// À rappeler si l'ensemble d'animations du joueur change.
+void Player_BuildAnimationTable(Player *player)
 {
-    player->state = PLAYER_STATE_MOVING;
-    player->currentDirection = direction;
-    player->targetX = targetX;
-    player->targetY = targetY;
-    Player_UpdateAnimation(player);
-}
-
-static void Player_UpdateMovement(Player *player, float deltaTime)
-{
-    if (player->hasTarget)
-    {
-        // Mouvement vers la target avec racine carrée
-        float dx = player->targetX - player->baseEntity.x;
-        float dy = player->targetY - player->baseEntity.y;
-        float distance = sqrt(dx * dx + dy * dy);
+    static const char *const directionSuffix[FACING_COUNT] = {"top", "down", "left", "right"};
+    static const char *const movingPrefix[MOVEMENT_MODE_COUNT] = {"walk", "run", "bike"};
+    static const char *const idlePrefix[MOVEMENT_MODE_COUNT] = {"idle", "run_idle", "bike_idle"};
 
-        if (distance > 1.0f)
-        {
-            float moveDistance = player->speed * deltaTime;
-            if (moveDistance > distance)
-                moveDistance = distance;
-
-            float newX = player->baseEntity.x + (dx / distance) * moveDistance;
-            float newY = player->baseEntity.y + (dy / distance) * moveDistance;
+    const AnimationSet *set = ECS_GetSprite(player->entity)->set;
+    char animationName[64];
 
-            player->baseEntity.x = newX;
-            player->baseEntity.y = newY;
-        }
-        else
-        {
-            // Arrivé à la target
-            player->baseEntity.x = player->targetX;
-            player->baseEntity.y = player->targetY;
-            player->hasTarget = false;
-            player->state = PLAYER_STATE_IDLE;
-            Player_UpdateAnimation(player);
-        }
-    }
-    else if (player->targetDirection != DIRECTION_NONE)
+    for (int mode = 0; mode < MOVEMENT_MODE_COUNT; mode++)
     {
-        // Mouvement libre continu
-        float moveDistance = player->speed * deltaTime;
-        float newX = player->baseEntity.x;
-        float newY = player->baseEntity.y;
-
-        switch (player->targetDirection)
+        for (int state = 0; state < PLAYER_STATE_COUNT; state++)
         {
-        case DIRECTION_UP:
-            newY -= moveDistance;
-            break;
-        case DIRECTION_DOWN:
-            newY += moveDistance;
-            break;
-        case DIRECTION_LEFT:
-            newX -= moveDistance;
-            break;
-        case DIRECTION_RIGHT:
-            newX += moveDistance;
-            break;
-        default:
-            break;
-        }
+            // Seul PLAYER_STATE_MOVING joue l'animation de déplacement
+            const char *prefix = state == PLAYER_STATE_MOVING ? movingPrefix[mode] : idlePrefix[mode];
 
-        player->baseEntity.x = newX;
-        player->baseEntity.y = newY;
-    }
-}
+            for (int facing = 0; facing < FACING_COUNT; facing++)
+            {
+                snprintf(animationName, sizeof(animationName), "%s_%s", prefix, directionSuffix[facing]);
+                int index = AnimSet_FindAnimation(set, animationName);
 
-static void Player_FinishMovement(Player *player, float deltaTime)
-{
-    float moveDistance = player->speed * deltaTime;
-
-    // Seulement aligner dans la direction du mouvement, pas perpendiculaire
-    float alignedX = player->baseEntity.x;
-    float alignedY = player->baseEntity.y;
+                // Mode sans animation dédiée (ex : course) : on reprend celle de la marche
+                if (index == -1 && mode != MOVEMENT_WALK)
+                    index = player->animationTable[MOVEMENT_WALK][state][facing];
 
-    // Aligner dans la direction du mouvement
-    if (player->currentDirection == DIRECTION_UP || player->currentDirection == DIRECTION_DOWN)
-    {
-        // Mouvement vertical, aligner Y
-        alignedY = Player_AlignToGrid(player->baseEntity.y, 16);
-    }
-    else if (player->currentDirection == DIRECTION_LEFT || player->currentDirection == DIRECTION_RIGHT)
-    {
-        // Mouvement horizontal, aligner X
-        alignedX = Player_AlignToGrid(player->baseEntity.x, 16);
-    }
-
-    float dx = alignedX - player->baseEntity.x;
-    float dy = alignedY - player->baseEntity.y;
-
-    if (fabs(dx) <= moveDistance && fabs(dy) <= moveDistance)
-    {
-        // Alignement terminé
-        player->baseEntity.x = alignedX;
-        player->baseEntity.y = alignedY;
-        player->state = PLAYER_STATE_IDLE;
-        player->lastDirection = player->currentDirection;
-        player->currentDirection = DIRECTION_NONE;
-        Player_UpdateAnimation(player);
-    }
-    else
-    {
-        // Continuer l'alignement
-        if (dx != 0)
-        {
-            player->baseEntity.x += (dx > 0) ? moveDistance : -moveDistance;
-        }
-        if (dy != 0)
-        {
-            player->baseEntity.y += (dy > 0) ? moveDistance : -moveDistance;
+                player->animationTable[mode][state][facing] = index;
+            }
         }
     }
 }
 
-static float Player_AlignToGrid(float position, int gridSize)
-{
-    return roundf(position / gridSize) * gridSize;
-}
-
 void Player_UpdateAnimation(Player *player)
 {
-    // Si on n'a pas de direction courante, garder la dernière direction connue
-    Direction directionToUse = player->currentDirection;
-    if (directionToUse == DIRECTION_NONE)
-    {
-        if (player->baseEntity.currentAnimation)
-        {
-            if (strstr(player->baseEntity.currentAnimation->name, "top"))
-                directionToUse = DIRECTION_UP;
-            else if (strstr(player->baseEntity.currentAnimation->name, "left"))
-                directionToUse = DIRECTION_LEFT;
-            else if (strstr(player->baseEntity.currentAnimation->name, "right"))
-                directionToUse = DIRECTION_RIGHT;
-            else
-                directionToUse = DIRECTION_DOWN;
-        }
-        else
-        {
-            directionToUse = DIRECTION_DOWN;
-        }
-    }
+    // Sans direction courante, on garde l'orientation mémorisée
+    if (player->currentDirection != DIRECTION_NONE)
+        player->facing = player->currentDirection;
 
-    const char *modePrefix;
-    switch (player->currentMovementMode)
-    {
-    case MOVEMENT_RUN:
-        modePrefix = "run";
-        break;
-    case MOVEMENT_BIKE:
-        modePrefix = "bike";
-        break;
-    default:
-        modePrefix = "walk";
-        break;
-    }
-
-    char animationName[64];
-    const char *directionSuffix;
-
-    switch (directionToUse)
-    {
-    case DIRECTION_UP:
-        directionSuffix = "top";
-        break;
-    case DIRECTION_DOWN:
-        directionSuffix = "down";
-        break;
-    case DIRECTION_LEFT:
-        directionSuffix = "left";
-        break;
-    case DIRECTION_RIGHT:
-        directionSuffix = "right";
-        break;
-    default:
-        directionSuffix = "down";
-        break;
-    }
-
-    if (player->state == PLAYER_STATE_MOVING)
-    {
-        snprintf(animationName, sizeof(animationName), "%s_%s", modePrefix, directionSuffix);
-    }
-    else
-    {
-        if (player->currentMovementMode == MOVEMENT_BIKE)
-        {
-            snprintf(animationName, sizeof(animationName), "bike_idle_%s", directionSuffix);
-        }
-        else if (player->currentMovementMode == MOVEMENT_RUN)
-        {
-            snprintf(animationName, sizeof(animationName), "run_idle_%s", directionSuffix);
-        }
-        else
-        {
-            snprintf(animationName, sizeof(animationName), "idle_%s", directionSuffix);
-        }
-    }
-
-    Entity_SetAnimation(&player->baseEntity, animationName);
+    int index = player->animationTable[player->currentMovementMode][player->state][Player_FacingIndex(player->facing)];
+    Entity_SetAnimationIndex(player->entity, index);
 }
 
 void Player_SetMovementMode(Player *player, MovementMode mode)
 {
     player->currentMovementMode = mode;
+    Mover *mover = ECS_GetMover(player->entity);
 
     switch (mode)
     {
     case MOVEMENT_WALK:
-        player->speed = player->walkSpeed;
+        mover->speed = player->walkSpeed;
         break;
     case MOVEMENT_RUN:
-        player->speed = player->runSpeed;
+        mover->speed = player->runSpeed;
         break;
     case MOVEMENT_BIKE:
-        player->speed = player->bikeSpeed;
+        mover->speed = player->bikeSpeed;
+        break;
+    default:
         break;
     }
 
@@ -3,20 +3,23 @@
 
 #include "entity.h"
 #include "constante.h"
+#include "input.h"
 #include <math.h>
 
 typedef enum
 {
     MOVEMENT_WALK,
     MOVEMENT_RUN,
-    MOVEMENT_BIKE
+    MOVEMENT_BIKE,
+    MOVEMENT_MODE_COUNT
 } MovementMode;
 
 typedef enum
 {
     PLAYER_STATE_IDLE,
     PLAYER_STATE_MOVING,
-    PLAYER_STATE_FINISHING_MOVE
+    PLAYER_STATE_FINISHING_MOVE,
+    PLAYER_STATE_COUNT
 } PlayerState;
 
 typedef enum
@@ -28,15 +31,17 @@ typedef enum
     DIRECTION_RIGHT = 8
 } Direction;
 
+// Index compact d'une direction réelle (haut, bas, gauche, droite) pour les tables
+#define FACING_COUNT 4
+
 typedef struct
 {
-    Entity baseEntity;
-    int speed;
+    EntityId entity; // Transform, Sprite, Hitbox, Collider et Mover (vitesse courante)
     PlayerState state;
     Direction currentDirection;
     Direction targetDirection;
     Direction lastDirection;
-    float targetX, targetY;
+    Direction facing; // Orientation affichée, jamais DIRECTION_NONE
     bool hasTarget;
     bool wasMovingLastFrame;
 
@@ -45,20 +50,24 @@ typedef struct
     int runSpeed;
     int bikeSpeed;
 
+    // Index d'animation résolus une fois à l'initialisation (-1 si absente)
+    int animationTable[MOVEMENT_MODE_COUNT][PLAYER_STATE_COUNT][FACING_COUNT];
 } Player;
 
 bool Player_Init(Player *player, SDL_Renderer *renderer, const char *spriteSheetPath,
                  int spriteWidth, int spriteHeight, float x, float y,
                  int hitboxWidth, int hitboxHeight);
 
+// Avant System_UpdateMovement : consigne de déplacement du Mover
 void Player_Update(Player *player, float deltaTime);
-void Player_Draw(Player *player, SDL_Renderer *renderer);
+// Après System_UpdateMovement : état et animation
+void Player_SyncMovement(Player *player);
 void Player_Free(Player *player);
 
-void Player_HandleInput(Player *player);
-bool Player_TryMove(Player *player, Direction direction, float newX, float newY);
-Direction Player_GetInputDirection(void);
+void Player_HandleInput(Player *player, const InputState *input);
+Direction Player_GetInputDirection(const InputState *input);
 void Player_UpdateAnimation(Player *player);
+void Player_BuildAnimationTable(Player *player);
 void Player_SetMovementMode(Player *player, MovementMode mode);
 
 #endif // PLAYER_H
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "savestate.h"
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framework/memtrack.h"
+
+// Disposition : SaveHeader, SavePlayer, npc_count x SaveNPC, tile_count x SaveTile.
+// Les composants (Mover, AI) sont copiés tels quels : SAVE_STATE_VERSION
+// change avec eux.
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 tick;     // Tick de simulation de la capture (information)
+    Uint32 state;    // GameState au sommet de la pile (information)
+    char map_name[64];
+    Uint32 npc_count;
+    Uint32 tile_count;
+} SaveHeader;
+
+// Lecture d'animation, sans les pointeurs (ensemble, propriétaire)
+typedef struct
+{
+    Sint32 animationIndex;
+    Sint32 frameIndex;
+    float timeMs;
+    float rate, targetRate;
+    Uint8 paused, finished;
+    Sint32 state;
+    float params[ANIM_PARAM_COUNT];
+} SaveAnim;
+
+typedef struct
+{
+    float x, y;
+    Mover mover;
+    Uint32 state;
+    Uint32 currentDirection, targetDirection, lastDirection, facing;
+    Uint32 movementMode;
+    Uint8 hasTarget, wasMovingLastFrame;
+    SaveAnim anim;
+} SavePlayer;
+
+typedef struct
+{
+    float x, y;
+    Mover mover;
+    AI ai;
+    Uint8 solid, active;
+    SaveAnim anim;
+} SaveNPC;
+
+typedef struct
+{
+    Sint32 current_frame;
+    Uint32 last_update;
+} SaveTile;
+
+static void SaveState_CaptureAnim(EntityId id, SaveAnim *out)
+{
+    memset(out, 0, sizeof(SaveAnim));
+    out->animationIndex = -1;
+
+    const Animator *animator = ECS_GetAnimator(id);
+    const AnimPlayback *playback = animator ? AnimSystem_Get(animator->anim) : NULL;
+    if (!playback)
+        return;
+
+    out->animationIndex = playback->animationIndex;
+    out->frameIndex = playback->frameIndex;
+    out->timeMs = playback->timeMs;
+    out->rate = playback->rate;
+    out->targetRate = playback->targetRate;
+    out->paused = playback->paused;
+    out->finished = playback->finished;
+    out->state = playback->state;
+    memcpy(out->params, playback->params, sizeof(out->params));
+}
+
+// Les index sont vérifiés contre l'ensemble actuel : il a pu être rechargé
+// à chaud depuis la capture
+static void SaveState_RestoreAnim(EntityId id, const SaveAnim *in)
+{
+    const Animator *animator = ECS_GetAnimator(id);
+    AnimPlayback *playback = animator ? AnimSystem_Get(animator->anim) : NULL;
+    if (!playback || !playback->set || in->animationIndex < 0 || in->animationIndex >= playback->set->animationCount)
+        return;
+
+    const Animation *animation = &playback->set->animations[in->animationIndex];
+    const AnimStateMachine *machine = playback->set->machine;
+
+    playback->animationIndex = in->animationIndex;
+    playback->frameIndex = in->frameIndex >= 0 && in->frameIndex < animation->frameCount ? in->frameIndex : 0;
+    playback->timeMs = in->timeMs;
+    playback->rate = in->rate;
+    playback->targetRate = in->targetRate;
+    playback->paused = in->paused;
+    playback->finished = in->finished;
+    playback->state = machine && in->state < machine->stateCount ? in->state : -1;
+    memcpy(playback->params, in->params, sizeof(playback->params));
+}
+
+static void SaveState_Reserve(SaveSnapshot *snapshot, size_t size)
+{
+    if (snapshot->capacity >= size)
+        return;
+
+    Uint8 *data = Mem_Realloc(MEM_TAG_SAVE, snapshot->data, size);
+    if (!data)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour l'instantané.\n");
+        exit(EXIT_FAILURE);
+    }
+    snapshot->data = data;
+    snapshot->capacity = size;
+}
+
+bool SaveState_Capture(const Game *game, SaveSnapshot *snapshot)
+{
+    const Map *map = game->current_map;
+    if (!map || !game->player)
+        return false;
+
+    size_t size = sizeof(SaveHeader) + sizeof(SavePlayer) +
+                  map->npc_count * sizeof(SaveNPC) + map->animated_tile_count * sizeof(SaveTile);
+    SaveState_Reserve(snapshot, size);
+    memset(snapshot->data, 0, size); // Octets de remplissage déterministes dans le fichier
+
+    SaveHeader *header = (SaveHeader *)snapshot->data;
+    memcpy(header->magic, SAVE_STATE_MAGIC, 4);
+    header->version = SAVE_STATE_VERSION;
+    header->tick = game->input.tick;
+    header->state = Game_GetState(game);
+    snprintf(header->map_name, sizeof(header->map_name), "%s", game->map_name);
+    header->npc_count = map->npc_count;
+    header->tile_count = map->animated_tile_count;
+
+    const Player *player = game->player;
+    SavePlayer *savedPlayer = (SavePlayer *)(header + 1);
+    const Transform *transform = ECS_GetTransform(player->entity);
+    savedPlayer->x = transform->x;
+    savedPlayer->y = transform->y;
+    savedPlayer->mover = *ECS_GetMover(player->entity);
+    savedPlayer->state = player->state;
+    savedPlayer->currentDirection = player->currentDirection;
+    savedPlayer->targetDirection = player->targetDirection;
+    savedPlayer->lastDirection = player->lastDirection;
+    savedPlayer->facing = player->facing;
+    savedPlayer->movementMode = player->currentMovementMode;
+    savedPlayer->hasTarget = player->hasTarget;
+    savedPlayer->wasMovingLastFrame = player->wasMovingLastFrame;
+    SaveState_CaptureAnim(player->entity, &savedPlayer->anim);
+
+    SaveNPC *savedNPC = (SaveNPC *)(savedPlayer + 1);
+    for (int i = 0; i < map->npc_count; i++, savedNPC++)
+    {
+        EntityId id = map->npc[i];
+        const Transform *npcTransform = ECS_GetTransform(id);
+        const Mover *mover = ECS_GetMover(id);
+        const AI *ai = ECS_GetAI(id);
+        const Collider *collider = ECS_GetCollider(id);
+
+        if (npcTransform)
+        {
+            savedNPC->x = npcTransform->x;
+            savedNPC->y = npcTransform->y;
+        }
+        if (mover)
+            savedNPC->mover = *mover;
+        if (ai)
+            savedNPC->ai = *ai;
+        savedNPC->solid = collider && collider->solid;
+        savedNPC->active = ECS_IsActive(id);
+        SaveState_CaptureAnim(id, &savedNPC->anim);
+    }
+
+    SaveTile *savedTile = (SaveTile *)savedNPC;
+    for (int i = 0; i < map->animated_tile_count; i++, savedTile++)
+    {
+        savedTile->current_frame = map->animated_tiles[i].current_frame;
+        savedTile->last_update = map->animated_tiles[i].last_update;
+    }
+
+    snapshot->size = size;
+    return true;
+}
+
+bool SaveState_Restore(Game *game, const Uint8 *data, size_t size)
+{
+    const SaveHeader *header = (const SaveHeader *)data;
+    if (size < sizeof(SaveHeader) + sizeof(SavePlayer) || memcmp(header->magic, SAVE_STATE_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "Instantané invalide\n");
+        return false;
+    }
+    if (header->version != SAVE_STATE_VERSION)
+    {
+        fprintf(stderr, "Instantané incompatible (version %u, attendue %u)\n", header->version, SAVE_STATE_VERSION);
+        return false;
+    }
+    if (size != sizeof(SaveHeader) + sizeof(SavePlayer) +
+                    header->npc_count * sizeof(SaveNPC) + header->tile_count * sizeof(SaveTile))
+    {
+        fprintf(stderr, "Instantané tronqué\n");
+        return false;
+    }
+
+    // Toujours terminé à l'écriture : sans '\0', l'en-tête est corrompu
+    if (!memchr(header->map_name, '\0', sizeof(header->map_name)))
+    {
+        fprintf(stderr, "Instantané corrompu (nom de map)\n");
+        return false;
+    }
+    char mapName[64];
+    snprintf(mapName, sizeof(mapName), "%.*s", (int)sizeof(header->map_name), header->map_name);
+    if (strcmp(mapName, game->map_name) != 0 && !Game_InitMap(game, mapName))
+        return false;
+
+    // Un changement de map en cours ou demandé est annulé
+    game->pending_map[0] = '\0';
+    game->warp_map[0] = '\0';
+    // Ni rencontre ni entrée de zone sur la position de reprise
+    Encounters_Reset(&game->encounters);
+    System_ResetTriggers();
+    game->accumulator = 0.0f;
+    // Menus, combats et cinématiques ouverts sont fermés : l'instantané ne
+    // décrit que le monde
+    Cinematic_Stop(&game->cinematic);
+    while (Game_PopState(game))
+        ;
+
+    Player *player = game->player;
+    const SavePlayer *savedPlayer = (const SavePlayer *)(header + 1);
+    Transform *transform = ECS_GetTransform(player->entity);
+    transform->x = savedPlayer->x;
+    transform->y = savedPlayer->y;
+    *ECS_GetMover(player->entity) = savedPlayer->mover;
+    player->state = (PlayerState)savedPlayer->state;
+    player->currentDirection = (Direction)savedPlayer->currentDirection;
+    player->targetDirection = (Direction)savedPlayer->targetDirection;
+    player->lastDirection = (Direction)savedPlayer->lastDirection;
+    player->facing = (Direction)savedPlayer->facing;
+    player->currentMovementMode = savedPlayer->movementMode < MOVEMENT_MODE_COUNT ? (MovementMode)savedPlayer->movementMode : MOVEMENT_WALK;
+    player->hasTarget = savedPlayer->hasTarget;
+    player->wasMovingLastFrame = savedPlayer->wasMovingLastFrame;
+    SaveState_RestoreAnim(player->entity, &savedPlayer->anim);
+
+    Map *map = game->current_map;
+    const SaveNPC *savedNPC = (const SaveNPC *)(savedPlayer + 1);
+    if ((int)header->npc_count == map->npc_count)
+    {
+        for (int i = 0; i < map->npc_count; i++)
+        {
+            EntityId id = map->npc[i];
+            Transform *npcTransform = ECS_GetTransform(id);
+            Mover *mover = ECS_GetMover(id);
+            AI *ai = ECS_GetAI(id);
+            Collider *collider = ECS_GetCollider(id);
+
+            if (npcTransform)
+            {
+                npcTransform->x = savedNPC[i].x;
+                npcTransform->y = savedNPC[i].y;
+            }
+            if (mover)
+                *mover = savedNPC[i].mover;
+            if (ai)
+                *ai = savedNPC[i].ai;
+            if (collider)
+                collider->solid = savedNPC[i].solid;
+            ECS_SetActive(id, savedNPC[i].active);
+            SaveState_RestoreAnim(id, &savedNPC[i].anim);
+        }
+    }
+    else
+    {
+        // Map modifiée depuis la capture : les PNJ gardent leur état actuel
+        fprintf(stderr, "Instantané : %u PNJ enregistrés, %d sur la map, PNJ ignorés\n", header->npc_count, map->npc_count);
+    }
+
+    const SaveTile *savedTile = (const SaveTile *)(savedNPC + header->npc_count);
+    if ((int)header->tile_count == map->animated_tile_count)
+    {
+        for (int i = 0; i < map->animated_tile_count; i++)
+        {
+            AnimatedTile *tile = &map->animated_tiles[i];
+            tile->current_frame = savedTile[i].current_frame >= 0 && savedTile[i].current_frame < tile->frame_count ? savedTile[i].current_frame : 0;
+            tile->last_update = savedTile[i].last_update;
+        }
+    }
+
+    // Rectangles de collision à jour avant le prochain tick
+    System_UpdateHitboxes();
+    return true;
+}
+
+void SaveState_Free(SaveSnapshot *snapshot)
+{
+    Mem_Free(snapshot->data);
+    memset(snapshot, 0, sizeof(SaveSnapshot));
+}
@@ -0,0 +1,33 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Instantanés de l'état du monde : map courante, joueur, PNJ de la map et
+// horloge des tiles animées. Enregistrements binaires bruts copiés dans un
+// tampon réutilisé : la capture ne coûte que quelques microsecondes et peut
+// être faite sur le thread principal entre deux ticks. Le même tampon sert de
+// point de restauration rapide en mémoire et de contenu du fichier
+// (compression et écriture : SaveWriter).
+
+#define SAVE_STATE_MAGIC "PKSV"
+#define SAVE_STATE_VERSION 2 // À incrémenter à chaque changement d'un enregistrement ou d'un composant
+
+struct Game;
+
+typedef struct
+{
+    Uint8 *data;
+    size_t size;
+    size_t capacity; // Conservée d'une capture à l'autre
+} SaveSnapshot;
+
+// À appeler entre deux ticks (sous world_lock si la simulation a son thread)
+bool SaveState_Capture(const struct Game *game, SaveSnapshot *snapshot);
+// Thread principal, sous world_lock : peut charger la map de l'instantané
+bool SaveState_Restore(struct Game *game, const Uint8 *data, size_t size);
+void SaveState_Free(SaveSnapshot *snapshot);
+
+#endif // SAVESTATE_H
@@ -0,0 +1,383 @@
+#include "systems.h"
+#include "entity.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framework/memtrack.h"
+
+// Tampon de tri du rendu, gardé d'une frame à l'autre
+typedef struct
+{
+    float depth;
+    EntityId entity;
+    int dx, dy; // Décalage de la map voisine, 0 pour la map courante
+} RenderItem;
+
+static RenderItem *renderItems = NULL;
+static int renderCapacity = 0;
+
+// Événements de zones du dernier System_UpdateTriggers
+static TriggerEvent *triggerEvents = NULL;
+static int triggerEventCount = 0;
+static int triggerEventCapacity = 0;
+static const Map *triggerOverflowMap = NULL; // Dépassement déjà signalé pour cette map
+
+// --- IA ---
+
+void System_UpdateAI(float deltaTime)
+{
+    AI *ais = ECS_Components(COMPONENT_AI);
+    const EntityId *entities = ECS_Entities(COMPONENT_AI);
+
+    for (int i = 0; i < ECS_Count(COMPONENT_AI); i++)
+    {
+        AI *ai = &ais[i];
+        if (ai->behaviour != AI_WANDER || !ECS_IsActive(entities[i]))
+            continue;
+
+        Mover *mover = ECS_GetMover(entities[i]);
+        if (!mover)
+            continue;
+
+        ai->actionTimer += deltaTime;
+        if (ai->actionTimer < ai->actionDuration)
+            continue;
+
+        // Une fois sur deux une pause, sinon quelques pas dans une direction
+        static const float directions[4][2] = {{0.0f, 1.0f}, {-1.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, -1.0f}};
+        int action = rand() % 8;
+        mover->dirX = action < 4 ? directions[action][0] : 0.0f;
+        mover->dirY = action < 4 ? directions[action][1] : 0.0f;
+        mover->hasTarget = false;
+        ai->actionTimer = 0.0f;
+        ai->actionDuration = 0.5f + (float)(rand() % 150) / 100.0f;
+    }
+}
+
+// --- Déplacement ---
+
+static bool System_CanMoveTo(Map *map, EntityId entity, bool collides, float x, float y)
+{
+    if (!collides)
+        return true;
+
+    SDL_Rect rect = Entity_HitboxAt(entity, x, y);
+    return !System_IsBlocked(map, &rect, entity);
+}
+
+// Orientation (convention de ANIM_PARAM_FACING) d'une direction non nulle
+static int System_FacingOf(float dirX, float dirY)
+{
+    if (dirY < 0.0f)
+        return 3;
+    if (dirY > 0.0f)
+        return 0;
+    return dirX < 0.0f ? 1 : 2;
+}
+
+static void System_MoveEntity(Map *map, EntityId entity, Mover *mover, Transform *transform, float deltaTime)
+{
+    bool collides = ECS_GetCollider(entity) && ECS_GetHitbox(entity);
+    float moveDistance = mover->speed * deltaTime;
+
+    if (mover->dirX != 0.0f || mover->dirY != 0.0f)
+    {
+        // Mouvement libre continu
+        mover->facing = System_FacingOf(mover->dirX, mover->dirY);
+        float newX = transform->x + mover->dirX * moveDistance;
+        float newY = transform->y + mover->dirY * moveDistance;
+
+        if (System_CanMoveTo(map, entity, collides, newX, newY))
+        {
+            transform->x = newX;
+            transform->y = newY;
+            mover->moved = true;
+            return;
+        }
+
+        // Se coller à la collision, pixel par pixel (sans dépasser le pas de la frame)
+        int steps = (int)ceilf(moveDistance);
+        for (int i = 0; i < steps && System_CanMoveTo(map, entity, collides, transform->x + mover->dirX, transform->y + mover->dirY); i++)
+        {
+            transform->x += mover->dirX;
+            transform->y += mover->dirY;
+        }
+        mover->blocked = true;
+    }
+    else if (mover->hasTarget)
+    {
+        float dx = mover->targetX - transform->x;
+        float dy = mover->targetY - transform->y;
+        float distance = sqrtf(dx * dx + dy * dy);
+
+        if (distance > 1.0f)
+        {
+            if (moveDistance > distance)
+                moveDistance = distance;
+
+            float newX = transform->x + (dx / distance) * moveDistance;
+            float newY = transform->y + (dy / distance) * moveDistance;
+            if (System_CanMoveTo(map, entity, collides, newX, newY))
+            {
+                transform->x = newX;
+                transform->y = newY;
+                mover->moved = true;
+            }
+            else
+            {
+                mover->blocked = true;
+            }
+        }
+        else
+        {
+            // Cible atteinte
+            transform->x = mover->targetX;
+            transform->y = mover->targetY;
+            mover->hasTarget = false;
+            mover->arrived = true;
+        }
+    }
+}
+
+void System_UpdateMovement(Map *map, float deltaTime)
+{
+    Mover *movers = ECS_Components(COMPONENT_MOVER);
+    const EntityId *entities = ECS_Entities(COMPONENT_MOVER);
+
+    for (int i = 0; i < ECS_Count(COMPONENT_MOVER); i++)
+    {
+        Mover *mover = &movers[i];
+        EntityId entity = entities[i];
+        mover->moved = mover->blocked = mover->arrived = false;
+
+        Transform *transform = ECS_GetTransform(entity);
+        if (!transform || !ECS_IsActive(entity))
+            continue;
+
+        System_MoveEntity(map, entity, mover, transform, deltaTime);
+
+        // Les machines à états d'animation lisent le résultat du déplacement
+        Animator *animator = ECS_GetAnimator(entity);
+        if (animator)
+        {
+            AnimSystem_SetParam(animator->anim, ANIM_PARAM_MOVING, mover->moved ? 1.0f : 0.0f);
+            AnimSystem_SetParam(animator->anim, ANIM_PARAM_FACING, (float)mover->facing);
+            AnimSystem_SetParam(animator->anim, ANIM_PARAM_SPEED, mover->speed);
+        }
+    }
+}
+
+bool System_IsBlocked(Map *map, const SDL_Rect *rect, EntityId ignore)
+{
+    if (Map_CheckCollision(map, (SDL_Rect *)rect))
+        return true;
+
+    const Collider *colliders = ECS_Components(COMPONENT_COLLIDER);
+    const EntityId *entities = ECS_Entities(COMPONENT_COLLIDER);
+    for (int i = 0; i < ECS_Count(COMPONENT_COLLIDER); i++)
+    {
+        if (!colliders[i].solid || entities[i] == ignore || !ECS_IsActive(entities[i]))
+            continue;
+
+        const Hitbox *hitbox = ECS_GetHitbox(entities[i]);
+        if (hitbox && SDL_HasIntersection(rect, &hitbox->rect))
+            return true;
+    }
+
+    // Les PNJ des maps voisines sont en pause mais restent des obstacles
+    for (int n = 0; map && n < map->neighbour_count; n++)
+    {
+        const MapNeighbour *neighbour = &map->neighbours[n];
+        for (int i = 0; i < neighbour->map->npc_count; i++)
+        {
+            EntityId npc = neighbour->map->npc[i];
+            const Collider *collider = ECS_GetCollider(npc);
+            const Transform *transform = ECS_GetTransform(npc);
+            if (!collider || !collider->solid || !transform)
+                continue;
+
+            SDL_Rect hitbox = Entity_HitboxAt(npc, transform->x + neighbour->dx, transform->y + neighbour->dy);
+            if (SDL_HasIntersection(rect, &hitbox))
+                return true;
+        }
+    }
+    return false;
+}
+
+// --- Hitbox ---
+
+void System_UpdateHitboxes(void)
+{
+    Hitbox *hitboxes = ECS_Components(COMPONENT_HITBOX);
+    const EntityId *entities = ECS_Entities(COMPONENT_HITBOX);
+
+    for (int i = 0; i < ECS_Count(COMPONENT_HITBOX); i++)
+    {
+        const Transform *transform = ECS_GetTransform(entities[i]);
+        if (transform && ECS_IsActive(entities[i]))
+            hitboxes[i].rect = Entity_HitboxAt(entities[i], transform->x, transform->y);
+    }
+}
+
+// --- Zones de déclenchement ---
+
+static void System_PushTriggerEvent(EntityId entity, int trigger, TriggerEventType type)
+{
+    if (triggerEventCount == triggerEventCapacity)
+    {
+        int capacity = triggerEventCapacity ? triggerEventCapacity * 2 : 16;
+        TriggerEvent *events = Mem_Realloc(MEM_TAG_ENTITY, triggerEvents, capacity * sizeof(TriggerEvent));
+        if (!events)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour les événements de zones.\n");
+            exit(EXIT_FAILURE);
+        }
+        triggerEvents = events;
+        triggerEventCapacity = capacity;
+    }
+    triggerEvents[triggerEventCount++] = (TriggerEvent){entity, trigger, type};
+}
+
+// Les deux ensembles sont triés : une fusion donne les entrées, les présences
+// et les sorties sans parcourir toutes les zones de la map
+void System_UpdateTriggers(Map *map)
+{
+    triggerEventCount = 0;
+
+    TriggerContact *contacts = ECS_Components(COMPONENT_TRIGGER_CONTACT);
+    const EntityId *entities = ECS_Entities(COMPONENT_TRIGGER_CONTACT);
+    for (int i = 0; i < ECS_Count(COMPONENT_TRIGGER_CONTACT); i++)
+    {
+        TriggerContact *contact = &contacts[i];
+        const Hitbox *hitbox = ECS_GetHitbox(entities[i]);
+        if (!hitbox || !ECS_IsActive(entities[i]))
+            continue;
+
+        Uint16 zones[TRIGGER_MAX_CONTACTS];
+        bool truncated;
+        int count = Map_QueryTriggers(map, &hitbox->rect, zones, TRIGGER_MAX_CONTACTS, &truncated);
+        if (truncated && triggerOverflowMap != map)
+        {
+            // Les zones d'indice le plus grand sont ignorées : à corriger dans la map
+            fprintf(stderr, "%s : plus de %d zones superposées en (%d, %d), les dernières sont ignorées\n",
+                    map->filename, TRIGGER_MAX_CONTACTS, hitbox->rect.x, hitbox->rect.y);
+            triggerOverflowMap = map;
+        }
+
+        int a = 0, b = 0;
+        while (contact->primed && (a < contact->count || b < count))
+        {
+            if (b == count || (a < contact->count && contact->zones[a] < zones[b]))
+                System_PushTriggerEvent(entities[i], contact->zones[a++], TRIGGER_EXIT);
+            else if (a == contact->count || zones[b] < contact->zones[a])
+                System_PushTriggerEvent(entities[i], zones[b++], TRIGGER_ENTER);
+            else
+            {
+                System_PushTriggerEvent(entities[i], zones[b++], TRIGGER_STAY);
+                a++;
+            }
+        }
+
+        memcpy(contact->zones, zones, count * sizeof(Uint16));
+        contact->count = count;
+        contact->primed = true;
+    }
+}
+
+int System_GetTriggerEvents(const TriggerEvent **events)
+{
+    *events = triggerEvents;
+    return triggerEventCount;
+}
+
+void System_ResetTriggers(void)
+{
+    TriggerContact *contacts = ECS_Components(COMPONENT_TRIGGER_CONTACT);
+    for (int i = 0; i < ECS_Count(COMPONENT_TRIGGER_CONTACT); i++)
+    {
+        contacts[i].count = 0;
+        contacts[i].primed = false;
+    }
+    triggerEventCount = 0;
+}
+
+// --- Rendu ---
+
+static int System_CompareDepth(const void *a, const void *b)
+{
+    float da = ((const RenderItem *)a)->depth, db = ((const RenderItem *)b)->depth;
+    return (da > db) - (da < db);
+}
+
+static void System_GrowRenderItems(int count)
+{
+    if (count <= renderCapacity)
+        return;
+
+    RenderItem *items = Mem_Realloc(MEM_TAG_ENTITY, renderItems, count * sizeof(RenderItem));
+    if (!items)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire pour le rendu des entités.\n");
+        exit(EXIT_FAILURE);
+    }
+    renderItems = items;
+    renderCapacity = count;
+}
+
+void System_Render(RenderList *list, const Map *map)
+{
+    int count = ECS_Count(COMPONENT_SPRITE);
+    System_GrowRenderItems(count);
+
+    // Les entités dont les pieds sont plus bas passent devant
+    const Sprite *sprites = ECS_Components(COMPONENT_SPRITE);
+    const EntityId *entities = ECS_Entities(COMPONENT_SPRITE);
+    int visible = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const Transform *transform = ECS_GetTransform(entities[i]);
+        if (!transform || !ECS_IsActive(entities[i]))
+            continue;
+
+        renderItems[visible++] = (RenderItem){transform->y + sprites[i].height, entities[i], 0, 0};
+    }
+
+    // PNJ en pause des voisines, à leur place dans le repère de la map courante
+    for (int n = 0; map && n < map->neighbour_count; n++)
+    {
+        const MapNeighbour *neighbour = &map->neighbours[n];
+        System_GrowRenderItems(visible + neighbour->map->npc_count);
+        for (int i = 0; i < neighbour->map->npc_count; i++)
+        {
+            EntityId npc = neighbour->map->npc[i];
+            const Transform *transform = ECS_GetTransform(npc);
+            const Sprite *sprite = ECS_GetSprite(npc);
+            if (!transform || !sprite)
+                continue;
+
+            renderItems[visible++] =
+                (RenderItem){transform->y + neighbour->dy + sprite->height, npc, neighbour->dx, neighbour->dy};
+        }
+    }
+
+    qsort(renderItems, visible, sizeof(RenderItem), System_CompareDepth);
+    int offset_x = list->offset_x, offset_y = list->offset_y;
+    for (int i = 0; i < visible; i++)
+    {
+        RenderList_SetOffset(list, offset_x + renderItems[i].dx, offset_y + renderItems[i].dy);
+        Entity_Draw(renderItems[i].entity, list);
+    }
+    RenderList_SetOffset(list, offset_x, offset_y);
+}
+
+void System_Shutdown(void)
+{
+    Mem_Free(renderItems);
+    renderItems = NULL;
+    renderCapacity = 0;
+    Mem_Free(triggerEvents);
+    triggerEvents = NULL;
+    triggerEventCount = 0;
+    triggerEventCapacity = 0;
+}
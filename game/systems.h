@@ -0,0 +1,46 @@
+#ifndef SYSTEMS_H
+#define SYSTEMS_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "ecs.h"
+#include "../framework/map.h"
+
+// Systèmes : chacun parcourt le tableau dense d'un composant et ignore les
+// entités inactives ou sans les autres composants nécessaires. Ordre d'une
+// frame : IA, déplacement, hitbox, zones, animation (AnimSystem_Update), rendu.
+
+typedef enum
+{
+    TRIGGER_ENTER, // Touchée à ce tick, pas au précédent
+    TRIGGER_STAY,
+    TRIGGER_EXIT   // Touchée au tick précédent seulement
+} TriggerEventType;
+
+typedef struct
+{
+    EntityId entity;
+    int trigger; // Indice dans map->triggers
+    TriggerEventType type;
+} TriggerEvent;
+
+void System_UpdateAI(float deltaTime);                 // AI + Mover
+void System_UpdateMovement(Map *map, float deltaTime); // Mover + Transform (+ Collider)
+void System_UpdateHitboxes(void);                      // Hitbox + Transform
+void System_UpdateTriggers(Map *map);                  // TriggerContact + Hitbox
+// Sprite + Transform, triés par les pieds ; avec les PNJ en pause des voisines de `map`
+void System_Render(RenderList *list, const Map *map);
+
+// Vrai si `rect` touche une collision de la map ou un Collider solide actif
+// (autre que `ignore`)
+bool System_IsBlocked(Map *map, const SDL_Rect *rect, EntityId ignore);
+
+// Événements du dernier System_UpdateTriggers, par entité puis par zone
+int System_GetTriggerEvents(const TriggerEvent **events);
+// Oublie les zones touchées (changement ou rechargement de map) : celles sous
+// les entités au prochain tick ne donnent pas d'entrée
+void System_ResetTriggers(void);
+
+void System_Shutdown(void);
+
+#endif // SYSTEMS_H
@@ -2,9 +2,19 @@
 #include "game/player.h"
 #include "game/npc.h"
 #include "game/constante.h"
+#include <string.h>
 
 int main(int argc, char *argv[])
 {
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[++i];
+    }
 
     Game *game = Game_Create(SCREEN_TITLE, SCREEN_WIDTH, SCREEN_HEIGHT);
     if (!game)
@@ -13,6 +23,19 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // Relecture d'un journal d'entrées : aussi vite que possible, sur ce thread
+    bool replaying = replayPath && Game_StartReplay(game, replayPath);
+    if (replayPath && !replaying)
+    {
+        Game_Free(game);
+        return 1;
+    }
+    if (recordPath && !replaying)
+        Game_StartRecording(game, recordPath);
+
+    // Simulation sur un second thread ; à défaut, elle reste dans cette boucle
+    bool threaded = !replaying && Game_StartSimulation(game);
+
     Uint32 lastTime = SDL_GetTicks();
 
     while (game->running)
@@ -22,7 +45,10 @@ int main(int argc, char *argv[])
         lastTime = currentTime;
 
         Game_HandleEvent(game, deltaTime);
-        Game_UpdateData(game, deltaTime);
+        if (replaying)
+            Game_AdvanceReplay(game, REPLAY_FRAME_BUDGET_MS);
+        else if (!threaded)
+            Game_Advance(game, deltaTime);
         Game_Render(game);
     }
 
@@ -0,0 +1,296 @@
+#include "../game/battle.h"
+#include "../game/battleai.h"
+#include "../game/gamedb.h"
+#include "../game/constante.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Combats simulés en masse sur tous les cœurs, pour l'équilibrage : taux de
+// victoire de chaque espèce dans des équipes tirées au hasard, et débit du
+// moteur en combats par seconde. Avec --mcts, le camp 1 est joué par l'IA de
+// combat (budget en ms par tour, tous les threads) contre le camp 0 glouton :
+// taux de victoire de l'IA et simulations par seconde.
+// Usage : battlesim [--battles N] [--threads T] [--seed S] [--level L] [--team K] [--policy greedy|random] [--mcts MS] [--db FICHIER]
+
+#define BATTLESIM_DEFAULT_BATTLES 1000000u
+#define BATTLESIM_MAX_THREADS 64
+
+typedef struct
+{
+    const BattleData *data;
+    Uint32 first, count; // Combats [first, first + count) : même résultat quel que soit le découpage
+    Uint32 seed;
+    int level;
+    int teamSize;
+    bool greedy;
+
+    // Résultats propres au thread, fusionnés à la fin
+    Uint64 *wins;
+    Uint64 *games;
+    Uint64 turns;
+    Uint64 draws;
+} BattleWorker;
+
+// Graine indépendante pour chaque combat (splitmix32)
+static Uint32 BattleSim_Seed(Uint32 seed, Uint32 index)
+{
+    Uint32 z = seed + index * 0x9E3779B9u;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    return z ? z : 1;
+}
+
+static BattleAction BattleSim_RandomAction(BattleState *battle, const BattleData *data, int side)
+{
+    BattleAction actions[BATTLE_MAX_ACTIONS];
+    int count = Battle_GetActions(battle, data, side, actions);
+    return actions[Battle_Random(battle) % count];
+}
+
+static void BattleSim_AddTeam(BattleState *battle, const BattleData *data, int side, int size, int level)
+{
+    // Espèces distinctes dans une équipe
+    while (battle->sides[side].count < size)
+    {
+        Uint16 species = (Uint16)(Battle_Random(battle) % data->speciesCount);
+        bool taken = false;
+        for (int i = 0; i < battle->sides[side].count; i++)
+            taken |= battle->sides[side].team[i].species == species;
+        if (!taken)
+            Battle_AddMon(battle, data, side, species, (Uint8)level);
+    }
+}
+
+static int BattleSim_Thread(void *userdata)
+{
+    BattleWorker *worker = (BattleWorker *)userdata;
+    const BattleData *data = worker->data;
+    Uint64 turns = 0, draws = 0; // Compteurs locaux : pas de partage de ligne de cache entre threads
+
+    for (Uint32 i = 0; i < worker->count; i++)
+    {
+        BattleState battle;
+        Battle_Init(&battle, BattleSim_Seed(worker->seed, worker->first + i));
+        BattleSim_AddTeam(&battle, data, 0, worker->teamSize, worker->level);
+        BattleSim_AddTeam(&battle, data, 1, worker->teamSize, worker->level);
+
+        while (battle.winner < 0)
+        {
+            BattleAction actions[2];
+            for (int side = 0; side < 2; side++)
+            {
+                actions[side] = worker->greedy ? Battle_GreedyAction(&battle, data, side)
+                                               : BattleSim_RandomAction(&battle, data, side);
+            }
+            Battle_Turn(&battle, data, actions);
+        }
+
+        turns += battle.turn;
+        if (battle.winner == BATTLE_DRAW)
+            draws++;
+        for (int side = 0; side < 2; side++)
+        {
+            for (int m = 0; m < battle.sides[side].count; m++)
+            {
+                Uint16 species = battle.sides[side].team[m].species;
+                worker->games[species]++;
+                if (battle.winner == side)
+                    worker->wins[species]++;
+            }
+        }
+    }
+
+    worker->turns = turns;
+    worker->draws = draws;
+    return 0;
+}
+
+// Combats un par un sur le thread principal, l'IA utilisant les autres threads
+static int BattleSim_RunAI(const BattleData *data, Uint32 battles, int threads, Uint32 seed, int level, int teamSize,
+                           Uint32 budgetMs)
+{
+    BattleAI *ai = BattleAI_Create(threads, 1 << 16);
+    if (!ai)
+        return 1;
+
+    Uint64 wins = 0, draws = 0, turns = 0, rollouts = 0, thinkMs = 0;
+    for (Uint32 i = 0; i < battles; i++)
+    {
+        BattleState battle;
+        Battle_Init(&battle, BattleSim_Seed(seed, i));
+        BattleSim_AddTeam(&battle, data, 0, teamSize, level);
+        BattleSim_AddTeam(&battle, data, 1, teamSize, level);
+
+        while (battle.winner < 0)
+        {
+            BattleAction actions[2];
+            actions[0] = Battle_GreedyAction(&battle, data, 0);
+            actions[1] = BattleAI_Think(ai, data, &battle, 1, budgetMs, 0, Battle_Random(&battle));
+            rollouts += ai->lastRollouts;
+            thinkMs += ai->lastTimeMs;
+            Battle_Turn(&battle, data, actions);
+        }
+
+        turns += battle.turn;
+        wins += battle.winner == 1;
+        draws += battle.winner == BATTLE_DRAW;
+    }
+
+    printf("%u combats (%d contre %d, niveau %d), IA %u ms/tour sur %d threads contre gloutonne : %.1f %% de victoires, "
+           "%llu nuls, %.1f tours en moyenne\n",
+           battles, teamSize, teamSize, level, budgetMs, ai->workerCount, battles ? 100.0 * wins / battles : 0.0,
+           (unsigned long long)draws, battles ? (double)turns / battles : 0.0);
+    printf("  %.0f simulations/s, %.0f simulations par décision\n", thinkMs ? rollouts * 1000.0 / thinkMs : 0.0,
+           turns ? (double)rollouts / turns : 0.0);
+
+    BattleAI_Free(ai);
+    return 0;
+}
+
+static const Uint64 *sortWins, *sortGames;
+
+static int BattleSim_CompareRate(const void *a, const void *b)
+{
+    int ia = *(const int *)a, ib = *(const int *)b;
+    double ra = sortGames[ia] ? (double)sortWins[ia] / sortGames[ia] : 0.0;
+    double rb = sortGames[ib] ? (double)sortWins[ib] / sortGames[ib] : 0.0;
+    return ra < rb ? 1 : ra > rb ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Uint32 battles = BATTLESIM_DEFAULT_BATTLES;
+    int threads = SDL_GetCPUCount();
+    Uint32 seed = 1;
+    int level = 50;
+    int teamSize = 3;
+    bool greedy = true;
+    Uint32 mctsBudget = 0;
+    const char *dbPath = GAMEDB_PATH;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--battles") == 0)
+            battles = (Uint32)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0)
+            threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = (Uint32)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--level") == 0)
+            level = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--team") == 0)
+            teamSize = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--policy") == 0)
+            greedy = strcmp(argv[i + 1], "random") != 0;
+        else if (strcmp(argv[i], "--mcts") == 0)
+            mctsBudget = (Uint32)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--db") == 0)
+            dbPath = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--battles N] [--threads T] [--seed S] [--level L] [--team K] [--policy greedy|random] [--mcts MS] [--db FICHIER]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    GameDB *db = GameDB_Open(dbPath);
+    if (!db)
+        return 1;
+    const BattleData *data = &db->battle;
+    if (threads < 1)
+        threads = 1;
+    if (threads > BATTLESIM_MAX_THREADS)
+        threads = BATTLESIM_MAX_THREADS;
+    if (level < 1 || level > 100)
+        level = 50;
+    if (teamSize < 1 || teamSize > BATTLE_TEAM_MAX || teamSize > data->speciesCount)
+        teamSize = 3;
+    if (mctsBudget)
+    {
+        int result = BattleSim_RunAI(data, battles, threads, seed, level, teamSize, mctsBudget);
+        GameDB_Close(db);
+        return result;
+    }
+
+    BattleWorker workers[BATTLESIM_MAX_THREADS];
+    SDL_Thread *handles[BATTLESIM_MAX_THREADS];
+    memset(workers, 0, sizeof(workers));
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 first = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        BattleWorker *worker = &workers[t];
+        worker->data = data;
+        worker->first = first;
+        worker->count = battles / threads + ((Uint32)t < battles % threads ? 1 : 0);
+        worker->seed = seed;
+        worker->level = level;
+        worker->teamSize = teamSize;
+        worker->greedy = greedy;
+        worker->wins = calloc(data->speciesCount, sizeof(Uint64));
+        worker->games = calloc(data->speciesCount, sizeof(Uint64));
+        if (!worker->wins || !worker->games)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire.\n");
+            exit(EXIT_FAILURE);
+        }
+        first += worker->count;
+
+        handles[t] = SDL_CreateThread(BattleSim_Thread, "battlesim", worker);
+        if (!handles[t])
+            BattleSim_Thread(worker); // Sans thread : sur le thread principal
+    }
+
+    Uint64 *wins = calloc(data->speciesCount, sizeof(Uint64));
+    Uint64 *games = calloc(data->speciesCount, sizeof(Uint64));
+    int *order = malloc(data->speciesCount * sizeof(int));
+    if (!wins || !games || !order)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Uint64 turns = 0, draws = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        if (handles[t])
+            SDL_WaitThread(handles[t], NULL);
+        for (int s = 0; s < data->speciesCount; s++)
+        {
+            wins[s] += workers[t].wins[s];
+            games[s] += workers[t].games[s];
+        }
+        turns += workers[t].turns;
+        draws += workers[t].draws;
+        free(workers[t].wins);
+        free(workers[t].games);
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+
+    printf("%u combats (%d contre %d, niveau %d, IA %s) sur %d threads en %.3f s : %.0f combats/s, %.1f tours en moyenne, %llu nuls\n",
+           battles, teamSize, teamSize, level, greedy ? "gloutonne" : "aléatoire", threads, seconds,
+           seconds > 0.0 ? battles / seconds : 0.0, battles ? (double)turns / battles : 0.0,
+           (unsigned long long)draws);
+
+    for (int s = 0; s < data->speciesCount; s++)
+        order[s] = s;
+    sortWins = wins;
+    sortGames = games;
+    qsort(order, data->speciesCount, sizeof(int), BattleSim_CompareRate);
+
+    for (int i = 0; i < data->speciesCount; i++)
+    {
+        int s = order[i];
+        printf("  %-*s %5.1f %% de victoires (%llu combats)\n", BATTLE_NAME_LENGTH, data->species[s].name,
+               games[s] ? 100.0 * wins[s] / games[s] : 0.0, (unsigned long long)games[s]);
+    }
+
+    free(wins);
+    free(games);
+    free(order);
+    GameDB_Close(db);
+    return 0;
+}
@@ -0,0 +1,667 @@
+#include "../game/gamedb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Compile les tables CSV de resources/data en base de données binaire (.db)
+// projetée en mémoire à l'exécution (game/gamedb.h).
+// Usage : dbcook <dossier des CSV> <sortie.db>
+//
+// Fichiers lus : species.csv, moves.csv, typechart.csv, learnsets.csv,
+// evolutions.csv et encounters.csv. Une ligne d'en-tête, les lignes vides et
+// celles qui commencent par '#' sont ignorées. Les espèces et les attaques
+// sont désignées par leur nom ; leur identifiant est leur rang dans le fichier.
+
+static const char *typeNames[TYPE_COUNT] = {
+    "Normal", "Fire", "Water", "Electric", "Grass", "Ice", "Fighting", "Poison", "Ground",
+    "Flying", "Psychic", "Bug", "Rock", "Ghost", "Dragon", "Dark", "Steel", "Fairy",
+};
+
+static const char *statNames[STAT_COUNT] = {"hp", "attack", "defense", "sp_attack", "sp_defense", "speed"};
+
+typedef struct
+{
+    const char *path;
+    char *text;
+    char **cells; // rows * columns
+    int *lines;   // Numéro de ligne de chaque rangée, pour les erreurs
+    int columns;
+    int rows;
+} CsvTable;
+
+typedef struct
+{
+    Uint8 *data;
+    size_t size, capacity;
+} DBBuffer;
+
+typedef struct
+{
+    Uint32 species;
+    Uint32 order; // Rang dans le fichier : tri stable
+    Uint32 key;   // Niveau
+    Uint16 value; // Attaque ou espèce obtenue
+} DBSpeciesEntry;
+
+static void DBCook_Trim(char **cell)
+{
+    char *start = *cell;
+    while (*start == ' ' || *start == '\t')
+        start++;
+    char *end = start + strlen(start);
+    while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        *--end = '\0';
+    *cell = start;
+}
+
+// Découpe en place : une rangée par ligne utile, `columns` cellules par rangée
+static bool CsvTable_Load(CsvTable *table, const char *dir, const char *name, int columns)
+{
+    static char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    memset(table, 0, sizeof(CsvTable));
+    table->path = name;
+    table->columns = columns;
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible d'ouvrir %s\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    table->text = malloc(length + 1);
+    if (!table->text || fread(table->text, 1, length, file) != (size_t)length)
+    {
+        fprintf(stderr, "Lecture impossible: %s\n", path);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    table->text[length] = '\0';
+
+    int capacity = 64;
+    table->cells = malloc(capacity * columns * sizeof(char *));
+    table->lines = malloc(capacity * sizeof(int));
+    if (!table->cells || !table->lines)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bool header = true;
+    int lineNumber = 0;
+    char *line = table->text;
+    while (line && *line)
+    {
+        lineNumber++;
+        char *next = strchr(line, '\n');
+        if (next)
+            *next++ = '\0';
+
+        DBCook_Trim(&line);
+        if (*line == '\0' || *line == '#')
+        {
+            line = next;
+            continue;
+        }
+
+        char *cells[64];
+        int count = 0;
+        for (char *cell = line; cell && count < 64; count++)
+        {
+            char *comma = strchr(cell, ',');
+            if (comma)
+                *comma++ = '\0';
+            cells[count] = cell;
+            DBCook_Trim(&cells[count]);
+            cell = comma;
+        }
+        if (count != columns)
+        {
+            fprintf(stderr, "%s:%d: %d colonnes au lieu de %d\n", name, lineNumber, count, columns);
+            return false;
+        }
+
+        if (header)
+        {
+            header = false; // Noms des colonnes : documentation seulement
+            line = next;
+            continue;
+        }
+
+        if (table->rows == capacity)
+        {
+            capacity *= 2;
+            table->cells = realloc(table->cells, capacity * columns * sizeof(char *));
+            table->lines = realloc(table->lines, capacity * sizeof(int));
+            if (!table->cells || !table->lines)
+            {
+                fprintf(stderr, "Erreur d'allocation mémoire.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        memcpy(&table->cells[table->rows * columns], cells, columns * sizeof(char *));
+        table->lines[table->rows] = lineNumber;
+        table->rows++;
+        line = next;
+    }
+    return true;
+}
+
+static void CsvTable_Free(CsvTable *table)
+{
+    free(table->text);
+    free(table->cells);
+    free(table->lines);
+}
+
+static const char *CsvTable_Cell(const CsvTable *table, int row, int column)
+{
+    return table->cells[row * table->columns + column];
+}
+
+// Entier de la cellule dans [min, max] ; message d'erreur sinon
+static bool CsvTable_Int(const CsvTable *table, int row, int column, long min, long max, long *value)
+{
+    const char *cell = CsvTable_Cell(table, row, column);
+    char *end;
+    *value = strtol(cell, &end, 10);
+    if (*cell == '\0' || *end != '\0' || *value < min || *value > max)
+    {
+        fprintf(stderr, "%s:%d: valeur invalide '%s' (attendu %ld à %ld)\n", table->path, table->lines[row], cell, min, max);
+        return false;
+    }
+    return true;
+}
+
+static int DBCook_FindName(const char *const *names, int count, const char *name)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcasecmp(names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool CsvTable_Type(const CsvTable *table, int row, int column, bool allowNone, Uint8 *type)
+{
+    const char *cell = CsvTable_Cell(table, row, column);
+    if (allowNone && strcmp(cell, "-") == 0)
+    {
+        *type = TYPE_NONE;
+        return true;
+    }
+    int index = DBCook_FindName(typeNames, TYPE_COUNT, cell);
+    if (index < 0)
+    {
+        fprintf(stderr, "%s:%d: type inconnu '%s'\n", table->path, table->lines[row], cell);
+        return false;
+    }
+    *type = (Uint8)index;
+    return true;
+}
+
+static bool CsvTable_Name(const CsvTable *table, int row, int column, char name[BATTLE_NAME_LENGTH])
+{
+    const char *cell = CsvTable_Cell(table, row, column);
+    size_t length = strlen(cell);
+    if (length == 0 || length >= BATTLE_NAME_LENGTH)
+    {
+        fprintf(stderr, "%s:%d: nom vide ou de plus de %d caractères '%s'\n", table->path, table->lines[row],
+                BATTLE_NAME_LENGTH - 1, cell);
+        return false;
+    }
+    memset(name, 0, BATTLE_NAME_LENGTH);
+    memcpy(name, cell, length);
+    return true;
+}
+
+static int DBCook_FindSpecies(const BattleSpecies *species, int count, const char *name)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(species[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int DBCook_FindMove(const BattleMove *moves, int count, const char *name)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(moves[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool CsvTable_Species(const CsvTable *table, int row, int column, const BattleSpecies *species, int count,
+                             Uint16 *id)
+{
+    int index = DBCook_FindSpecies(species, count, CsvTable_Cell(table, row, column));
+    if (index < 0)
+    {
+        fprintf(stderr, "%s:%d: espèce inconnue '%s'\n", table->path, table->lines[row], CsvTable_Cell(table, row, column));
+        return false;
+    }
+    *id = (Uint16)index;
+    return true;
+}
+
+static bool DBCook_ReadSpecies(const CsvTable *table, BattleSpecies *species)
+{
+    for (int row = 0; row < table->rows; row++)
+    {
+        BattleSpecies *s = &species[row];
+        if (!CsvTable_Name(table, row, 0, s->name) || !CsvTable_Type(table, row, 1, false, &s->types[0]) ||
+            !CsvTable_Type(table, row, 2, true, &s->types[1]))
+            return false;
+        if (DBCook_FindSpecies(species, row, s->name) >= 0)
+        {
+            fprintf(stderr, "%s:%d: espèce en double '%s'\n", table->path, table->lines[row], s->name);
+            return false;
+        }
+        for (int stat = 0; stat < STAT_COUNT; stat++)
+        {
+            long value;
+            if (!CsvTable_Int(table, row, 3 + stat, 1, 255, &value))
+                return false;
+            s->base[stat] = (Uint8)value;
+        }
+    }
+    return true;
+}
+
+static bool DBCook_ReadMoves(const CsvTable *table, BattleMove *moves)
+{
+    static const char *categories[] = {"physical", "special", "status"};
+
+    for (int row = 0; row < table->rows; row++)
+    {
+        BattleMove *m = &moves[row];
+        if (!CsvTable_Name(table, row, 0, m->name) || !CsvTable_Type(table, row, 1, false, &m->type))
+            return false;
+        if (DBCook_FindMove(moves, row, m->name) >= 0)
+        {
+            fprintf(stderr, "%s:%d: attaque en double '%s'\n", table->path, table->lines[row], m->name);
+            return false;
+        }
+
+        int category = DBCook_FindName(categories, 3, CsvTable_Cell(table, row, 2));
+        if (category < 0)
+        {
+            fprintf(stderr, "%s:%d: catégorie inconnue '%s'\n", table->path, table->lines[row], CsvTable_Cell(table, row, 2));
+            return false;
+        }
+        m->category = (Uint8)category;
+
+        long power, accuracy, pp, priority, stage, self;
+        if (!CsvTable_Int(table, row, 3, 0, 255, &power) || !CsvTable_Int(table, row, 4, 0, 100, &accuracy) ||
+            !CsvTable_Int(table, row, 5, 1, 64, &pp) || !CsvTable_Int(table, row, 6, -7, 5, &priority) ||
+            !CsvTable_Int(table, row, 8, -6, 6, &stage) || !CsvTable_Int(table, row, 9, 0, 1, &self))
+            return false;
+        m->power = (Uint8)power;
+        m->accuracy = (Uint8)accuracy;
+        m->pp = (Uint8)pp;
+        m->priority = (Sint8)priority;
+        m->effectStage = (Sint8)stage;
+        m->effectSelf = (Uint8)self;
+
+        // Aucun effet : STAT_HP, comme le moteur l'attend
+        const char *stat = CsvTable_Cell(table, row, 7);
+        int index = strcmp(stat, "-") == 0 ? STAT_HP : DBCook_FindName(statNames, STAT_COUNT, stat);
+        if (index < 0)
+        {
+            fprintf(stderr, "%s:%d: statistique inconnue '%s'\n", table->path, table->lines[row], stat);
+            return false;
+        }
+        m->effectStat = (Uint8)index;
+    }
+    return true;
+}
+
+static bool DBCook_ReadTypeChart(const CsvTable *table, Uint8 *chart)
+{
+    if (table->rows != TYPE_COUNT)
+    {
+        fprintf(stderr, "%s: %d lignes au lieu de %d\n", table->path, table->rows, TYPE_COUNT);
+        return false;
+    }
+
+    for (int row = 0; row < TYPE_COUNT; row++)
+    {
+        Uint8 attack;
+        if (!CsvTable_Type(table, row, 0, false, &attack))
+            return false;
+        for (int defense = 0; defense < TYPE_COUNT; defense++)
+        {
+            // Multiplicateurs 0, 0.5, 1 et 2, stockés x2
+            const char *cell = CsvTable_Cell(table, row, 1 + defense);
+            double value = strtod(cell, NULL);
+            int doubled = (int)(value * 2.0 + 0.5);
+            if (doubled != 0 && doubled != 1 && doubled != 2 && doubled != 4)
+            {
+                fprintf(stderr, "%s:%d: multiplicateur invalide '%s'\n", table->path, table->lines[row], cell);
+                return false;
+            }
+            chart[attack * TYPE_COUNT + defense] = (Uint8)doubled;
+        }
+    }
+    return true;
+}
+
+static int DBCook_CompareEntries(const void *a, const void *b)
+{
+    const DBSpeciesEntry *ea = a, *eb = b;
+    if (ea->species != eb->species)
+        return ea->species < eb->species ? -1 : 1;
+    if (ea->key != eb->key)
+        return ea->key < eb->key ? -1 : 1;
+    return ea->order < eb->order ? -1 : ea->order > eb->order ? 1 : 0;
+}
+
+// Entrées triées par espèce puis par niveau ; plage de chaque espèce
+static void DBCook_BuildRanges(DBSpeciesEntry *entries, int count, BattleRange *ranges, int speciesCount)
+{
+    qsort(entries, count, sizeof(DBSpeciesEntry), DBCook_CompareEntries);
+    memset(ranges, 0, speciesCount * sizeof(BattleRange));
+    for (int i = count - 1; i >= 0; i--)
+    {
+        ranges[entries[i].species].first = (Uint32)i;
+        ranges[entries[i].species].count++;
+    }
+}
+
+static void DBBuffer_Reserve(DBBuffer *buffer, size_t size)
+{
+    if (buffer->size + size <= buffer->capacity)
+        return;
+    while (buffer->size + size > buffer->capacity)
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+    buffer->data = realloc(buffer->data, buffer->capacity);
+    if (!buffer->data)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Ajoute une section alignée ; retourne son offset
+static Uint32 DBBuffer_Append(DBBuffer *buffer, const void *data, size_t size)
+{
+    size_t padding = (GAMEDB_ALIGNMENT - buffer->size % GAMEDB_ALIGNMENT) % GAMEDB_ALIGNMENT;
+    DBBuffer_Reserve(buffer, padding + size);
+    memset(buffer->data + buffer->size, 0, padding);
+    buffer->size += padding;
+
+    Uint32 offset = (Uint32)buffer->size;
+    if (size > 0)
+        memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return offset;
+}
+
+typedef const char *(*DBNameFunc)(const void *records, Uint32 id, const char *strings);
+
+static const char *DBCook_SpeciesName(const void *records, Uint32 id, const char *strings)
+{
+    (void)strings;
+    return ((const BattleSpecies *)records)[id].name;
+}
+
+static const char *DBCook_MoveName(const void *records, Uint32 id, const char *strings)
+{
+    (void)strings;
+    return ((const BattleMove *)records)[id].name;
+}
+
+static const char *DBCook_AreaName(const void *records, Uint32 id, const char *strings)
+{
+    return strings + ((const GameDBArea *)records)[id].name;
+}
+
+static void DBCook_BuildIndex(Uint32 *index, Uint32 size, const void *records, Uint32 count, DBNameFunc name,
+                              const char *strings)
+{
+    for (Uint32 i = 0; i < size; i++)
+        index[i] = GAMEDB_NONE;
+    for (Uint32 id = 0; id < count; id++)
+    {
+        Uint32 slot = GameDB_HashName(name(records, id, strings)) & (size - 1);
+        while (index[slot] != GAMEDB_NONE)
+            slot = (slot + 1) & (size - 1);
+        index[slot] = id;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <dossier des CSV> <sortie.db>\n", argv[0]);
+        return 1;
+    }
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    fprintf(stderr, "La base de données est petit-boutiste, non supportée sur cette plateforme\n");
+    return 1;
+#endif
+
+    const char *dir = argv[1];
+    CsvTable speciesTable, movesTable, chartTable, learnTable, evoTable, encounterTable;
+    if (!CsvTable_Load(&speciesTable, dir, "species.csv", 3 + STAT_COUNT) ||
+        !CsvTable_Load(&movesTable, dir, "moves.csv", 10) ||
+        !CsvTable_Load(&chartTable, dir, "typechart.csv", 1 + TYPE_COUNT) ||
+        !CsvTable_Load(&learnTable, dir, "learnsets.csv", 3) ||
+        !CsvTable_Load(&evoTable, dir, "evolutions.csv", 3) ||
+        !CsvTable_Load(&encounterTable, dir, "encounters.csv", 5))
+        return 1;
+
+    int speciesCount = speciesTable.rows;
+    int moveCount = movesTable.rows;
+    if (speciesCount == 0 || speciesCount >= BATTLE_NO_MOVE || moveCount == 0 || moveCount >= BATTLE_NO_MOVE)
+    {
+        fprintf(stderr, "Nombre d'espèces (%d) ou d'attaques (%d) invalide\n", speciesCount, moveCount);
+        return 1;
+    }
+
+    BattleSpecies *species = calloc(speciesCount, sizeof(BattleSpecies));
+    BattleMove *moves = calloc(moveCount, sizeof(BattleMove));
+    Uint8 chart[TYPE_COUNT * TYPE_COUNT];
+    DBSpeciesEntry *learnEntries = calloc(learnTable.rows + 1, sizeof(DBSpeciesEntry));
+    DBSpeciesEntry *evoEntries = calloc(evoTable.rows + 1, sizeof(DBSpeciesEntry));
+    BattleRange *learnRanges = calloc(speciesCount, sizeof(BattleRange));
+    BattleRange *evoRanges = calloc(speciesCount, sizeof(BattleRange));
+    BattleLearn *learns = calloc(learnTable.rows + 1, sizeof(BattleLearn));
+    GameDBEvolution *evolutions = calloc(evoTable.rows + 1, sizeof(GameDBEvolution));
+    GameDBArea *areas = calloc(encounterTable.rows + 1, sizeof(GameDBArea));
+    GameDBEncounter *encounters = calloc(encounterTable.rows + 1, sizeof(GameDBEncounter));
+    int *encounterAreas = calloc(encounterTable.rows + 1, sizeof(int));
+    DBBuffer strings = {0};
+    if (!species || !moves || !learnEntries || !evoEntries || !learnRanges || !evoRanges || !learns ||
+        !evolutions || !areas || !encounters || !encounterAreas)
+    {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bool ok = DBCook_ReadSpecies(&speciesTable, species) && DBCook_ReadMoves(&movesTable, moves) &&
+              DBCook_ReadTypeChart(&chartTable, chart);
+
+    // Attaques apprises : espèce, niveau, attaque
+    for (int row = 0; ok && row < learnTable.rows; row++)
+    {
+        Uint16 id;
+        long level;
+        int move = DBCook_FindMove(moves, moveCount, CsvTable_Cell(&learnTable, row, 2));
+        ok = CsvTable_Species(&learnTable, row, 0, species, speciesCount, &id) &&
+             CsvTable_Int(&learnTable, row, 1, 1, 100, &level);
+        if (ok && move < 0)
+        {
+            fprintf(stderr, "%s:%d: attaque inconnue '%s'\n", learnTable.path, learnTable.lines[row],
+                    CsvTable_Cell(&learnTable, row, 2));
+            ok = false;
+        }
+        learnEntries[row] = (DBSpeciesEntry){id, (Uint32)row, (Uint32)level, (Uint16)move};
+    }
+
+    // Évolutions : espèce, espèce obtenue, niveau
+    for (int row = 0; ok && row < evoTable.rows; row++)
+    {
+        Uint16 from, into;
+        long level;
+        ok = CsvTable_Species(&evoTable, row, 0, species, speciesCount, &from) &&
+             CsvTable_Species(&evoTable, row, 1, species, speciesCount, &into) &&
+             CsvTable_Int(&evoTable, row, 2, 1, 100, &level);
+        evoEntries[row] = (DBSpeciesEntry){from, (Uint32)row, (Uint32)level, into};
+    }
+
+    // Rencontres : zones dans l'ordre d'apparition, entrées regroupées par zone
+    int areaCount = 0;
+    for (int row = 0; ok && row < encounterTable.rows; row++)
+    {
+        const char *name = CsvTable_Cell(&encounterTable, row, 0);
+        int area = 0;
+        while (area < areaCount && strcmp((const char *)strings.data + areas[area].name, name) != 0)
+            area++;
+        if (area == areaCount)
+        {
+            areas[area].name = (Uint32)strings.size;
+            DBBuffer_Reserve(&strings, strlen(name) + 1);
+            memcpy(strings.data + strings.size, name, strlen(name) + 1);
+            strings.size += strlen(name) + 1;
+            areaCount++;
+        }
+        encounterAreas[row] = area;
+    }
+
+    int encounterCount = 0;
+    for (int area = 0; ok && area < areaCount; area++)
+    {
+        areas[area].first = (Uint32)encounterCount;
+        for (int row = 0; ok && row < encounterTable.rows; row++)
+        {
+            if (encounterAreas[row] != area)
+                continue;
+
+            GameDBEncounter *e = &encounters[encounterCount++];
+            long minLevel, maxLevel, weight;
+            ok = CsvTable_Species(&encounterTable, row, 1, species, speciesCount, &e->species) &&
+                 CsvTable_Int(&encounterTable, row, 2, 1, 100, &minLevel) &&
+                 CsvTable_Int(&encounterTable, row, 3, minLevel, 100, &maxLevel) &&
+                 CsvTable_Int(&encounterTable, row, 4, 1, 65535, &weight);
+            e->min_level = (Uint8)minLevel;
+            e->max_level = (Uint8)maxLevel;
+            e->weight = (Uint16)weight;
+            areas[area].count++;
+            areas[area].total_weight += (Uint32)weight;
+        }
+    }
+
+    if (ok)
+    {
+        DBCook_BuildRanges(learnEntries, learnTable.rows, learnRanges, speciesCount);
+        for (int i = 0; i < learnTable.rows; i++)
+            learns[i] = (BattleLearn){(Uint8)learnEntries[i].key, 0, learnEntries[i].value};
+
+        DBCook_BuildRanges(evoEntries, evoTable.rows, evoRanges, speciesCount);
+        for (int i = 0; i < evoTable.rows; i++)
+            evolutions[i] = (GameDBEvolution){evoEntries[i].value, (Uint8)evoEntries[i].key, 0};
+
+        // Index : au plus une case sur deux occupée
+        int largest = speciesCount > moveCount ? speciesCount : moveCount;
+        if (areaCount > largest)
+            largest = areaCount;
+        Uint32 indexSize = 16;
+        while (indexSize < (Uint32)largest * 2)
+            indexSize <<= 1;
+
+        Uint32 *speciesIndex = malloc(indexSize * sizeof(Uint32));
+        Uint32 *moveIndex = malloc(indexSize * sizeof(Uint32));
+        Uint32 *areaIndex = malloc(indexSize * sizeof(Uint32));
+        if (!speciesIndex || !moveIndex || !areaIndex)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire.\n");
+            exit(EXIT_FAILURE);
+        }
+        DBCook_BuildIndex(speciesIndex, indexSize, species, speciesCount, DBCook_SpeciesName, NULL);
+        DBCook_BuildIndex(moveIndex, indexSize, moves, moveCount, DBCook_MoveName, NULL);
+        DBCook_BuildIndex(areaIndex, indexSize, areas, areaCount, DBCook_AreaName, (const char *)strings.data);
+
+        GameDBHeader header;
+        memset(&header, 0, sizeof(header));
+        DBBuffer out = {0};
+        DBBuffer_Append(&out, &header, sizeof(header));
+
+        memcpy(header.magic, GAMEDB_MAGIC, 4);
+        header.version = GAMEDB_VERSION;
+        header.species_count = (Uint32)speciesCount;
+        header.species_offset = DBBuffer_Append(&out, species, speciesCount * sizeof(BattleSpecies));
+        header.move_count = (Uint32)moveCount;
+        header.moves_offset = DBBuffer_Append(&out, moves, moveCount * sizeof(BattleMove));
+        header.type_chart_offset = DBBuffer_Append(&out, chart, sizeof(chart));
+        header.learnsets_offset = DBBuffer_Append(&out, learnRanges, speciesCount * sizeof(BattleRange));
+        header.learn_count = (Uint32)learnTable.rows;
+        header.learns_offset = DBBuffer_Append(&out, learns, learnTable.rows * sizeof(BattleLearn));
+        header.evolution_ranges_offset = DBBuffer_Append(&out, evoRanges, speciesCount * sizeof(BattleRange));
+        header.evolution_count = (Uint32)evoTable.rows;
+        header.evolutions_offset = DBBuffer_Append(&out, evolutions, evoTable.rows * sizeof(GameDBEvolution));
+        header.area_count = (Uint32)areaCount;
+        header.areas_offset = DBBuffer_Append(&out, areas, areaCount * sizeof(GameDBArea));
+        header.encounter_count = (Uint32)encounterCount;
+        header.encounters_offset = DBBuffer_Append(&out, encounters, encounterCount * sizeof(GameDBEncounter));
+        header.index_size = indexSize;
+        header.species_index_offset = DBBuffer_Append(&out, speciesIndex, indexSize * sizeof(Uint32));
+        header.move_index_offset = DBBuffer_Append(&out, moveIndex, indexSize * sizeof(Uint32));
+        header.area_index_offset = DBBuffer_Append(&out, areaIndex, indexSize * sizeof(Uint32));
+        header.strings_size = (Uint32)strings.size;
+        header.strings_offset = DBBuffer_Append(&out, strings.data, strings.size);
+        header.file_size = (Uint32)out.size;
+        memcpy(out.data, &header, sizeof(header));
+
+        FILE *file = fopen(argv[2], "wb");
+        ok = file && fwrite(out.data, 1, out.size, file) == out.size;
+        if (file && fclose(file) != 0)
+            ok = false;
+        if (ok)
+        {
+            printf("%s -> %s (%d espèces, %d attaques, %d attaques apprises, %d évolutions, %d zones, %d rencontres, %zu octets)\n",
+                   dir, argv[2], speciesCount, moveCount, learnTable.rows, evoTable.rows, areaCount, encounterCount, out.size);
+        }
+        else
+        {
+            fprintf(stderr, "Écriture impossible: %s\n", argv[2]);
+        }
+
+        free(out.data);
+        free(speciesIndex);
+        free(moveIndex);
+        free(areaIndex);
+    }
+
+    free(species);
+    free(moves);
+    free(learnEntries);
+    free(evoEntries);
+    free(learnRanges);
+    free(evoRanges);
+    free(learns);
+    free(evolutions);
+    free(areas);
+    free(encounters);
+    free(encounterAreas);
+    free(strings.data);
+    CsvTable_Free(&speciesTable);
+    CsvTable_Free(&movesTable);
+    CsvTable_Free(&chartTable);
+    CsvTable_Free(&learnTable);
+    CsvTable_Free(&evoTable);
+    CsvTable_Free(&encounterTable);
+    return ok ? 0 : 1;
+}
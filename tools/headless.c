@@ -0,0 +1,182 @@
+#include "../game/game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Simulation sans fenêtre, aussi vite que le CPU le permet : mesure du débit
+// de la simulation seule et sessions d'endurance.
+// Usage : headless [--ticks N] [--replay journal] [--bot graine] [--record journal]
+//   --ticks N       nombre de ticks à simuler (défaut : 1 000 000, ou la fin du journal)
+//   --replay        rejoue un journal enregistré par le jeu (--record)
+//   --bot graine    joueur scripté : marche aléatoire et vélo de temps en temps ; valide
+//                   combats et dialogues, passe les cinématiques
+
+#define HEADLESS_DEFAULT_TICKS 1000000u
+#define HEADLESS_SYNC_INTERVAL SIM_TICK_RATE  // Chargements et préchargements : une fois par seconde simulée
+#define HEADLESS_PROGRESS_INTERVAL 1000000u
+
+typedef struct
+{
+    Uint32 state; // xorshift32, indépendant de rand() (IA)
+    Uint32 nextDecision;
+    int direction; // Action maintenue, -1 si aucune
+} Bot;
+
+static Uint32 Bot_Random(Bot *bot)
+{
+    bot->state ^= bot->state << 13;
+    bot->state ^= bot->state >> 17;
+    bot->state ^= bot->state << 5;
+    return bot->state;
+}
+
+// Appui bref, par la même file que le clavier
+static void Bot_Tap(Input *input, InputAction action)
+{
+    Input_Push(input, action, true, 0);
+    Input_Push(input, action, false, 0);
+}
+
+// Hors de l'exploration (combat, dialogue, cinématique, menu) : valide ou
+// quitte à un rythme humain, sinon la partie resterait bloquée sur cet écran
+static void Bot_UpdateScreen(Bot *bot, Input *input, GameState mode)
+{
+    if (bot->direction >= 0)
+    {
+        Input_Push(input, (InputAction)bot->direction, false, 0);
+        bot->direction = -1;
+    }
+
+    switch (mode)
+    {
+    case MODE_COMBAT:
+        // Une attaque au hasard parmi les quatre, puis validation
+        if (Bot_Random(bot) % 2)
+            Bot_Tap(input, INPUT_ACTION_LEFT);
+        if (Bot_Random(bot) % 2)
+            Bot_Tap(input, INPUT_ACTION_UP);
+        Bot_Tap(input, INPUT_ACTION_CONFIRM);
+        break;
+    case MODE_DIALOGUE:
+        Bot_Tap(input, INPUT_ACTION_CONFIRM);
+        break;
+    case MODE_MENU:
+    case MODE_CINEMATIC: // Passe la scène
+        Bot_Tap(input, INPUT_ACTION_MENU);
+        break;
+    default:
+        break;
+    }
+
+    bot->nextDecision = input->tick + SIM_TICK_RATE / 4 + Bot_Random(bot) % (SIM_TICK_RATE / 2);
+}
+
+// Change d'intention toutes les 0,5 à 2 s simulées, par la même file que le clavier
+static void Bot_Update(Bot *bot, Game *game)
+{
+    Input *input = &game->input;
+    if (input->tick < bot->nextDecision)
+        return;
+
+    GameState mode = Game_GetState(game);
+    if (mode != MODE_WORLD)
+    {
+        Bot_UpdateScreen(bot, input, mode);
+        return;
+    }
+
+    if (bot->direction >= 0)
+        Input_Push(input, (InputAction)bot->direction, false, 0);
+
+    Uint32 roll = Bot_Random(bot) % 10;
+    bot->direction = roll < 7 ? (int)(roll % 4) : -1; // Directions : 0 à 3
+    if (bot->direction >= 0)
+        Input_Push(input, (InputAction)bot->direction, true, 0);
+
+    if (roll == 9)
+        Bot_Tap(input, INPUT_ACTION_TOGGLE_BIKE);
+
+    bot->nextDecision = input->tick + SIM_TICK_RATE / 2 + Bot_Random(bot) % (SIM_TICK_RATE * 3 / 2);
+}
+
+int main(int argc, char *argv[])
+{
+    Uint32 ticks = 0;
+    const char *replayPath = NULL;
+    const char *recordPath = NULL;
+    bool useBot = false;
+    Bot bot = {0};
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--ticks") == 0)
+            ticks = (Uint32)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[i + 1];
+        else if (strcmp(argv[i], "--record") == 0)
+            recordPath = argv[i + 1];
+        else if (strcmp(argv[i], "--bot") == 0)
+        {
+            useBot = true;
+            bot.state = (Uint32)strtoul(argv[i + 1], NULL, 10) | 1; // xorshift : jamais 0
+            bot.direction = -1;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--ticks N] [--replay journal] [--bot graine] [--record journal]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (replayPath && useBot)
+    {
+        fprintf(stderr, "--replay et --bot sont exclusifs\n");
+        return 1;
+    }
+    if (ticks == 0 && !replayPath)
+        ticks = HEADLESS_DEFAULT_TICKS;
+
+    Game *game = Game_CreateHeadless();
+    if (!game)
+        return 1;
+
+    if ((replayPath && !Game_StartReplay(game, replayPath)) ||
+        (recordPath && !replayPath && !Game_StartRecording(game, recordPath)))
+    {
+        Game_Free(game);
+        return 1;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint32 simulated = 0;
+
+    while (ticks == 0 || simulated < ticks)
+    {
+        if (Input_ReplayFinished(&game->input))
+            break;
+        if (useBot)
+            Bot_Update(&bot, game);
+
+        if (!Game_Tick(game))
+        {
+            // Changement de map : on attend le chargement (threads du loader)
+            Game_SyncWorld(game);
+            continue;
+        }
+        simulated++;
+
+        if (simulated % HEADLESS_SYNC_INTERVAL == 0)
+            Game_SyncWorld(game);
+        if (simulated % HEADLESS_PROGRESS_INTERVAL == 0)
+            printf("%u ticks...\n", simulated);
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)frequency;
+    printf("%u ticks (%.0f s de jeu) en %.3f s : %.0f ticks/s, x%.0f temps réel\n",
+           simulated, simulated * (double)SIM_TIMESTEP, seconds,
+           seconds > 0.0 ? simulated / seconds : 0.0,
+           seconds > 0.0 ? simulated * (double)SIM_TIMESTEP / seconds : 0.0);
+
+    Game_Free(game);
+    return 0;
+}
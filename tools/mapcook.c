@@ -0,0 +1,32 @@
+#include "../framework/map.h"
+#include <stdio.h>
+
+// Convertit une map TMX en map cuite (.cmap) chargée par mmap à l'exécution.
+// Usage : mapcook <entree.tmx> <sortie.cmap>
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <map.tmx> <map.cmap>\n", argv[0]);
+        return 1;
+    }
+
+    // Sans renderer : seules les données de la map sont chargées (pas de textures)
+    Map *map = Map_Load(argv[1], NULL);
+    if (!map)
+    {
+        fprintf(stderr, "Impossible de charger %s\n", argv[1]);
+        return 1;
+    }
+
+    bool ok = Map_WriteCooked(map, argv[2]);
+    if (ok)
+    {
+        printf("%s -> %s (%d calques, %d collisions, %d tiles animées, %d PNJ)\n",
+               argv[1], argv[2], map->layer_count, map->collision_count,
+               map->animated_tile_count, map->pnj_count);
+    }
+
+    Map_Free(map);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+#include "../framework/pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// Construit l'archive d'assets (.pak) lue par Pack_Mount.
+// Usage : packer <sortie.pak> <dossier|fichier>...
+//
+// Les chemins sont stockés normalisés, tels que le jeu les demande (relatifs au
+// dossier de lancement). Les fichiers déjà compressés (PNG, maps cuites lues en
+// place) sont stockés tels quels, les autres sont compressés avec zlib si le gain
+// est suffisant.
+
+typedef struct
+{
+    char path[1024];
+    Uint64 hash;
+    Uint8 *data; // Contenu stocké (compressé ou non)
+    Uint32 stored_size;
+    Uint32 raw_size;
+    Uint32 flags;
+} PackerFile;
+
+typedef struct
+{
+    PackerFile *files;
+    int count;
+    int capacity;
+} PackerList;
+
+static bool Packer_HasExtension(const char *path, const char *ext)
+{
+    size_t len = strlen(path), ext_len = strlen(ext);
+    return len >= ext_len && strcmp(path + len - ext_len, ext) == 0;
+}
+
+static bool Packer_ReadFile(const char *path, Uint8 **data, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (length < 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    *data = malloc(length > 0 ? length : 1);
+    if (!*data || fread(*data, 1, length, file) != (size_t)length)
+    {
+        free(*data);
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+    *size = length;
+    return true;
+}
+
+static bool Packer_AddFile(PackerList *list, const char *path)
+{
+    Uint8 *raw;
+    size_t raw_size;
+    if (!Packer_ReadFile(path, &raw, &raw_size) || raw_size > 0xFFFFFFFFu)
+    {
+        fprintf(stderr, "Lecture impossible: %s\n", path);
+        return false;
+    }
+
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->files = realloc(list->files, list->capacity * sizeof(PackerFile));
+        if (!list->files)
+        {
+            fprintf(stderr, "Erreur d'allocation mémoire pour l'index.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    PackerFile *file = &list->files[list->count++];
+    memset(file, 0, sizeof(PackerFile));
+    Pack_NormalizePath(path, file->path, sizeof(file->path));
+    file->hash = Pack_HashPath(file->path);
+    file->raw_size = (Uint32)raw_size;
+    file->data = raw;
+    file->stored_size = (Uint32)raw_size;
+
+    // Les maps cuites et la base de données doivent rester lisibles en place ;
+    // les PNG ne gagnent rien
+    if (Packer_HasExtension(file->path, ".png") || Packer_HasExtension(file->path, ".cmap") ||
+        Packer_HasExtension(file->path, ".db") || raw_size == 0)
+        return true;
+
+    uLongf packed_size = compressBound(raw_size);
+    Uint8 *packed = malloc(packed_size);
+    if (packed && compress2(packed, &packed_size, raw, raw_size, Z_BEST_COMPRESSION) == Z_OK &&
+        packed_size < raw_size * 9 / 10)
+    {
+        free(raw);
+        file->data = packed;
+        file->stored_size = (Uint32)packed_size;
+        file->flags |= PACK_ENTRY_DEFLATE;
+    }
+    else
+    {
+        free(packed);
+    }
+    return true;
+}
+
+static bool Packer_AddPath(PackerList *list, const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        fprintf(stderr, "Chemin introuvable: %s\n", path);
+        return false;
+    }
+
+    if (!S_ISDIR(st.st_mode))
+        return Packer_AddFile(list, path);
+
+    DIR *dir = opendir(path);
+    if (!dir)
+    {
+        fprintf(stderr, "Dossier illisible: %s\n", path);
+        return false;
+    }
+
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)))
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        char child[1024];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        ok = Packer_AddPath(list, child);
+    }
+
+    closedir(dir);
+    return ok;
+}
+
+static int Packer_CompareFiles(const void *a, const void *b)
+{
+    const PackerFile *fa = (const PackerFile *)a;
+    const PackerFile *fb = (const PackerFile *)b;
+    if (fa->hash != fb->hash)
+        return fa->hash < fb->hash ? -1 : 1;
+    return strcmp(fa->path, fb->path);
+}
+
+static void Packer_Pad(FILE *file, Uint64 *offset, Uint64 alignment)
+{
+    static const Uint8 zeros[PACK_ALIGNMENT] = {0};
+    Uint64 padding = (alignment - (*offset % alignment)) % alignment;
+    fwrite(zeros, 1, padding, file);
+    *offset += padding;
+}
+
+static bool Packer_Write(PackerList *list, const char *output)
+{
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", output);
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible d'écrire %s\n", tmp_path);
+        return false;
+    }
+
+    PackHeader header = {0};
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entry_count = list->count;
+
+    PackEntry *entries = calloc(list->count + 1, sizeof(PackEntry));
+    if (!entries)
+    {
+        fclose(file);
+        return false;
+    }
+
+    // Données : chaque entrée commence sur une frontière de PACK_ALIGNMENT
+    Uint64 offset = sizeof(PackHeader);
+    fwrite(&header, sizeof(header), 1, file);
+
+    Uint32 path_offset = 0;
+    for (int i = 0; i < list->count; i++)
+    {
+        PackerFile *pf = &list->files[i];
+        Packer_Pad(file, &offset, PACK_ALIGNMENT);
+
+        entries[i].hash = pf->hash;
+        entries[i].offset = offset;
+        entries[i].stored_size = pf->stored_size;
+        entries[i].raw_size = pf->raw_size;
+        entries[i].flags = pf->flags;
+        entries[i].path_offset = path_offset;
+        path_offset += strlen(pf->path) + 1;
+
+        fwrite(pf->data, 1, pf->stored_size, file);
+        offset += pf->stored_size;
+    }
+
+    // Index trié puis table des chemins
+    Packer_Pad(file, &offset, 8);
+    header.index_offset = (Uint32)offset;
+    fwrite(entries, sizeof(PackEntry), list->count, file);
+    offset += (Uint64)list->count * sizeof(PackEntry);
+
+    header.paths_offset = (Uint32)offset;
+    header.paths_size = path_offset;
+    for (int i = 0; i < list->count; i++)
+    {
+        fwrite(list->files[i].path, 1, strlen(list->files[i].path) + 1, file);
+    }
+    offset += path_offset;
+    header.file_size = offset;
+
+    free(entries);
+
+    if (offset > 0xFFFFFFFFu)
+    {
+        fclose(file);
+        remove(tmp_path);
+        fprintf(stderr, "Archive trop volumineuse (index limité à 4 Go)\n");
+        return false;
+    }
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+
+    bool ok = !ferror(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_path, output) != 0)
+    {
+        remove(tmp_path);
+        fprintf(stderr, "Erreur d'écriture de l'archive %s\n", output);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <sortie.pak> <dossier|fichier>...\n", argv[0]);
+        return 1;
+    }
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    fprintf(stderr, "Les archives sont petit-boutistes, non supportées sur cette plateforme\n");
+    return 1;
+#endif
+
+    PackerList list = {0};
+    bool ok = true;
+    for (int i = 2; ok && i < argc; i++)
+    {
+        ok = Packer_AddPath(&list, argv[i]);
+    }
+
+    if (ok)
+    {
+        qsort(list.files, list.count, sizeof(PackerFile), Packer_CompareFiles);
+
+        // Doublons (même fichier passé deux fois) et collisions de hash à signaler
+        for (int i = 1; ok && i < list.count; i++)
+        {
+            if (list.files[i].hash != list.files[i - 1].hash)
+                continue;
+            if (strcmp(list.files[i].path, list.files[i - 1].path) == 0)
+            {
+                fprintf(stderr, "Fichier ajouté deux fois: %s\n", list.files[i].path);
+                ok = false;
+            }
+            else
+            {
+                printf("Collision de hash (résolue par le chemin): %s / %s\n",
+                       list.files[i - 1].path, list.files[i].path);
+            }
+        }
+    }
+
+    if (ok)
+        ok = Packer_Write(&list, argv[1]);
+
+    if (ok)
+    {
+        Uint64 raw_total = 0, stored_total = 0;
+        for (int i = 0; i < list.count; i++)
+        {
+            raw_total += list.files[i].raw_size;
+            stored_total += list.files[i].stored_size;
+        }
+        printf("%s: %d fichiers, %llu -> %llu octets\n", argv[1], list.count,
+               (unsigned long long)raw_total, (unsigned long long)stored_total);
+    }
+
+    for (int i = 0; i < list.count; i++)
+    {
+        free(list.files[i].data);
+    }
+    free(list.files);
+    return ok ? 0 : 1;
+}